@@ -0,0 +1,97 @@
+#pragma once
+
+#include <dam/types.hpp>
+#include <dam/result.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dam {
+
+/**
+ * CompletionIndex - Memory-mapped snippet names and tags for shell completion.
+ *
+ * The store rewrites the file (atomically, on checkpoint) whenever names
+ * or tags have changed, so a completion request can answer from it alone
+ * without opening the database or its buffer pool.
+ *
+ * Each list is sorted and concatenated, with an offset table and a
+ * 256-entry index of where each leading byte starts. A prefix lookup
+ * jumps to its leading byte's bucket and binary searches only that.
+ */
+class CompletionIndex {
+public:
+    enum class Kind { NAMES = 0, TAGS = 1 };
+
+    /**
+     * File name of the index inside a store directory.
+     */
+    static constexpr const char* FILE_NAME = "dam.complete";
+
+    /**
+     * Write an index file (replaced atomically).
+     *
+     * @param path Output file
+     * @param names Snippet names (sorted and deduplicated here)
+     * @param tags Tags (sorted and deduplicated here)
+     * @return Success or error
+     */
+    static Result<void> write(const fs::path& path,
+                              std::vector<std::string> names,
+                              std::vector<std::string> tags);
+
+    /**
+     * Map an index file read-only.
+     *
+     * @param path Index file
+     * @return The opened index, or error
+     */
+    static Result<std::unique_ptr<CompletionIndex>> open(const fs::path& path);
+
+    ~CompletionIndex();
+
+    CompletionIndex(const CompletionIndex&) = delete;
+    CompletionIndex& operator=(const CompletionIndex&) = delete;
+
+    /**
+     * Number of entries in a list.
+     */
+    size_t size(Kind kind) const { return lists_[static_cast<int>(kind)].count; }
+
+    /**
+     * Entries starting with a prefix, in sorted order.
+     *
+     * @param kind Names or tags
+     * @param prefix The prefix (empty matches everything)
+     * @param limit Maximum entries to return (0 = no limit)
+     * @return Views into the mapping, valid while the index is open
+     */
+    std::vector<std::string_view> complete(Kind kind, std::string_view prefix,
+                                           size_t limit = 0) const;
+
+private:
+    struct List {
+        const uint32_t* buckets = nullptr;  // [257] first entry per leading byte
+        const uint32_t* offsets = nullptr;  // [count + 1] into strings
+        const char* strings = nullptr;
+        uint32_t strings_size = 0;
+        uint32_t count = 0;
+    };
+
+    CompletionIndex() = default;
+
+    Result<void> load();
+    std::string_view entry(const List& list, uint32_t index) const;
+
+    fs::path path_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buffer_;  // File contents when mmap is unavailable
+    List lists_[2];
+};
+
+}  // namespace dam
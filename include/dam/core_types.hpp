@@ -18,9 +18,19 @@ constexpr PageId INVALID_PAGE_ID = 0;
 constexpr FileId INVALID_FILE_ID = 0;
 
 // Page configuration
+// Page size is chosen per database file (recorded in its header);
+// PAGE_SIZE is the default and the smallest supported size.
 constexpr size_t PAGE_SIZE = 4096;  // 4KB pages, aligned to disk blocks
+constexpr size_t MIN_PAGE_SIZE = PAGE_SIZE;
+constexpr size_t MAX_PAGE_SIZE = 1024 * 1024;
 constexpr size_t MAX_KEY_SIZE = 256;
 
+// Valid page sizes are powers of two in [MIN_PAGE_SIZE, MAX_PAGE_SIZE]
+constexpr bool is_valid_page_size(size_t size) {
+    return size >= MIN_PAGE_SIZE && size <= MAX_PAGE_SIZE &&
+           (size & (size - 1)) == 0;
+}
+
 // File metadata stored in the file index
 struct FileMetadata {
     FileId id = INVALID_FILE_ID;
@@ -8,4 +8,5 @@
 
 #include <dam/types.hpp>
 #include <dam/snippet_store.hpp>
+#include <dam/completion_index.hpp>
 #include <dam/language_detector.hpp>
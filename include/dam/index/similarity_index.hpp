@@ -0,0 +1,170 @@
+#pragma once
+
+#include <dam/core_types.hpp>
+#include <dam/result.hpp>
+#include <dam/storage/btree.hpp>
+
+#include <array>
+#include <functional>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace dam {
+
+/**
+ * MinHash - Fixed-size signatures that estimate Jaccard similarity.
+ *
+ * Each of NUM_HASHES hash functions keeps its minimum over a document's
+ * trigram set. The fraction of positions where two signatures agree is an
+ * unbiased estimate of the Jaccard similarity of the two sets.
+ */
+class MinHash {
+public:
+    static constexpr size_t NUM_HASHES = 128;
+    using Signature = std::array<uint32_t, NUM_HASHES>;
+
+    /**
+     * Compute the signature of a trigram set
+     * (e.g. from TrigramIndex::extract_trigrams).
+     */
+    static Signature compute(const std::set<std::string>& trigrams);
+
+    /**
+     * Compute the signature of a text's lowercased trigrams without
+     * materializing the set.
+     *
+     * @return The signature, or nullopt if the text has no trigrams
+     */
+    static std::optional<Signature> from_text(const std::string& text);
+
+    /**
+     * Estimate the Jaccard similarity of two documents.
+     */
+    static float similarity(const Signature& a, const Signature& b);
+};
+
+/**
+ * A pair of near-duplicate documents.
+ */
+struct SimilarPair {
+    FileId first;
+    FileId second;
+    float similarity;
+};
+
+/**
+ * A document similar to a query document.
+ */
+struct SimilarMatch {
+    FileId id;
+    float similarity;
+};
+
+/**
+ * SimilarityIndex - Persistent MinHash/LSH index for near-duplicate search.
+ *
+ * Stores each document's MinHash signature, and buckets documents by
+ * NUM_BANDS bands of ROWS_PER_BAND signature rows. Documents that share a
+ * bucket in any band are candidates; candidates are then checked against
+ * their full signatures. With 16 bands of 8 rows, pairs at 0.9 similarity
+ * collide with probability > 0.99 and pairs below 0.5 rarely do, so
+ * lookups touch only near neighbours instead of every document.
+ *
+ * Key layout in the tree:
+ * - "sig:<id>" -> signature
+ * - "band:<band>:<bucket hash>:<id>" -> (empty); a bucket is read by a
+ *   prefix scan, so adding a document never rewrites a shared value
+ * - "layout" -> LAYOUT_VERSION
+ */
+class SimilarityIndex {
+public:
+    static constexpr size_t NUM_BANDS = 16;
+    static constexpr size_t ROWS_PER_BAND = MinHash::NUM_HASHES / NUM_BANDS;
+
+    /**
+     * Create a similarity index backed by a B+ tree.
+     *
+     * @param buffer_pool The buffer pool for page management
+     * @param root_page_id Root page ID (INVALID_PAGE_ID to create new)
+     */
+    SimilarityIndex(BufferPool* buffer_pool, PageId root_page_id = INVALID_PAGE_ID);
+
+    /**
+     * Index a document's content. Replaces any previous entry.
+     *
+     * @param file_id The document ID
+     * @param content The document content
+     * @return true if indexed (content too short to have trigrams is
+     *         skipped), or error if the tree could not be written; no
+     *         entry for the document is left then
+     */
+    Result<bool> add(FileId file_id, const std::string& content);
+
+    /**
+     * Remove a document.
+     *
+     * @param file_id The document ID
+     * @return true if the document was indexed, or error
+     */
+    Result<bool> remove(FileId file_id);
+
+    /**
+     * Whether the tree uses the current key layout. An index written in
+     * an older layout must be cleared and rebuilt.
+     */
+    bool has_current_layout() const;
+
+    /**
+     * Remove every entry and mark the tree with the current layout.
+     */
+    Result<void> clear();
+
+    /**
+     * Find documents similar to an indexed document.
+     *
+     * @param file_id The query document
+     * @param threshold Minimum estimated Jaccard similarity
+     * @param max_results Maximum number of matches
+     * @return Matches, most similar first
+     */
+    std::vector<SimilarMatch> find_similar(FileId file_id, float threshold,
+                                           size_t max_results = 50) const;
+
+    /**
+     * Find all pairs of near-duplicate documents.
+     *
+     * @param threshold Minimum estimated Jaccard similarity
+     * @return Pairs (first < second), most similar first
+     */
+    std::vector<SimilarPair> find_duplicates(float threshold) const;
+
+    /**
+     * Get a document's stored signature.
+     */
+    std::optional<MinHash::Signature> get_signature(FileId file_id) const;
+
+    /**
+     * Get root page ID for persistence.
+     */
+    PageId get_root_page_id() const { return tree_.get_root_page_id(); }
+
+private:
+    static constexpr const char* LAYOUT_KEY = "layout";
+    static constexpr const char* LAYOUT_VERSION = "2";
+
+    // Key prefixes of a signature's buckets, one per band
+    static std::vector<std::string> bucket_prefixes(const MinHash::Signature& signature);
+
+    static std::string bucket_key(const std::string& prefix, FileId file_id);
+    static std::string signature_key(FileId file_id);
+
+    // Call for each document in the bucket with the given key prefix
+    void for_each_in_bucket(const std::string& prefix,
+                            const std::function<void(FileId)>& callback) const;
+
+    BPlusTree tree_;
+};
+
+}  // namespace dam
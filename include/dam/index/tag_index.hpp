@@ -53,6 +53,24 @@ public:
      */
     bool remove_file_from_all_tags(FileId file_id, const std::vector<std::string>& tags);
 
+    /**
+     * Add many files to a tag with one rewrite of its set.
+     *
+     * @param tag The tag
+     * @param file_ids The file IDs to add
+     * @return false if the index could not be written
+     */
+    bool add_files_to_tag(const std::string& tag, const std::set<FileId>& file_ids);
+
+    /**
+     * Remove many files from a tag with one rewrite of its set.
+     *
+     * @param tag The tag
+     * @param file_ids The file IDs to remove
+     * @return false if the index could not be written
+     */
+    bool remove_files_from_tag(const std::string& tag, const std::set<FileId>& file_ids);
+
     /**
      * Get all file IDs for a tag.
      *
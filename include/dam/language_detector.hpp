@@ -1,29 +1,57 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace dam {
 
+/**
+ * Result of classifying content by language.
+ */
+struct LanguageGuess {
+    std::string language = "text";
+    float confidence = 0.0f;  // Probability of the guess (0-1)
+};
+
 /**
  * Detects programming language from file content and/or filename.
  *
  * Detection priority:
  * 1. Shebang line (#!/bin/bash, #!/usr/bin/env python)
  * 2. File extension mapping
- * 3. Returns "text" if unknown
+ * 3. Content classifier (if confident enough)
+ * 4. Returns "text" if unknown
  */
 class LanguageDetector {
 public:
+    /**
+     * Minimum classifier confidence for detect() to use its guess.
+     */
+    static constexpr float MIN_CONFIDENCE = 0.75f;
+
     /**
      * Detect language from content and optional filename.
      *
-     * @param content The file content (checks shebang)
+     * @param content The file content (checks shebang, then classifies)
      * @param filename Optional filename (checks extension)
      * @return Detected language name (lowercase)
      */
     static std::string detect(const std::string& content,
                              const std::string& filename = "");
 
+    /**
+     * Classify content by language without looking at a filename.
+     *
+     * A linear model over token, line-start and line-end features plus
+     * a byte histogram, with weights compiled into static tables. Only
+     * the first 64 KiB are examined.
+     *
+     * @param content The file content
+     * @return Most likely language and its probability ("text" if no
+     *         language is more likely than plain text)
+     */
+    static LanguageGuess classify(std::string_view content);
+
 private:
     static std::string from_extension(const std::string& filename);
     static std::string from_shebang(const std::string& content);
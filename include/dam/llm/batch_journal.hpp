@@ -0,0 +1,52 @@
+#pragma once
+
+#include <dam/result.hpp>
+#include <dam/types.hpp>
+
+#include <fstream>
+#include <set>
+#include <string>
+
+namespace dam::llm {
+
+// ============================================================================
+// Batch Journal
+// ============================================================================
+
+/**
+ * BatchJournal - Keys of the finished jobs of a resumable batch.
+ *
+ * One key per line, appended and flushed as each job finishes, so a batch
+ * that is interrupted skips those jobs when it is run again. A last line
+ * without its newline was cut off mid-write; open() drops it, and that
+ * job is not counted as done.
+ *
+ *   auto journal = BatchJournal::open("jobs.jsonl.progress");
+ *   if (!journal->done(key)) {
+ *       ... run the job ...
+ *       journal->record(key);
+ *   }
+ */
+class BatchJournal {
+public:
+    /**
+     * Load a journal (a missing file is an empty one) and open it for
+     * appending.
+     */
+    static Result<BatchJournal> open(const fs::path& path);
+
+    bool done(const std::string& key) const { return done_.count(key) != 0; }
+    size_t size() const { return done_.size(); }
+
+    /**
+     * Mark a job finished. Keys must not contain newlines.
+     */
+    Result<void> record(const std::string& key);
+
+private:
+    fs::path path_;
+    std::set<std::string> done_;
+    std::ofstream file_;
+};
+
+}  // namespace dam::llm
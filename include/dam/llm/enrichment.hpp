@@ -0,0 +1,224 @@
+#pragma once
+
+#include "router.hpp"
+
+#include <dam/snippet_store.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dam::llm {
+
+// ============================================================================
+// Enrichment Cache
+// ============================================================================
+
+/**
+ * A generated description and tags for one snippet body.
+ */
+struct Enrichment {
+    std::string description;
+    std::vector<std::string> tags;
+};
+
+/**
+ * EnrichmentCache - Enrichments keyed by content, persisted beside the store.
+ *
+ * The key is the content's CRC32 and size, so a body is sent to the model
+ * once however often it is copied, and an edited body is sent again.
+ * Entries are kept even when the model returned nothing useful, so that
+ * content is not retried either.
+ */
+class EnrichmentCache {
+public:
+    static uint64_t key(uint32_t checksum, size_t size) {
+        return (static_cast<uint64_t>(size) << 32) | checksum;
+    }
+
+    /**
+     * Load a cache file; a missing file gives an empty cache.
+     */
+    static Result<EnrichmentCache> load(const fs::path& path);
+
+    /**
+     * Write the cache back to the file it was loaded from (if changed).
+     */
+    Result<void> save();
+
+    const Enrichment* find(uint64_t key) const;
+    void put(uint64_t key, Enrichment enrichment);
+    size_t size() const { return entries_.size(); }
+
+private:
+    fs::path path_;
+    std::unordered_map<uint64_t, Enrichment> entries_;
+    bool dirty_ = false;
+};
+
+// ============================================================================
+// Enrichment Worker
+// ============================================================================
+
+struct EnrichmentOptions {
+    bool describe = true;           // Fill missing descriptions
+    bool tag = true;                // Fill missing tags
+    size_t max_tags = 5;
+
+    // Snippets sent to the router together (LLMRouter::complete_batch)
+    size_t batch_size = 4;
+
+    // poll() looks for new work at most this often once nothing is left
+    std::chrono::milliseconds rescan_interval{30000};
+
+    // Content whose model call failed is retried after rescan_interval,
+    // then twice as long each time; after max_failures it is left alone
+    // until it changes or the worker is restarted
+    size_t max_failures = 3;
+
+    // Throttling. The worker only starts a batch once no interactive
+    // request has been noted for idle_delay, and rests after each batch
+    // so it is busy at most max_duty_cycle of the time.
+    std::chrono::milliseconds idle_delay{2000};
+    double max_duty_cycle = 0.25;
+
+    // A batch averaging more than this per snippet means the backend is
+    // loaded: the rest after it doubles (up to max_rest) until one is fast
+    std::chrono::milliseconds latency_budget{5000};
+    std::chrono::milliseconds max_rest{60000};
+};
+
+/**
+ * Read a model's "Description: ..." / "Tags: a, b" reply. Without a
+ * description label the first other line is used; tags are lowercased,
+ * hyphenated and deduplicated, and overlong ones dropped.
+ *
+ * @param text The model's reply
+ * @param max_tags Tags kept at most
+ * @return The enrichment (fields are empty if nothing was usable)
+ */
+Enrichment parse_enrichment(const std::string& text, size_t max_tags);
+
+/**
+ * EnrichmentWorker - Fills in missing snippet descriptions and tags.
+ *
+ * SnippetStore is not thread-safe, so the work is split: poll(), called
+ * from the thread that owns the store, finds snippets without a
+ * description or tags and writes finished results back; a background
+ * thread only talks to the router. Results are only written into fields
+ * that are still empty, and only if the content has not changed since
+ * it was read. They are written with SnippetStore::annotate, so they add
+ * no revision and leave the modification time alone.
+ *
+ *   EnrichmentWorker worker(store, router);
+ *   worker.start();
+ *   while (running) {
+ *       worker.notify_activity();  // On each interactive request
+ *       worker.poll();             // Now and then, e.g. when idle
+ *   }
+ *   worker.stop();
+ */
+class EnrichmentWorker {
+public:
+    EnrichmentWorker(SnippetStore& store, LLMRouter& router, EnrichmentOptions options = {});
+    ~EnrichmentWorker();
+
+    EnrichmentWorker(const EnrichmentWorker&) = delete;
+    EnrichmentWorker& operator=(const EnrichmentWorker&) = delete;
+
+    /**
+     * Load <root>/enrichment.cache and start the background thread.
+     */
+    Result<void> start();
+
+    /**
+     * Stop the background thread (the batch in progress is finished
+     * first), apply what is done and save the cache.
+     */
+    Result<void> stop();
+
+    /**
+     * Apply finished results and queue snippets that still need work.
+     * Snippets whose content is already cached are filled without a
+     * model call.
+     *
+     * @return Snippets updated, or error
+     */
+    Result<size_t> poll();
+
+    /**
+     * Note interactive use; defers the next batch by idle_delay.
+     * Safe to call from any thread.
+     */
+    void notify_activity();
+
+    /**
+     * Whether snippets are queued or being enriched.
+     */
+    bool busy() const;
+
+    struct Stats {
+        size_t queued = 0;          // Distinct contents sent to the worker
+        size_t generated = 0;       // Model calls that succeeded
+        size_t failed = 0;          // Model calls that failed
+        size_t from_cache = 0;      // Snippets filled from the cache
+        size_t updated = 0;         // Snippets written back
+        size_t stale = 0;           // Results dropped because content changed
+        size_t abandoned = 0;       // Contents not retried after max_failures
+    };
+    Stats stats() const;
+
+private:
+    struct Job {
+        std::vector<SnippetId> ids;  // Snippets sharing this content
+        uint64_t key;
+        std::string name;
+        std::string language;
+        std::string content;
+    };
+
+    struct Done {
+        Job job;
+        bool ok = false;
+        Enrichment enrichment;
+    };
+
+    struct Failure {
+        size_t count = 0;
+        std::chrono::steady_clock::time_point retry_at;
+    };
+
+    void run();
+    CompletionRequest make_request(const Job& job) const;
+    Result<bool> apply(SnippetId id, uint64_t key, const Enrichment& enrichment);
+    Result<size_t> apply_finished();
+    Result<size_t> queue_pending();
+
+    SnippetStore& store_;
+    LLMRouter& router_;
+    EnrichmentOptions options_;
+    EnrichmentCache cache_;
+    std::unordered_map<uint64_t, Failure> failures_;  // By content key; owner thread only
+
+    std::thread thread_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Job> pending_;
+    std::vector<Done> finished_;
+    std::unordered_set<SnippetId> in_progress_;  // Queued or running
+    bool stopping_ = false;
+    bool started_ = false;
+    Stats stats_;
+    std::chrono::steady_clock::time_point next_scan_{};
+
+    std::atomic<int64_t> last_activity_ms_{0};  // steady_clock, since epoch
+};
+
+}  // namespace dam::llm
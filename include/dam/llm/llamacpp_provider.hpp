@@ -13,6 +13,13 @@
 
 namespace dam::llm {
 
+// Precision of the KV cache entries
+enum class KVCacheType {
+    F16,    // Full precision
+    Q8_0,   // About half the memory of F16, near lossless
+    Q4_0    // About a quarter, with some quality loss
+};
+
 struct LlamaCppConfig {
     std::string model_path;
 
@@ -34,8 +41,58 @@ struct LlamaCppConfig {
 
     // Attention
     bool flash_attn = false;    // Use flash attention if available
+
+    // KV cache. Keys are always stored as kv_cache_type; llama.cpp can
+    // only quantize values with flash attention, so they stay F16 without.
+    KVCacheType kv_cache_type = KVCacheType::F16;
+
+    // When the context fills, drop the older half of what follows the
+    // system prompt and keep decoding, instead of failing
+    bool context_shift = true;
 };
 
+// ============================================================================
+// Context Window and KV Cache Arithmetic
+// ============================================================================
+
+/**
+ * Entry types of the KV cache for a config. Keys use kv_cache_type;
+ * values too with flash attention, and F16 without.
+ */
+struct KVCacheTypes {
+    KVCacheType k;
+    KVCacheType v;
+};
+KVCacheTypes kv_cache_types(const LlamaCppConfig& config);
+
+/**
+ * Parse a KV cache type name: f16, q8_0 (or q8) or q4_0 (or q4).
+ */
+Result<KVCacheType> parse_kv_cache_type(const std::string& name);
+
+/**
+ * Prompt tokens kept at the front of the context when it shifts: the
+ * system prefix, up to half the context.
+ */
+size_t context_keep_tokens(size_t prefix_tokens, size_t n_ctx);
+
+/**
+ * Tokens dropped when a full context shifts: the older half of what
+ * follows the first n_keep.
+ */
+size_t context_shift_discard(size_t n_tokens, size_t n_keep);
+
+/**
+ * Prompt tokens after the kept ones that a fresh window skips, so the
+ * prompt's end fits with room left to generate (max_tokens, up to a
+ * quarter of the context). 0 when the whole prompt fits.
+ */
+size_t context_window_offset(size_t n_tokens, size_t n_keep, size_t n_ctx, int max_tokens);
+
+// ============================================================================
+// llama.cpp Provider
+// ============================================================================
+
 class LlamaCppProvider : public LLMProvider {
 public:
     explicit LlamaCppProvider(LlamaCppConfig config);
@@ -59,7 +116,7 @@ public:
 
     // llama.cpp specific
     Result<void> warmup();  // Pre-load model into memory
-    size_t memory_usage() const;
+    size_t memory_usage() const;  // Model weights plus the KV cache, in bytes
 
     // Factory methods
     static Result<std::unique_ptr<LlamaCppProvider>> create(LlamaCppConfig config);
@@ -82,11 +139,27 @@ private:
     std::atomic<bool> abort_requested_{false};
     mutable std::mutex inference_mutex_;
 
+    // What the KV cache holds, by position, so the next request only
+    // decodes what differs. The first keep_tokens_ are the prompt's
+    // system prefix; the rest are the prompt and output from
+    // window_offset_ tokens past it (above 0 once the context shifted).
+    std::vector<int32_t> kv_tokens_;
+    size_t keep_tokens_ = 0;
+    size_t window_offset_ = 0;
+    size_t kv_cache_bytes_ = 0;
+    bool can_shift_ = false;
+
     // Internal helpers
     std::vector<int32_t> tokenize(const std::string& text, bool add_bos);
     std::string detokenize(const std::vector<int32_t>& tokens);
+    std::string build_system_prefix(const CompletionRequest& request);
     std::string build_prompt(const CompletionRequest& request);
-    void setup_sampler(const CompletionRequest& request);
+    Result<void> setup_sampler(const CompletionRequest& request);
+#ifdef DAM_HAS_LLAMACPP
+    Result<void> decode_tokens(llama_batch& batch, const std::vector<llama_token>& tokens);
+    bool shift_context();
+    void clear_kv_cache();
+#endif
 };
 
 }  // namespace dam::llm
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <dam/result.hpp>
+#include <dam/llm/stop_conditions.hpp>
 
 #include <atomic>
 #include <chrono>
@@ -46,6 +47,14 @@ struct CompletionRequest {
     float repeat_penalty = 1.1f;
     std::vector<std::string> stop_sequences;
 
+    // Structure-aware stopping: end once the output completes a line or
+    // block of the code in stop_context (what the completion continues)
+    StopMode stop_mode = StopMode::NONE;
+    std::string stop_context;
+
+    // GBNF grammar constraining the output (llama.cpp only; others ignore it)
+    std::string grammar;
+
     // Streaming
     StreamCallback on_chunk = nullptr;
 
@@ -55,7 +64,7 @@ struct CompletionRequest {
 
 struct CompletionResult {
     std::string content;
-    std::string stop_reason;  // "eos", "max_tokens", "stop_sequence", "aborted"
+    std::string stop_reason;  // "eos", "max_tokens", "stop_sequence", "structure", "aborted"
 
     // Token counts
     int prompt_tokens = 0;
@@ -73,6 +82,7 @@ struct ProviderInfo {
     bool supports_streaming = true;
     size_t context_length = 4096;
     size_t model_size_bytes = 0;
+    int max_concurrency = 1;        // Calls it can serve at once
 };
 
 // ============================================================================
@@ -125,6 +135,54 @@ Use the specified language if provided, otherwise infer the most appropriate lan
 Write clean, idiomatic, production-quality code. Include necessary imports/headers.
 Keep the code focused and minimal - only implement what was requested.)";
 
+constexpr const char* DESCRIBE_SNIPPET = R"(You describe code snippets for a snippet library.
+Given a snippet, reply with ONE concise sentence saying what it does.
+Output ONLY the sentence - no quotes, no markdown, no preamble.)";
+
+constexpr const char* SUGGEST_TAGS = R"(You tag code snippets for a snippet library.
+Given a snippet, reply with up to 5 short lowercase tags (topic, tool, technique).
+Output ONLY the tags, comma-separated - no explanations.)";
+
+constexpr const char* ADD_DOCSTRING = R"(You are an expert programmer documenting code.
+Add idiomatic documentation comments or docstrings for the given code in its language's style.
+Do not change behavior, names or formatting otherwise.
+Output ONLY the complete documented code - no markdown code fences, no explanations.)";
+
+constexpr const char* ENRICH_SNIPPET = R"(You catalogue code snippets for a snippet library.
+Given a snippet, reply with exactly two lines:
+Description: <one concise sentence saying what it does>
+Tags: <up to 5 short lowercase tags (topic, tool, technique), comma-separated>
+Output nothing else.)";
+
 }  // namespace prompts
 
+// ============================================================================
+// GBNF Grammars for CompletionRequest::grammar
+// ============================================================================
+
+namespace grammars {
+
+// A single line of output
+constexpr const char* SINGLE_LINE = R"(root ::= [^\n]*)";
+
+// Code only: no line may open a markdown code fence
+constexpr const char* NO_CODE_FENCE = R"(root ::= line ("\n" line)*
+line ::= "" | [^`\n] [^\n]* | "`" ([^`\n] [^\n]*)? | "``" ([^`\n] [^\n]*)?)";
+
+// The grammar matching a stop mode: one line for LINE, unfenced code for
+// BLOCK, none for NONE
+inline const char* for_stop_mode(StopMode mode) {
+    switch (mode) {
+        case StopMode::LINE:
+            return SINGLE_LINE;
+        case StopMode::BLOCK:
+            return NO_CODE_FENCE;
+        case StopMode::NONE:
+            break;
+    }
+    return "";
+}
+
+}  // namespace grammars
+
 }  // namespace dam::llm
@@ -5,7 +5,10 @@
 #include "model_discovery.hpp"
 #include "ollama_provider.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
@@ -44,6 +47,36 @@ struct LLMRouterConfig {
     bool enable_cache = true;
     size_t cache_size = 100;
     int cache_ttl_seconds = 300;  // 5 minutes
+
+    // Identical requests made while one is running share its generation
+    bool enable_coalescing = true;
+};
+
+// ============================================================================
+// Batch Completion
+// ============================================================================
+
+struct BatchOptions {
+    // Requests run at once on each provider, by provider name or else
+    // max_concurrency_per_provider. Either is capped by the provider's
+    // ProviderInfo::max_concurrency: a local llama.cpp model and
+    // OllamaProvider (one connection) take one call at a time, whatever
+    // is asked for here.
+    int max_concurrency_per_provider = 1;
+    std::unordered_map<std::string, int> concurrency_by_provider;
+
+    // Retries: RATE_LIMITED, TIMEOUT and NETWORK_ERROR are retried with
+    // exponential backoff, on any provider; a rate-limited provider also
+    // takes no new requests until its backoff has passed. Other errors
+    // move the request on to the providers that have not yet failed it;
+    // it fails with the last error once every provider has.
+    int max_attempts = 4;
+    int initial_backoff_ms = 500;
+    int max_backoff_ms = 30000;
+
+    // Called as each request finishes (index into the batch). Calls come
+    // from worker threads but never overlap.
+    std::function<void(size_t index, const Result<CompletionResult>& result)> on_result;
 };
 
 // ============================================================================
@@ -66,7 +99,9 @@ public:
     std::vector<ProviderInfo> list_providers() const;
     std::string active_provider_name() const;
 
-    // Main completion interface (routes automatically)
+    // Main completion interface (routes automatically). Concurrent
+    // identical requests are coalesced: one runs, the others wait for its
+    // result, and streaming callers all receive its chunks.
     Result<CompletionResult> complete(const CompletionRequest& request);
 
     // Specialized methods (with intelligent routing)
@@ -80,6 +115,12 @@ public:
         const std::string& language = "",
         StreamCallback callback = nullptr);
 
+    // Run many requests across every available provider (in strategy
+    // order), bounded per provider; results are in request order
+    std::vector<Result<CompletionResult>> complete_batch(
+        const std::vector<CompletionRequest>& requests,
+        const BatchOptions& options = {});
+
     // Direct provider access (bypass routing)
     Result<CompletionResult> complete_with_provider(
         const std::string& provider_name,
@@ -130,7 +171,41 @@ private:
     // Statistics
     mutable std::unordered_map<std::string, ProviderStats> stats_;
 
+    // Request coalescing (single-flight), keyed by cache_key(). The first
+    // caller runs the generation on its own thread; later callers wait for
+    // it, and a follower that stops listening returns early. The provider
+    // is asked to stream only when the first caller has a callback.
+    struct InFlight {
+        struct Subscriber {
+            StreamCallback callback;
+            std::mutex calling;             // Serializes calls to callback
+            std::atomic<bool> active{true}; // false once callback declined
+            size_t heard = 0;               // Bytes streamed when it declined
+        };
+
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        std::vector<std::shared_ptr<Subscriber>> subscribers;  // Active only
+        std::string streamed;   // Chunks so far, replayed to late subscribers
+        bool streaming = false; // Whether chunks are fanned out at all
+        int participants = 0;   // Callers waiting on this generation
+        int declined = 0;       // Streaming callers that stopped listening
+        std::optional<Result<CompletionResult>> result;
+    };
+    std::unordered_map<std::string, std::shared_ptr<InFlight>> in_flight_;
+    std::mutex in_flight_mutex_;
+
+    Result<CompletionResult> complete_coalesced(const std::string& key,
+                                                const CompletionRequest& request);
+    Result<CompletionResult> lead_flight(const std::shared_ptr<InFlight>& flight,
+                                         const std::string& key,
+                                         const CompletionRequest& request);
+    Result<CompletionResult> join_flight(InFlight& flight, const StreamCallback& callback);
+    static bool fan_out(InFlight& flight, const std::string& chunk);
+    Result<CompletionResult> complete_with_fallback(const CompletionRequest& request);
+
     // Routing logic
+    std::vector<LLMProvider*> providers_in_strategy_order() const;
     LLMProvider* select_provider(const CompletionRequest& request);
     LLMProvider* select_by_strategy(const CompletionRequest& request);
     LLMProvider* get_fallback_provider(LLMProvider* failed);
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dam::llm {
+
+struct CompletionRequest;
+
+// ============================================================================
+// Structure-Aware Stopping
+// ============================================================================
+
+enum class StopMode {
+    NONE,   // Stop only at max_tokens, end of generation or a stop sequence
+    LINE,   // Stop at the end of the first line (outside brackets and strings)
+    BLOCK   // Stop once a statement or bracketed block at the starting
+            // indentation is complete, or an enclosing bracket is closed
+};
+
+/**
+ * StopSequenceMatcher - Incremental stop-sequence matching.
+ *
+ * The stop sequences are compiled into one Aho-Corasick automaton, so each
+ * generated byte costs a single table step however long the output or how
+ * many stop sequences there are.
+ */
+class StopSequenceMatcher {
+public:
+    explicit StopSequenceMatcher(const std::vector<std::string>& stops = {});
+
+    bool empty() const { return depth_.size() <= 1; }
+
+    /**
+     * Advance by one byte.
+     *
+     * @return Length of the stop sequence ending at this byte, or 0
+     */
+    size_t step(unsigned char c) {
+        state_ = next_[state_ * 256 + c];
+        return match_[state_];
+    }
+
+    /**
+     * Length of the longest suffix seen so far that could still grow into
+     * a stop sequence (such text must not be shown yet).
+     */
+    size_t pending() const { return depth_[state_]; }
+
+    void reset() { state_ = 0; }
+
+private:
+    std::vector<uint32_t> next_;   // [state * 256 + byte] -> state
+    std::vector<uint32_t> match_;  // Longest stop sequence ending at a state (0 = none)
+    std::vector<uint32_t> depth_;  // Length of the prefix a state stands for
+    uint32_t state_ = 0;
+};
+
+/**
+ * StructureTracker - Bracket and indentation balance over generated code.
+ *
+ * Tracks (), [] and {} nesting, skipping string literals, comments
+ * (//, #, and block comments) and markdown fence lines, and the
+ * indentation of each line. Language agnostic: brace languages end
+ * units with ';' or '}', indentation languages by returning to the
+ * starting indentation.
+ */
+class StructureTracker {
+public:
+    /**
+     * @param mode LINE or BLOCK (NONE never stops)
+     * @param context Text the generation continues. It is scanned once so
+     *                brackets opened on its last line may be closed, and
+     *                that line gives the starting indentation.
+     */
+    explicit StructureTracker(StopMode mode, std::string_view context = {});
+
+    /**
+     * Advance by one byte at absolute output offset pos.
+     *
+     * @return Offset to cut the output at, once the unit is complete
+     */
+    std::optional<size_t> step(char c, size_t pos);
+
+    /**
+     * Offset a cut may still land on while the first word of a line is
+     * read (text from there on must not be shown yet).
+     */
+    std::optional<size_t> pending_cut() const { return pending_cut_; }
+
+private:
+    bool ends_line();
+    void start_line(size_t pos);
+    void mark_code(char c);
+
+    StopMode mode_;
+    bool priming_ = false;     // Scanning the context: never cut
+    int depth_ = 0;
+    int floor_ = 0;            // Depth at the start of the context's last line
+    int line_floor_ = 0;       // Depth at the start of the current line
+    char quote_ = 0;
+    bool escaped_ = false;
+    bool line_comment_ = false;
+    bool block_comment_ = false;
+    int fence_ = 0;            // Backticks opening the current line so far
+    bool emitted_before_fence_ = false;
+    char prev_ = 0;
+
+    int base_indent_ = -1;     // Indentation of the starting line (-1 = unknown yet)
+    int indent_ = 0;           // Indentation of the current line
+    bool at_line_start_ = true;  // Only whitespace so far on the current line
+    char last_code_ = 0;       // Last non-space byte outside comments on the line
+    bool line_generated_ = false;  // Code was generated on the current line
+    bool emitted_ = false;     // Any code was generated
+    char code_before_slash_ = 0;
+    bool continues_ = true;    // The previous line did not end a statement
+    size_t line_start_ = 0;    // Offset of the current line's newline
+    std::optional<size_t> pending_cut_;
+    std::string word_;         // First word of a line that may start a new statement
+};
+
+/**
+ * StopController - Applies a request's stop conditions to generated text.
+ *
+ * Providers append each decoded piece and stop generating as soon as
+ * append() returns true. Text that may still be cut (a partial stop
+ * sequence, or trailing whitespace before a structural stop) is held
+ * back from streaming until it is settled.
+ *
+ *   StopController stop(request);
+ *   for (each piece) {
+ *       bool done = stop.append(piece);
+ *       if (!stop.stream(request.on_chunk)) { aborted }
+ *       if (done) break;
+ *   }
+ *   stop.finish();  // Release held-back text
+ *   stop.stream(request.on_chunk);
+ */
+class StopController {
+public:
+    explicit StopController(const CompletionRequest& request);
+
+    /**
+     * Append generated text.
+     *
+     * @return true once a stop condition has been met
+     */
+    bool append(std::string_view text);
+
+    /**
+     * Mark the generation finished so no text is held back anymore.
+     */
+    void finish() { finished_ = true; }
+
+    /**
+     * Pass the text that is ready and not yet streamed to a callback.
+     *
+     * @return false if the callback asked to abort
+     */
+    bool stream(const std::function<bool(const std::string&)>& callback);
+
+    bool stopped() const { return !stop_reason_.empty(); }
+
+    /**
+     * "stop_sequence", "structure", or empty while generating.
+     */
+    const std::string& stop_reason() const { return stop_reason_; }
+
+    /**
+     * Output so far, with any stop sequence removed.
+     */
+    const std::string& content() const { return content_; }
+    std::string take_content() { return std::move(content_); }
+
+private:
+    size_t ready_size() const;
+
+    StopSequenceMatcher matcher_;
+    StructureTracker tracker_;
+    bool track_structure_;
+    std::string content_;
+    std::string stop_reason_;
+    size_t streamed_ = 0;
+    bool finished_ = false;
+};
+
+}  // namespace dam::llm
@@ -55,6 +55,7 @@ struct EmbedderConfig {
  * Implementations:
  * - LlamaCppEmbedder: Uses llama.cpp with dedicated embedding model
  * - OllamaEmbedder: Uses Ollama's /api/embeddings endpoint
+ * - BuiltinEmbedder: Hashed lexical features, no model needed
  */
 class Embedder {
 public:
@@ -234,6 +235,47 @@ private:
     bool initialized_ = false;
 };
 
+// ============================================================================
+// Builtin Embedder
+// ============================================================================
+
+/**
+ * BuiltinEmbedder - Model-free embeddings computed on the CPU.
+ *
+ * Hashes features of the text (identifiers and their camelCase and
+ * snake_case parts, adjacent identifier pairs, character trigrams and
+ * operator runs) into signed buckets, then projects the bucket counts
+ * through a random +/-1 matrix. Its entries are hashed from the bucket
+ * and dimension as they are used, so nothing is stored per instance.
+ * Snippets sharing vocabulary and spelling land close together; it has
+ * no notion of meaning beyond that, but needs no model file or service
+ * and embeds thousands of snippets per second.
+ *
+ * config.dimension defaults to 256.
+ */
+class BuiltinEmbedder : public Embedder {
+public:
+    explicit BuiltinEmbedder(EmbedderConfig config = {});
+
+    int dimension() const override { return dimension_; }
+    std::string model_name() const override;
+    bool is_available() const override { return true; }
+
+    Result<Embedding> embed(const std::string& text) override;
+    Result<std::vector<Embedding>> embed_batch(
+        const std::vector<std::string>& texts,
+        EmbedProgressCallback callback = nullptr) override;
+
+    /**
+     * Create with config.
+     */
+    static Result<EmbedderPtr> create(EmbedderConfig config = {});
+
+private:
+    EmbedderConfig config_;
+    int dimension_;
+};
+
 // ============================================================================
 // Embedder Factory
 // ============================================================================
@@ -244,15 +286,17 @@ public:
      * Create the best available embedder from environment.
      *
      * Priority:
+     * 0. The type named by DAM_EMBEDDER, if set
      * 1. LlamaCpp if DAM_EMBEDDING_MODEL_PATH is set
      * 2. Ollama if running
+     * 3. Builtin
      */
     static Result<EmbedderPtr> create_from_env();
 
     /**
      * Create embedder by type name.
      *
-     * @param type "llamacpp" or "ollama"
+     * @param type "llamacpp", "ollama" or "builtin"
      */
     static Result<EmbedderPtr> create(const std::string& type);
 };
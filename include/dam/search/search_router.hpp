@@ -9,6 +9,7 @@
 #include <dam/search/vector_index.hpp>
 
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -296,32 +297,55 @@ public:
     PageId get_inverted_root_page_id() const;
     PageId get_trigram_root_page_id() const;
 
+    /**
+     * Account the router's memory (vector index, embedding cache, query
+     * arenas) against a shared budget. Call after initialize(); pass
+     * nullptr to detach.
+     */
+    void attach_memory_governor(MemoryGovernor* governor);
+
 private:
     // Detect query type from content
     SearchMode detect_search_mode(const SearchQuery& query) const;
 
-    // Individual search methods returning unified results
-    std::vector<UnifiedSearchResult> do_keyword_search(
-        const SearchQuery& query) const;
+    // Query-scoped candidate. Lives in the thread's QueryArena until the
+    // final top-k results are materialized as UnifiedSearchResult.
+    struct Candidate {
+        explicit Candidate(std::pmr::memory_resource* mr)
+            : positions(mr), matched_text(mr) {}
+
+        SnippetId doc_id = 0;
+        float keyword_score = 0.0f;
+        float fuzzy_score = 0.0f;
+        float semantic_score = 0.0f;
+        float final_score = 0.0f;
+        std::pmr::vector<uint32_t> positions;
+        std::pmr::string matched_text;
+    };
+    using CandidateList = std::pmr::vector<Candidate>;
+
+    // Individual search methods returning query-scoped candidates
+    CandidateList do_keyword_search(const SearchQuery& query,
+                                    std::pmr::memory_resource* mr) const;
 
-    std::vector<UnifiedSearchResult> do_fuzzy_search(
-        const SearchQuery& query) const;
+    CandidateList do_fuzzy_search(const SearchQuery& query,
+                                  std::pmr::memory_resource* mr) const;
 
-    std::vector<UnifiedSearchResult> do_substring_search(
-        const SearchQuery& query) const;
+    CandidateList do_substring_search(const SearchQuery& query,
+                                      std::pmr::memory_resource* mr) const;
 
-    std::vector<UnifiedSearchResult> do_semantic_search(
-        const SearchQuery& query) const;
+    CandidateList do_semantic_search(const SearchQuery& query,
+                                     std::pmr::memory_resource* mr) const;
 
     // Merge results from different indexes
-    std::vector<UnifiedSearchResult> merge_results(
-        std::vector<UnifiedSearchResult>& keyword_results,
-        std::vector<UnifiedSearchResult>& fuzzy_results,
-        std::vector<UnifiedSearchResult>& semantic_results,
-        const SearchQuery& query) const;
+    CandidateList merge_results(CandidateList& keyword_results,
+                                CandidateList& fuzzy_results,
+                                CandidateList& semantic_results,
+                                const SearchQuery& query,
+                                std::pmr::memory_resource* mr) const;
 
     // Normalize scores to 0-1 range
-    void normalize_scores(std::vector<UnifiedSearchResult>& results) const;
+    void normalize_scores(CandidateList& results) const;
 
     BufferPool* buffer_pool_;
     SearchRouterConfig config_;
@@ -330,6 +354,7 @@ private:
     std::unique_ptr<TrigramIndex> trigram_;
     std::unique_ptr<VectorIndexWithEmbedder> vector_;
 
+    MemoryGovernor* governor_ = nullptr;
     bool initialized_ = false;
 };
 
@@ -341,6 +366,7 @@ class SearchRouterFactory {
 public:
     /**
      * Create search router with all available indexes from environment.
+     * The router's memory shares the buffer pool's governor, if any.
      */
     static Result<std::unique_ptr<SearchRouter>> create_from_env(
         BufferPool* buffer_pool,
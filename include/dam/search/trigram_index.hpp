@@ -5,6 +5,7 @@
 #include <dam/storage/btree.hpp>
 
 #include <map>
+#include <memory_resource>
 #include <set>
 #include <string>
 #include <vector>
@@ -233,6 +234,10 @@ private:
     // Get documents for a trigram
     std::set<FileId> get_documents_for_trigram(const std::string& trigram) const;
 
+    // Decode a trigram's documents into a sorted, query-scoped vector
+    void read_documents_for_trigram(const std::string& trigram,
+                                    std::pmr::vector<FileId>& out) const;
+
     // Add document to trigram posting list
     Result<void> add_to_trigram(const std::string& trigram, FileId doc_id);
 
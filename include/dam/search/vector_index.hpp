@@ -3,9 +3,14 @@
 #include <dam/core_types.hpp>
 #include <dam/result.hpp>
 #include <dam/search/embedder.hpp>
+#include <dam/util/memory_governor.hpp>
 
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace dam::search {
@@ -64,8 +69,11 @@ struct VectorIndexConfig {
  * - Batch insertion with parallelization
  * - Save/load to disk
  * - Support for multiple distance metrics
+ *
+ * Reports its preallocated graph to a MemoryGovernor. It is not
+ * reclaimable: hnswlib cannot resize while searches may be running.
  */
-class VectorIndex {
+class VectorIndex : public MemoryConsumer {
 public:
     /**
      * Create a vector index with configuration.
@@ -74,7 +82,7 @@ public:
      */
     explicit VectorIndex(VectorIndexConfig config = {});
 
-    ~VectorIndex();
+    ~VectorIndex() override;
 
     // Non-copyable
     VectorIndex(const VectorIndex&) = delete;
@@ -246,6 +254,10 @@ public:
      */
     const VectorIndexConfig& config() const { return config_; }
 
+    // MemoryConsumer
+    std::string consumer_name() const override { return "vector_index"; }
+    size_t memory_usage() const override;
+
     // ========================================================================
     // Factory
     // ========================================================================
@@ -276,11 +288,22 @@ private:
 /**
  * VectorIndexWithEmbedder - Convenience wrapper that combines
  * VectorIndex with Embedder for end-to-end text search.
+ *
+ * Embeddings of recently indexed texts are kept by content hash, so
+ * documents with identical bodies are embedded once. The cache reports to
+ * a MemoryGovernor: it only grows when the budget allows and gives up its
+ * oldest entries when reclaimed.
  */
-class VectorIndexWithEmbedder {
+class VectorIndexWithEmbedder : public MemoryConsumer {
 public:
+    static constexpr size_t MAX_CACHED_EMBEDDINGS = 1024;
+
     VectorIndexWithEmbedder(std::unique_ptr<VectorIndex> index,
                             std::unique_ptr<Embedder> embedder);
+    ~VectorIndexWithEmbedder() override;
+
+    VectorIndexWithEmbedder(const VectorIndexWithEmbedder&) = delete;
+    VectorIndexWithEmbedder& operator=(const VectorIndexWithEmbedder&) = delete;
 
     /**
      * Index a text document.
@@ -318,6 +341,17 @@ public:
     Embedder* embedder() { return embedder_.get(); }
     const Embedder* embedder() const { return embedder_.get(); }
 
+    /**
+     * Account the embedding cache against a shared budget. Registers
+     * this object with the governor; pass nullptr to detach.
+     */
+    void attach_memory_governor(MemoryGovernor* governor);
+
+    // MemoryConsumer (the embedding cache)
+    std::string consumer_name() const override { return "embedding_cache"; }
+    size_t memory_usage() const override { return cache_bytes_.load(); }
+    size_t reclaim(size_t bytes) override;
+
     /**
      * Create from environment.
      */
@@ -325,8 +359,22 @@ public:
         VectorIndexConfig config = {});
 
 private:
+    // Look up / remember the embedding of a text by its content hash
+    bool cached_embedding(const std::string& hash, Embedding* embedding) const;
+    void cache_embedding(const std::string& hash, const Embedding& embedding);
+
+    // Drop the oldest cache entry; returns its size. cache_mutex_ held.
+    size_t evict_oldest_locked();
+
     std::unique_ptr<VectorIndex> index_;
     std::unique_ptr<Embedder> embedder_;
+
+    // The governor may reclaim from another thread while texts are indexed
+    mutable std::mutex cache_mutex_;
+    std::unordered_map<std::string, Embedding> embedding_cache_;
+    std::deque<std::string> cache_order_;  // Oldest first
+    std::atomic<size_t> cache_bytes_{0};
+    MemoryGovernor* governor_ = nullptr;
 };
 
 }  // namespace dam::search
@@ -3,31 +3,79 @@
 #include <dam/types.hpp>
 #include <dam/storage/btree.hpp>
 #include <dam/storage/buffer_pool.hpp>
+#include <dam/util/compression.hpp>
 
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 
 namespace dam {
 
+/**
+ * Content compression settings for records written by a SnippetIndex.
+ */
+struct CompressionOptions {
+    bool enabled = true;
+    size_t min_size = 128;  // Smaller bodies are stored raw
+};
+
+/**
+ * Content deduplication settings for records written by a SnippetIndex.
+ */
+struct DeduplicationOptions {
+    bool enabled = true;
+    size_t min_size = 256;  // Smaller bodies are stored inline
+};
+
 /**
  * SnippetIndex - Maps snippet IDs to metadata using B+ trees.
  *
- * Maintains two indexes:
+ * Maintains five trees:
  * - Primary: SnippetId -> SnippetMetadata (serialized)
  * - Secondary: name -> SnippetId
+ * - Dictionaries: dictionary ID -> (language, compression dictionary)
+ * - Bodies: SHA-256 of content -> (refcount, CRC32, encoded content)
+ * - History: (SnippetId, revision) -> earlier content
+ *
+ * Snippet bodies at or above CompressionOptions::min_size are stored
+ * LZ4-compressed, against the language's trained dictionary when there
+ * is one. Each record ends with a format byte and its codec, followed
+ * for compressed bodies by the dictionary ID and uncompressed size, so
+ * records written before a dictionary was (re)trained stay readable.
+ * Records from before compression end at their tags and are read raw.
+ *
+ * Bodies at or above DeduplicationOptions::min_size are stored once in
+ * the body tree and referenced by hash from each record that has them.
+ *
+ * When an update changes a snippet's content, the replaced version is
+ * kept in the history tree as a reverse delta against its successor, or
+ * whole every HISTORY_KEYFRAME_INTERVAL revisions to bound the number of
+ * deltas applied on reconstruction. The current version stays in the
+ * primary record, so reading it costs nothing extra.
  */
 class SnippetIndex {
 public:
+    static constexpr uint32_t HISTORY_KEYFRAME_INTERVAL = 16;
+
     /**
      * Create a snippet index backed by B+ trees.
      *
      * @param buffer_pool The buffer pool for page management
      * @param primary_root Primary index root page ID
      * @param name_root Name index root page ID
+     * @param dict_root Dictionary tree root page ID
+     * @param body_root Body tree root page ID
+     * @param history_root History tree root page ID
      */
     SnippetIndex(BufferPool* buffer_pool,
                  PageId primary_root = INVALID_PAGE_ID,
-                 PageId name_root = INVALID_PAGE_ID);
+                 PageId name_root = INVALID_PAGE_ID,
+                 PageId dict_root = INVALID_PAGE_ID,
+                 PageId body_root = INVALID_PAGE_ID,
+                 PageId history_root = INVALID_PAGE_ID);
 
     /**
      * Insert a new snippet.
@@ -63,6 +111,58 @@ public:
      */
     std::optional<SnippetMetadata> get(SnippetId id) const;
 
+    /**
+     * Get a snippet by ID, optionally without decoding its body.
+     *
+     * @param id The snippet ID
+     * @param with_content Decode the body (false leaves content empty)
+     * @param content_size Receives the body size in bytes (may be null)
+     * @return The snippet if found
+     */
+    std::optional<SnippetMetadata> get(SnippetId id, bool with_content,
+                                       size_t* content_size = nullptr) const;
+
+    /**
+     * Check if a snippet exists, without decoding it.
+     */
+    bool contains(SnippetId id) const;
+
+    /**
+     * Add and remove tags on many snippets in one pass, in key order.
+     *
+     * Records are patched in place: the encoded body is copied through
+     * without being decoded, and no revision is recorded. A tag in both
+     * lists ends up added.
+     *
+     * @param ids Snippets to patch (missing ones are skipped)
+     * @param add_tags Tags to add
+     * @param remove_tags Tags to remove
+     * @param modified_at New modification time of changed snippets
+     * @return IDs of the snippets whose tags changed, ascending
+     */
+    std::vector<SnippetId> patch_tags(const std::vector<SnippetId>& ids,
+                                      const std::vector<std::string>& add_tags,
+                                      const std::vector<std::string>& remove_tags,
+                                      std::chrono::system_clock::time_point modified_at);
+
+    /**
+     * Get a snippet as of an earlier revision.
+     * The current revision is the same as get().
+     *
+     * @param id The snippet ID
+     * @param revision Revision number (1 = original content)
+     * @return The snippet with that revision's content and modification time
+     */
+    std::optional<SnippetMetadata> get_revision(SnippetId id, uint32_t revision) const;
+
+    /**
+     * List a snippet's revisions, oldest first, ending with the current one.
+     *
+     * @param id The snippet ID
+     * @return The revisions (empty if the snippet doesn't exist)
+     */
+    std::vector<SnippetRevision> get_revisions(SnippetId id) const;
+
     /**
      * Find a snippet by name.
      *
@@ -71,6 +171,11 @@ public:
      */
     std::optional<SnippetId> find_by_name(const std::string& name) const;
 
+    /**
+     * Get every snippet name, in sorted order, without decoding records.
+     */
+    std::vector<std::string> names() const;
+
     /**
      * Get all snippets.
      *
@@ -78,6 +183,59 @@ public:
      */
     std::vector<SnippetMetadata> get_all() const;
 
+    /**
+     * Get all snippets matching a predicate.
+     * Deserialization and filtering run in parallel across the index;
+     * the predicate must be safe to call concurrently.
+     *
+     * @param predicate Returns true for snippets to keep
+     * @return Matching snippets in ID order
+     */
+    std::vector<SnippetMetadata> filter(
+        const std::function<bool(const SnippetMetadata&)>& predicate) const;
+
+    /**
+     * Iterate over the primary records in ID order, without decoding them.
+     *
+     * @return Iterator over (key, record) pairs; decode with decode_record()
+     */
+    BPlusTreeIterator records() const { return primary_tree_.seek(""); }
+
+    /**
+     * Decode a record from records().
+     *
+     * @param record The stored record
+     * @param with_content Decode the body (false leaves content empty and
+     *                     skips decompression)
+     * @param content_size Receives the body size in bytes (may be null)
+     * @return The snippet (id is INVALID_SNIPPET_ID if the record is corrupt)
+     */
+    SnippetMetadata decode_record(const std::string& record, bool with_content,
+                                  size_t* content_size = nullptr) const {
+        return deserialize(record, nullptr, with_content, content_size);
+    }
+
+    /**
+     * Fold every snippet into a result on parallel workers.
+     *
+     * @param accumulate Called as accumulate(T&, SnippetMetadata&&)
+     *                   concurrently on worker-private partials
+     * @param reduce Called as reduce(T& into, T&& from) in ID order
+     * @return The reduced result
+     */
+    template <typename T, typename Accumulate, typename Reduce>
+    T parallel_scan(Accumulate accumulate, Reduce reduce) const {
+        return primary_tree_.parallel_scan<T>(
+            [this, &accumulate](T& partial, const std::string&, const std::string& value) {
+                SnippetMetadata snippet = deserialize(value);
+                // Skip corrupted entries with invalid IDs
+                if (snippet.id != INVALID_SNIPPET_ID) {
+                    accumulate(partial, std::move(snippet));
+                }
+            },
+            reduce);
+    }
+
     /**
      * Get the number of snippets.
      */
@@ -88,6 +246,46 @@ public:
      */
     PageId get_primary_root_id() const { return primary_tree_.get_root_page_id(); }
     PageId get_name_root_id() const { return name_tree_.get_root_page_id(); }
+    PageId get_dict_root_id() const { return dict_tree_.get_root_page_id(); }
+    PageId get_body_root_id() const { return body_tree_.get_root_page_id(); }
+    PageId get_history_root_id() const { return history_tree_.get_root_page_id(); }
+
+    /**
+     * Set compression for records written from now on.
+     */
+    void set_compression(const CompressionOptions& options) { compression_ = options; }
+    const CompressionOptions& compression() const { return compression_; }
+
+    /**
+     * Set deduplication for records written from now on.
+     */
+    void set_deduplication(const DeduplicationOptions& options) { dedup_ = options; }
+    const DeduplicationOptions& deduplication() const { return dedup_; }
+
+    /**
+     * Get the number of records sharing a stored body.
+     *
+     * @param content The body
+     * @return Reference count (0 if the body is not stored in the body tree)
+     */
+    uint32_t body_references(const std::string& content) const;
+
+    /**
+     * Train a compression dictionary for a language from its snippets and
+     * rewrite that language's records against it.
+     *
+     * @param language The language to train for
+     * @param max_samples Maximum snippets to sample
+     * @return Dictionary size in bytes (0 if too little recurring content)
+     */
+    size_t train_dictionary(const std::string& language, size_t max_samples = 256);
+
+    /**
+     * Check if a language has a trained dictionary.
+     */
+    bool has_dictionary(const std::string& language) const {
+        return dictionary_set()->latest.count(language) > 0;
+    }
 
     /**
      * Get/set next ID for persistence.
@@ -101,19 +299,78 @@ public:
     void set_count(size_t count) { count_ = count; }
 
 private:
-    // Serialize SnippetMetadata to string
-    static std::string serialize(const SnippetMetadata& snippet);
+    // Serialize SnippetMetadata to string (compressing the content, or
+    // referencing body_key in the body tree when it is non-empty)
+    std::string serialize(const SnippetMetadata& snippet,
+                          const std::string& body_key = "") const;
+
+    // Deserialize string to SnippetMetadata (body_key receives the
+    // referenced body's key, or is cleared for inline content).
+    // Without with_content the body is left undecoded and content empty.
+    SnippetMetadata deserialize(const std::string& data,
+                                std::string* body_key = nullptr,
+                                bool with_content = true,
+                                size_t* content_size = nullptr) const;
 
-    // Deserialize string to SnippetMetadata
-    static SnippetMetadata deserialize(const std::string& data);
+    // Compress content against the language's dictionary if that wins
+    Codec encode_body(const std::string& content, const std::string& language,
+                      uint32_t* dict_id, std::string* encoded) const;
+
+    // Reverse encode_body()
+    bool decode_body(uint8_t codec, uint32_t dict_id, uint32_t raw_size,
+                     const std::string& encoded, std::string* content) const;
+
+    // Add a reference to the snippet's body, storing it on first use.
+    // Returns the body key, or empty if the body is stored inline.
+    std::string acquire_body(const SnippetMetadata& snippet);
+
+    // Drop a reference; the body is deleted with its last reference
+    void release_body(const std::string& body_key);
+
+    // Re-encode a stored body against the language's current dictionary
+    void reencode_body(const std::string& body_key, const SnippetMetadata& snippet);
+
+    // Keys of a snippet's history entries, oldest first
+    std::vector<std::string> history_keys(SnippetId id) const;
+
+    // Store the version an update replaced as the given revision
+    void record_revision(const SnippetMetadata& replaced, uint32_t revision,
+                         const std::string& successor_content);
 
     // Generate next snippet ID
     SnippetId generate_id();
 
+    // Load persisted dictionaries into memory
+    void load_dictionaries();
+
+    // Trained dictionaries. A set is never modified once published;
+    // train_dictionary() swaps in a new one.
+    struct DictionarySet {
+        std::map<uint32_t, std::string> by_id;
+        std::map<std::string, uint32_t> latest;  // per language
+    };
+
+    // The current set, kept alive for as long as the caller holds it
+    std::shared_ptr<const DictionarySet> dictionary_set() const {
+        return std::atomic_load(&dictionaries_);
+    }
+
     BPlusTree primary_tree_;  // id -> metadata
     BPlusTree name_tree_;     // name -> id
+    BPlusTree dict_tree_;     // dictionary id -> (language, dictionary)
+    BPlusTree body_tree_;     // content hash -> (refcount, crc, body)
+    BPlusTree history_tree_;  // "id:revision" -> earlier content
     SnippetId next_id_;
     size_t count_ = 0;
+
+    // Compression state. Parallel scans read the dictionaries while
+    // train_dictionary() replaces them, so they are only accessed through
+    // dictionary_set() and swapped with std::atomic_store.
+    CompressionOptions compression_;
+    DeduplicationOptions dedup_;
+    std::shared_ptr<const DictionarySet> dictionaries_;
+    uint32_t next_dict_id_ = 1;
+    size_t max_dict_size_;
 };
 
 }  // namespace dam
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <dam/types.hpp>
+#include <dam/result.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dam {
+
+namespace search {
+class Embedder;
+}
+
+/**
+ * Options for writing a snippet pack.
+ */
+struct PackOptions {
+    bool compress = true;                  // LZ4-compress bodies that shrink
+    search::Embedder* embedder = nullptr;  // Adds a vector section when set
+};
+
+/**
+ * Outcome of writing a snippet pack.
+ */
+struct PackStats {
+    size_t snippets = 0;
+    uint64_t bytes = 0;
+    size_t terms = 0;
+    size_t trigrams = 0;
+    int vector_dimension = 0;  // 0 = no vector section
+};
+
+/**
+ * SnippetPack - Immutable, memory-mapped snippet collection.
+ *
+ * A pack is a single file holding everything needed to serve its
+ * snippets without building an index on import:
+ *
+ *   [header][offset table][records][strings][bodies][tags][terms][trigrams][vectors]
+ *
+ * Records are fixed-size and sorted by name, so a name lookup is a binary
+ * search. Bodies are LZ4 blocks. Tags, code terms and lowercase trigrams
+ * (of name, content and tags) are posting tables: sorted keys, each with
+ * a sorted array of record ordinals. Sections are 8-byte aligned and read
+ * in place from the mapping, so opening a pack only validates the header
+ * and offset table.
+ *
+ * Snippets are addressed by ordinal (position in name order).
+ */
+class SnippetPack {
+public:
+    /**
+     * Write a pack file.
+     *
+     * @param path Output file (replaced atomically)
+     * @param snippets Snippets to pack (names should be unique)
+     * @param options Pack options
+     * @return Statistics, or error
+     */
+    static Result<PackStats> write(const fs::path& path,
+                                   const std::vector<SnippetMetadata>& snippets,
+                                   const PackOptions& options = {});
+
+    /**
+     * Map a pack file read-only.
+     *
+     * @param path Pack file
+     * @return The opened pack, or error
+     */
+    static Result<std::unique_ptr<SnippetPack>> open(const fs::path& path);
+
+    ~SnippetPack();
+
+    SnippetPack(const SnippetPack&) = delete;
+    SnippetPack& operator=(const SnippetPack&) = delete;
+
+    /**
+     * Number of snippets.
+     */
+    size_t size() const { return count_; }
+
+    const fs::path& path() const { return path_; }
+
+    /**
+     * Decode a snippet (decompresses its body).
+     *
+     * @param ordinal Position in name order
+     * @return The snippet (id left as INVALID_SNIPPET_ID), or error
+     */
+    Result<SnippetMetadata> get(size_t ordinal) const;
+
+    /**
+     * Body of a snippet in place in the mapping, without copying it.
+     *
+     * @param ordinal Position in name order
+     * @return The body, or nullopt if it is stored compressed (use get())
+     */
+    std::optional<std::string_view> stored_body(size_t ordinal) const;
+
+    /**
+     * CRC32 of a snippet's content.
+     */
+    uint32_t checksum(size_t ordinal) const;
+
+    /**
+     * Name of a snippet, without decoding it.
+     */
+    std::string_view name(size_t ordinal) const;
+
+    /**
+     * Language of a snippet, without decoding it.
+     */
+    std::string_view language(size_t ordinal) const;
+
+    /**
+     * Find a snippet by exact name.
+     */
+    std::optional<size_t> find(std::string_view name) const;
+
+    /**
+     * Snippets carrying a tag.
+     */
+    std::vector<size_t> find_by_tag(std::string_view tag) const;
+
+    /**
+     * Every tag with its snippet count, in sorted order.
+     */
+    std::vector<std::pair<std::string, size_t>> tag_counts() const;
+
+    /**
+     * Snippets containing every code term of a query (same tokenization
+     * as InvertedIndex::index_code).
+     */
+    std::vector<size_t> search_terms(const std::string& query) const;
+
+    /**
+     * Snippets that may contain a substring (case-insensitive) in their
+     * name, content or tags: those holding all of its trigrams.
+     *
+     * @return Candidates, or nullopt if the pattern is too short to filter
+     */
+    std::optional<std::vector<size_t>> substring_candidates(const std::string& pattern) const;
+
+    /**
+     * Dimension of the stored embeddings (0 = none).
+     */
+    int vector_dimension() const { return static_cast<int>(vector_dim_); }
+
+    /**
+     * Embedding of a snippet (vector_dimension() floats), or nullptr.
+     */
+    const float* vector(size_t ordinal) const;
+
+private:
+    struct Record;
+    struct PostingTable;
+
+    SnippetPack() = default;
+
+    Result<void> load();
+    std::string_view string_at(uint32_t offset, uint32_t length) const;
+    const PostingTable* table(uint32_t section) const;
+
+    fs::path path_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buffer_;  // File contents when mmap is unavailable
+
+    size_t count_ = 0;
+    uint32_t vector_dim_ = 0;
+    const Record* records_ = nullptr;
+    std::string_view strings_;
+    std::string_view bodies_;
+    const float* vectors_ = nullptr;
+    std::vector<PostingTable> tables_;
+};
+
+}  // namespace dam
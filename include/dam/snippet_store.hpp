@@ -1,16 +1,24 @@
 #pragma once
 
 #include <dam/types.hpp>
+#include <dam/completion_index.hpp>
 #include <dam/snippet_index.hpp>
 #include <dam/language_detector.hpp>
 #include <dam/result.hpp>
+#include <dam/snippet_pack.hpp>
+#include <dam/store_backup.hpp>
 #include <dam/storage/buffer_pool.hpp>
 #include <dam/storage/disk_manager.hpp>
+#include <dam/index/similarity_index.hpp>
 #include <dam/index/tag_index.hpp>
 
+#include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace dam {
@@ -22,6 +30,101 @@ struct SearchResult {
     std::string matched_text;
 };
 
+/**
+ * Chooses snippets for bulk operations. The set criteria are ANDed;
+ * an empty selector matches nothing.
+ */
+struct SnippetSelector {
+    std::vector<SnippetId> ids;       // One of these IDs
+    std::vector<std::string> tags;    // Every one of these tags
+    std::string language;             // This language
+    std::string text;                 // Case-insensitive substring of name, content or tags
+
+    bool empty() const {
+        return ids.empty() && tags.empty() && language.empty() && text.empty();
+    }
+
+    /**
+     * Parse a query of tag:<tag>, lang:<language> and id:<id> terms;
+     * the other words, joined by spaces, form the text.
+     *
+     * @param query The query
+     * @return The selector, or error for a malformed id: term
+     */
+    static Result<SnippetSelector> parse(const std::string& query);
+};
+
+/**
+ * Criteria and paging for SnippetStore::scan(). The set criteria are ANDed.
+ */
+struct ScanOptions {
+    std::string tag;            // Only snippets with this tag ("" = any)
+    std::string language;       // Only snippets in this language ("" = any)
+    bool with_content = true;   // false leaves content empty and skips decompression
+    size_t offset = 0;          // Matching snippets to skip
+    size_t limit = 0;           // Maximum snippets to return (0 = no limit)
+};
+
+class SnippetStore;
+
+/**
+ * SnippetCursor - Lazily decodes the snippets chosen by SnippetStore::scan().
+ *
+ * Store snippets come first, in ID order, then each mounted pack's in
+ * name order. Only the current snippet is held in memory. Without a
+ * language filter the offset is skipped by counting B+ tree leaves rather
+ * than decoding records; with one, skipped records are checked without
+ * decoding their bodies.
+ *
+ * The store must stay open and unmodified while the cursor is in use.
+ */
+class SnippetCursor {
+public:
+    /**
+     * Move to the next snippet.
+     *
+     * @return false once the scan is exhausted
+     */
+    bool next();
+
+    /**
+     * The current snippet (valid after next() returned true).
+     */
+    const SnippetMetadata& snippet() const { return current_; }
+
+    /**
+     * Size of the current snippet's body, also known without its content.
+     */
+    size_t content_size() const { return content_size_; }
+
+private:
+    friend class SnippetStore;
+
+    SnippetCursor(const SnippetStore* store, ScanOptions options);
+
+    bool next_stored();
+    bool next_packed();
+    std::optional<SnippetMetadata> read_stored(bool with_content);
+
+    const SnippetStore* store_;
+    ScanOptions options_;
+    size_t skip_;
+    size_t returned_ = 0;
+
+    bool by_tag_;
+    std::vector<SnippetId> tagged_;  // Tag scans walk the tag's ID set
+    size_t tagged_pos_ = 0;
+    BPlusTreeIterator records_;      // Other scans walk the primary tree
+
+    size_t pack_ = 0;
+    bool pack_loaded_ = false;
+    std::vector<size_t> pack_ordinals_;
+    size_t pack_pos_ = 0;
+
+    SnippetMetadata current_;
+    size_t content_size_ = 0;
+};
+
 /**
  * SnippetStore - Main API for the Developer Asset Manager.
  *
@@ -76,6 +179,44 @@ public:
      */
     Result<SnippetMetadata> get(SnippetId id) const;
 
+    /**
+     * Receives a snippet's content chunk by chunk; returns false to stop.
+     */
+    using ContentSink = std::function<bool(std::string_view chunk)>;
+
+    /**
+     * Stream a snippet's content, verifying its checksum as it goes.
+     *
+     * Uncompressed pack bodies are passed straight from the mapping; other
+     * bodies are decoded once and passed from that buffer. Each chunk is
+     * checksummed just before it is handed over. A mismatch is only known
+     * after the last chunk, so the sink may already have received the
+     * content when CORRUPTION is returned.
+     *
+     * @param id The snippet ID
+     * @param sink Called with each chunk, in order
+     * @return Bytes passed to the sink, or error
+     */
+    Result<uint64_t> read_content(SnippetId id, const ContentSink& sink) const;
+
+    /**
+     * Get a snippet as of an earlier revision.
+     *
+     * @param id The snippet ID
+     * @param revision Revision number (1 = original content)
+     * @return The snippet with that revision's content, or NOT_FOUND error
+     */
+    Result<SnippetMetadata> get_revision(SnippetId id, uint32_t revision) const;
+
+    /**
+     * List a snippet's revisions, oldest first. Every update that changes
+     * the content adds one.
+     *
+     * @param id The snippet ID
+     * @return The revisions, or NOT_FOUND error
+     */
+    Result<std::vector<SnippetRevision>> get_revisions(SnippetId id) const;
+
     /**
      * Find a snippet by name.
      *
@@ -114,6 +255,21 @@ public:
                         const std::string& language,
                         const std::string& description);
 
+    /**
+     * Set a snippet's description and tags, leaving everything else alone.
+     *
+     * For metadata filled in automatically: the content, name and
+     * modification time are kept and no revision is recorded.
+     *
+     * @param id The snippet ID
+     * @param description New description
+     * @param tags New tags (replaces existing tags)
+     * @return Success or error
+     */
+    Result<void> annotate(SnippetId id,
+                          const std::string& description,
+                          const std::vector<std::string>& tags);
+
     // ========================================================================
     // Tag Operations
     // ========================================================================
@@ -136,6 +292,30 @@ public:
      */
     Result<void> remove_tag(SnippetId id, const std::string& tag);
 
+    /**
+     * Add and remove tags on every snippet a selector matches.
+     *
+     * Records are patched in one sorted pass without decoding their
+     * bodies, and each tag's ID set is rewritten once. A tag in both
+     * lists ends up added. Pack snippets are not selected.
+     *
+     * @param selector Snippets to retag
+     * @param add_tags Tags to add
+     * @param remove_tags Tags to remove
+     * @return Number of snippets whose tags changed, or error
+     */
+    Result<size_t> retag(const SnippetSelector& selector,
+                         const std::vector<std::string>& add_tags,
+                         const std::vector<std::string>& remove_tags);
+
+    /**
+     * Resolve a selector to the IDs of the store's own snippets.
+     *
+     * @param selector The selector
+     * @return Matching IDs, ascending, or error
+     */
+    Result<std::vector<SnippetId>> select(const SnippetSelector& selector) const;
+
     // ========================================================================
     // Query Operations
     // ========================================================================
@@ -147,6 +327,14 @@ public:
      */
     Result<std::vector<SnippetMetadata>> list_all() const;
 
+    /**
+     * Stream snippets matching a filter, one page of the B+ tree at a time.
+     *
+     * @param options Filter, projection and paging
+     * @return A cursor over the matching snippets, or error
+     */
+    Result<SnippetCursor> scan(const ScanOptions& options = {}) const;
+
     /**
      * Find snippets by tag.
      *
@@ -192,6 +380,109 @@ public:
     Result<std::vector<SearchResult>> search(const std::string& query,
                                               size_t max_results = 50) const;
 
+    /**
+     * Find snippets whose content is similar to a snippet's.
+     * Similarity is the MinHash estimate of trigram Jaccard similarity.
+     *
+     * @param id The snippet to compare against
+     * @param threshold Minimum similarity (0.0 - 1.0)
+     * @param max_results Maximum number of matches
+     * @return Matches, most similar first, or error
+     */
+    Result<std::vector<SimilarMatch>> find_similar(SnippetId id,
+                                                   float threshold = 0.5f,
+                                                   size_t max_results = 10) const;
+
+    /**
+     * Find all pairs of near-duplicate snippets.
+     *
+     * @param threshold Minimum similarity (0.0 - 1.0)
+     * @return Pairs, most similar first, or error
+     */
+    Result<std::vector<SimilarPair>> find_near_duplicates(float threshold = 0.9f) const;
+
+    // ========================================================================
+    // Maintenance
+    // ========================================================================
+
+    /**
+     * Train per-language compression dictionaries from the stored snippets
+     * and recompress each trained language's records.
+     *
+     * @param min_samples Languages with fewer snippets are skipped
+     * @return Number of dictionaries trained, or error
+     */
+    Result<size_t> train_compression_dictionaries(size_t min_samples = 16);
+
+    // ========================================================================
+    // Backup
+    // ========================================================================
+
+    /**
+     * Checkpoint the store and snapshot it for a backup.
+     *
+     * The returned backup's run() may be called from another thread while
+     * this store keeps serving; the store must stay open until the backup
+     * is destroyed. Only one backup can be active at a time.
+     *
+     * @param dest Backup directory
+     * @param options Backup options
+     * @return The pending backup, or error
+     */
+    Result<std::unique_ptr<StoreBackup>> begin_backup(const fs::path& dest,
+                                                      const BackupOptions& options = {});
+
+    /**
+     * Back up the store as of now (begin_backup() followed by run()).
+     */
+    Result<BackupStats> backup(const fs::path& dest, const BackupOptions& options = {});
+
+    /**
+     * Replace a closed store's files with a backup (see StoreBackup::restore).
+     */
+    static Result<void> restore(const fs::path& backup_dir, const fs::path& root_dir);
+
+    // ========================================================================
+    // Packs
+    // ========================================================================
+
+    /**
+     * Write the store's snippets to a read-only pack file.
+     *
+     * @param path Output file
+     * @param options Pack options
+     * @return Pack statistics, or error
+     */
+    Result<PackStats> export_pack(const fs::path& path, const PackOptions& options = {}) const;
+
+    /**
+     * Mount a pack read-only beside the writable store.
+     *
+     * Pack snippets are returned by get(), find_by_name() (the store's own
+     * snippets win), list_all(), the tag and language queries, search()
+     * and count(), with IDs from pack_snippet_id(). They cannot be
+     * modified. Packs in <root>/packs/ are mounted on open.
+     *
+     * @param path Pack file
+     * @return Number of snippets in the pack, or error
+     */
+    Result<size_t> mount_pack(const fs::path& path);
+
+    /**
+     * Mounted packs, in mount order.
+     */
+    const std::vector<std::unique_ptr<SnippetPack>>& packs() const { return packs_; }
+
+    /**
+     * ID of a pack snippet: the pack number (from 1) above PACK_ID_SHIFT
+     * bits, the snippet's ordinal below. Store IDs never reach it.
+     */
+    static constexpr unsigned PACK_ID_SHIFT = 40;
+    static SnippetId pack_snippet_id(size_t pack, size_t ordinal) {
+        return (static_cast<SnippetId>(pack + 1) << PACK_ID_SHIFT) | ordinal;
+    }
+    static bool is_pack_snippet(SnippetId id) { return (id >> PACK_ID_SHIFT) != 0; }
+
     // ========================================================================
     // Statistics
     // ========================================================================
@@ -211,15 +502,47 @@ public:
      */
     bool is_open() const { return is_open_; }
 
+    /**
+     * Get the memory budget shared by the store's caches.
+     * Other components (search router, embedders) may register with it.
+     * Returns nullptr when Config::memory_budget_bytes is 0.
+     */
+    MemoryGovernor* memory_governor() const { return memory_governor_.get(); }
+
+    /**
+     * Get the buffer pool (for statistics).
+     */
+    const BufferPool* buffer_pool() const { return buffer_pool_.get(); }
+
 private:
+    friend class SnippetCursor;
+
     SnippetStore() = default;
 
+    // Save metadata and flush dirty pages so the files agree on disk;
+    // rewrites the completion index if names or tags changed
+    Result<void> checkpoint();
+
+    // Write <root>/dam.complete from the current names and tags
+    Result<void> write_completion_index() const;
+
+    // Decode a pack snippet by ID
+    Result<SnippetMetadata> get_pack_snippet(SnippetId id) const;
+
+    // Append pack snippets at the given ordinals of one pack
+    void append_pack_snippets(size_t pack, const std::vector<size_t>& ordinals,
+                              std::vector<SnippetMetadata>& out) const;
+
+    std::unique_ptr<MemoryGovernor> memory_governor_;
     std::unique_ptr<DiskManager> disk_manager_;
     std::unique_ptr<BufferPool> buffer_pool_;
     std::unique_ptr<SnippetIndex> snippet_index_;
     std::unique_ptr<TagIndex> tag_index_;
+    std::unique_ptr<SimilarityIndex> similarity_index_;
+    std::vector<std::unique_ptr<SnippetPack>> packs_;
     fs::path root_dir_;
     bool is_open_ = false;
+    bool completions_stale_ = false;  // Names or tags changed since dam.complete was written
 };
 
 }  // namespace dam
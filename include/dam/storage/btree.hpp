@@ -5,14 +5,33 @@
 #include <dam/storage/page.hpp>
 #include <dam/storage/buffer_pool.hpp>
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace dam {
 
+/**
+ * KeyRange - A half-open slice [lower, upper) of a tree's key space.
+ * An empty lower bound starts at the first key; has_upper = false runs
+ * to the last key.
+ */
+struct KeyRange {
+    std::string lower;
+    std::string upper;
+    bool has_upper = false;
+
+    bool contains(const std::string& key) const {
+        return key >= lower && (!has_upper || key < upper);
+    }
+};
+
+class BPlusTreeIterator;
+
 /**
  * BPlusTree - A disk-based B+ tree implementation.
  *
@@ -116,6 +135,59 @@ public:
      */
     void for_each(const std::function<bool(const std::string&, const std::string&)>& callback) const;
 
+    /**
+     * Split the key space into at most max_ranges contiguous ranges.
+     *
+     * Boundaries are internal-node separator keys, taken from the
+     * shallowest level that yields enough of them, so ranges cover whole
+     * subtrees and hold roughly equal numbers of leaves.
+     *
+     * @param max_ranges Upper bound on the number of ranges (at least 1)
+     * @return Ranges in key order covering every key exactly once
+     */
+    std::vector<KeyRange> partition(size_t max_ranges) const;
+
+    /**
+     * Iterate over the key-value pairs in one range, in key order.
+     *
+     * @param range The range to scan
+     * @param callback Function called for each pair; return false to stop
+     */
+    void for_each_in_range(
+        const KeyRange& range,
+        const std::function<bool(const std::string&, const std::string&)>& callback) const;
+
+    /**
+     * Position an iterator at the first key not less than a key.
+     *
+     * @param key The key to seek to (empty = first key)
+     * @return Iterator, invalid if every key is smaller
+     */
+    BPlusTreeIterator seek(const std::string& key) const;
+
+    /**
+     * Scan the whole tree on several threads and combine the results.
+     *
+     * The key space is partitioned (see partition()) and each range is
+     * scanned by its own worker into a private T. Partials are then folded
+     * into the first one in key order, so a concatenating reducer yields
+     * the same order as for_each().
+     *
+     * The tree must not be modified during the scan.
+     *
+     * @param accumulate Called as accumulate(T&, key, value) on a worker
+     * @param reduce Called as reduce(T& into, T&& from) on the caller
+     * @param num_workers Worker count (0 = hardware concurrency)
+     * @return The reduced result
+     */
+    template <typename T, typename Accumulate, typename Reduce>
+    T parallel_scan(Accumulate accumulate, Reduce reduce, size_t num_workers = 0) const;
+
+    /**
+     * Default worker count for parallel scans.
+     */
+    static size_t default_scan_workers();
+
     /**
      * Get the number of keys in the tree.
      */
@@ -170,33 +242,82 @@ private:
     size_t size_;
 };
 
+template <typename T, typename Accumulate, typename Reduce>
+T BPlusTree::parallel_scan(Accumulate accumulate, Reduce reduce,
+                           size_t num_workers) const {
+    if (num_workers == 0) {
+        num_workers = default_scan_workers();
+    }
+
+    std::vector<KeyRange> ranges = partition(num_workers);
+    std::vector<T> partials(ranges.size());
+
+    auto scan_range = [&](size_t i) {
+        for_each_in_range(ranges[i], [&](const std::string& key, const std::string& value) {
+            accumulate(partials[i], key, value);
+            return true;
+        });
+    };
+
+    // The first range runs on the calling thread
+    std::vector<std::thread> workers;
+    workers.reserve(ranges.size() - 1);
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        workers.emplace_back(scan_range, i);
+    }
+    scan_range(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    T result = std::move(partials[0]);
+    for (size_t i = 1; i < partials.size(); ++i) {
+        reduce(result, std::move(partials[i]));
+    }
+    return result;
+}
+
 /**
  * BPlusTreeIterator - Iterator for range scans over a B+ tree.
  *
- * Caches the current entry to avoid use-after-free if the page
- * is evicted between iterator operations.
+ * Copies one leaf's entries at a time, so the current entry stays valid
+ * if the page is evicted between iterator operations and stepping within
+ * a leaf touches no pages. The tree must not be modified while an
+ * iterator is in use.
  */
 class BPlusTreeIterator {
 public:
     BPlusTreeIterator(BufferPool* buffer_pool, PageId leaf_id, size_t index);
 
-    bool valid() const { return leaf_id_ != INVALID_PAGE_ID && cached_valid_; }
+    bool valid() const { return index_ < entries_.size(); }
+
+    const std::pair<std::string, std::string>& operator*() const { return entries_[index_]; }
 
-    std::pair<std::string, std::string> operator*() const;
+    const std::string& key() const { return entries_[index_].first; }
+    const std::string& value() const { return entries_[index_].second; }
 
     BPlusTreeIterator& operator++();
 
+    /**
+     * Advance past up to n entries. Leaves that are skipped entirely are
+     * only counted, not copied.
+     *
+     * @return Number of entries actually skipped (less than n at the end)
+     */
+    size_t skip(size_t n);
+
     bool operator==(const BPlusTreeIterator& other) const;
     bool operator!=(const BPlusTreeIterator& other) const { return !(*this == other); }
 
 private:
-    void cache_current_entry();  // Fetch and cache current key-value
+    // Copy the entries of leaf_id_, moving on past empty leaves
+    void load_leaf();
 
     BufferPool* buffer_pool_;
     PageId leaf_id_;
+    PageId next_leaf_ = INVALID_PAGE_ID;
     size_t index_;
-    std::pair<std::string, std::string> cached_entry_;
-    bool cached_valid_ = false;
+    std::vector<std::pair<std::string, std::string>> entries_;
 };
 
 }  // namespace dam
@@ -4,8 +4,11 @@
 #include <dam/result.hpp>
 #include <dam/storage/page.hpp>
 #include <dam/storage/disk_manager.hpp>
+#include <dam/storage/frame_arena.hpp>
 #include <dam/storage/lru_replacer.hpp>
+#include <dam/util/memory_governor.hpp>
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -13,6 +16,22 @@
 
 namespace dam {
 
+/**
+ * Adaptive sizing policy for BufferPool.
+ *
+ * Every adapt_interval page accesses (at least twice the pool size) the
+ * pool looks at the hit rate and working set (frames touched) of the last
+ * window. A saturated pool that
+ * misses too often grows by grow_factor, subject to the memory governor;
+ * a pool whose working set is under half its size shrinks toward it.
+ */
+struct BufferPoolPolicy {
+    size_t min_frames = 64;
+    size_t adapt_interval = 4096;
+    double target_hit_rate = 0.95;
+    double grow_factor = 1.5;
+};
+
 /**
  * BufferPool - Manages a pool of in-memory page frames.
  *
@@ -21,18 +40,37 @@ namespace dam {
  * - Pin/unpin semantics for concurrency control
  * - LRU eviction of unpinned pages
  * - Dirty page tracking and flushing
+ *
+ * Frames live in a single contiguous FrameArena (huge-page backed for
+ * large pools); per-frame metadata is kept in a parallel cache-line
+ * aligned array indexed by frame id.
+ *
+ * The pool can be resized online within a capacity reserved at
+ * construction, and registers with a MemoryGovernor as a consumer so the
+ * governor can reclaim frames for other components.
  */
-class BufferPool {
+class BufferPool : public MemoryConsumer {
 public:
     /**
      * Create a buffer pool.
      *
      * @param pool_size Number of page frames in the pool
-     * @param disk_manager The disk manager for I/O
+     * @param disk_manager The disk manager for I/O (sets the frame size)
+     * @param max_pool_size Frames to reserve for online growth (0 = fixed)
+     */
+    BufferPool(size_t pool_size, DiskManager* disk_manager,
+               size_t max_pool_size = 0);
+
+    /**
+     * Number of frames that fit in a memory budget (at least 1).
+     *
+     * @param budget_bytes Memory budget for page frames in bytes
+     * @param page_size Bytes per frame
      */
-    BufferPool(size_t pool_size, DiskManager* disk_manager);
+    static size_t frames_for_budget(size_t budget_bytes,
+                                    size_t page_size = PAGE_SIZE);
 
-    ~BufferPool();
+    ~BufferPool() override;
 
     // Prevent copying
     BufferPool(const BufferPool&) = delete;
@@ -99,7 +137,71 @@ public:
     /**
      * Get the number of pages currently in the buffer pool.
      */
-    size_t get_pool_size() const { return pool_size_; }
+    size_t get_pool_size() const { return pool_size_.load(); }
+
+    /**
+     * Get the largest size the pool can grow to.
+     */
+    size_t get_max_pool_size() const { return frames_.capacity_frames(); }
+
+    /**
+     * Resize the pool online.
+     * Growing is limited by the reserved capacity and, if set, the memory
+     * governor. Shrinking migrates or evicts pages from released frames and
+     * stops early at the first pinned frame.
+     *
+     * @param new_pool_size Desired number of frames
+     * @return Error if the pool could not reach the requested size
+     */
+    Result<void> resize(size_t new_pool_size);
+
+    /**
+     * Enable hit-rate driven sizing.
+     *
+     * @param governor Shared memory budget (may be nullptr for no limit)
+     * @param policy Sizing policy
+     */
+    void enable_adaptive_sizing(MemoryGovernor* governor,
+                                BufferPoolPolicy policy = {});
+
+    /**
+     * The budget the pool was attached to by enable_adaptive_sizing(),
+     * for components that should share it.
+     */
+    MemoryGovernor* memory_governor() const;
+
+    /**
+     * Access counters since construction.
+     */
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t pool_size = 0;
+    };
+    Stats get_stats() const;
+
+    // MemoryConsumer
+    std::string consumer_name() const override { return "buffer_pool"; }
+    size_t memory_usage() const override {
+        return pool_size_.load() * (page_size() + sizeof(FrameInfo));
+    }
+    size_t reclaim(size_t bytes) override;
+
+    /**
+     * Get the memory used by page frames in bytes.
+     */
+    size_t get_memory_bytes() const { return frames_.active_bytes(); }
+
+    /**
+     * Get the size of each page frame in bytes.
+     */
+    size_t page_size() const { return frames_.frame_size(); }
+
+    /**
+     * Check if frames are backed by huge pages.
+     */
+    bool uses_huge_pages() const { return frames_.uses_huge_pages(); }
 
     /**
      * Get the number of free frames in the pool.
@@ -125,18 +227,30 @@ private:
     // Evict a page from a frame
     Result<void> evict_page(size_t frame_id);
 
-    struct FrameInfo {
+    // Resize helpers; caller holds mutex_
+    void grow_locked(size_t new_pool_size);
+    void shrink_locked(size_t new_pool_size);
+
+    // Record an access and run the adaptive policy when a window ends
+    void record_access_locked(size_t frame_id, bool hit);
+    void adapt_locked();
+
+    // Padded to 16 bytes: four entries per cache line, none straddling
+    struct alignas(16) FrameInfo {
         PageId page_id = INVALID_PAGE_ID;
-        bool is_dirty = false;
         uint32_t pin_count = 0;
+        bool is_dirty = false;
+        bool referenced = false;  // Touched in the current adapt window
     };
 
-    size_t pool_size_;
+    Page* frame(size_t frame_id) { return frames_.frame(frame_id); }
+
+    std::atomic<size_t> pool_size_;
     DiskManager* disk_manager_;
 
-    // Page frames
-    std::vector<std::unique_ptr<Page>> pages_;
-    std::vector<FrameInfo> frame_info_;
+    // Page frames and their metadata, both indexed by frame id
+    FrameArena frames_;
+    std::vector<FrameInfo, CacheAlignedAllocator<FrameInfo>> frame_info_;
 
     // Page table: page_id -> frame_id
     std::unordered_map<PageId, size_t> page_table_;
@@ -147,6 +261,14 @@ private:
     // LRU replacer for eviction
     LRUReplacer replacer_;
 
+    // Access statistics and adaptive sizing state
+    Stats stats_;
+    uint64_t window_accesses_ = 0;
+    uint64_t window_hits_ = 0;
+    bool adaptive_ = false;
+    BufferPoolPolicy policy_;
+    MemoryGovernor* governor_ = nullptr;
+
     mutable std::mutex mutex_;
 };
 
@@ -2,10 +2,13 @@
 
 #include <dam/core_types.hpp>
 #include <dam/result.hpp>
+#include <array>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace dam {
 
@@ -18,6 +21,10 @@ namespace fs = std::filesystem;
  * - Page-aligned I/O
  * - Page allocation and deallocation
  * - Database file management
+ *
+ * The page size is fixed per database file and recorded in its header.
+ * Files using the default PAGE_SIZE keep the original (version 1) header
+ * layout; other sizes write a version 2 header that stores the size.
  */
 class DiskManager {
 public:
@@ -25,8 +32,11 @@ public:
      * Create a DiskManager for a database file.
      *
      * @param db_path Path to the database file
+     * @param page_size Page size for a new file (power of two between
+     *                  MIN_PAGE_SIZE and MAX_PAGE_SIZE). An existing file
+     *                  keeps the size recorded in its header.
      */
-    explicit DiskManager(const fs::path& db_path);
+    explicit DiskManager(const fs::path& db_path, size_t page_size = PAGE_SIZE);
 
     // Prevent copying
     DiskManager(const DiskManager&) = delete;
@@ -38,7 +48,7 @@ public:
      * Read a page from disk into the provided buffer.
      *
      * @param page_id The page to read
-     * @param data Buffer to read into (must be PAGE_SIZE bytes)
+     * @param data Buffer to read into (must be get_page_size() bytes)
      * @return Result indicating success or failure
      */
     virtual Result<void> read_page(PageId page_id, char* data);
@@ -47,7 +57,7 @@ public:
      * Write a page from the buffer to disk.
      *
      * @param page_id The page to write
-     * @param data Buffer to write from (must be PAGE_SIZE bytes)
+     * @param data Buffer to write from (must be get_page_size() bytes)
      * @return Result indicating success or failure
      */
     virtual Result<void> write_page(PageId page_id, const char* data);
@@ -71,6 +81,11 @@ public:
      */
     PageId get_num_pages() const { return num_pages_; }
 
+    /**
+     * Get the page size of the database file in bytes.
+     */
+    virtual size_t get_page_size() const { return page_size_; }
+
     /**
      * Flush all pending writes to disk.
      */
@@ -91,10 +106,52 @@ public:
      */
     uint64_t get_file_size() const;
 
+    // ========================================================================
+    // Snapshots
+    // ========================================================================
+
+    /**
+     * Log sequence number stamped into the page_lsn of every page written.
+     * It advances at each snapshot, so a page's LSN tells which snapshot
+     * interval last changed it.
+     */
+    uint32_t get_lsn() const;
+    void set_lsn(uint32_t lsn);
+
+    /**
+     * Start a point-in-time snapshot of the file.
+     *
+     * Until end_snapshot(), the first write to a page that existed at the
+     * snapshot saves the page's old image, so read_snapshot_page() keeps
+     * returning the file as it was while writers carry on. Saved images
+     * go to a side file (<db>.snapshot), so memory use does not grow with
+     * the number of pages written during the snapshot. A write whose old
+     * image cannot be saved fails rather than change the snapshot.
+     *
+     * @return LSN of the snapshot (later writes carry a higher one), or
+     *         error if a snapshot is already active
+     */
+    Result<uint32_t> begin_snapshot();
+
+    /**
+     * Read a page as of the snapshot. Page 0 is the file header.
+     */
+    Result<void> read_snapshot_page(PageId page_id, char* data);
+
+    /**
+     * Number of pages in the snapshot, including the header page.
+     */
+    PageId get_snapshot_pages() const;
+
+    /**
+     * End the snapshot and delete the saved page images.
+     */
+    void end_snapshot();
+
 private:
     // Calculate file offset for a page
     uint64_t get_file_offset(PageId page_id) const {
-        return static_cast<uint64_t>(page_id) * PAGE_SIZE;
+        return static_cast<uint64_t>(page_id) * page_size_;
     }
 
     // Open or create the database file
@@ -106,12 +163,33 @@ private:
     // Write the file header
     Result<void> write_header();
 
+    // Assemble the header page (fixed fields, then the free list)
+    Result<void> build_header(std::vector<char>& buf) const;
+
+    // Save a page's current image for the active snapshot; caller holds mutex_
+    Result<void> preserve_page_locked(PageId page_id);
+
+    // Free list entries that fit in the header page
+    size_t free_list_capacity() const;
+
     fs::path db_path_;
     std::fstream db_file_;
+    size_t page_size_;
     PageId num_pages_;
     PageId next_page_id_;
     std::vector<PageId> free_pages_;  // List of deallocated pages
     bool is_open_;
+    uint32_t lsn_ = 1;
+
+    // Active snapshot: header image, page count, and saved page images
+    // (stored in snapshot_file_, slot by slot in the order they were saved)
+    bool snapshot_active_ = false;
+    PageId snapshot_pages_ = 0;
+    std::vector<char> snapshot_header_;
+    fs::path snapshot_path_;
+    std::fstream snapshot_file_;
+    std::unordered_map<PageId, uint32_t> snapshot_saved_;  // Page -> slot
+
     mutable std::mutex mutex_;
 };
 
@@ -120,16 +198,18 @@ private:
  */
 class InMemoryDiskManager : public DiskManager {
 public:
-    InMemoryDiskManager();
+    explicit InMemoryDiskManager(size_t page_size = PAGE_SIZE);
 
     Result<void> read_page(PageId page_id, char* data) override;
     Result<void> write_page(PageId page_id, const char* data) override;
     PageId allocate_page() override;
     void deallocate_page(PageId page_id) override;
     PageId get_num_pages() const { return static_cast<PageId>(pages_.size()); }
+    size_t get_page_size() const override { return page_size_; }
 
 private:
-    std::unordered_map<PageId, std::array<char, PAGE_SIZE>> pages_;
+    size_t page_size_;
+    std::unordered_map<PageId, std::vector<char>> pages_;
     PageId next_page_id_;
     std::vector<PageId> free_pages_;
     mutable std::mutex in_memory_mutex_;
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <dam/core_types.hpp>
+#include <dam/storage/page.hpp>
+
+#include <cstddef>
+#include <new>
+
+namespace dam {
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/**
+ * FrameArena - One contiguous, aligned allocation holding every page frame.
+ *
+ * Frames are laid out back to back, each aligned to the frame size
+ * (at least PAGE_SIZE, suitable for O_DIRECT). Arenas of at least HUGE_PAGE_SIZE are backed by 2MB pages
+ * when the platform allows it: explicit MAP_HUGETLB first, then
+ * transparent huge pages via madvise, then ordinary pages.
+ *
+ * A growable arena reserves address space for max_frames up front and
+ * only touches the active prefix, so resize() never moves live frames.
+ * Shrinking returns the released tail to the OS.
+ */
+class FrameArena {
+public:
+    /**
+     * Allocate an arena for a number of frames.
+     * Throws std::bad_alloc if the memory cannot be obtained.
+     *
+     * @param num_frames Number of frames initially active
+     * @param max_frames Frames to reserve for growth (0 = fixed size)
+     * @param frame_size Bytes per frame (the database page size)
+     */
+    explicit FrameArena(size_t num_frames, size_t max_frames = 0,
+                        size_t frame_size = PAGE_SIZE);
+
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * Get the frame at an index.
+     */
+    Page* frame(size_t index) {
+        return reinterpret_cast<Page*>(base_ + index * frame_size_);
+    }
+    const Page* frame(size_t index) const {
+        return reinterpret_cast<const Page*>(base_ + index * frame_size_);
+    }
+
+    size_t num_frames() const { return num_frames_; }
+    size_t frame_size() const { return frame_size_; }
+
+    /**
+     * Largest frame count resize() can reach.
+     */
+    size_t capacity_frames() const { return capacity_frames_; }
+
+    /**
+     * Change the number of active frames within the reserved capacity.
+     * New frames are constructed empty; released frames are returned to
+     * the OS. The caller must ensure no released frame is in use.
+     *
+     * @param num_frames New active frame count
+     * @return false if num_frames exceeds capacity_frames()
+     */
+    bool resize(size_t num_frames);
+
+    /**
+     * Bytes of the active frames.
+     */
+    size_t active_bytes() const { return num_frames_ * frame_size_; }
+
+    /**
+     * Bytes reserved for the arena (covers capacity_frames(), rounded up
+     * to a huge page boundary when mmap'd).
+     */
+    size_t mapped_bytes() const { return mapped_bytes_; }
+
+    /**
+     * True if the arena is backed by huge pages (explicit or advised).
+     */
+    bool uses_huge_pages() const { return huge_pages_; }
+
+private:
+    // Construct an empty page in a frame
+    void init_frame(size_t index);
+
+    char* base_ = nullptr;
+    size_t frame_size_;
+    size_t num_frames_;
+    size_t capacity_frames_;
+    size_t mapped_bytes_ = 0;
+    bool huge_pages_ = false;
+    bool mmapped_ = false;
+};
+
+/**
+ * Allocator that places container storage on cache-line boundaries, so
+ * per-frame metadata packs into whole lines alongside the frame arena.
+ */
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(
+            ::operator new(n * sizeof(T), std::align_val_t(CACHE_LINE_SIZE)));
+    }
+
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(CACHE_LINE_SIZE));
+    }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+}  // namespace dam
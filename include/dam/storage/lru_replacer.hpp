@@ -59,6 +59,12 @@ public:
      */
     bool empty() const { return size() == 0; }
 
+    /**
+     * Change the maximum number of tracked frames (for pool resizing).
+     * Frames already tracked are kept even if above the new capacity.
+     */
+    void set_capacity(size_t capacity);
+
     /**
      * Check if a frame is in the replacer (unpinned).
      */
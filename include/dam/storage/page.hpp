@@ -15,9 +15,10 @@ namespace dam {
  *   [4]     node_type (1 byte)
  *   [5-6]   num_keys (2 bytes)
  *   [7-10]  parent_page_id (4 bytes)
- *   [11-14] page_lsn (4 bytes) - for WAL
+ *   [11-14] page_lsn (4 bytes) - snapshot interval of the last write
  *   [15-18] checksum (4 bytes)
- *   [19-31] reserved (13 bytes)
+ *   [19]    page_size_log2 (1 byte) - 0 means the default PAGE_SIZE
+ *   [20-31] reserved (12 bytes)
  */
 struct PageHeader {
     PageId page_id;          // 4 bytes
@@ -26,7 +27,8 @@ struct PageHeader {
     uint32_t checksum;       // 4 bytes
     uint16_t num_keys;       // 2 bytes
     NodeType node_type;      // 1 byte
-    uint8_t reserved[13];    // 13 bytes = 32 total
+    uint8_t page_size_log2;  // 1 byte
+    uint8_t reserved[12];    // 12 bytes = 32 total
 
     PageHeader()
         : page_id(INVALID_PAGE_ID)
@@ -34,7 +36,8 @@ struct PageHeader {
         , page_lsn(0)
         , checksum(0)
         , num_keys(0)
-        , node_type(NodeType::UNINITIALIZED) {
+        , node_type(NodeType::UNINITIALIZED)
+        , page_size_log2(0) {
         std::memset(reserved, 0, sizeof(reserved));
     }
 };
@@ -42,11 +45,16 @@ struct PageHeader {
 static_assert(sizeof(PageHeader) == 32, "PageHeader must be 32 bytes");
 
 /**
- * Page - A 4KB page that can be stored on disk.
+ * Page - A page that can be stored on disk.
  *
  * The page contains:
  * - Header (32 bytes)
- * - Data region (4064 bytes)
+ * - Data region (page_size() - 32 bytes)
+ *
+ * The object itself covers a default PAGE_SIZE page. Larger pages live in
+ * frames of page_size() bytes (see FrameArena) and their data region
+ * extends past the end of the object; always use data_size() rather
+ * than DATA_SIZE for bounds.
  *
  * For B+ tree nodes:
  * - Internal nodes: keys + child pointers
@@ -57,6 +65,10 @@ public:
     static constexpr size_t HEADER_SIZE = sizeof(PageHeader);
     static constexpr size_t DATA_SIZE = PAGE_SIZE - HEADER_SIZE;
 
+    // num_keys is 16 bits; large pages of small entries reach it before
+    // running out of bytes
+    static constexpr size_t MAX_KEYS = UINT16_MAX;
+
     Page() : header_(), data_() {
         std::memset(data_.data(), 0, DATA_SIZE);
     }
@@ -80,9 +92,40 @@ public:
     uint32_t get_checksum() const { return header_.checksum; }
     void set_checksum(uint32_t cs) { header_.checksum = cs; }
 
+    // Page size (recorded in the header so every frame knows its extent)
+    size_t page_size() const {
+        return header_.page_size_log2 == 0
+            ? PAGE_SIZE
+            : size_t(1) << header_.page_size_log2;
+    }
+    size_t data_size() const { return page_size() - HEADER_SIZE; }
+
+    /**
+     * Set the page size and clear the page. The frame backing this
+     * object must be at least page_size bytes.
+     */
+    void format(size_t page_size) {
+        header_ = PageHeader();
+        set_page_size(page_size);
+        std::memset(get_data(), 0, data_size());
+    }
+
+    /**
+     * Stamp the page size without clearing (after reading from disk).
+     */
+    void set_page_size(size_t page_size) {
+        uint8_t log2 = 0;
+        if (page_size != PAGE_SIZE) {
+            while ((size_t(1) << log2) < page_size) ++log2;
+        }
+        header_.page_size_log2 = log2;
+    }
+
     // Data accessors
-    uint8_t* get_data() { return data_.data(); }
-    const uint8_t* get_data() const { return data_.data(); }
+    uint8_t* get_data() { return reinterpret_cast<uint8_t*>(this) + HEADER_SIZE; }
+    const uint8_t* get_data() const {
+        return reinterpret_cast<const uint8_t*>(this) + HEADER_SIZE;
+    }
 
     // Raw page accessors (for disk I/O)
     char* get_raw_data() { return reinterpret_cast<char*>(this); }
@@ -92,10 +135,9 @@ public:
     bool is_leaf() const { return header_.node_type == NodeType::LEAF; }
     bool is_internal() const { return header_.node_type == NodeType::INTERNAL; }
 
-    // Reset page to initial state
+    // Reset page to initial state (keeps the page size)
     void reset() {
-        header_ = PageHeader();
-        std::memset(data_.data(), 0, DATA_SIZE);
+        format(page_size());
     }
 
     // Compute checksum of page data
@@ -118,6 +160,9 @@ private:
 
 static_assert(sizeof(Page) == PAGE_SIZE, "Page must be exactly PAGE_SIZE bytes");
 
+// Pages above this size need 32-bit in-page offsets (see LeafPage)
+constexpr size_t WIDE_LAYOUT_THRESHOLD = 64 * 1024;
+
 /**
  * Leaf node specific layout within Page::data_:
  *
@@ -127,11 +172,21 @@ static_assert(sizeof(Page) == PAGE_SIZE, "Page must be exactly PAGE_SIZE bytes")
  * [10-11] data_offset (2 bytes) - where key-value data starts (grows from end)
  * [12+]   slot array: [offset:2, key_len:2, val_len:2] per entry
  * [...-end] key-value data (grows backward from end)
+ *
+ * Pages larger than 64KB use the wide layout, where in-page offsets and
+ * value lengths are 32-bit:
+ *
+ * [0-7]   prev/next leaf ids
+ * [8-11]  free_space_offset (4 bytes)
+ * [12-15] data_offset (4 bytes)
+ * [16+]   slot array: [offset:4, key_len:2, val_len:4] per entry
  */
 class LeafPage {
 public:
     static constexpr size_t LEAF_HEADER_SIZE = 12;
     static constexpr size_t SLOT_SIZE = 6;  // offset(2) + key_len(2) + val_len(2)
+    static constexpr size_t WIDE_LEAF_HEADER_SIZE = 16;
+    static constexpr size_t WIDE_SLOT_SIZE = 10;  // offset(4) + key_len(2) + val_len(4)
 
     explicit LeafPage(Page* page) : page_(page) {
         if (page_->get_node_type() != NodeType::LEAF) {
@@ -155,6 +210,11 @@ public:
     // Check if there's space for a new key-value pair
     bool has_space(size_t key_len, size_t val_len) const;
 
+    // Pack the key-value data against the end of the page, reclaiming the
+    // gaps left by removes and shrinking updates. Returns false if there
+    // was nothing to reclaim.
+    bool compact();
+
     // Get all key-value pairs (for iteration)
     std::vector<std::pair<std::string, std::string>> get_all() const;
 
@@ -176,20 +236,25 @@ private:
     uint8_t* data() { return page_->get_data(); }
     const uint8_t* data() const { return page_->get_data(); }
 
+    // Layout selection
+    bool wide() const { return page_->page_size() > WIDE_LAYOUT_THRESHOLD; }
+    size_t header_size() const { return wide() ? WIDE_LEAF_HEADER_SIZE : LEAF_HEADER_SIZE; }
+    size_t slot_size() const { return wide() ? WIDE_SLOT_SIZE : SLOT_SIZE; }
+
     // Slot array access
     struct Slot {
-        uint16_t offset;
+        uint32_t offset;
         uint16_t key_len;
-        uint16_t val_len;
+        uint32_t val_len;
     };
 
     Slot get_slot(size_t index) const;
     void set_slot(size_t index, const Slot& slot);
 
-    uint16_t get_free_space_offset() const;
-    void set_free_space_offset(uint16_t offset);
-    uint16_t get_data_offset() const;
-    void set_data_offset(uint16_t offset);
+    uint32_t get_free_space_offset() const;
+    void set_free_space_offset(uint32_t offset);
+    uint32_t get_data_offset() const;
+    void set_data_offset(uint32_t offset);
 
     Page* page_;
 };
@@ -202,11 +267,17 @@ private:
  * [6-7]   data_offset (2 bytes)
  * [8+]    slot array: [child_id:4, offset:2, key_len:2] per entry
  * [...-end] key data (grows backward from end)
+ *
+ * The wide layout (pages larger than 64KB) widens the offsets to 4 bytes:
+ * header [first_child:4, free_space_offset:4, data_offset:4] and slots
+ * [child_id:4, offset:4, key_len:2].
  */
 class InternalPage {
 public:
     static constexpr size_t INTERNAL_HEADER_SIZE = 8;
     static constexpr size_t SLOT_SIZE = 8;  // child_id(4) + offset(2) + key_len(2)
+    static constexpr size_t WIDE_INTERNAL_HEADER_SIZE = 12;
+    static constexpr size_t WIDE_SLOT_SIZE = 10;  // child_id(4) + offset(4) + key_len(2)
 
     explicit InternalPage(Page* page) : page_(page) {
         if (page_->get_node_type() != NodeType::INTERNAL) {
@@ -245,19 +316,26 @@ private:
     uint8_t* data() { return page_->get_data(); }
     const uint8_t* data() const { return page_->get_data(); }
 
+    // Layout selection
+    bool wide() const { return page_->page_size() > WIDE_LAYOUT_THRESHOLD; }
+    size_t header_size() const {
+        return wide() ? WIDE_INTERNAL_HEADER_SIZE : INTERNAL_HEADER_SIZE;
+    }
+    size_t slot_size() const { return wide() ? WIDE_SLOT_SIZE : SLOT_SIZE; }
+
     struct Slot {
         PageId child_id;
-        uint16_t offset;
+        uint32_t offset;
         uint16_t key_len;
     };
 
     Slot get_slot(size_t index) const;
     void set_slot(size_t index, const Slot& slot);
 
-    uint16_t get_free_space_offset() const;
-    void set_free_space_offset(uint16_t offset);
-    uint16_t get_data_offset() const;
-    void set_data_offset(uint16_t offset);
+    uint32_t get_free_space_offset() const;
+    void set_free_space_offset(uint32_t offset);
+    uint32_t get_data_offset() const;
+    void set_data_offset(uint32_t offset);
 
     Page* page_;
 };
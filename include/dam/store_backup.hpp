@@ -0,0 +1,90 @@
+#pragma once
+
+#include <dam/result.hpp>
+#include <dam/storage/disk_manager.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace dam {
+
+/**
+ * Options for a store backup.
+ */
+struct BackupOptions {
+    // Only copy pages changed since the backup already in the destination
+    // (falls back to a full copy if there is none)
+    bool incremental = false;
+};
+
+/**
+ * Outcome of a store backup.
+ */
+struct BackupStats {
+    uint64_t pages_total = 0;
+    uint64_t pages_copied = 0;
+    uint32_t lsn = 0;          // Snapshot LSN the backup reflects
+    bool incremental = false;
+};
+
+/**
+ * A point-in-time backup of an open store.
+ *
+ * Created by SnippetStore::begin_backup(), which checkpoints the store
+ * and starts a DiskManager snapshot. run() then copies the snapshot into
+ * the destination directory page by page, taking the disk manager's lock
+ * only per page, so it may run on another thread while the store keeps
+ * serving reads and writes. The store must stay open until the backup
+ * is destroyed.
+ *
+ * Destination layout:
+ *   dam.db       - page image of the database file
+ *   dam.meta     - store metadata as of the snapshot
+ *   backup.info  - snapshot LSN and page count; marks the backup complete
+ *
+ * An incremental backup copies only the pages whose page_lsn is newer
+ * than the LSN recorded in backup.info into a copy of the previous
+ * dam.db. Either kind is written to dam.db.tmp and renamed into place
+ * at the end, so a backup that fails part way leaves the previous one
+ * complete.
+ */
+class StoreBackup {
+public:
+    ~StoreBackup();
+
+    StoreBackup(const StoreBackup&) = delete;
+    StoreBackup& operator=(const StoreBackup&) = delete;
+
+    /**
+     * Copy the snapshot into the destination and end the snapshot.
+     *
+     * @return Backup statistics, or error
+     */
+    Result<BackupStats> run();
+
+    /**
+     * Move a complete backup into a store directory, replacing its files.
+     * The files are renamed rather than copied when both directories are
+     * on the same filesystem; the backup is consumed either way.
+     *
+     * @param backup_dir Directory written by run()
+     * @param root_dir Store root directory (the store must be closed)
+     * @return Success or error
+     */
+    static Result<void> restore(const fs::path& backup_dir, const fs::path& root_dir);
+
+private:
+    friend class SnippetStore;
+
+    StoreBackup(DiskManager* disk_manager, fs::path dest, std::string metadata,
+                uint32_t lsn, BackupOptions options);
+
+    DiskManager* disk_manager_;
+    fs::path dest_;
+    std::string metadata_;  // dam.meta contents as of the snapshot
+    uint32_t lsn_;
+    BackupOptions options_;
+    bool finished_ = false;
+};
+
+}  // namespace dam
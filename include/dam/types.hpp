@@ -30,12 +30,29 @@ struct SnippetMetadata {
     uint32_t checksum = 0;      // CRC32 of content
 };
 
+/**
+ * One entry of a snippet's revision history.
+ * Revisions are numbered from 1 (the original content).
+ */
+struct SnippetRevision {
+    uint32_t number = 0;
+    std::chrono::system_clock::time_point modified_at;
+    size_t size = 0;            // Content size in bytes
+};
+
 /**
  * Configuration for opening a SnippetStore.
  */
 struct Config {
     fs::path root_directory;
-    size_t buffer_pool_size = 512;
+    size_t buffer_pool_bytes = 2 * 1024 * 1024;  // Memory budget for page frames
+    size_t buffer_pool_size = 0;                 // Frame count override (0 = use budget)
+    size_t memory_budget_bytes = 256 * 1024 * 1024;  // Shared cache budget (0 = fixed pool)
+    size_t page_size = PAGE_SIZE;                // Page size for new databases (existing keep theirs)
+    bool compress_content = true;                // LZ4-compress snippet bodies
+    size_t compression_threshold = 128;          // Bodies smaller than this are stored raw
+    bool dedup_content = true;                   // Store identical bodies once
+    size_t dedup_threshold = 256;                // Bodies smaller than this are stored inline
     bool verbose = false;
 };
 
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dam {
+
+/**
+ * Codec tag stored with each compressed record.
+ */
+enum class Codec : uint8_t {
+    NONE = 0,
+    LZ4 = 1,
+};
+
+/**
+ * LZ4 - Block-format LZ4 compression with optional prefix dictionary.
+ *
+ * Produces standard LZ4 block sequences (no frame header); the caller
+ * stores the uncompressed size alongside the block. A dictionary acts as
+ * history preceding the input, so matches may reach back into it. Only
+ * the last 64KB of a dictionary is usable (LZ4 offsets are 16-bit).
+ */
+class LZ4 {
+public:
+    static constexpr size_t MAX_DICTIONARY_SIZE = 64 * 1024 - 1;
+
+    /**
+     * Compress a buffer.
+     *
+     * @param input Data to compress
+     * @param dictionary Optional shared history (same bytes on decompress)
+     * @return The compressed block
+     */
+    static std::string compress(std::string_view input,
+                                std::string_view dictionary = {});
+
+    /**
+     * Decompress a block.
+     *
+     * @param input Compressed block
+     * @param raw_size Exact uncompressed size
+     * @param output Receives the decompressed data
+     * @param dictionary The dictionary used for compression
+     * @return false if the block is malformed or the size does not match
+     */
+    static bool decompress(std::string_view input, size_t raw_size,
+                           std::string* output,
+                           std::string_view dictionary = {});
+};
+
+/**
+ * DictionaryTrainer - Builds a compression dictionary from sample records.
+ *
+ * Picks lines that recur across samples (license headers, imports,
+ * boilerplate), scored by document frequency times length. The most
+ * valuable lines are placed at the end of the dictionary, where LZ4
+ * offsets from the start of a record are shortest.
+ */
+class DictionaryTrainer {
+public:
+    /**
+     * Train a dictionary.
+     *
+     * @param samples Representative records
+     * @param max_size Dictionary size limit in bytes
+     * @return The dictionary (empty if nothing recurs)
+     */
+    static std::string train(const std::vector<std::string>& samples, size_t max_size);
+};
+
+}  // namespace dam
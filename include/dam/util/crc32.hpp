@@ -25,7 +25,7 @@ public:
 
 private:
     static void init_table();
-    static uint32_t table_[256];
+    static uint32_t table_[8][256];  // Slicing-by-8 tables
     static bool table_initialized_;
 };
 
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace dam {
+
+/**
+ * Delta - Line-oriented binary delta between two versions of a text.
+ *
+ * A delta is a sequence of operations that rebuild the target from the
+ * base: COPY(offset, length) takes bytes from the base, INSERT(bytes)
+ * adds new ones. Copies are found by matching whole lines, so edits to a
+ * few lines of a snippet cost little more than the changed lines.
+ */
+class Delta {
+public:
+    /**
+     * Compute a delta that turns base into target.
+     */
+    static std::string encode(const std::string& base, const std::string& target);
+
+    /**
+     * Apply a delta to its base.
+     *
+     * @param base The base the delta was computed against
+     * @param delta The delta
+     * @param target Receives the rebuilt target
+     * @return false if the delta is malformed or does not fit the base
+     */
+    static bool apply(const std::string& base, const std::string& delta,
+                      std::string* target);
+};
+
+}  // namespace dam
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dam {
+
+/**
+ * MemoryConsumer - A component whose memory is governed by a shared budget.
+ *
+ * memory_usage() and reclaim() may be called from any thread while the
+ * governor holds its lock, so implementations must not call back into the
+ * governor and must not block on locks held across governor calls
+ * (use try_lock and report 0 bytes reclaimed when busy).
+ */
+class MemoryConsumer {
+public:
+    virtual ~MemoryConsumer() = default;
+
+    /**
+     * Short name for reporting (e.g., "buffer_pool").
+     */
+    virtual std::string consumer_name() const = 0;
+
+    /**
+     * Current memory held, in bytes.
+     */
+    virtual size_t memory_usage() const = 0;
+
+    /**
+     * Release up to the requested number of bytes.
+     *
+     * @param bytes Amount the governor would like back
+     * @return Bytes actually released
+     */
+    virtual size_t reclaim(size_t bytes) {
+        (void)bytes;
+        return 0;
+    }
+};
+
+/**
+ * MemoryGovernor - Process-wide memory budget shared by caching components.
+ *
+ * Consumers (buffer pool, vector index, query arenas, embedding caches)
+ * register themselves and ask before growing. When a request would exceed
+ * the budget the governor reclaims from the other consumers, largest
+ * first, and grants the request only if enough was freed.
+ */
+class MemoryGovernor {
+public:
+    /**
+     * Create a governor.
+     *
+     * @param budget_bytes Total memory budget across all consumers
+     */
+    explicit MemoryGovernor(size_t budget_bytes);
+
+    MemoryGovernor(const MemoryGovernor&) = delete;
+    MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+
+    void register_consumer(MemoryConsumer* consumer);
+    void unregister_consumer(MemoryConsumer* consumer);
+
+    /**
+     * Ask to grow a consumer by a number of bytes.
+     * May reclaim memory from other consumers to make room.
+     *
+     * @param requester The consumer that wants to grow
+     * @param bytes Additional bytes requested
+     * @return true if the growth fits the budget
+     */
+    bool request(const MemoryConsumer* requester, size_t bytes);
+
+    size_t budget() const;
+    void set_budget(size_t budget_bytes);
+
+    /**
+     * Sum of memory_usage() over all consumers.
+     */
+    size_t usage() const;
+
+    /**
+     * Bytes left before the budget is reached.
+     */
+    size_t available() const;
+
+    /**
+     * Per-consumer usage snapshot.
+     */
+    struct ConsumerUsage {
+        std::string name;
+        size_t bytes = 0;
+    };
+    std::vector<ConsumerUsage> report() const;
+
+private:
+    size_t usage_locked() const;
+
+    size_t budget_;
+    std::vector<MemoryConsumer*> consumers_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace dam
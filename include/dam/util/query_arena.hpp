@@ -0,0 +1,148 @@
+#pragma once
+
+#include <dam/util/memory_governor.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+namespace dam {
+
+/**
+ * QueryArena - Per-thread monotonic memory resource for query execution.
+ *
+ * Search paths allocate many short-lived containers (posting candidates,
+ * trigram sets, merge maps). Routing them through a monotonic arena turns
+ * each allocation into a pointer bump and each query teardown into a
+ * single reset.
+ *
+ * The arena owns a backing buffer that is reused across queries. When a
+ * query overflows it, the overflow is served from the heap and the buffer
+ * is enlarged to the observed high-water mark on the next reset (up to
+ * MAX_RETAINED_SIZE), so steady-state queries do not touch the allocator.
+ *
+ * Use QueryArenaScope rather than calling reset() directly.
+ *
+ * Buffers retained by all threads are reported to a MemoryGovernor through
+ * memory_consumer(), and growing a buffer asks the attached governor first.
+ * Reclaiming trims idle arenas at once and lowers the per-thread retention
+ * limit, so arenas busy with a query trim at their next reset. The limit is
+ * lifted again once the governor has room for a query's high-water mark.
+ */
+class QueryArena {
+public:
+    static constexpr size_t INITIAL_SIZE = 64 * 1024;
+    static constexpr size_t MAX_RETAINED_SIZE = 8 * 1024 * 1024;
+
+    QueryArena();
+    ~QueryArena();
+
+    QueryArena(const QueryArena&) = delete;
+    QueryArena& operator=(const QueryArena&) = delete;
+
+    /**
+     * Get the calling thread's arena.
+     */
+    static QueryArena& for_this_thread();
+
+    /**
+     * Memory resource for query-scoped allocations.
+     */
+    std::pmr::memory_resource* resource() { return &*monotonic_; }
+
+    /**
+     * Release everything allocated since the last reset.
+     * Grows the retained buffer if the last query overflowed it.
+     */
+    void reset();
+
+    /**
+     * Size of the retained backing buffer in bytes.
+     */
+    size_t capacity() const { return buffer_.size(); }
+
+    /**
+     * Bytes served from the heap because the buffer was exhausted
+     * since the last reset.
+     */
+    size_t overflow_bytes() const { return upstream_.allocated; }
+
+    /**
+     * Governor view of the buffers retained by every thread's arena.
+     */
+    static MemoryConsumer& memory_consumer();
+
+    /**
+     * Account every thread's arena against a shared budget: registers
+     * memory_consumer() and asks the governor before a buffer grows.
+     * Pass nullptr to detach.
+     */
+    static void attach_memory_governor(MemoryGovernor* governor);
+
+    /**
+     * Detach from a governor if it is the one attached.
+     */
+    static void detach_memory_governor(MemoryGovernor* governor);
+
+    /**
+     * Shrink the buffers of arenas not running a query back to
+     * INITIAL_SIZE, until at least the requested number of bytes is freed.
+     *
+     * @return Bytes freed
+     */
+    static size_t trim_idle(size_t bytes);
+
+private:
+    friend class QueryArenaScope;
+
+    // Heap fallback that records how much the arena overflowed.
+    struct CountingResource : std::pmr::memory_resource {
+        size_t allocated = 0;
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    // Replace the backing buffer, keeping the global retained count in sync
+    void set_buffer_size(size_t size);
+
+    // Exclusive use of the buffer: the owning thread holds it for the
+    // outermost scope, trim_idle() while shrinking an idle arena
+    void acquire();
+    bool try_acquire() { return !busy_.exchange(true, std::memory_order_acquire); }
+    void release() { busy_.store(false, std::memory_order_release); }
+
+    std::vector<std::byte> buffer_;
+    CountingResource upstream_;
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic_;
+    int depth_ = 0;
+    std::atomic<bool> busy_{false};
+};
+
+/**
+ * QueryArenaScope - RAII guard delimiting one query on the thread's arena.
+ *
+ * Scopes nest: only the outermost scope resets the arena on exit, so an
+ * index search called from SearchRouter::search shares the router's arena.
+ * Nothing allocated from resource() may outlive the outermost scope.
+ */
+class QueryArenaScope {
+public:
+    QueryArenaScope();
+    ~QueryArenaScope();
+
+    QueryArenaScope(const QueryArenaScope&) = delete;
+    QueryArenaScope& operator=(const QueryArenaScope&) = delete;
+
+    std::pmr::memory_resource* resource() const { return arena_.resource(); }
+
+private:
+    QueryArena& arena_;
+};
+
+}  // namespace dam
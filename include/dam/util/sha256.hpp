@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace dam {
+
+/**
+ * SHA-256 utility functions (FIPS 180-4).
+ *
+ * Used to address snippet bodies by content.
+ */
+class SHA256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    /**
+     * Compute the SHA-256 digest of data.
+     */
+    static Digest compute(const uint8_t* data, size_t len);
+    static Digest compute(const std::string& data);
+
+    /**
+     * Compute the digest as a lowercase hex string (64 characters).
+     */
+    static std::string hex(const std::string& data);
+};
+
+}  // namespace dam
@@ -0,0 +1,262 @@
+#include <dam/completion_index.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DAM_HAS_MMAP 1
+#endif
+
+namespace dam {
+
+namespace {
+
+// Completion file structure:
+// - CompletionHeader
+// - For names, then tags, each 4-byte aligned:
+//   uint32[257]: index of the first entry whose leading byte is >= b
+//                (entry 256 = count)
+//   uint32[count + 1]: offsets of each entry in the string bytes
+//   char[]: sorted entries, concatenated
+constexpr char COMPLETION_MAGIC[8] = {'D', 'A', 'M', 'C', 'O', 'M', 'P', '\0'};
+constexpr uint32_t COMPLETION_VERSION = 1;
+constexpr size_t BUCKET_COUNT = 257;
+
+struct CompletionHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint32_t list_offset[2];
+    uint32_t list_count[2];
+    uint32_t strings_size[2];
+};
+
+void append_u32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void append_list(std::string& out, const std::vector<std::string>& entries) {
+    uint32_t buckets[BUCKET_COUNT];
+    size_t next = 0;
+    for (size_t b = 0; b < 256; ++b) {
+        while (next < entries.size() &&
+               static_cast<unsigned char>(entries[next][0]) < b) {
+            ++next;
+        }
+        buckets[b] = static_cast<uint32_t>(next);
+    }
+    buckets[256] = static_cast<uint32_t>(entries.size());
+    out.append(reinterpret_cast<const char*>(buckets), sizeof(buckets));
+
+    uint32_t offset = 0;
+    for (const auto& entry : entries) {
+        append_u32(out, offset);
+        offset += static_cast<uint32_t>(entry.size());
+    }
+    append_u32(out, offset);
+
+    for (const auto& entry : entries) {
+        out += entry;
+    }
+    while (out.size() % 4 != 0) {
+        out += '\0';
+    }
+}
+
+void sort_unique(std::vector<std::string>& entries) {
+    entries.erase(std::remove(entries.begin(), entries.end(), std::string()), entries.end());
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+}
+
+}  // namespace
+
+Result<void> CompletionIndex::write(const fs::path& path,
+                                    std::vector<std::string> names,
+                                    std::vector<std::string> tags) {
+    sort_unique(names);
+    sort_unique(tags);
+
+    CompletionHeader header{};
+    std::memcpy(header.magic, COMPLETION_MAGIC, sizeof(COMPLETION_MAGIC));
+    header.version = COMPLETION_VERSION;
+
+    std::string out(sizeof(header), '\0');
+    const std::vector<std::string>* lists[2] = {&names, &tags};
+    for (int i = 0; i < 2; ++i) {
+        header.list_offset[i] = static_cast<uint32_t>(out.size());
+        header.list_count[i] = static_cast<uint32_t>(lists[i]->size());
+        size_t before = out.size();
+        append_list(out, *lists[i]);
+        header.strings_size[i] = static_cast<uint32_t>(
+            out.size() - before - (BUCKET_COUNT + lists[i]->size() + 1) * sizeof(uint32_t));
+    }
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    fs::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return Error(ErrorCode::IO_ERROR, "Failed to create completion index: " + tmp.string());
+        }
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        if (!file.good()) {
+            return Error(ErrorCode::IO_ERROR, "Failed to write completion index: " + tmp.string());
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        return Error(ErrorCode::IO_ERROR, "Failed to write completion index: " + ec.message());
+    }
+    return Ok();
+}
+
+Result<std::unique_ptr<CompletionIndex>> CompletionIndex::open(const fs::path& path) {
+    auto index = std::unique_ptr<CompletionIndex>(new CompletionIndex());
+    index->path_ = path;
+
+#ifdef DAM_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Error(ErrorCode::NOT_FOUND, "Cannot open completion index: " + path.string());
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return Error(ErrorCode::IO_ERROR, "Cannot stat completion index: " + path.string());
+    }
+    index->size_ = static_cast<size_t>(st.st_size);
+    if (index->size_ > 0) {
+        void* p = ::mmap(nullptr, index->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            index->data_ = static_cast<const char*>(p);
+            index->mapped_ = true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    // No mmap: read the file
+    if (!index->mapped_) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return Error(ErrorCode::NOT_FOUND, "Cannot open completion index: " + path.string());
+        }
+        index->buffer_.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(index->buffer_.data(), static_cast<std::streamsize>(index->buffer_.size()));
+        index->data_ = index->buffer_.data();
+        index->size_ = index->buffer_.size();
+    }
+
+    auto loaded = index->load();
+    if (!loaded.ok()) {
+        return loaded.error();
+    }
+    return index;
+}
+
+CompletionIndex::~CompletionIndex() {
+#ifdef DAM_HAS_MMAP
+    if (mapped_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+Result<void> CompletionIndex::load() {
+    auto corrupt = [this](const std::string& what) {
+        return Error(ErrorCode::CORRUPTION, "Invalid completion index " + path_.string() + ": " + what);
+    };
+
+    if (size_ < sizeof(CompletionHeader)) {
+        return corrupt("file too small");
+    }
+    CompletionHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, COMPLETION_MAGIC, sizeof(COMPLETION_MAGIC)) != 0) {
+        return corrupt("bad magic");
+    }
+    if (header.version != COMPLETION_VERSION) {
+        return corrupt("unsupported version " + std::to_string(header.version));
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        uint64_t tables = (BUCKET_COUNT + static_cast<uint64_t>(header.list_count[i]) + 1) *
+                          sizeof(uint32_t);
+        uint64_t end = static_cast<uint64_t>(header.list_offset[i]) + tables + header.strings_size[i];
+        if (header.list_offset[i] % 4 != 0 || end > size_) {
+            return corrupt("list out of bounds");
+        }
+
+        List& list = lists_[i];
+        list.count = header.list_count[i];
+        list.buckets = reinterpret_cast<const uint32_t*>(data_ + header.list_offset[i]);
+        list.offsets = list.buckets + BUCKET_COUNT;
+        list.strings = reinterpret_cast<const char*>(list.offsets + list.count + 1);
+        list.strings_size = header.strings_size[i];
+
+        for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+            if (list.buckets[b] > list.count || (b > 0 && list.buckets[b] < list.buckets[b - 1])) {
+                return corrupt("bad bucket index");
+            }
+        }
+    }
+    return Ok();
+}
+
+std::string_view CompletionIndex::entry(const List& list, uint32_t index) const {
+    uint32_t begin = list.offsets[index];
+    uint32_t end = list.offsets[index + 1];
+    if (begin > end || end > list.strings_size) {
+        return {};
+    }
+    return std::string_view(list.strings + begin, end - begin);
+}
+
+std::vector<std::string_view> CompletionIndex::complete(Kind kind, std::string_view prefix,
+                                                        size_t limit) const {
+    const List& list = lists_[static_cast<int>(kind)];
+    std::vector<std::string_view> result;
+
+    uint32_t lo = 0;
+    uint32_t hi = list.count;
+    if (!prefix.empty()) {
+        auto lead = static_cast<unsigned char>(prefix[0]);
+        lo = list.buckets[lead];
+        hi = list.buckets[lead + 1];
+
+        // Binary search within the leading byte's bucket
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (entry(list, mid) < prefix) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        hi = list.buckets[lead + 1];
+    }
+
+    for (uint32_t i = lo; i < hi; ++i) {
+        std::string_view candidate = entry(list, i);
+        if (candidate.substr(0, prefix.size()) != prefix) {
+            break;
+        }
+        result.push_back(candidate);
+        if (limit != 0 && result.size() == limit) {
+            break;
+        }
+    }
+    return result;
+}
+
+}  // namespace dam
@@ -0,0 +1,353 @@
+#include <dam/index/similarity_index.hpp>
+#include <dam/util/serializer.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <unordered_map>
+
+namespace dam {
+
+namespace {
+
+// FNV-1a over a trigram's bytes
+uint64_t hash_trigram(const char* data, size_t len) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Murmur3 finalizer
+uint32_t mix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+// Fold one trigram into the signature. The NUM_HASHES functions are
+// derived from two base hashes (h1 + k * h2) rather than computed apart.
+void update_signature(MinHash::Signature& signature, uint64_t trigram_hash) {
+    uint32_t h1 = static_cast<uint32_t>(trigram_hash);
+    uint32_t h2 = static_cast<uint32_t>(trigram_hash >> 32) | 1;
+    for (size_t k = 0; k < MinHash::NUM_HASHES; ++k) {
+        uint32_t h = mix32(h1 + static_cast<uint32_t>(k) * h2);
+        signature[k] = std::min(signature[k], h);
+    }
+}
+
+// "band:" + 2 hex digits + ':' + 16 hex digits + ':'
+constexpr size_t BUCKET_PREFIX_SIZE = 5 + 2 + 1 + 16 + 1;
+
+void append_hex(std::string& out, uint64_t value, int digits) {
+    static const char hex[] = "0123456789abcdef";
+    for (int shift = (digits - 1) * 4; shift >= 0; shift -= 4) {
+        out += hex[(value >> shift) & 0x0F];
+    }
+}
+
+// The 16 hex digits of a document ID at the end of a bucket key
+std::optional<FileId> parse_hex(const std::string& key, size_t pos) {
+    if (key.size() != pos + 16) {
+        return std::nullopt;
+    }
+    FileId id = 0;
+    for (size_t i = pos; i < key.size(); ++i) {
+        char c = key[i];
+        int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+        if (digit < 0) {
+            return std::nullopt;
+        }
+        id = (id << 4) | static_cast<FileId>(digit);
+    }
+    return id;
+}
+
+MinHash::Signature empty_signature() {
+    MinHash::Signature signature;
+    signature.fill(UINT32_MAX);
+    return signature;
+}
+
+}  // namespace
+
+// ============================================================================
+// MinHash Implementation
+// ============================================================================
+
+MinHash::Signature MinHash::compute(const std::set<std::string>& trigrams) {
+    Signature signature = empty_signature();
+    for (const auto& trigram : trigrams) {
+        update_signature(signature, hash_trigram(trigram.data(), trigram.size()));
+    }
+    return signature;
+}
+
+std::optional<MinHash::Signature> MinHash::from_text(const std::string& text) {
+    if (text.size() < 3) {
+        return std::nullopt;
+    }
+
+    Signature signature = empty_signature();
+    char window[3] = {};
+    for (size_t i = 0; i < text.size(); ++i) {
+        window[0] = window[1];
+        window[1] = window[2];
+        window[2] = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+        if (i >= 2) {
+            update_signature(signature, hash_trigram(window, 3));
+        }
+    }
+    return signature;
+}
+
+float MinHash::similarity(const Signature& a, const Signature& b) {
+    size_t same = 0;
+    for (size_t k = 0; k < NUM_HASHES; ++k) {
+        same += (a[k] == b[k]);
+    }
+    return static_cast<float>(same) / static_cast<float>(NUM_HASHES);
+}
+
+// ============================================================================
+// SimilarityIndex Implementation
+// ============================================================================
+
+SimilarityIndex::SimilarityIndex(BufferPool* buffer_pool, PageId root_page_id)
+    : tree_(buffer_pool, root_page_id) {
+    if (root_page_id == INVALID_PAGE_ID) {
+        tree_.insert(LAYOUT_KEY, LAYOUT_VERSION);
+    }
+}
+
+std::string SimilarityIndex::signature_key(FileId file_id) {
+    return "sig:" + std::to_string(file_id);
+}
+
+std::vector<std::string> SimilarityIndex::bucket_prefixes(const MinHash::Signature& signature) {
+    std::vector<std::string> prefixes;
+    prefixes.reserve(NUM_BANDS);
+    for (size_t band = 0; band < NUM_BANDS; ++band) {
+        uint64_t h = hash_trigram(
+            reinterpret_cast<const char*>(signature.data() + band * ROWS_PER_BAND),
+            ROWS_PER_BAND * sizeof(uint32_t));
+
+        std::string prefix = "band:";
+        append_hex(prefix, band, 2);
+        prefix += ':';
+        append_hex(prefix, h, 16);
+        prefix += ':';
+        prefixes.push_back(std::move(prefix));
+    }
+    return prefixes;
+}
+
+std::string SimilarityIndex::bucket_key(const std::string& prefix, FileId file_id) {
+    // Fixed-width hex keeps a bucket's keys in ID order
+    std::string key = prefix;
+    append_hex(key, file_id, 16);
+    return key;
+}
+
+void SimilarityIndex::for_each_in_bucket(const std::string& prefix,
+                                         const std::function<void(FileId)>& callback) const {
+    KeyRange range;
+    range.lower = prefix;
+    range.upper = prefix;
+    range.upper.back() = ':' + 1;
+    range.has_upper = true;
+
+    tree_.for_each_in_range(range, [&](const std::string& key, const std::string&) {
+        if (auto id = parse_hex(key, prefix.size())) {
+            callback(*id);
+        }
+        return true;
+    });
+}
+
+std::optional<MinHash::Signature> SimilarityIndex::get_signature(FileId file_id) const {
+    auto data = tree_.find(signature_key(file_id));
+    if (!data.has_value() || data->size() != sizeof(MinHash::Signature)) {
+        return std::nullopt;
+    }
+
+    MinHash::Signature signature;
+    std::memcpy(signature.data(), data->data(), sizeof(signature));
+    return signature;
+}
+
+bool SimilarityIndex::has_current_layout() const {
+    auto version = tree_.find(LAYOUT_KEY);
+    return version.has_value() && *version == LAYOUT_VERSION;
+}
+
+Result<void> SimilarityIndex::clear() {
+    std::vector<std::string> keys;
+    tree_.for_each([&keys](const std::string& key, const std::string&) {
+        keys.push_back(key);
+        return true;
+    });
+    for (const auto& key : keys) {
+        if (!tree_.remove(key)) {
+            return Error(ErrorCode::INTERNAL_ERROR, "Failed to clear similarity index");
+        }
+    }
+    if (!tree_.insert(LAYOUT_KEY, LAYOUT_VERSION)) {
+        return Error(ErrorCode::INTERNAL_ERROR, "Failed to clear similarity index");
+    }
+    return Ok();
+}
+
+Result<bool> SimilarityIndex::add(FileId file_id, const std::string& content) {
+    auto removed = remove(file_id);
+    if (!removed.ok()) {
+        return removed.error();
+    }
+
+    auto signature = MinHash::from_text(content);
+    if (!signature.has_value()) {
+        return false;
+    }
+
+    std::string value(reinterpret_cast<const char*>(signature->data()), sizeof(*signature));
+    bool written = tree_.insert(signature_key(file_id), value);
+    for (const auto& prefix : bucket_prefixes(*signature)) {
+        if (!written) {
+            break;
+        }
+        written = tree_.insert(bucket_key(prefix, file_id), "");
+    }
+
+    if (!written) {
+        (void)remove(file_id);
+        return Error(ErrorCode::INTERNAL_ERROR,
+                     "Failed to index document " + std::to_string(file_id));
+    }
+    return true;
+}
+
+Result<bool> SimilarityIndex::remove(FileId file_id) {
+    auto signature = get_signature(file_id);
+    if (!signature.has_value()) {
+        return false;
+    }
+
+    // Bucket keys may be missing after a failed add()
+    bool removed = true;
+    for (const auto& prefix : bucket_prefixes(*signature)) {
+        std::string key = bucket_key(prefix, file_id);
+        if (tree_.contains(key) && !tree_.remove(key)) {
+            removed = false;
+        }
+    }
+    if (!removed || !tree_.remove(signature_key(file_id))) {
+        return Error(ErrorCode::INTERNAL_ERROR,
+                     "Failed to remove document " + std::to_string(file_id) +
+                     " from the similarity index");
+    }
+    return true;
+}
+
+std::vector<SimilarMatch> SimilarityIndex::find_similar(FileId file_id, float threshold,
+                                                        size_t max_results) const {
+    std::vector<SimilarMatch> matches;
+    auto signature = get_signature(file_id);
+    if (!signature.has_value()) {
+        return matches;
+    }
+
+    // Candidates share a bucket in at least one band
+    std::set<FileId> candidates;
+    for (const auto& prefix : bucket_prefixes(*signature)) {
+        for_each_in_bucket(prefix, [&candidates](FileId id) { candidates.insert(id); });
+    }
+    candidates.erase(file_id);
+
+    for (FileId candidate : candidates) {
+        auto other = get_signature(candidate);
+        if (!other.has_value()) {
+            continue;
+        }
+        float similarity = MinHash::similarity(*signature, *other);
+        if (similarity >= threshold) {
+            matches.push_back({candidate, similarity});
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+        return a.similarity != b.similarity ? a.similarity > b.similarity : a.id < b.id;
+    });
+    if (matches.size() > max_results) {
+        matches.resize(max_results);
+    }
+    return matches;
+}
+
+std::vector<SimilarPair> SimilarityIndex::find_duplicates(float threshold) const {
+    KeyRange range;
+    range.lower = "band:";
+    range.upper = "band;";
+    range.has_upper = true;
+
+    // Pairs are only compared when some bucket holds both documents
+    std::set<std::pair<FileId, FileId>> seen;
+    std::unordered_map<FileId, std::optional<MinHash::Signature>> signatures;
+    auto signature_of = [&](FileId id) -> const std::optional<MinHash::Signature>& {
+        auto it = signatures.find(id);
+        if (it == signatures.end()) {
+            it = signatures.emplace(id, get_signature(id)).first;
+        }
+        return it->second;
+    };
+
+    std::vector<SimilarPair> pairs;
+    auto compare_bucket = [&](const std::vector<FileId>& ids) {
+        for (size_t a = 0; a < ids.size(); ++a) {
+            for (size_t b = a + 1; b < ids.size(); ++b) {
+                if (!seen.emplace(ids[a], ids[b]).second) {
+                    continue;
+                }
+                const auto& sig_a = signature_of(ids[a]);
+                const auto& sig_b = signature_of(ids[b]);
+                if (!sig_a.has_value() || !sig_b.has_value()) {
+                    continue;
+                }
+                float similarity = MinHash::similarity(*sig_a, *sig_b);
+                if (similarity >= threshold) {
+                    pairs.push_back({ids[a], ids[b], similarity});
+                }
+            }
+        }
+    };
+
+    // A bucket's keys are adjacent and in ID order
+    std::string bucket;
+    std::vector<FileId> ids;
+    tree_.for_each_in_range(range, [&](const std::string& key, const std::string&) {
+        auto id = parse_hex(key, BUCKET_PREFIX_SIZE);
+        if (!id.has_value()) {
+            return true;
+        }
+        if (key.compare(0, BUCKET_PREFIX_SIZE, bucket) != 0) {
+            compare_bucket(ids);
+            ids.clear();
+            bucket.assign(key, 0, BUCKET_PREFIX_SIZE);
+        }
+        ids.push_back(*id);
+        return true;
+    });
+    compare_bucket(ids);
+
+    std::sort(pairs.begin(), pairs.end(), [](const auto& x, const auto& y) {
+        if (x.similarity != y.similarity) return x.similarity > y.similarity;
+        return std::make_pair(x.first, x.second) < std::make_pair(y.first, y.second);
+    });
+    return pairs;
+}
+
+}  // namespace dam
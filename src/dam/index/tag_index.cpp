@@ -1,6 +1,7 @@
 #include <dam/index/tag_index.hpp>
 #include <algorithm>
 #include <cstring>
+#include <iterator>
 
 namespace dam {
 
@@ -87,6 +88,44 @@ bool TagIndex::remove_file_from_all_tags(FileId file_id, const std::vector<std::
     return all_success;
 }
 
+bool TagIndex::add_files_to_tag(const std::string& tag, const std::set<FileId>& file_ids) {
+    if (file_ids.empty()) {
+        return true;
+    }
+
+    auto existing = tree_.find(tag);
+    if (!existing.has_value()) {
+        return tree_.insert(tag, serialize_file_ids(file_ids));
+    }
+
+    std::set<FileId> ids = deserialize_file_ids(existing.value());
+    size_t before = ids.size();
+    ids.insert(file_ids.begin(), file_ids.end());
+    if (ids.size() == before) {
+        return true;
+    }
+    return tree_.update(tag, serialize_file_ids(ids));
+}
+
+bool TagIndex::remove_files_from_tag(const std::string& tag, const std::set<FileId>& file_ids) {
+    auto existing = tree_.find(tag);
+    if (!existing.has_value() || file_ids.empty()) {
+        return true;
+    }
+
+    std::set<FileId> ids = deserialize_file_ids(existing.value());
+    std::set<FileId> remaining;
+    std::set_difference(ids.begin(), ids.end(), file_ids.begin(), file_ids.end(),
+                        std::inserter(remaining, remaining.end()));
+    if (remaining.size() == ids.size()) {
+        return true;
+    }
+    if (remaining.empty()) {
+        return tree_.remove(tag);
+    }
+    return tree_.update(tag, serialize_file_ids(remaining));
+}
+
 std::set<FileId> TagIndex::get_files_for_tag(const std::string& tag) const {
     auto data = tree_.find(tag);
     if (!data.has_value()) {
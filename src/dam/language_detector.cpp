@@ -1,6 +1,12 @@
 #include <dam/language_detector.hpp>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <unordered_map>
+#include <vector>
 
 namespace dam {
 
@@ -139,6 +145,505 @@ std::string to_lower(const std::string& s) {
     return result;
 }
 
+
+// ============================================================================
+// Content classifier
+// ============================================================================
+
+enum Lang : uint8_t {
+    BASH, C, CPP, CSS, DOCKERFILE, GO, HTML, JAVA, JAVASCRIPT, JSON, LUA,
+    MAKEFILE, MARKDOWN, PHP, PYTHON, RUBY, RUST, SQL, TYPESCRIPT, XML, YAML,
+    NUM_LANGS
+};
+
+const char* const LANG_NAMES[NUM_LANGS] = {
+    "bash", "c", "cpp", "css", "dockerfile", "go", "html", "java",
+    "javascript", "json", "lua", "makefile", "markdown", "php", "python",
+    "ruby", "rust", "sql", "typescript", "xml", "yaml",
+};
+
+// Score a language starts from before any evidence; plain text scores 0,
+// so a few weak hits are not enough to call something code
+constexpr float LANG_PRIOR = -4.0f;
+
+// Only a prefix of large inputs is examined
+constexpr size_t MAX_SAMPLE_BYTES = 64 * 1024;
+
+struct Weight {
+    Lang lang;
+    float value;
+};
+
+// A feature and the languages it is evidence for (unused slots add 0)
+struct Feature {
+    const char* token;
+    Weight weights[6];
+};
+
+struct ByteFeature {
+    unsigned char byte;
+    Weight weights[6];
+};
+
+// Tokens are runs of word characters or of punctuation. Words starting
+// with digits are looked up without them ("10px" -> "px").
+const Feature TOKEN_FEATURES[] = {
+    // Python
+    {"def", {{PYTHON, 2.0f}, {RUBY, 1.5f}}},
+    {"elif", {{PYTHON, 3.0f}}},
+    {"self", {{PYTHON, 1.5f}, {RUBY, 0.5f}, {RUST, 0.5f}}},
+    {"None", {{PYTHON, 2.5f}, {RUST, 1.0f}}},
+    {"True", {{PYTHON, 2.0f}}},
+    {"False", {{PYTHON, 2.0f}}},
+    {"lambda", {{PYTHON, 2.0f}}},
+    {"except", {{PYTHON, 3.0f}}},
+    {"raise", {{PYTHON, 2.0f}, {RUBY, 1.0f}}},
+    {"pass", {{PYTHON, 1.5f}}},
+    {"__init__", {{PYTHON, 3.0f}}},
+    {"__name__", {{PYTHON, 3.0f}}},
+    {"kwargs", {{PYTHON, 3.0f}}},
+    {"len", {{PYTHON, 2.0f}, {GO, 1.0f}}},
+    {"range", {{PYTHON, 1.5f}, {GO, 1.0f}}},
+    {"print", {{PYTHON, 1.5f}, {LUA, 0.5f}}},
+    {"\"\"\"", {{PYTHON, 3.0f}}},
+    {"):", {{PYTHON, 2.0f}}},
+    {"import", {{PYTHON, 1.0f}, {JAVA, 1.0f}, {JAVASCRIPT, 0.8f}, {TYPESCRIPT, 0.8f}, {GO, 0.8f}}},
+
+    // JavaScript / TypeScript
+    {"function", {{JAVASCRIPT, 2.0f}, {TYPESCRIPT, 1.5f}, {PHP, 1.5f}, {LUA, 1.5f}, {BASH, 0.5f}}},
+    {"const", {{JAVASCRIPT, 1.5f}, {TYPESCRIPT, 1.5f}, {CPP, 0.5f}, {RUST, 0.5f}}},
+    {"let", {{JAVASCRIPT, 1.5f}, {TYPESCRIPT, 1.5f}, {RUST, 1.0f}}},
+    {"var", {{JAVASCRIPT, 1.5f}, {TYPESCRIPT, 0.5f}, {GO, 0.5f}}},
+    {"=>", {{JAVASCRIPT, 1.5f}, {TYPESCRIPT, 1.5f}, {PHP, 1.0f}, {RUST, 1.0f}, {RUBY, 0.5f}}},
+    {"===", {{JAVASCRIPT, 3.0f}, {TYPESCRIPT, 2.5f}, {PHP, 1.5f}}},
+    {"!==", {{JAVASCRIPT, 3.0f}, {TYPESCRIPT, 2.5f}, {PHP, 1.5f}}},
+    {"console", {{JAVASCRIPT, 3.0f}, {TYPESCRIPT, 2.5f}}},
+    {"undefined", {{JAVASCRIPT, 3.0f}, {TYPESCRIPT, 2.5f}}},
+    {"typeof", {{JAVASCRIPT, 2.5f}, {TYPESCRIPT, 2.0f}}},
+    {"prototype", {{JAVASCRIPT, 3.0f}}},
+    {"document", {{JAVASCRIPT, 2.5f}, {TYPESCRIPT, 1.5f}}},
+    {"window", {{JAVASCRIPT, 2.0f}, {TYPESCRIPT, 1.5f}}},
+    {"JSON", {{JAVASCRIPT, 2.0f}, {TYPESCRIPT, 1.5f}}},
+    {"require", {{JAVASCRIPT, 2.0f}, {RUBY, 1.0f}, {LUA, 1.0f}, {PHP, 0.5f}}},
+    {"exports", {{JAVASCRIPT, 2.5f}, {TYPESCRIPT, 0.5f}}},
+    {"async", {{JAVASCRIPT, 1.5f}, {TYPESCRIPT, 1.5f}, {PYTHON, 1.0f}, {RUST, 0.5f}}},
+    {"await", {{JAVASCRIPT, 1.5f}, {TYPESCRIPT, 1.5f}, {PYTHON, 1.0f}, {RUST, 0.5f}}},
+    {"export", {{JAVASCRIPT, 1.0f}, {TYPESCRIPT, 1.5f}, {BASH, 1.0f}}},
+    {"});", {{JAVASCRIPT, 2.0f}, {TYPESCRIPT, 1.5f}, {JAVA, 0.5f}}},
+    {"interface", {{TYPESCRIPT, 2.0f}, {JAVA, 1.5f}, {GO, 1.0f}, {PHP, 1.0f}}},
+    {"number", {{TYPESCRIPT, 2.5f}}},
+    {"boolean", {{TYPESCRIPT, 2.5f}, {JAVA, 1.5f}}},
+    {"string", {{TYPESCRIPT, 1.5f}, {GO, 1.0f}, {CPP, 0.5f}}},
+    {"readonly", {{TYPESCRIPT, 3.0f}, {BASH, 0.5f}}},
+    {"keyof", {{TYPESCRIPT, 3.0f}}},
+    {"declare", {{TYPESCRIPT, 3.0f}, {BASH, 0.5f}}},
+    {"unknown", {{TYPESCRIPT, 1.5f}}},
+    {"any", {{TYPESCRIPT, 1.5f}}},
+    {"Promise", {{TYPESCRIPT, 1.5f}, {JAVASCRIPT, 1.0f}}},
+
+    // C / C++
+    {"include", {{C, 2.0f}, {CPP, 2.0f}, {PHP, 0.5f}, {MAKEFILE, 0.5f}}},
+    {"define", {{C, 1.5f}, {CPP, 1.0f}}},
+    {"ifdef", {{C, 2.0f}, {CPP, 2.0f}, {MAKEFILE, 1.0f}}},
+    {"endif", {{C, 2.0f}, {CPP, 2.0f}, {MAKEFILE, 1.0f}, {PHP, 0.5f}}},
+    {"printf", {{C, 2.0f}, {CPP, 0.5f}, {BASH, 1.0f}, {PHP, 0.5f}}},
+    {"fprintf", {{C, 3.0f}, {CPP, 1.0f}}},
+    {"malloc", {{C, 3.0f}, {CPP, 0.5f}}},
+    {"free", {{C, 1.5f}, {CPP, 0.5f}}},
+    {"sizeof", {{C, 2.0f}, {CPP, 1.0f}}},
+    {"typedef", {{C, 2.5f}, {CPP, 1.5f}}},
+    {"struct", {{C, 1.5f}, {CPP, 1.0f}, {GO, 1.0f}, {RUST, 1.5f}}},
+    {"unsigned", {{C, 2.0f}, {CPP, 1.5f}}},
+    {"char", {{C, 1.5f}, {CPP, 1.0f}, {JAVA, 0.5f}}},
+    {"int", {{C, 1.0f}, {CPP, 1.0f}, {JAVA, 1.0f}, {GO, 0.3f}}},
+    {"void", {{C, 1.0f}, {CPP, 1.0f}, {JAVA, 1.0f}, {TYPESCRIPT, 0.3f}}},
+    {"NULL", {{C, 2.0f}, {CPP, 1.0f}, {SQL, 1.5f}}},
+    {"size_t", {{C, 2.0f}, {CPP, 2.0f}}},
+    {"stdio", {{C, 3.0f}}},
+    {"stdlib", {{C, 3.0f}}},
+    {"std", {{CPP, 3.0f}, {RUST, 1.0f}}},
+    {"::", {{CPP, 1.5f}, {RUST, 1.5f}, {PHP, 1.0f}, {RUBY, 0.5f}}},
+    {"template", {{CPP, 3.0f}}},
+    {"typename", {{CPP, 3.0f}}},
+    {"namespace", {{CPP, 2.0f}, {TYPESCRIPT, 1.0f}, {PHP, 1.0f}}},
+    {"cout", {{CPP, 3.0f}}},
+    {"endl", {{CPP, 3.0f}}},
+    {"nullptr", {{CPP, 3.0f}}},
+    {"constexpr", {{CPP, 3.0f}}},
+    {"virtual", {{CPP, 3.0f}}},
+    {"auto", {{CPP, 1.5f}, {C, 0.5f}}},
+    {"vector", {{CPP, 2.0f}}},
+    {"unique_ptr", {{CPP, 3.0f}}},
+    {"shared_ptr", {{CPP, 3.0f}}},
+    {"<<", {{CPP, 1.0f}, {BASH, 0.5f}, {RUBY, 0.5f}}},
+
+    // Go
+    {"func", {{GO, 3.0f}}},
+    {":=", {{GO, 3.0f}, {MAKEFILE, 1.5f}}},
+    {"package", {{GO, 2.0f}, {JAVA, 2.0f}}},
+    {"fmt", {{GO, 3.0f}}},
+    {"err", {{GO, 2.0f}}},
+    {"nil", {{GO, 2.0f}, {RUBY, 2.0f}, {LUA, 2.0f}}},
+    {"chan", {{GO, 3.0f}}},
+    {"defer", {{GO, 3.0f}}},
+    {"Println", {{GO, 2.0f}}},
+    {"Printf", {{GO, 2.0f}}},
+    {"Errorf", {{GO, 3.0f}}},
+
+    // Rust
+    {"fn", {{RUST, 3.0f}}},
+    {"mut", {{RUST, 3.0f}}},
+    {"impl", {{RUST, 3.0f}}},
+    {"pub", {{RUST, 2.5f}}},
+    {"crate", {{RUST, 3.0f}}},
+    {"trait", {{RUST, 3.0f}}},
+    {"Some", {{RUST, 2.5f}}},
+    {"Ok", {{RUST, 2.0f}}},
+    {"Err", {{RUST, 2.5f}}},
+    {"Vec", {{RUST, 2.5f}}},
+    {"Self", {{RUST, 2.0f}}},
+    {"unwrap", {{RUST, 3.0f}}},
+    {"println", {{RUST, 2.0f}, {JAVA, 1.5f}}},
+    {"match", {{RUST, 1.5f}}},
+    {"usize", {{RUST, 3.0f}}},
+    {"u32", {{RUST, 2.5f}}},
+    {"i32", {{RUST, 2.5f}}},
+    {"u8", {{RUST, 2.5f}}},
+    {"#[", {{RUST, 2.5f}}},
+    {"->", {{CPP, 1.0f}, {C, 1.0f}, {RUST, 1.0f}, {PHP, 1.5f}, {PYTHON, 0.5f}}},
+
+    // Java
+    {"public", {{JAVA, 1.5f}, {CPP, 0.5f}, {PHP, 0.5f}, {TYPESCRIPT, 0.5f}}},
+    {"private", {{JAVA, 1.0f}, {CPP, 0.5f}, {PHP, 0.5f}, {TYPESCRIPT, 0.5f}}},
+    {"protected", {{JAVA, 1.0f}, {CPP, 0.5f}, {PHP, 0.5f}}},
+    {"static", {{JAVA, 1.0f}, {C, 0.5f}, {CPP, 0.5f}, {PHP, 0.3f}}},
+    {"final", {{JAVA, 2.0f}, {PHP, 0.5f}}},
+    {"extends", {{JAVA, 1.5f}, {TYPESCRIPT, 1.0f}, {PHP, 1.0f}, {JAVASCRIPT, 0.5f}}},
+    {"implements", {{JAVA, 1.5f}, {TYPESCRIPT, 1.0f}, {PHP, 1.0f}}},
+    {"throws", {{JAVA, 3.0f}}},
+    {"String", {{JAVA, 1.5f}, {RUST, 0.5f}}},
+    {"System", {{JAVA, 2.5f}}},
+    {"Override", {{JAVA, 3.0f}}},
+    {"ArrayList", {{JAVA, 3.0f}}},
+    {"HashMap", {{JAVA, 2.0f}, {RUST, 1.0f}}},
+    {"Integer", {{JAVA, 1.5f}}},
+    {"class", {{JAVA, 1.0f}, {CPP, 0.5f}, {PYTHON, 0.5f}, {PHP, 0.5f}, {RUBY, 0.5f}, {TYPESCRIPT, 0.5f}}},
+
+    // Ruby
+    {"end", {{RUBY, 1.5f}, {LUA, 1.5f}}},
+    {"puts", {{RUBY, 3.0f}}},
+    {"elsif", {{RUBY, 3.0f}}},
+    {"unless", {{RUBY, 2.5f}}},
+    {"attr_accessor", {{RUBY, 3.0f}}},
+    {"initialize", {{RUBY, 3.0f}}},
+    {"rescue", {{RUBY, 3.0f}}},
+    {"ensure", {{RUBY, 2.5f}}},
+    {"each", {{RUBY, 1.5f}}},
+    {"do", {{RUBY, 0.5f}, {BASH, 0.5f}, {LUA, 0.5f}}},
+
+    // Shell
+    {"echo", {{BASH, 3.0f}, {PHP, 1.0f}}},
+    {"fi", {{BASH, 3.0f}}},
+    {"esac", {{BASH, 3.0f}}},
+    {"done", {{BASH, 2.5f}}},
+    {"then", {{BASH, 1.0f}, {LUA, 1.0f}}},
+    {"local", {{BASH, 1.0f}, {LUA, 2.0f}}},
+    {"sudo", {{BASH, 2.5f}}},
+    {"grep", {{BASH, 2.0f}}},
+    {"mkdir", {{BASH, 2.0f}, {DOCKERFILE, 0.5f}}},
+    {"cd", {{BASH, 2.0f}, {DOCKERFILE, 0.5f}, {MAKEFILE, 0.5f}}},
+    {"rm", {{BASH, 1.5f}, {MAKEFILE, 1.0f}, {DOCKERFILE, 0.5f}}},
+    {"apt", {{BASH, 1.5f}, {DOCKERFILE, 1.5f}}},
+    {"dev", {{BASH, 1.0f}}},
+    {"[[", {{BASH, 3.0f}}},
+    {"]];", {{BASH, 3.0f}}},
+    {"$(", {{BASH, 2.0f}, {MAKEFILE, 2.0f}}},
+    {"${", {{BASH, 1.5f}, {JAVASCRIPT, 0.5f}, {TYPESCRIPT, 0.5f}}},
+    {"\"$", {{BASH, 2.0f}}},
+    {"|", {{BASH, 1.0f}}},
+    {"&&", {{BASH, 0.5f}, {DOCKERFILE, 0.5f}}},
+
+    // SQL
+    {"SELECT", {{SQL, 3.0f}}},
+    {"FROM", {{SQL, 1.5f}}},
+    {"WHERE", {{SQL, 3.0f}}},
+    {"INSERT", {{SQL, 3.0f}}},
+    {"INTO", {{SQL, 3.0f}}},
+    {"VALUES", {{SQL, 3.0f}}},
+    {"UPDATE", {{SQL, 2.5f}}},
+    {"DELETE", {{SQL, 2.5f}}},
+    {"CREATE", {{SQL, 2.5f}}},
+    {"TABLE", {{SQL, 3.0f}}},
+    {"JOIN", {{SQL, 3.0f}}},
+    {"ORDER", {{SQL, 2.5f}}},
+    {"GROUP", {{SQL, 2.5f}}},
+    {"BY", {{SQL, 2.5f}}},
+    {"AND", {{SQL, 1.5f}}},
+    {"NOT", {{SQL, 1.5f}}},
+    {"AS", {{SQL, 1.5f}}},
+    {"ON", {{SQL, 1.5f}}},
+    {"LIMIT", {{SQL, 2.0f}}},
+    {"PRIMARY", {{SQL, 3.0f}}},
+    {"KEY", {{SQL, 2.0f}}},
+    {"VARCHAR", {{SQL, 3.0f}}},
+    {"INTEGER", {{SQL, 2.0f}}},
+    {"select", {{SQL, 2.0f}}},
+    {"where", {{SQL, 1.0f}}},
+    {"varchar", {{SQL, 3.0f}}},
+
+    // JSON / YAML
+    {"\":", {{JSON, 2.5f}, {JAVASCRIPT, 0.5f}, {PYTHON, 0.5f}}},
+    {"true", {{JSON, 1.0f}, {YAML, 0.5f}, {JAVASCRIPT, 0.5f}, {TYPESCRIPT, 0.5f}}},
+    {"false", {{JSON, 1.0f}, {YAML, 0.5f}, {JAVASCRIPT, 0.5f}, {TYPESCRIPT, 0.5f}}},
+    {"null", {{JSON, 1.0f}, {JAVASCRIPT, 0.5f}, {TYPESCRIPT, 0.5f}, {JAVA, 0.5f}}},
+    {"apiVersion", {{YAML, 3.0f}}},
+    {"kind", {{YAML, 2.0f}}},
+    {"metadata", {{YAML, 1.0f}}},
+    {"spec", {{YAML, 1.5f}}},
+    {"steps", {{YAML, 1.5f}}},
+
+    // HTML / XML / CSS
+    {"<", {{HTML, 1.0f}, {XML, 1.0f}}},
+    {"</", {{HTML, 2.5f}, {XML, 2.5f}}},
+    {">", {{HTML, 0.5f}, {XML, 0.5f}}},
+    {"/>", {{HTML, 1.5f}, {XML, 1.5f}}},
+    {"=\"", {{HTML, 1.5f}, {XML, 1.5f}}},
+    {"\">", {{HTML, 1.5f}, {XML, 1.5f}}},
+    {"<!--", {{HTML, 2.0f}, {XML, 2.0f}, {MARKDOWN, 1.0f}}},
+    {"<!", {{HTML, 2.0f}, {XML, 1.0f}}},
+    {"DOCTYPE", {{HTML, 3.0f}}},
+    {"html", {{HTML, 3.0f}}},
+    {"div", {{HTML, 3.0f}}},
+    {"span", {{HTML, 3.0f}}},
+    {"href", {{HTML, 3.0f}}},
+    {"body", {{HTML, 2.0f}}},
+    {"head", {{HTML, 1.5f}}},
+    {"meta", {{HTML, 2.0f}}},
+    {"script", {{HTML, 1.5f}}},
+    {"li", {{HTML, 1.5f}}},
+    {"<?", {{XML, 3.0f}, {PHP, 2.0f}}},
+    {"?>", {{XML, 2.0f}, {PHP, 1.5f}}},
+    {"xml", {{XML, 3.0f}}},
+    {"xmlns", {{XML, 3.0f}}},
+    {"encoding", {{XML, 1.5f}}},
+    {"px", {{CSS, 2.5f}}},
+    {"em", {{CSS, 1.5f}}},
+    {"rem", {{CSS, 2.5f}}},
+    {"color", {{CSS, 2.0f}}},
+    {"margin", {{CSS, 3.0f}}},
+    {"padding", {{CSS, 3.0f}}},
+    {"display", {{CSS, 2.5f}}},
+    {"font", {{CSS, 2.0f}}},
+    {"background", {{CSS, 2.0f}}},
+    {"border", {{CSS, 2.5f}}},
+    {"flex", {{CSS, 2.5f}}},
+    {"width", {{CSS, 1.0f}, {HTML, 0.5f}}},
+    {"height", {{CSS, 1.0f}, {HTML, 0.5f}}},
+    {"important", {{CSS, 1.5f}}},
+
+    // PHP
+    {"php", {{PHP, 3.0f}}},
+    {"this", {{JAVASCRIPT, 1.0f}, {TYPESCRIPT, 1.0f}, {JAVA, 1.0f}, {PHP, 1.0f}, {CPP, 0.5f}}},
+    {"isset", {{PHP, 3.0f}}},
+    {"foreach", {{PHP, 2.5f}}},
+    {"array", {{PHP, 1.5f}}},
+    {"elseif", {{PHP, 1.5f}, {LUA, 2.0f}}},
+
+    // Lua
+    {"pairs", {{LUA, 3.0f}}},
+    {"ipairs", {{LUA, 3.0f}}},
+    {"~=", {{LUA, 3.0f}}},
+    {"..", {{LUA, 1.0f}, {RUST, 1.0f}}},
+
+    // Markdown
+    {"```", {{MARKDOWN, 3.0f}}},
+    {"](", {{MARKDOWN, 3.0f}}},
+    {"**", {{MARKDOWN, 2.0f}, {PYTHON, 0.5f}}},
+    {"`", {{MARKDOWN, 1.0f}}},
+
+    // Makefile
+    {"PHONY", {{MAKEFILE, 3.0f}}},
+    {"CFLAGS", {{MAKEFILE, 3.0f}}},
+    {"$@", {{MAKEFILE, 2.0f}, {BASH, 1.0f}}},
+    {"$<", {{MAKEFILE, 2.5f}}},
+    {"$^", {{MAKEFILE, 2.5f}}},
+
+    // Comments
+    {"//", {{C, 0.5f}, {CPP, 1.0f}, {JAVA, 1.0f}, {JAVASCRIPT, 1.0f}, {TYPESCRIPT, 1.0f}, {GO, 1.0f}}},
+    {"/*", {{C, 1.0f}, {CPP, 0.5f}, {JAVA, 0.5f}, {CSS, 1.0f}, {JAVASCRIPT, 0.5f}}},
+};
+
+// Features of the first token on a line
+const Feature LINE_START_FEATURES[] = {
+    {"FROM", {{DOCKERFILE, 3.0f}}},
+    {"RUN", {{DOCKERFILE, 3.0f}}},
+    {"COPY", {{DOCKERFILE, 3.0f}}},
+    {"WORKDIR", {{DOCKERFILE, 3.0f}}},
+    {"ENV", {{DOCKERFILE, 2.5f}}},
+    {"EXPOSE", {{DOCKERFILE, 3.0f}}},
+    {"CMD", {{DOCKERFILE, 3.0f}}},
+    {"ENTRYPOINT", {{DOCKERFILE, 3.0f}}},
+    {"ARG", {{DOCKERFILE, 2.5f}}},
+    {"def", {{PYTHON, 1.0f}, {RUBY, 0.5f}}},
+    {"from", {{PYTHON, 1.5f}}},
+    {"#", {{BASH, 0.5f}, {PYTHON, 0.5f}, {RUBY, 0.5f}, {YAML, 0.5f}, {MARKDOWN, 1.0f}}},
+    {"##", {{MARKDOWN, 3.0f}}},
+    {"###", {{MARKDOWN, 3.0f}}},
+    {"-", {{YAML, 1.5f}, {MARKDOWN, 1.5f}}},
+    {"---", {{YAML, 2.0f}, {MARKDOWN, 1.0f}}},
+    {"*", {{MARKDOWN, 1.5f}}},
+    {">", {{MARKDOWN, 1.5f}}},
+    {"--", {{SQL, 1.5f}, {LUA, 1.5f}}},
+    {"@", {{JAVA, 1.0f}, {PYTHON, 1.0f}, {TYPESCRIPT, 0.5f}}},
+    {"#!", {{BASH, 2.0f}}},
+    {"{", {{JSON, 1.0f}}},
+    {"<", {{HTML, 1.0f}, {XML, 1.0f}}},
+};
+
+// Features of the last character of a line, if it is punctuation
+const ByteFeature LINE_END_FEATURES[] = {
+    {';', {{C, 1.0f}, {CPP, 1.0f}, {JAVA, 1.0f}, {JAVASCRIPT, 0.8f}, {TYPESCRIPT, 0.8f}, {PHP, 1.0f}}},
+    {'{', {{C, 0.5f}, {CPP, 0.5f}, {JAVA, 0.5f}, {JAVASCRIPT, 0.5f}, {GO, 0.8f}, {RUST, 0.8f}}},
+    {':', {{PYTHON, 2.0f}, {YAML, 1.5f}, {MAKEFILE, 0.5f}}},
+    {',', {{JSON, 1.0f}, {PYTHON, 0.3f}, {JAVASCRIPT, 0.3f}}},
+    {'\\', {{BASH, 1.5f}, {DOCKERFILE, 1.5f}, {MAKEFILE, 1.0f}, {C, 0.5f}}},
+    {'>', {{HTML, 1.5f}, {XML, 1.5f}}},
+};
+
+// Per-byte features from the histogram
+const ByteFeature BYTE_FEATURES[] = {
+    {'$', {{BASH, 0.5f}, {PHP, 0.5f}, {MAKEFILE, 0.5f}}},
+    {'{', {{JSON, 0.3f}, {CSS, 0.3f}, {C, 0.2f}, {CPP, 0.2f}, {JAVA, 0.2f}, {JAVASCRIPT, 0.2f}}},
+    {'"', {{JSON, 0.5f}}},
+    {'<', {{HTML, 0.3f}, {XML, 0.3f}}},
+    {'\t', {{GO, 0.3f}, {MAKEFILE, 0.5f}}},
+};
+
+enum CharClass : uint8_t { SPACE, WORD, PUNCT, NEWLINE };
+
+constexpr std::array<uint8_t, 256> make_char_classes() {
+    std::array<uint8_t, 256> classes{};
+    for (int c = 0; c < 256; ++c) {
+        if (c == '\n') {
+            classes[c] = NEWLINE;
+        } else if (c <= ' ' || c == 0x7F) {
+            classes[c] = SPACE;
+        } else if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') ||
+                   (c >= 'a' && c <= 'z') || c == '_' || c >= 0x80) {
+            classes[c] = WORD;
+        } else {
+            classes[c] = PUNCT;
+        }
+    }
+    return classes;
+}
+
+constexpr std::array<uint8_t, 256> CHAR_CLASSES = make_char_classes();
+
+uint64_t hash_token(const unsigned char* data, size_t len) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Open-addressing map from token to feature index, built once
+class FeatureTable {
+public:
+    template <size_t N>
+    explicit FeatureTable(const Feature (&features)[N]) : features_(features) {
+        size_t capacity = 16;
+        while (capacity < N * 2) {
+            capacity <<= 1;
+        }
+        mask_ = capacity - 1;
+        slots_.assign(capacity, Slot{0, -1});
+
+        for (size_t i = 0; i < N; ++i) {
+            const char* token = features[i].token;
+            uint64_t h = hash_token(reinterpret_cast<const unsigned char*>(token),
+                                    std::strlen(token));
+            size_t pos = h & mask_;
+            while (slots_[pos].index >= 0) {
+                pos = (pos + 1) & mask_;
+            }
+            slots_[pos] = Slot{h, static_cast<int32_t>(i)};
+        }
+    }
+
+    int32_t find(uint64_t h, const unsigned char* data, size_t len) const {
+        for (size_t pos = h & mask_;; pos = (pos + 1) & mask_) {
+            const Slot& slot = slots_[pos];
+            if (slot.index < 0) {
+                return -1;
+            }
+            if (slot.hash == h) {
+                const char* token = features_[slot.index].token;
+                if (std::strncmp(token, reinterpret_cast<const char*>(data), len) == 0 &&
+                    token[len] == '\0') {
+                    return slot.index;
+                }
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        uint64_t hash;
+        int32_t index;
+    };
+
+    const Feature* features_;
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+};
+
+const FeatureTable& token_table() {
+    static const FeatureTable table(TOKEN_FEATURES);
+    return table;
+}
+
+const FeatureTable& line_start_table() {
+    static const FeatureTable table(LINE_START_FEATURES);
+    return table;
+}
+
+// Count each byte value. Four interleaved tables keep runs of the same
+// byte from serializing on one counter.
+void byte_histogram(const unsigned char* data, size_t len, uint32_t hist[256]) {
+    uint32_t tables[4][256] = {};
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        tables[0][data[i]]++;
+        tables[1][data[i + 1]]++;
+        tables[2][data[i + 2]]++;
+        tables[3][data[i + 3]]++;
+    }
+    for (; i < len; ++i) {
+        tables[0][data[i]]++;
+    }
+    for (int b = 0; b < 256; ++b) {
+        hist[b] = tables[0][b] + tables[1][b] + tables[2][b] + tables[3][b];
+    }
+}
+
+// Repeated evidence counts with diminishing returns
+float damped(uint32_t count) {
+    return count == 0 ? 0.0f : std::log2(1.0f + static_cast<float>(count));
+}
+
+void add_weights(float* scores, const Weight (&weights)[6], uint32_t count) {
+    if (count == 0) {
+        return;
+    }
+    float scale = damped(count);
+    for (const Weight& w : weights) {
+        scores[w.lang] += w.value * scale;
+    }
+}
+
 }  // namespace
 
 std::string LanguageDetector::detect(const std::string& content,
@@ -171,9 +676,121 @@ std::string LanguageDetector::detect(const std::string& content,
         return "gitconfig";
     }
 
+    // Fall back to the content itself
+    LanguageGuess guess = classify(content);
+    if (guess.confidence >= MIN_CONFIDENCE) {
+        return guess.language;
+    }
+
     return "text";
 }
 
+LanguageGuess LanguageDetector::classify(std::string_view content) {
+    LanguageGuess guess;
+
+    size_t len = content.size();
+    if (len > MAX_SAMPLE_BYTES) {
+        // Cut at a line boundary so the last token is whole
+        size_t cut = content.rfind('\n', MAX_SAMPLE_BYTES);
+        len = (cut == std::string_view::npos) ? MAX_SAMPLE_BYTES : cut;
+    }
+    const auto* data = reinterpret_cast<const unsigned char*>(content.data());
+
+    uint32_t hist[256];
+    byte_histogram(data, len, hist);
+    if (hist[0] != 0) {
+        return guess;  // Binary data
+    }
+
+    // Count features in one pass over the tokens
+    const FeatureTable& tokens = token_table();
+    const FeatureTable& line_starts = line_start_table();
+    std::array<uint32_t, std::size(TOKEN_FEATURES)> token_counts{};
+    std::array<uint32_t, std::size(LINE_START_FEATURES)> line_start_counts{};
+    uint32_t line_end_counts[256] = {};
+
+    bool at_line_start = true;
+    unsigned char last = 0;  // Last non-space byte of the line
+    size_t i = 0;
+    while (i < len) {
+        uint8_t cls = CHAR_CLASSES[data[i]];
+        if (cls == NEWLINE) {
+            line_end_counts[last]++;
+            at_line_start = true;
+            last = 0;
+            ++i;
+            continue;
+        }
+        if (cls == SPACE) {
+            ++i;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < len && CHAR_CLASSES[data[i]] == cls) {
+            ++i;
+        }
+        last = data[i - 1];
+
+        if (cls == WORD) {
+            while (start < i && data[start] >= '0' && data[start] <= '9') {
+                ++start;
+            }
+        }
+        if (start < i) {
+            size_t n = i - start;
+            uint64_t h = hash_token(data + start, n);
+            int32_t feature = tokens.find(h, data + start, n);
+            if (feature >= 0) {
+                token_counts[feature]++;
+            }
+            if (at_line_start) {
+                feature = line_starts.find(h, data + start, n);
+                if (feature >= 0) {
+                    line_start_counts[feature]++;
+                }
+            }
+        }
+        at_line_start = false;
+    }
+    line_end_counts[last]++;
+
+    float scores[NUM_LANGS];
+    std::fill(std::begin(scores), std::end(scores), LANG_PRIOR);
+    for (size_t f = 0; f < token_counts.size(); ++f) {
+        add_weights(scores, TOKEN_FEATURES[f].weights, token_counts[f]);
+    }
+    for (size_t f = 0; f < line_start_counts.size(); ++f) {
+        add_weights(scores, LINE_START_FEATURES[f].weights, line_start_counts[f]);
+    }
+    for (const auto& feature : LINE_END_FEATURES) {
+        add_weights(scores, feature.weights, line_end_counts[feature.byte]);
+    }
+    for (const auto& feature : BYTE_FEATURES) {
+        add_weights(scores, feature.weights, hist[feature.byte]);
+    }
+
+    // Softmax over the languages and plain text, which scores 0
+    int best_lang = -1;
+    float best = 0.0f;
+    for (int lang = 0; lang < NUM_LANGS; ++lang) {
+        if (scores[lang] > best) {
+            best = scores[lang];
+            best_lang = lang;
+        }
+    }
+    float total = std::exp(-best);
+    for (float score : scores) {
+        total += std::exp(score - best);
+    }
+
+    if (best_lang >= 0) {
+        guess.language = LANG_NAMES[best_lang];
+    }
+    guess.confidence = 1.0f / total;
+    return guess;
+}
+
 std::string LanguageDetector::from_extension(const std::string& filename) {
     if (filename.empty()) {
         return "";
@@ -0,0 +1,49 @@
+#include <dam/llm/batch_journal.hpp>
+
+namespace dam::llm {
+
+Result<BatchJournal> BatchJournal::open(const fs::path& path) {
+    BatchJournal journal;
+    journal.path_ = path;
+
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        size_t begin = 0;
+        for (size_t end; (end = data.find('\n', begin)) != std::string::npos; begin = end + 1) {
+            std::string key = data.substr(begin, end - begin);
+            if (!key.empty() && key.back() == '\r') key.pop_back();
+            if (!key.empty()) journal.done_.insert(std::move(key));
+        }
+        if (begin < data.size()) {
+            // Drop the torn line, so the next key starts a line of its own
+            std::error_code ec;
+            fs::resize_file(path, begin, ec);
+            if (ec) {
+                return Error(ErrorCode::IO_ERROR, "Cannot repair journal " + path.string() +
+                             ": " + ec.message());
+            }
+        }
+    }
+
+    journal.file_.open(path, std::ios::binary | std::ios::app);
+    if (!journal.file_) {
+        return Error(ErrorCode::IO_ERROR, "Cannot write journal " + path.string());
+    }
+    return journal;
+}
+
+Result<void> BatchJournal::record(const std::string& key) {
+    if (key.empty() || key.find('\n') != std::string::npos) {
+        return Error(ErrorCode::INVALID_ARGUMENT, "Invalid journal key");
+    }
+    file_ << key << '\n';
+    file_.flush();
+    if (!file_) {
+        return Error(ErrorCode::IO_ERROR, "Failed to write journal " + path_.string());
+    }
+    done_.insert(key);
+    return Ok();
+}
+
+}  // namespace dam::llm
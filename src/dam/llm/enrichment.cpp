@@ -0,0 +1,553 @@
+#include <dam/llm/enrichment.hpp>
+#include <dam/util/serializer.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+namespace dam::llm {
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC = 0x434E4544;  // "DENC"
+constexpr uint32_t CACHE_VERSION = 1;
+
+// Only the start of long snippets is sent to the model
+constexpr size_t MAX_PROMPT_CONTENT = 4000;
+constexpr size_t MAX_TAG_LENGTH = 32;
+
+int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r\n\"'`*");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n\"'`*");
+    return s.substr(begin, end - begin + 1);
+}
+
+// Strip a case-insensitive "label:" prefix, if present
+bool take_label(std::string& line, const std::string& label) {
+    if (line.size() <= label.size() || line[label.size()] != ':') return false;
+    for (size_t i = 0; i < label.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(line[i])) != label[i]) return false;
+    }
+    line = trim(line.substr(label.size() + 1));
+    return true;
+}
+
+}  // namespace
+
+// ============================================================================
+// EnrichmentCache
+// ============================================================================
+
+Result<EnrichmentCache> EnrichmentCache::load(const fs::path& path) {
+    EnrichmentCache cache;
+    cache.path_ = path;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return cache;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    auto corrupt = [&path]() {
+        return Error(ErrorCode::CORRUPTION, "Invalid enrichment cache: " + path.string());
+    };
+
+    BinaryReader reader(data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t count = 0;
+    if (!reader.read_uint32(&magic) || magic != CACHE_MAGIC ||
+        !reader.read_uint32(&version) || version != CACHE_VERSION ||
+        !reader.read_uint32(&count)) {
+        return corrupt();
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t key = 0;
+        Enrichment entry;
+        uint32_t tag_count = 0;
+        if (!reader.read_uint64(&key) || !reader.read_string(&entry.description) ||
+            !reader.read_uint32(&tag_count) || !reader.has_remaining(tag_count * sizeof(uint32_t))) {
+            return corrupt();
+        }
+        entry.tags.resize(tag_count);
+        for (auto& tag : entry.tags) {
+            if (!reader.read_string(&tag)) {
+                return corrupt();
+            }
+        }
+        cache.entries_[key] = std::move(entry);
+    }
+    return cache;
+}
+
+Result<void> EnrichmentCache::save() {
+    if (!dirty_) {
+        return Ok();
+    }
+
+    BinaryWriter writer;
+    writer.write_uint32(CACHE_MAGIC);
+    writer.write_uint32(CACHE_VERSION);
+    writer.write_uint32(static_cast<uint32_t>(entries_.size()));
+    for (const auto& [key, entry] : entries_) {
+        writer.write_uint64(key);
+        writer.write_string(entry.description);
+        writer.write_uint32(static_cast<uint32_t>(entry.tags.size()));
+        for (const auto& tag : entry.tags) {
+            writer.write_string(tag);
+        }
+    }
+
+    fs::path tmp = path_;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return Error(ErrorCode::IO_ERROR, "Failed to create enrichment cache: " + tmp.string());
+        }
+        file.write(writer.data().data(), static_cast<std::streamsize>(writer.size()));
+        if (!file.good()) {
+            return Error(ErrorCode::IO_ERROR, "Failed to write enrichment cache: " + tmp.string());
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, path_, ec);
+    if (ec) {
+        return Error(ErrorCode::IO_ERROR, "Failed to write enrichment cache: " + ec.message());
+    }
+    dirty_ = false;
+    return Ok();
+}
+
+const Enrichment* EnrichmentCache::find(uint64_t key) const {
+    auto it = entries_.find(key);
+    return it == entries_.end() ? nullptr : &it->second;
+}
+
+void EnrichmentCache::put(uint64_t key, Enrichment enrichment) {
+    entries_[key] = std::move(enrichment);
+    dirty_ = true;
+}
+
+// ============================================================================
+// Response parsing
+// ============================================================================
+
+Enrichment parse_enrichment(const std::string& text, size_t max_tags) {
+    Enrichment enrichment;
+    std::string tag_line;
+    std::string first_line;
+
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        line = trim(line);
+        if (line.empty()) continue;
+        if (take_label(line, "description")) {
+            enrichment.description = line;
+        } else if (take_label(line, "tags")) {
+            tag_line = line;
+        } else if (first_line.empty()) {
+            first_line = line;
+        }
+    }
+    if (enrichment.description.empty()) {
+        enrichment.description = first_line;
+    }
+
+    std::istringstream tags(tag_line);
+    std::string tag;
+    while (std::getline(tags, tag, ',') && enrichment.tags.size() < max_tags) {
+        tag = trim(tag);
+        if (!tag.empty() && tag[0] == '#') tag.erase(0, 1);
+        for (char& c : tag) {
+            c = c == ' ' ? '-' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        if (tag.empty() || tag.size() > MAX_TAG_LENGTH ||
+            std::find(enrichment.tags.begin(), enrichment.tags.end(), tag) != enrichment.tags.end()) {
+            continue;
+        }
+        enrichment.tags.push_back(tag);
+    }
+    return enrichment;
+}
+
+// ============================================================================
+// EnrichmentWorker
+// ============================================================================
+
+EnrichmentWorker::EnrichmentWorker(SnippetStore& store, LLMRouter& router,
+                                   EnrichmentOptions options)
+    : store_(store)
+    , router_(router)
+    , options_(std::move(options)) {
+    options_.batch_size = std::max<size_t>(1, options_.batch_size);
+    options_.max_duty_cycle = std::clamp(options_.max_duty_cycle, 0.01, 1.0);
+}
+
+EnrichmentWorker::~EnrichmentWorker() {
+    if (started_) {
+        (void)stop();
+    }
+}
+
+Result<void> EnrichmentWorker::start() {
+    if (started_) {
+        return Ok();
+    }
+
+    auto cache = EnrichmentCache::load(store_.get_root_directory() / "enrichment.cache");
+    if (!cache.ok()) {
+        return cache.error();
+    }
+    cache_ = std::move(cache.value());
+    failures_.clear();
+
+    stopping_ = false;
+    started_ = true;
+    next_scan_ = {};
+    thread_ = std::thread([this]() { run(); });
+    return Ok();
+}
+
+Result<void> EnrichmentWorker::stop() {
+    if (!started_) {
+        return Ok();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (const auto& job : pending_) {
+            for (SnippetId id : job.ids) {
+                in_progress_.erase(id);
+            }
+        }
+        pending_.clear();
+    }
+    wake_.notify_all();
+    thread_.join();
+    started_ = false;
+
+    auto applied = apply_finished();
+    auto saved = cache_.save();
+    if (!applied.ok()) {
+        return applied.error();
+    }
+    return saved;
+}
+
+void EnrichmentWorker::notify_activity() {
+    last_activity_ms_.store(now_ms(), std::memory_order_relaxed);
+}
+
+bool EnrichmentWorker::busy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !in_progress_.empty() || !finished_.empty();
+}
+
+EnrichmentWorker::Stats EnrichmentWorker::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+Result<size_t> EnrichmentWorker::poll() {
+    auto applied = apply_finished();
+    if (!applied.ok()) {
+        return applied;
+    }
+    auto queued = queue_pending();
+    if (!queued.ok()) {
+        return queued;
+    }
+
+    auto saved = cache_.save();
+    if (!saved.ok()) {
+        return saved.error();
+    }
+    return *applied + *queued;
+}
+
+// ----------------------------------------------------------------------------
+// Owner thread: store access
+// ----------------------------------------------------------------------------
+
+Result<size_t> EnrichmentWorker::apply_finished() {
+    std::vector<Done> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished.swap(finished_);
+    }
+
+    size_t updated = 0;
+    for (auto& done : finished) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (SnippetId id : done.job.ids) {
+                in_progress_.erase(id);
+            }
+        }
+        if (!done.ok) {
+            // Retried on a later scan once the backoff has passed
+            Failure& failure = failures_[done.job.key];
+            ++failure.count;
+            failure.retry_at = std::chrono::steady_clock::now() +
+                               options_.rescan_interval * (1 << std::min<size_t>(failure.count - 1, 16));
+            if (failure.count == options_.max_failures) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.abandoned;
+            }
+            continue;
+        }
+        failures_.erase(done.job.key);
+
+        cache_.put(done.job.key, done.enrichment);
+        for (SnippetId id : done.job.ids) {
+            auto applied = apply(id, done.job.key, done.enrichment);
+            if (!applied.ok()) {
+                return applied.error();
+            }
+            updated += *applied ? 1 : 0;
+        }
+    }
+    return updated;
+}
+
+Result<bool> EnrichmentWorker::apply(SnippetId id, uint64_t key, const Enrichment& enrichment) {
+    auto snippet = store_.get(id);
+    if (!snippet.ok()) {
+        if (snippet.error_code() == ErrorCode::NOT_FOUND) {
+            return false;  // Removed meanwhile
+        }
+        return snippet.error();
+    }
+    auto& s = snippet.value();
+
+    if (EnrichmentCache::key(s.checksum, s.content.size()) != key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.stale;
+        return false;
+    }
+
+    // Never overwrite what the user wrote
+    bool changed = false;
+    std::string description = s.description;
+    std::vector<std::string> tags = s.tags;
+    if (options_.describe && description.empty() && !enrichment.description.empty()) {
+        description = enrichment.description;
+        changed = true;
+    }
+    if (options_.tag && tags.empty() && !enrichment.tags.empty()) {
+        tags = enrichment.tags;
+        changed = true;
+    }
+    if (!changed) {
+        return false;
+    }
+
+    auto updated = store_.annotate(s.id, description, tags);
+    if (!updated.ok()) {
+        return updated.error();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.updated;
+    return true;
+}
+
+Result<size_t> EnrichmentWorker::queue_pending() {
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!pending_.empty() || now < next_scan_) {
+            return size_t{0};
+        }
+    }
+
+    // Bounds the content held in memory for the worker
+    const size_t limit = options_.batch_size * 4;
+
+    struct Candidate {
+        SnippetId id;
+        uint64_t key;
+    };
+    std::vector<Candidate> candidates;
+    bool more = false;
+    {
+        ScanOptions scan;
+        scan.with_content = false;
+        auto cursor = store_.scan(scan);
+        if (!cursor.ok()) {
+            return cursor.error();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (cursor->next()) {
+            const auto& s = cursor->snippet();
+            if (SnippetStore::is_pack_snippet(s.id)) {
+                break;  // Packs come last and are read-only
+            }
+            bool wanted = (options_.describe && s.description.empty()) ||
+                          (options_.tag && s.tags.empty());
+            if (!wanted || in_progress_.count(s.id)) {
+                continue;
+            }
+
+            uint64_t key = EnrichmentCache::key(s.checksum, cursor->content_size());
+            auto failure = failures_.find(key);
+            if (failure != failures_.end() &&
+                (failure->second.count >= options_.max_failures || now < failure->second.retry_at)) {
+                continue;
+            }
+            if (!cache_.find(key) && candidates.size() >= limit) {
+                more = true;
+                continue;
+            }
+            candidates.push_back({s.id, key});
+        }
+    }
+
+    // The cursor is closed: the store may be updated now
+    size_t updated = 0;
+    std::vector<Job> jobs;
+    std::unordered_map<uint64_t, size_t> job_for_key;  // Copies share one call
+    for (const auto& candidate : candidates) {
+        if (const Enrichment* cached = cache_.find(candidate.key)) {
+            auto applied = apply(candidate.id, candidate.key, *cached);
+            if (!applied.ok()) {
+                return applied.error();
+            }
+            if (*applied) {
+                ++updated;
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.from_cache;
+            }
+            continue;
+        }
+
+        auto shared = job_for_key.find(candidate.key);
+        if (shared != job_for_key.end()) {
+            jobs[shared->second].ids.push_back(candidate.id);
+            continue;
+        }
+
+        auto snippet = store_.get(candidate.id);
+        if (!snippet.ok()) {
+            continue;
+        }
+        auto& s = snippet.value();
+        Job job{{s.id}, candidate.key, s.name, s.language, std::move(s.content)};
+        if (job.content.size() > MAX_PROMPT_CONTENT) {
+            job.content.resize(MAX_PROMPT_CONTENT);
+        }
+        job_for_key.emplace(candidate.key, jobs.size());
+        jobs.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& job : jobs) {
+            in_progress_.insert(job.ids.begin(), job.ids.end());
+            pending_.push_back(std::move(job));
+        }
+        stats_.queued += jobs.size();
+        next_scan_ = more ? now : now + options_.rescan_interval;
+    }
+    if (!jobs.empty()) {
+        wake_.notify_all();
+    }
+    return updated;
+}
+
+// ----------------------------------------------------------------------------
+// Worker thread: model calls only
+// ----------------------------------------------------------------------------
+
+void EnrichmentWorker::run() {
+    using std::chrono::milliseconds;
+    milliseconds slow_rest{0};
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+
+        // Stay out of the way while the store is in interactive use
+        while (!stopping_) {
+            int64_t idle = now_ms() - last_activity_ms_.load(std::memory_order_relaxed);
+            if (idle >= options_.idle_delay.count()) break;
+            wake_.wait_for(lock, milliseconds(options_.idle_delay.count() - idle));
+        }
+        if (stopping_) break;
+
+        std::vector<Job> batch;
+        while (!pending_.empty() && batch.size() < options_.batch_size) {
+            batch.push_back(std::move(pending_.front()));
+            pending_.pop_front();
+        }
+        lock.unlock();
+
+        std::vector<CompletionRequest> requests;
+        requests.reserve(batch.size());
+        for (const auto& job : batch) {
+            requests.push_back(make_request(job));
+        }
+
+        BatchOptions batch_options;
+        batch_options.max_attempts = 2;
+        auto started = std::chrono::steady_clock::now();
+        auto results = router_.complete_batch(requests, batch_options);
+        auto busy = std::chrono::duration_cast<milliseconds>(
+            std::chrono::steady_clock::now() - started);
+
+        lock.lock();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            Done done;
+            done.ok = results[i].ok();
+            if (done.ok) {
+                done.enrichment = parse_enrichment(results[i]->content, options_.max_tags);
+                ++stats_.generated;
+            } else {
+                ++stats_.failed;
+            }
+            done.job = std::move(batch[i]);
+            finished_.push_back(std::move(done));
+        }
+
+        // Rest so the worker is busy at most max_duty_cycle of the time,
+        // and back off further while the backend answers slowly
+        double duty = options_.max_duty_cycle;
+        auto rest = milliseconds(static_cast<int64_t>(busy.count() * (1.0 - duty) / duty));
+        if (busy / static_cast<int64_t>(batch.size()) > options_.latency_budget) {
+            slow_rest = std::min(options_.max_rest,
+                                 std::max(rest, slow_rest * 2 + milliseconds(1000)));
+        } else {
+            slow_rest = milliseconds(0);
+        }
+        rest = std::min(options_.max_rest, std::max(rest, slow_rest));
+        wake_.wait_for(lock, rest, [this]() { return stopping_; });
+    }
+}
+
+CompletionRequest EnrichmentWorker::make_request(const Job& job) const {
+    std::ostringstream msg;
+    if (!job.language.empty()) {
+        msg << "Language: " << job.language << "\n";
+    }
+    msg << "Name: " << job.name << "\n\n" << job.content;
+
+    CompletionRequest request;
+    request.system_prompt = prompts::ENRICH_SNIPPET;
+    request.messages = {Message::user(msg.str())};
+    request.max_tokens = 96;
+    request.temperature = 0.2f;
+    return request;
+}
+
+}  // namespace dam::llm
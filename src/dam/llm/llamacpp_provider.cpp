@@ -1,14 +1,133 @@
 #include <dam/llm/llamacpp_provider.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <sstream>
 
+namespace dam::llm {
+
+// ============================================================================
+// Context Window and KV Cache Arithmetic
+// ============================================================================
+
+KVCacheTypes kv_cache_types(const LlamaCppConfig& config) {
+    // llama.cpp can only quantize the V cache with flash attention
+    return {config.kv_cache_type, config.flash_attn ? config.kv_cache_type : KVCacheType::F16};
+}
+
+Result<KVCacheType> parse_kv_cache_type(const std::string& name) {
+    if (name == "f16") {
+        return KVCacheType::F16;
+    }
+    if (name == "q8_0" || name == "q8") {
+        return KVCacheType::Q8_0;
+    }
+    if (name == "q4_0" || name == "q4") {
+        return KVCacheType::Q4_0;
+    }
+    return Error(ErrorCode::INVALID_ARGUMENT,
+        "KV cache type must be f16, q8_0 or q4_0, not '" + name + "'");
+}
+
+size_t context_keep_tokens(size_t prefix_tokens, size_t n_ctx) {
+    return std::min(prefix_tokens, n_ctx / 2);
+}
+
+size_t context_shift_discard(size_t n_tokens, size_t n_keep) {
+    return n_tokens > n_keep ? (n_tokens - n_keep) / 2 : 0;
+}
+
+size_t context_window_offset(size_t n_tokens, size_t n_keep, size_t n_ctx, int max_tokens) {
+    size_t reserve = std::min(static_cast<size_t>(std::max(max_tokens, 0)), n_ctx / 4);
+    size_t room = n_ctx - std::min(n_ctx, n_keep + reserve);
+    size_t after_keep = n_tokens - std::min(n_tokens, n_keep);
+    return after_keep > room ? after_keep - room : 0;
+}
+
+// Configuration from the environment is read the same with or without
+// llama.cpp; create() fails in a build without it
+Result<std::unique_ptr<LlamaCppProvider>> LlamaCppProvider::create_from_env() {
+    LlamaCppConfig config;
+
+    if (const char* path = std::getenv("DAM_LLAMACPP_MODEL_PATH")) {
+        config.model_path = path;
+    } else {
+        return Error(ErrorCode::INVALID_ARGUMENT,
+            "DAM_LLAMACPP_MODEL_PATH environment variable not set");
+    }
+
+    if (const char* ctx = std::getenv("DAM_LLAMACPP_CTX_SIZE")) {
+        config.n_ctx = std::atoi(ctx);
+    }
+
+    if (const char* threads = std::getenv("DAM_LLAMACPP_THREADS")) {
+        config.n_threads = std::atoi(threads);
+        config.n_threads_batch = config.n_threads;
+    }
+
+    if (const char* gpu = std::getenv("DAM_LLAMACPP_GPU_LAYERS")) {
+        config.n_gpu_layers = std::atoi(gpu);
+    }
+
+    if (const char* kv = std::getenv("DAM_LLAMACPP_KV_CACHE")) {
+        auto type = parse_kv_cache_type(kv);
+        if (!type.ok()) {
+            return Error(ErrorCode::INVALID_ARGUMENT,
+                "DAM_LLAMACPP_KV_CACHE must be f16, q8_0 or q4_0");
+        }
+        config.kv_cache_type = *type;
+    }
+
+    if (const char* flash = std::getenv("DAM_LLAMACPP_FLASH_ATTN")) {
+        config.flash_attn = std::atoi(flash) != 0;
+    }
+
+    if (const char* shift = std::getenv("DAM_LLAMACPP_CONTEXT_SHIFT")) {
+        config.context_shift = std::atoi(shift) != 0;
+    }
+
+    return create(std::move(config));
+}
+
+}  // namespace dam::llm
+
 #ifdef DAM_HAS_LLAMACPP
 
 namespace dam::llm {
 
+namespace {
+
+ggml_type to_ggml_type(KVCacheType type) {
+    switch (type) {
+        case KVCacheType::Q8_0: return GGML_TYPE_Q8_0;
+        case KVCacheType::Q4_0: return GGML_TYPE_Q4_0;
+        case KVCacheType::F16:  break;
+    }
+    return GGML_TYPE_F16;
+}
+
+// Attention heads holding keys and values. Grouped-query attention models
+// have fewer than n_head; the count is only in the GGUF metadata.
+int64_t n_head_kv(const llama_model* model) {
+    char arch[64];
+    char value[32];
+    if (llama_model_meta_val_str(model, "general.architecture", arch, sizeof(arch)) > 0) {
+        std::string key = std::string(arch) + ".attention.head_count_kv";
+        if (llama_model_meta_val_str(model, key.c_str(), value, sizeof(value)) > 0) {
+            // Per-layer counts are an array; those fall back to n_head
+            int64_t n = std::atoll(value);
+            if (n > 0) {
+                return n;
+            }
+        }
+    }
+    return llama_model_n_head(model);
+}
+
+}  // namespace
+
 LlamaCppProvider::LlamaCppProvider(LlamaCppConfig config)
     : config_(std::move(config)) {}
 
@@ -22,7 +141,12 @@ LlamaCppProvider::LlamaCppProvider(LlamaCppProvider&& other) noexcept
     , context_(other.context_)
     , sampler_(other.sampler_)
     , initialized_(other.initialized_.load())
-    , abort_requested_(other.abort_requested_.load()) {
+    , abort_requested_(other.abort_requested_.load())
+    , kv_tokens_(std::move(other.kv_tokens_))
+    , keep_tokens_(other.keep_tokens_)
+    , window_offset_(other.window_offset_)
+    , kv_cache_bytes_(other.kv_cache_bytes_)
+    , can_shift_(other.can_shift_) {
     other.model_ = nullptr;
     other.context_ = nullptr;
     other.sampler_ = nullptr;
@@ -38,6 +162,11 @@ LlamaCppProvider& LlamaCppProvider::operator=(LlamaCppProvider&& other) noexcept
         sampler_ = other.sampler_;
         initialized_ = other.initialized_.load();
         abort_requested_ = other.abort_requested_.load();
+        kv_tokens_ = std::move(other.kv_tokens_);
+        keep_tokens_ = other.keep_tokens_;
+        window_offset_ = other.window_offset_;
+        kv_cache_bytes_ = other.kv_cache_bytes_;
+        can_shift_ = other.can_shift_;
         other.model_ = nullptr;
         other.context_ = nullptr;
         other.sampler_ = nullptr;
@@ -78,7 +207,7 @@ Result<void> LlamaCppProvider::initialize() {
     model_params.use_mmap = config_.use_mmap;
     model_params.use_mlock = config_.use_mlock;
 
-    model_ = llama_load_model_from_file(config_.model_path.c_str(), model_params);
+    model_ = llama_model_load_from_file(config_.model_path.c_str(), model_params);
     if (!model_) {
         return Error(ErrorCode::IO_ERROR,
             "Failed to load model: " + config_.model_path);
@@ -91,14 +220,32 @@ Result<void> LlamaCppProvider::initialize() {
     ctx_params.n_threads = config_.n_threads;
     ctx_params.n_threads_batch = config_.n_threads_batch;
     ctx_params.flash_attn = config_.flash_attn;
+    KVCacheTypes kv_types = kv_cache_types(config_);
+    ctx_params.type_k = to_ggml_type(kv_types.k);
+    ctx_params.type_v = to_ggml_type(kv_types.v);
 
-    context_ = llama_new_context_with_model(model_, ctx_params);
+    context_ = llama_init_from_model(model_, ctx_params);
     if (!context_) {
-        llama_free_model(model_);
+        llama_model_free(model_);
         model_ = nullptr;
         return Error(ErrorCode::INTERNAL_ERROR, "Failed to create context");
     }
 
+    kv_tokens_.clear();
+    keep_tokens_ = 0;
+    window_offset_ = 0;
+    can_shift_ = llama_kv_cache_can_shift(context_);
+
+    // One key and one value row per layer for every context cell
+    int64_t n_head = llama_model_n_head(model_);
+    int64_t n_embd_kv = llama_model_n_embd(model_);
+    if (n_head > 0) {
+        n_embd_kv = n_embd_kv / n_head * n_head_kv(model_);
+    }
+    kv_cache_bytes_ = static_cast<size_t>(llama_model_n_layer(model_)) * llama_n_ctx(context_) *
+                      (ggml_row_size(ctx_params.type_k, n_embd_kv) +
+                       ggml_row_size(ctx_params.type_v, n_embd_kv));
+
     // Create sampler chain
     sampler_ = llama_sampler_chain_init(llama_sampler_chain_default_params());
 
@@ -120,10 +267,12 @@ void LlamaCppProvider::shutdown() {
     }
 
     if (model_) {
-        llama_free_model(model_);
+        llama_model_free(model_);
         model_ = nullptr;
     }
 
+    kv_tokens_.clear();
+    kv_cache_bytes_ = 0;
     initialized_ = false;
 }
 
@@ -141,10 +290,18 @@ Result<CompletionResult> LlamaCppProvider::complete(const CompletionRequest& req
 
     auto start_time = std::chrono::steady_clock::now();
     CompletionResult result;
+    const size_t n_ctx = static_cast<size_t>(config_.n_ctx);
+    const bool shifting = config_.context_shift && can_shift_;
 
-    // Build and tokenize prompt
+    // Build and tokenize prompt. The system prefix is tokenized on its own
+    // so its tokens do not depend on what follows and can be kept in place
+    // when the context shifts.
+    std::string prefix = build_system_prefix(request);
     std::string prompt = build_prompt(request);
-    std::vector<llama_token> tokens = tokenize(prompt, true);
+    std::vector<llama_token> tokens = tokenize(prefix, true);
+    size_t keep = context_keep_tokens(tokens.size(), n_ctx);
+    std::vector<llama_token> body = tokenize(prompt.substr(prefix.size()), false);
+    tokens.insert(tokens.end(), body.begin(), body.end());
 
     if (tokens.empty()) {
         return Error(ErrorCode::INVALID_ARGUMENT, "Empty prompt");
@@ -153,56 +310,81 @@ Result<CompletionResult> LlamaCppProvider::complete(const CompletionRequest& req
     result.prompt_tokens = static_cast<int>(tokens.size());
 
     // Check context length
-    if (tokens.size() > static_cast<size_t>(config_.n_ctx)) {
+    if (tokens.size() > n_ctx && !shifting) {
         return Error(ErrorCode::INVALID_ARGUMENT,
             "Prompt exceeds context length: " + std::to_string(tokens.size()) +
             " > " + std::to_string(config_.n_ctx));
     }
 
-    // Clear KV cache
-    llama_kv_cache_clear(context_);
-
-    // Process prompt in batches
-    llama_batch batch = llama_batch_init(config_.n_batch, 0, 1);
-
-    for (size_t i = 0; i < tokens.size(); i += config_.n_batch) {
-        if (abort_requested_) {
-            llama_batch_free(batch);
-            result.stop_reason = "aborted";
-            return result;
+    // Keep the cached tokens that match this prompt: KV position p holds
+    // tokens[p] within the system prefix, tokens[window_offset_ + p] after
+    size_t reuse = 0;
+    size_t offset = 0;
+    if (keep == keep_tokens_ && kv_tokens_.size() >= keep &&
+        std::equal(tokens.begin(), tokens.begin() + keep, kv_tokens_.begin())) {
+        reuse = keep;
+        offset = window_offset_;
+        while (reuse < kv_tokens_.size() && offset + reuse < tokens.size() &&
+               kv_tokens_[reuse] == tokens[offset + reuse]) {
+            ++reuse;
         }
+    }
 
-        size_t n_tokens = std::min(static_cast<size_t>(config_.n_batch),
-                                   tokens.size() - i);
+    // A fresh window puts the prompt's end in the context with room left
+    // to generate. It is used when decoding it costs less than continuing
+    // the cached window, which would decode tokens only to shift them out.
+    size_t fresh_offset = shifting
+        ? context_window_offset(tokens.size(), keep, n_ctx, request.max_tokens)
+        : 0;
+    if (reuse <= keep || tokens.size() - (offset + reuse) > tokens.size() - (fresh_offset + keep)) {
+        reuse = std::min(reuse, keep);
+        offset = fresh_offset;
+    }
+    // The last prompt token is decoded again for fresh logits
+    if (offset + reuse >= tokens.size()) {
+        reuse = tokens.size() - offset - 1;
+    }
 
-        // Clear batch
-        batch.n_tokens = 0;
-        // Add tokens to batch
-        for (size_t j = 0; j < n_tokens; ++j) {
-            batch.token[batch.n_tokens] = tokens[i + j];
-            batch.pos[batch.n_tokens] = static_cast<llama_pos>(i + j);
-            batch.n_seq_id[batch.n_tokens] = 1;
-            batch.seq_id[batch.n_tokens][0] = 0;
-            batch.logits[batch.n_tokens] = false;
-            batch.n_tokens++;
+    if (reuse == 0) {
+        clear_kv_cache();
+    } else if (reuse < kv_tokens_.size()) {
+        if (llama_kv_cache_seq_rm(context_, 0, static_cast<llama_pos>(reuse), -1)) {
+            kv_tokens_.resize(reuse);
+        } else {
+            clear_kv_cache();
+            reuse = 0;
         }
+    }
+    keep_tokens_ = keep;
+    window_offset_ = offset;
 
-        // Mark last token for logits
-        if (i + n_tokens == tokens.size()) {
-            batch.logits[batch.n_tokens - 1] = true;
-        }
+    std::vector<llama_token> pending(tokens.begin() + std::min(reuse, keep), tokens.begin() + keep);
+    pending.insert(pending.end(), tokens.begin() + offset + std::max(reuse, keep), tokens.end());
 
-        if (llama_decode(context_, batch) != 0) {
-            llama_batch_free(batch);
-            return Error(ErrorCode::INTERNAL_ERROR, "Failed to decode prompt");
-        }
+    // Process prompt in batches
+    llama_batch batch = llama_batch_init(config_.n_batch, 0, 1);
+
+    auto decoded = decode_tokens(batch, pending);
+    if (!decoded.ok()) {
+        llama_batch_free(batch);
+        return decoded.error();
+    }
+    if (abort_requested_) {
+        llama_batch_free(batch);
+        result.stop_reason = "aborted";
+        return result;
     }
 
     // Setup sampler for generation
-    setup_sampler(request);
+    auto sampler = setup_sampler(request);
+    if (!sampler.ok()) {
+        llama_batch_free(batch);
+        return sampler.error();
+    }
 
     // Generate tokens
-    int n_cur = static_cast<int>(tokens.size());
+    const auto* vocab = llama_model_get_vocab(model_);
+    StopController stop(request);
 
     while (result.completion_tokens < request.max_tokens) {
         if (abort_requested_) {
@@ -214,56 +396,48 @@ Result<CompletionResult> LlamaCppProvider::complete(const CompletionRequest& req
         llama_token new_token = llama_sampler_sample(sampler_, context_, -1);
 
         // Check for EOS
-        const auto* vocab = llama_model_get_vocab(model_);
         if (llama_vocab_is_eog(vocab, new_token)) {
             result.stop_reason = "eos";
             break;
         }
 
-        // Decode token to text
-        std::string piece = detokenize({new_token});
-        result.content += piece;
+        // Decode token to text; stop sequences and structure are matched
+        // incrementally as it arrives
+        bool done = stop.append(detokenize({new_token}));
         result.completion_tokens++;
 
-        // Check stop sequences
-        bool should_stop = false;
-        for (const auto& stop : request.stop_sequences) {
-            if (result.content.size() >= stop.size() &&
-                result.content.substr(result.content.size() - stop.size()) == stop) {
-                // Remove stop sequence from output
-                result.content = result.content.substr(0,
-                    result.content.size() - stop.size());
-                result.stop_reason = "stop_sequence";
-                should_stop = true;
-                break;
-            }
-        }
-        if (should_stop) break;
-
         // Stream callback
-        if (request.on_chunk && !request.on_chunk(piece)) {
+        if (!stop.stream(request.on_chunk)) {
             result.stop_reason = "aborted";
             break;
         }
+        if (done) {
+            result.stop_reason = stop.stop_reason();
+            break;
+        }
 
-        // Prepare next batch
-        batch.n_tokens = 0;
-        batch.token[batch.n_tokens] = new_token;
-        batch.pos[batch.n_tokens] = n_cur;
-        batch.n_seq_id[batch.n_tokens] = 1;
-        batch.seq_id[batch.n_tokens][0] = 0;
-        batch.logits[batch.n_tokens] = true;
-        batch.n_tokens++;
-        n_cur++;
+        if (kv_tokens_.size() >= n_ctx && !shifting) {
+            result.stop_reason = "context_full";
+            break;
+        }
 
-        if (llama_decode(context_, batch) != 0) {
+        auto next = decode_tokens(batch, {new_token});
+        if (!next.ok()) {
             llama_batch_free(batch);
-            return Error(ErrorCode::INTERNAL_ERROR, "Failed to decode token");
+            return next.error();
         }
     }
 
     llama_batch_free(batch);
 
+    if (result.stop_reason != "aborted") {
+        stop.finish();
+        if (!stop.stream(request.on_chunk)) {
+            result.stop_reason = "aborted";
+        }
+    }
+    result.content = stop.take_content();
+
     if (result.stop_reason.empty()) {
         result.stop_reason = "max_tokens";
     }
@@ -283,6 +457,79 @@ Result<CompletionResult> LlamaCppProvider::complete(const CompletionRequest& req
     return result;
 }
 
+Result<void> LlamaCppProvider::decode_tokens(llama_batch& batch,
+                                             const std::vector<llama_token>& tokens) {
+    const size_t n_ctx = static_cast<size_t>(config_.n_ctx);
+
+    for (size_t i = 0; i < tokens.size();) {
+        if (abort_requested_) {
+            return {};
+        }
+        if (kv_tokens_.size() >= n_ctx && !shift_context()) {
+            return Error(ErrorCode::INVALID_ARGUMENT,
+                "Context is full: " + std::to_string(config_.n_ctx) + " tokens");
+        }
+
+        size_t n_tokens = std::min({static_cast<size_t>(config_.n_batch),
+                                    tokens.size() - i, n_ctx - kv_tokens_.size()});
+
+        // Fill batch, appending after what the cache holds
+        batch.n_tokens = 0;
+        for (size_t j = 0; j < n_tokens; ++j) {
+            batch.token[batch.n_tokens] = tokens[i + j];
+            batch.pos[batch.n_tokens] = static_cast<llama_pos>(kv_tokens_.size() + j);
+            batch.n_seq_id[batch.n_tokens] = 1;
+            batch.seq_id[batch.n_tokens][0] = 0;
+            batch.logits[batch.n_tokens] = false;
+            batch.n_tokens++;
+        }
+
+        // Mark last token for logits
+        if (i + n_tokens == tokens.size()) {
+            batch.logits[batch.n_tokens - 1] = true;
+        }
+
+        if (llama_decode(context_, batch) != 0) {
+            clear_kv_cache();
+            return Error(ErrorCode::INTERNAL_ERROR, "Failed to decode tokens");
+        }
+        kv_tokens_.insert(kv_tokens_.end(), tokens.begin() + i, tokens.begin() + i + n_tokens);
+        i += n_tokens;
+    }
+    return {};
+}
+
+bool LlamaCppProvider::shift_context() {
+    if (!config_.context_shift || !can_shift_) {
+        return false;
+    }
+
+    // Drop the older half after the kept prefix and move the rest down;
+    // nothing is decoded again
+    size_t discard = context_shift_discard(kv_tokens_.size(), keep_tokens_);
+    if (discard == 0) {
+        return false;
+    }
+    auto keep = static_cast<llama_pos>(keep_tokens_);
+    auto n_discard = static_cast<llama_pos>(discard);
+    if (!llama_kv_cache_seq_rm(context_, 0, keep, keep + n_discard)) {
+        return false;
+    }
+    llama_kv_cache_seq_add(context_, 0, keep + n_discard,
+                           static_cast<llama_pos>(kv_tokens_.size()), -n_discard);
+
+    kv_tokens_.erase(kv_tokens_.begin() + keep_tokens_,
+                     kv_tokens_.begin() + keep_tokens_ + discard);
+    window_offset_ += discard;
+    return true;
+}
+
+void LlamaCppProvider::clear_kv_cache() {
+    llama_kv_cache_clear(context_);
+    kv_tokens_.clear();
+    window_offset_ = 0;
+}
+
 void LlamaCppProvider::abort() {
     abort_requested_ = true;
 }
@@ -328,13 +575,18 @@ std::string LlamaCppProvider::detokenize(const std::vector<int32_t>& tokens) {
     return result;
 }
 
+std::string LlamaCppProvider::build_system_prefix(const CompletionRequest& request) {
+    if (request.system_prompt.empty()) {
+        return "";
+    }
+    return "<|system|>\n" + request.system_prompt + "\n";
+}
+
 std::string LlamaCppProvider::build_prompt(const CompletionRequest& request) {
     std::ostringstream ss;
 
     // Use simple chat template compatible with most models
-    if (!request.system_prompt.empty()) {
-        ss << "<|system|>\n" << request.system_prompt << "\n";
-    }
+    ss << build_system_prefix(request);
 
     for (const auto& msg : request.messages) {
         switch (msg.role) {
@@ -354,11 +606,21 @@ std::string LlamaCppProvider::build_prompt(const CompletionRequest& request) {
     return ss.str();
 }
 
-void LlamaCppProvider::setup_sampler(const CompletionRequest& request) {
+Result<void> LlamaCppProvider::setup_sampler(const CompletionRequest& request) {
     // Reset sampler chain
     llama_sampler_free(sampler_);
     sampler_ = llama_sampler_chain_init(llama_sampler_chain_default_params());
 
+    // The grammar masks disallowed tokens before any other sampler
+    if (!request.grammar.empty()) {
+        llama_sampler* grammar = llama_sampler_init_grammar(
+            llama_model_get_vocab(model_), request.grammar.c_str(), "root");
+        if (!grammar) {
+            return Error(ErrorCode::INVALID_ARGUMENT, "Invalid GBNF grammar");
+        }
+        llama_sampler_chain_add(sampler_, grammar);
+    }
+
     // Add samplers in order
     llama_sampler_chain_add(sampler_,
         llama_sampler_init_top_k(request.top_k));
@@ -368,6 +630,7 @@ void LlamaCppProvider::setup_sampler(const CompletionRequest& request) {
         llama_sampler_init_temp(request.temperature));
     llama_sampler_chain_add(sampler_,
         llama_sampler_init_dist(LLAMA_DEFAULT_SEED));
+    return {};
 }
 
 Result<void> LlamaCppProvider::warmup() {
@@ -390,7 +653,7 @@ Result<void> LlamaCppProvider::warmup() {
 
 size_t LlamaCppProvider::memory_usage() const {
     if (!model_) return 0;
-    return llama_model_size(model_);
+    return llama_model_size(model_) + kv_cache_bytes_;
 }
 
 Result<std::unique_ptr<LlamaCppProvider>> LlamaCppProvider::create(LlamaCppConfig config) {
@@ -402,32 +665,6 @@ Result<std::unique_ptr<LlamaCppProvider>> LlamaCppProvider::create(LlamaCppConfi
     return provider;
 }
 
-Result<std::unique_ptr<LlamaCppProvider>> LlamaCppProvider::create_from_env() {
-    LlamaCppConfig config;
-
-    if (const char* path = std::getenv("DAM_LLAMACPP_MODEL_PATH")) {
-        config.model_path = path;
-    } else {
-        return Error(ErrorCode::INVALID_ARGUMENT,
-            "DAM_LLAMACPP_MODEL_PATH environment variable not set");
-    }
-
-    if (const char* ctx = std::getenv("DAM_LLAMACPP_CTX_SIZE")) {
-        config.n_ctx = std::atoi(ctx);
-    }
-
-    if (const char* threads = std::getenv("DAM_LLAMACPP_THREADS")) {
-        config.n_threads = std::atoi(threads);
-        config.n_threads_batch = config.n_threads;
-    }
-
-    if (const char* gpu = std::getenv("DAM_LLAMACPP_GPU_LAYERS")) {
-        config.n_gpu_layers = std::atoi(gpu);
-    }
-
-    return create(std::move(config));
-}
-
 }  // namespace dam::llm
 
 #else  // !DAM_HAS_LLAMACPP
@@ -482,17 +719,19 @@ std::string LlamaCppProvider::detokenize(const std::vector<int32_t>&) {
     return "";
 }
 
-std::string LlamaCppProvider::build_prompt(const CompletionRequest&) {
+std::string LlamaCppProvider::build_system_prefix(const CompletionRequest&) {
     return "";
 }
 
-void LlamaCppProvider::setup_sampler(const CompletionRequest&) {}
+std::string LlamaCppProvider::build_prompt(const CompletionRequest&) {
+    return "";
+}
 
-Result<std::unique_ptr<LlamaCppProvider>> LlamaCppProvider::create(LlamaCppConfig) {
+Result<void> LlamaCppProvider::setup_sampler(const CompletionRequest&) {
     return Error(ErrorCode::INTERNAL_ERROR, "llama.cpp not available");
 }
 
-Result<std::unique_ptr<LlamaCppProvider>> LlamaCppProvider::create_from_env() {
+Result<std::unique_ptr<LlamaCppProvider>> LlamaCppProvider::create(LlamaCppConfig) {
     return Error(ErrorCode::INTERNAL_ERROR, "llama.cpp not available");
 }
 
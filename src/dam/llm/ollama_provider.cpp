@@ -6,6 +6,7 @@
 #include <chrono>
 #include <cstdlib>
 #include <mutex>
+#include <optional>
 #include <sstream>
 
 namespace dam::llm {
@@ -16,8 +17,10 @@ using json = nlohmann::json;
 struct OllamaStreamState {
     StreamCallback callback;
     std::string buffer;
-    std::string accumulated_content;
+    StopController* stop = nullptr;
     std::atomic<bool>* abort_flag;
+    bool stopped = false;       // Stop condition met; transfer cut short
+    int chunks = 0;
     bool error_occurred = false;
     std::string error_message;
     int prompt_tokens = 0;
@@ -36,6 +39,17 @@ static size_t buffer_write_callback(char* ptr, size_t size, size_t nmemb, void*
     return total_size;
 }
 
+// Ollama answers 429, or 503 once its request queue is full, when busy
+static std::optional<Error> busy_error(CURL* curl) {
+    long http_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    if (http_code == 429 || http_code == 503) {
+        return Error(ErrorCode::RATE_LIMITED,
+            "Ollama is busy (HTTP " + std::to_string(http_code) + ")");
+    }
+    return std::nullopt;
+}
+
 OllamaProvider::OllamaProvider(OllamaConfig config)
     : config_(std::move(config)) {}
 
@@ -181,13 +195,24 @@ size_t OllamaProvider::write_callback(char* ptr, size_t size, size_t nmemb, void
                 return 0;
             }
 
-            if (j.contains("response")) {
-                std::string text = j["response"].get<std::string>();
-                state->accumulated_content += text;
-
-                if (state->callback && !state->callback(text)) {
+            // /api/chat streams message.content; /api/generate streams response
+            const json* text = nullptr;
+            if (j.contains("message") && j["message"].contains("content")) {
+                text = &j["message"]["content"];
+            } else if (j.contains("response")) {
+                text = &j["response"];
+            }
+            if (text) {
+                state->chunks++;
+                bool done = state->stop->append(text->get<std::string>());
+                if (!state->stop->stream(state->callback)) {
                     return 0;  // User aborted
                 }
+                if (done) {
+                    // Closing the connection makes Ollama stop generating
+                    state->stopped = true;
+                    return 0;
+                }
             }
 
             // Token counts from final response
@@ -265,7 +290,9 @@ Result<CompletionResult> OllamaProvider::complete(const CompletionRequest& reque
     reset_abort();
     auto start_time = std::chrono::steady_clock::now();
 
-    bool use_streaming = (request.on_chunk != nullptr);
+    // Stop conditions are checked as tokens arrive, so they need streaming
+    bool use_streaming = request.on_chunk != nullptr ||
+                         request.stop_mode != StopMode::NONE;
     std::string request_body = build_request_body(request, use_streaming);
 
     CURL* curl = static_cast<CURL*>(curl_handle_);
@@ -285,8 +312,10 @@ Result<CompletionResult> OllamaProvider::complete(const CompletionRequest& reque
     CompletionResult result;
 
     if (use_streaming) {
+        StopController stop(request);
         OllamaStreamState state;
         state.callback = request.on_chunk;
+        state.stop = &stop;
         state.abort_flag = &abort_requested_;
 
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
@@ -297,11 +326,11 @@ Result<CompletionResult> OllamaProvider::complete(const CompletionRequest& reque
 
         if (abort_requested_.load()) {
             result.stop_reason = "aborted";
-            result.content = state.accumulated_content;
+            result.content = stop.take_content();
             return result;
         }
 
-        if (res != CURLE_OK) {
+        if (res != CURLE_OK && !state.stopped) {
             if (res == CURLE_OPERATION_TIMEDOUT) {
                 return Error(ErrorCode::TIMEOUT, "Request timed out");
             }
@@ -309,14 +338,23 @@ Result<CompletionResult> OllamaProvider::complete(const CompletionRequest& reque
                 std::string("Network error: ") + curl_easy_strerror(res));
         }
 
+        if (auto busy = busy_error(curl)) {
+            return *busy;
+        }
+
         if (state.error_occurred) {
             return Error(ErrorCode::INTERNAL_ERROR, state.error_message);
         }
 
-        result.content = state.accumulated_content;
+        stop.finish();
+        if (!stop.stream(request.on_chunk)) {
+            result.stop_reason = "aborted";
+        } else {
+            result.stop_reason = stop.stopped() ? stop.stop_reason() : "eos";
+        }
+        result.content = stop.take_content();
         result.prompt_tokens = state.prompt_tokens;
-        result.completion_tokens = state.completion_tokens;
-        result.stop_reason = "eos";
+        result.completion_tokens = state.stopped ? state.chunks : state.completion_tokens;
     } else {
         ResponseBuffer response;
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, buffer_write_callback);
@@ -333,6 +371,10 @@ Result<CompletionResult> OllamaProvider::complete(const CompletionRequest& reque
                 std::string("Network error: ") + curl_easy_strerror(res));
         }
 
+        if (auto busy = busy_error(curl)) {
+            return *busy;
+        }
+
         try {
             auto j = json::parse(response.data);
 
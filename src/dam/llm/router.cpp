@@ -1,6 +1,7 @@
 #include <dam/llm/router.hpp>
 
 #include <algorithm>
+#include <deque>
 #include <functional>
 #include <limits>
 #include <sstream>
@@ -71,14 +72,190 @@ std::string LLMRouter::active_provider_name() const {
 }
 
 Result<CompletionResult> LLMRouter::complete(const CompletionRequest& request) {
+    std::string key = cache_key(request);
+
     // Check cache first
     if (config_.enable_cache) {
-        std::string key = cache_key(request);
         if (auto cached = get_cached(key)) {
             return *cached;
         }
     }
 
+    if (config_.enable_coalescing) {
+        return complete_coalesced(key, request);
+    }
+
+    auto result = complete_with_fallback(request);
+    if (result.ok() && config_.enable_cache) {
+        cache_result(key, result.value());
+    }
+    return result;
+}
+
+Result<CompletionResult> LLMRouter::complete_coalesced(
+    const std::string& key,
+    const CompletionRequest& request) {
+
+    std::shared_ptr<InFlight> flight;
+    bool leader = false;
+    {
+        std::lock_guard<std::mutex> lock(in_flight_mutex_);
+        auto& slot = in_flight_[key];
+        if (!slot) {
+            slot = std::make_shared<InFlight>();
+            leader = true;
+        }
+        flight = slot;
+    }
+    if (!leader) {
+        // Another caller is already generating this
+        return join_flight(*flight, request.on_chunk);
+    }
+    return lead_flight(flight, key, request);
+}
+
+Result<CompletionResult> LLMRouter::lead_flight(const std::shared_ptr<InFlight>& flight,
+                                                const std::string& key,
+                                                const CompletionRequest& request) {
+    // Run the request once, on this thread. Its chunks are fanned out to
+    // every caller only if this one streams; otherwise the provider is
+    // called as it would be without coalescing.
+    std::shared_ptr<InFlight::Subscriber> own;
+    CompletionRequest generation = request;
+    {
+        std::lock_guard<std::mutex> lock(flight->mutex);
+        flight->participants++;
+        if (request.on_chunk) {
+            own = std::make_shared<InFlight::Subscriber>();
+            own->callback = request.on_chunk;
+            flight->subscribers.push_back(own);
+            flight->streaming = true;
+            generation.on_chunk = [flight](const std::string& chunk) {
+                return fan_out(*flight, chunk);
+            };
+        }
+    }
+
+    auto result = complete_with_fallback(generation);
+
+    // A generation every caller walked away from is incomplete
+    if (result.ok() && result->stop_reason != "aborted" && config_.enable_cache) {
+        cache_result(key, result.value());
+    }
+
+    // Later identical requests hit the cache (or start a new generation)
+    {
+        std::lock_guard<std::mutex> lock(in_flight_mutex_);
+        in_flight_.erase(key);
+    }
+    {
+        std::lock_guard<std::mutex> lock(flight->mutex);
+        flight->result = result;
+    }
+    flight->done_cv.notify_all();
+
+    // A leader that stopped listening kept generating for the others, but
+    // sees only what it heard
+    if (own && !own->active && result.ok()) {
+        std::lock_guard<std::mutex> lock(flight->mutex);
+        result->content = flight->streamed.substr(0, own->heard);
+        result->stop_reason = "aborted";
+    }
+    return result;
+}
+
+bool LLMRouter::fan_out(InFlight& flight, const std::string& chunk) {
+    std::vector<std::shared_ptr<InFlight::Subscriber>> listeners;
+    size_t heard = 0;
+    {
+        std::lock_guard<std::mutex> lock(flight.mutex);
+        flight.streamed += chunk;
+        heard = flight.streamed.size();
+        listeners = flight.subscribers;
+    }
+
+    // Callbacks run without the flight lock, so a slow or re-entrant one
+    // does not hold up callers joining or leaving
+    int declined = 0;
+    for (auto& subscriber : listeners) {
+        std::lock_guard<std::mutex> calling(subscriber->calling);
+        if (subscriber->active && !subscriber->callback(chunk)) {
+            subscriber->heard = heard;
+            subscriber->active = false;
+            declined++;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(flight.mutex);
+    if (declined > 0) {
+        auto& subscribers = flight.subscribers;
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                                         [](const auto& s) { return !s->active; }),
+                          subscribers.end());
+        flight.declined += declined;
+        flight.done_cv.notify_all();
+    }
+    // Keep generating while anyone still wants the output
+    return flight.declined < flight.participants;
+}
+
+Result<CompletionResult> LLMRouter::join_flight(InFlight& flight, const StreamCallback& callback) {
+    std::unique_lock<std::mutex> lock(flight.mutex);
+    if (flight.result) {
+        return *flight.result;
+    }
+    flight.participants++;
+
+    std::shared_ptr<InFlight::Subscriber> own;
+    if (callback) {
+        own = std::make_shared<InFlight::Subscriber>();
+        own->callback = callback;
+        flight.subscribers.push_back(own);
+
+        // Catch up on what was streamed before joining. Holding `calling`
+        // makes chunks that arrive meanwhile wait until the replay is done.
+        if (!flight.streamed.empty()) {
+            std::string backlog = flight.streamed;
+            std::unique_lock<std::mutex> calling(own->calling);
+            lock.unlock();
+            bool keep = callback(backlog);
+            calling.unlock();
+            lock.lock();
+            own->heard = backlog.size();
+            if (!keep && own->active.exchange(false)) {
+                auto& subscribers = flight.subscribers;
+                subscribers.erase(std::find(subscribers.begin(), subscribers.end(), own));
+                flight.declined++;
+            }
+        }
+    }
+
+    flight.done_cv.wait(lock, [&flight, &own]() {
+        return flight.result.has_value() || (own && !own->active);
+    });
+
+    if (flight.result) {
+        auto result = *flight.result;
+        if (own && !own->active && result.ok()) {
+            result->stop_reason = "aborted";
+        } else if (own && !flight.streaming && result.ok() && !result->content.empty()) {
+            // The leader did not stream; hand this caller the whole output
+            lock.unlock();
+            if (!callback(result->content)) {
+                result->stop_reason = "aborted";
+            }
+        }
+        return result;
+    }
+
+    // This caller stopped listening; the generation goes on for the others
+    CompletionResult aborted;
+    aborted.content = flight.streamed;
+    aborted.stop_reason = "aborted";
+    return aborted;
+}
+
+Result<CompletionResult> LLMRouter::complete_with_fallback(const CompletionRequest& request) {
     LLMProvider* provider = select_provider(request);
     if (!provider) {
         return Error(ErrorCode::NOT_FOUND, "No available LLM providers");
@@ -99,25 +276,19 @@ Result<CompletionResult> LLMRouter::complete(const CompletionRequest& request) {
 
         if (result.ok()) {
             // Update stats
+            std::lock_guard<std::mutex> lock(providers_mutex_);
             update_latency(provider->name(), latency);
             record_result(provider->name(), true, latency);
-
-            {
-                std::lock_guard<std::mutex> lock(providers_mutex_);
-                last_used_provider_ = provider->name();
-            }
-
-            // Cache result
-            if (config_.enable_cache) {
-                cache_result(cache_key(request), result.value());
-            }
-
+            last_used_provider_ = provider->name();
             return result;
         }
 
         // Record failure
         last_error = result.error();
-        record_result(provider->name(), false, latency);
+        {
+            std::lock_guard<std::mutex> lock(providers_mutex_);
+            record_result(provider->name(), false, latency);
+        }
 
         // Try fallback if enabled
         if (config_.enable_fallback) {
@@ -155,6 +326,9 @@ Result<std::string> LLMRouter::complete_code(
     request.messages = {Message::user(user_msg.str())};
     request.max_tokens = 256;  // Shorter for completions
     request.temperature = 0.2f;  // More deterministic
+    request.stop_mode = StopMode::BLOCK;  // End with the statement or block
+    request.stop_context = code_context;
+    request.grammar = grammars::for_stop_mode(request.stop_mode);
     request.on_chunk = callback;
 
     auto result = complete(request);
@@ -191,6 +365,186 @@ Result<std::string> LLMRouter::generate_from_nl(
     return result->content;
 }
 
+std::vector<Result<CompletionResult>> LLMRouter::complete_batch(
+    const std::vector<CompletionRequest>& requests,
+    const BatchOptions& options) {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Lane {
+        LLMProvider* provider;
+        int limit = 1;
+        int active = 0;
+        Clock::time_point cooldown_until;
+    };
+    struct Pending {
+        size_t index;
+        int attempt;
+        Clock::time_point not_before;
+        std::vector<bool> refused;  // Lanes that failed it for good
+    };
+
+    std::vector<std::optional<Result<CompletionResult>>> results(requests.size());
+    std::mutex mutex;
+    std::mutex callback_mutex;
+    std::condition_variable cv;
+    std::deque<Pending> pending;
+    size_t remaining = requests.size();
+
+    auto finish = [&](size_t index, Result<CompletionResult> result) {
+        std::lock_guard<std::mutex> lock(callback_mutex);
+        results[index] = std::move(result);
+        if (options.on_result) {
+            options.on_result(index, *results[index]);
+        }
+    };
+
+    std::vector<Lane> lanes;
+    size_t lane_capacity = 0;
+    for (LLMProvider* provider : providers_in_strategy_order()) {
+        ProviderInfo info = provider->info();
+        auto named = options.concurrency_by_provider.find(info.name);
+        int wanted = named != options.concurrency_by_provider.end()
+            ? named->second : options.max_concurrency_per_provider;
+        int limit = std::max(1, std::min(wanted, info.max_concurrency));
+        lanes.push_back(Lane{provider, limit, 0, {}});
+        lane_capacity += static_cast<size_t>(limit);
+    }
+
+    // Cached results and an empty router finish right away
+    for (size_t i = 0; i < requests.size(); ++i) {
+        std::optional<CompletionResult> cached;
+        if (config_.enable_cache) {
+            cached = get_cached(cache_key(requests[i]));
+        }
+        if (cached) {
+            finish(i, *cached);
+        } else if (lanes.empty()) {
+            finish(i, Error(ErrorCode::NOT_FOUND, "No available LLM providers"));
+        } else {
+            pending.push_back(Pending{i, 0, Clock::time_point{}, std::vector<bool>(lanes.size())});
+            continue;
+        }
+        --remaining;
+    }
+
+    auto backoff = [&options](int attempt) {
+        int64_t ms = static_cast<int64_t>(options.initial_backoff_ms) << std::min(attempt, 20);
+        return std::chrono::milliseconds(std::min<int64_t>(ms, options.max_backoff_ms));
+    };
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (remaining > 0) {
+            // Take the first ready request and the first open provider
+            // that has not refused it
+            auto now = Clock::now();
+            Clock::time_point wake = Clock::time_point::max();
+            Lane* lane = nullptr;
+            auto item = pending.end();
+            for (auto it = pending.begin(); it != pending.end() && !lane; ++it) {
+                if (it->not_before > now) {
+                    wake = std::min(wake, it->not_before);
+                    continue;
+                }
+                for (size_t l = 0; l < lanes.size(); ++l) {
+                    Lane& candidate = lanes[l];
+                    if (it->refused[l] || candidate.active >= candidate.limit) continue;
+                    if (candidate.cooldown_until > now) {
+                        wake = std::min(wake, candidate.cooldown_until);
+                        continue;
+                    }
+                    lane = &candidate;
+                    item = it;
+                    break;
+                }
+            }
+
+            if (!lane) {
+                if (pending.empty() || wake == Clock::time_point::max()) {
+                    cv.wait(lock);
+                } else {
+                    cv.wait_until(lock, wake);
+                }
+                continue;
+            }
+
+            Pending job = std::move(*item);
+            pending.erase(item);
+            lane->active++;
+            lock.unlock();
+
+            auto start = Clock::now();
+            auto result = lane->provider->complete(requests[job.index]);
+            int latency = static_cast<int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    Clock::now() - start).count());
+            {
+                std::lock_guard<std::mutex> stats_lock(providers_mutex_);
+                if (result.ok()) {
+                    update_latency(lane->provider->name(), latency);
+                }
+                record_result(lane->provider->name(), result.ok(), latency);
+            }
+
+            // Transient errors are retried after a backoff. Others fail the
+            // request over to the remaining providers, as the interactive
+            // path does, and fail it once every provider has refused it.
+            bool retry = false;
+            bool fail_over = false;
+            if (!result.ok()) {
+                ErrorCode code = result.error().code();
+                if (code == ErrorCode::RATE_LIMITED || code == ErrorCode::TIMEOUT ||
+                    code == ErrorCode::NETWORK_ERROR) {
+                    retry = job.attempt + 1 < options.max_attempts;
+                } else {
+                    job.refused[static_cast<size_t>(lane - lanes.data())] = true;
+                    fail_over = std::find(job.refused.begin(), job.refused.end(), false) !=
+                                job.refused.end();
+                }
+            } else if (config_.enable_cache) {
+                cache_result(cache_key(requests[job.index]), result.value());
+            }
+            if (!retry && !fail_over) {
+                finish(job.index, std::move(result));
+            }
+
+            lock.lock();
+            lane->active--;
+            if (retry) {
+                auto delay = backoff(job.attempt);
+                if (result.error().code() == ErrorCode::RATE_LIMITED) {
+                    lane->cooldown_until = std::max(lane->cooldown_until, Clock::now() + delay);
+                }
+                job.attempt++;
+                job.not_before = Clock::now() + delay;
+                pending.push_back(std::move(job));
+            } else if (fail_over) {
+                pending.push_front(std::move(job));
+            } else {
+                --remaining;
+            }
+            cv.notify_all();
+        }
+    };
+
+    size_t workers = std::min(pending.size(), lane_capacity);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<Result<CompletionResult>> ordered;
+    ordered.reserve(results.size());
+    for (auto& result : results) {
+        ordered.push_back(std::move(*result));
+    }
+    return ordered;
+}
+
 Result<CompletionResult> LLMRouter::complete_with_provider(
     const std::string& provider_name,
     const CompletionRequest& request) {
@@ -249,6 +603,37 @@ void LLMRouter::reset_stats() {
     latency_records_.clear();
 }
 
+std::vector<LLMProvider*> LLMRouter::providers_in_strategy_order() const {
+    std::lock_guard<std::mutex> lock(providers_mutex_);
+    std::vector<LLMProvider*> result;
+
+    auto append = [&result](const std::vector<ProviderPtr>& providers) {
+        for (const auto& p : providers) {
+            if (p->is_available()) {
+                result.push_back(p.get());
+            }
+        }
+    };
+
+    switch (config_.strategy) {
+        case RoutingStrategy::LOCAL_ONLY:
+            append(local_providers_);
+            break;
+        case RoutingStrategy::CLOUD_ONLY:
+            append(cloud_providers_);
+            break;
+        case RoutingStrategy::CLOUD_FIRST:
+            append(cloud_providers_);
+            append(local_providers_);
+            break;
+        default:
+            append(local_providers_);
+            append(cloud_providers_);
+            break;
+    }
+    return result;
+}
+
 LLMProvider* LLMRouter::select_provider(const CompletionRequest& request) {
     std::lock_guard<std::mutex> lock(providers_mutex_);
     return select_by_strategy(request);
@@ -427,7 +812,13 @@ std::string LLMRouter::cache_key(const CompletionRequest& request) const {
     for (const auto& msg : request.messages) {
         ss << static_cast<int>(msg.role) << ":" << msg.content << "|";
     }
-    ss << request.max_tokens << "|" << request.temperature;
+    ss << request.max_tokens << "|" << request.temperature << "|" << request.top_p << "|"
+       << request.top_k << "|" << request.repeat_penalty << "|" << request.timeout_ms << "|";
+    for (const auto& stop : request.stop_sequences) {
+        ss << stop << "|";
+    }
+    ss << static_cast<int>(request.stop_mode) << "|" << request.stop_context << "|"
+       << request.grammar;
 
     // Simple hash
     std::hash<std::string> hasher;
@@ -0,0 +1,362 @@
+#include <dam/llm/stop_conditions.hpp>
+#include <dam/llm/provider.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <limits>
+
+namespace dam::llm {
+
+namespace {
+
+constexpr uint32_t NO_STATE = std::numeric_limits<uint32_t>::max();
+
+// A line ending in one of these goes on to the next
+bool is_continuation(char c) {
+    switch (c) {
+        case '{': case '(': case '[': case ',': case '\\': case ':':
+        case '=': case '+': case '-': case '*': case '/': case '%':
+        case '&': case '|': case '.': case '?': case '<': case '!':
+        case '^': case '~':
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Words that continue the statement above them at the same indentation
+bool is_continuation_word(const std::string& word) {
+    return word == "else" || word == "elif" || word == "except" ||
+           word == "finally" || word == "catch";
+}
+
+bool is_word_char(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$' || c == '@';
+}
+
+int indent_width(char c) {
+    return c == '\t' ? 4 : 1;
+}
+
+}  // namespace
+
+// ============================================================================
+// StopSequenceMatcher
+// ============================================================================
+
+StopSequenceMatcher::StopSequenceMatcher(const std::vector<std::string>& stops)
+    : next_(256, NO_STATE)
+    , match_(1, 0)
+    , depth_(1, 0) {
+    // Trie of the stop sequences
+    for (const auto& stop : stops) {
+        if (stop.empty()) continue;
+        uint32_t state = 0;
+        for (unsigned char c : stop) {
+            uint32_t& next = next_[state * 256 + c];
+            if (next == NO_STATE) {
+                next = static_cast<uint32_t>(depth_.size());
+                uint32_t depth = depth_[state] + 1;
+                next_.resize(next_.size() + 256, NO_STATE);
+                match_.push_back(0);
+                depth_.push_back(depth);
+                state = static_cast<uint32_t>(depth_.size() - 1);
+            } else {
+                state = next;
+            }
+        }
+        match_[state] = static_cast<uint32_t>(stop.size());
+    }
+
+    // Breadth-first: fill missing transitions from each state's failure link
+    std::vector<uint32_t> fail(depth_.size(), 0);
+    std::deque<uint32_t> queue;
+    for (size_t c = 0; c < 256; ++c) {
+        uint32_t& next = next_[c];
+        if (next == NO_STATE) {
+            next = 0;
+        } else {
+            queue.push_back(next);
+        }
+    }
+    while (!queue.empty()) {
+        uint32_t state = queue.front();
+        queue.pop_front();
+        if (match_[state] == 0) {
+            match_[state] = match_[fail[state]];
+        }
+        for (size_t c = 0; c < 256; ++c) {
+            uint32_t& next = next_[state * 256 + c];
+            uint32_t fallback = next_[fail[state] * 256 + c];
+            if (next == NO_STATE) {
+                next = fallback;
+            } else {
+                fail[next] = fallback;
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// StructureTracker
+// ============================================================================
+
+StructureTracker::StructureTracker(StopMode mode, std::string_view context)
+    : mode_(mode) {
+    if (mode_ == StopMode::NONE) return;
+
+    priming_ = true;
+    for (char c : context) {
+        step(c, 0);
+    }
+    priming_ = false;
+
+    // The generation continues the context's last line
+    floor_ = line_floor_;
+    base_indent_ = at_line_start_ ? -1 : indent_;
+}
+
+std::optional<size_t> StructureTracker::step(char c, size_t pos) {
+    if (mode_ == StopMode::NONE) return std::nullopt;
+    char prev = prev_;
+    prev_ = c;
+
+    // The first word of a line back at the starting indentation decides
+    // whether a new statement begins there
+    if (pending_cut_) {
+        if (is_word_char(c) && word_.size() < 8) {
+            word_ += c;
+        } else {
+            size_t cut = *pending_cut_;
+            pending_cut_.reset();
+            if (!is_continuation_word(word_)) {
+                return cut;
+            }
+        }
+    }
+
+    if (c == '\n') {
+        line_comment_ = false;
+        if (quote_ != '`') {
+            quote_ = 0;  // Only template strings span lines
+            escaped_ = false;
+        }
+        bool ends = !block_comment_ && quote_ == 0 && ends_line();
+        start_line(pos);
+        if (ends && !priming_) {
+            return pos;
+        }
+        return std::nullopt;
+    }
+
+    if (block_comment_) {
+        if (prev == '*' && c == '/') {
+            block_comment_ = false;
+            prev_ = 0;
+        }
+        return std::nullopt;
+    }
+    if (line_comment_) return std::nullopt;
+
+    // A line opening with ``` is a markdown fence, not a template string
+    // running on: it is skipped like a comment
+    if (c == '`' && (fence_ > 0 || (at_line_start_ && quote_ == 0))) {
+        if (fence_ == 0) {
+            emitted_before_fence_ = emitted_;
+        }
+        if (++fence_ == 3) {
+            fence_ = 0;
+            quote_ = 0;
+            line_comment_ = true;
+            line_generated_ = false;
+            last_code_ = 0;
+            emitted_ = emitted_before_fence_;
+            return std::nullopt;
+        }
+    } else {
+        fence_ = 0;
+    }
+
+    if (quote_ != 0) {
+        at_line_start_ = false;
+        if (escaped_) {
+            escaped_ = false;
+        } else if (c == '\\') {
+            escaped_ = true;
+        } else if (c == quote_) {
+            quote_ = 0;
+        }
+        mark_code(c);
+        return std::nullopt;
+    }
+
+    if (c == ' ' || c == '\t' || c == '\r') {
+        if (at_line_start_) {
+            indent_ += indent_width(c);
+        }
+        return std::nullopt;
+    }
+
+    if (at_line_start_) {
+        at_line_start_ = false;
+        if (base_indent_ < 0) {
+            base_indent_ = indent_;
+        } else if (mode_ == StopMode::BLOCK && !priming_ && emitted_ && !continues_ &&
+                   depth_ == floor_ && indent_ <= base_indent_ && is_word_char(c)) {
+            pending_cut_ = line_start_;
+            word_.assign(1, c);
+        }
+    }
+
+    switch (c) {
+        case '"':
+        case '\'':
+        case '`':
+            quote_ = c;
+            break;
+        case '#':
+            if (prev == ' ' || prev == '\t' || prev == '\n' || prev == 0) {
+                line_comment_ = true;
+                line_generated_ = emitted_ = !priming_;
+                return std::nullopt;
+            }
+            break;
+        case '/':
+            if (prev == '/') {
+                line_comment_ = true;
+                last_code_ = code_before_slash_;
+                return std::nullopt;
+            }
+            code_before_slash_ = last_code_;
+            break;
+        case '*':
+            if (prev == '/') {
+                block_comment_ = true;
+                last_code_ = code_before_slash_;
+                prev_ = 0;
+                return std::nullopt;
+            }
+            break;
+        case '(':
+        case '[':
+        case '{':
+            ++depth_;
+            break;
+        case ')':
+        case ']':
+        case '}':
+            if (depth_ <= floor_) {
+                // Closes a bracket opened before the current line
+                if (!priming_) return pos;
+                break;
+            }
+            --depth_;
+            break;
+        default:
+            break;
+    }
+
+    mark_code(c);
+    return std::nullopt;
+}
+
+bool StructureTracker::ends_line() {
+    bool ends = false;
+    if (line_generated_ && depth_ == floor_) {
+        if (mode_ == StopMode::LINE) {
+            ends = true;
+        } else if (indent_ <= base_indent_ && (last_code_ == ';' || last_code_ == '}')) {
+            ends = true;
+        }
+    }
+    if (last_code_ != 0) {
+        continues_ = depth_ > line_floor_ || is_continuation(last_code_);
+    }
+    return ends;
+}
+
+void StructureTracker::start_line(size_t pos) {
+    line_start_ = pos;
+    line_floor_ = depth_;
+    at_line_start_ = true;
+    indent_ = 0;
+    last_code_ = 0;
+    line_generated_ = false;
+    fence_ = 0;
+    prev_ = '\n';
+}
+
+void StructureTracker::mark_code(char c) {
+    last_code_ = c;
+    if (!priming_) {
+        line_generated_ = true;
+        emitted_ = true;
+    }
+}
+
+// ============================================================================
+// StopController
+// ============================================================================
+
+StopController::StopController(const CompletionRequest& request)
+    : matcher_(request.stop_sequences)
+    , tracker_(request.stop_mode, request.stop_context)
+    , track_structure_(request.stop_mode != StopMode::NONE) {}
+
+bool StopController::append(std::string_view text) {
+    if (stopped()) return true;
+
+    for (char c : text) {
+        size_t pos = content_.size();
+        content_ += c;
+
+        if (size_t length = matcher_.step(static_cast<unsigned char>(c))) {
+            content_.resize(pos + 1 - length);
+            stop_reason_ = "stop_sequence";
+            return true;
+        }
+
+        if (track_structure_) {
+            if (auto cut = tracker_.step(c, pos)) {
+                content_.resize(*cut);
+                size_t end = content_.find_last_not_of(" \t\r\n");
+                size_t kept = end == std::string::npos ? 0 : end + 1;
+                content_.resize(std::max(kept, streamed_));
+                stop_reason_ = "structure";
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool StopController::stream(const std::function<bool(const std::string&)>& callback) {
+    size_t ready = ready_size();
+    if (ready <= streamed_) return true;
+
+    std::string chunk = content_.substr(streamed_, ready - streamed_);
+    streamed_ = ready;
+    return !callback || callback(chunk);
+}
+
+size_t StopController::ready_size() const {
+    if (finished_ || stopped()) {
+        return content_.size();
+    }
+
+    size_t ready = content_.size() - std::min(matcher_.pending(), content_.size());
+    if (track_structure_) {
+        if (auto cut = tracker_.pending_cut()) {
+            ready = std::min(ready, *cut);
+        }
+        // Trailing whitespace is dropped if the unit ends here
+        size_t end = ready == 0 ? std::string::npos
+                                : content_.find_last_not_of(" \t\r\n", ready - 1);
+        ready = end == std::string::npos ? 0 : end + 1;
+    }
+    return std::max(ready, streamed_);
+}
+
+}  // namespace dam::llm
@@ -3,8 +3,12 @@
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <mutex>
 #include <numeric>
 #include <sstream>
@@ -493,11 +497,258 @@ Result<EmbedderPtr> LlamaCppEmbedder::create_from_env() {
 
 #endif  // DAM_HAS_LLAMACPP
 
+// ============================================================================
+// Builtin Embedder Implementation
+// ============================================================================
+
+namespace {
+
+constexpr size_t BUILTIN_BUCKETS = 4096;  // Power of two
+constexpr int BUILTIN_DEFAULT_DIMENSION = 256;
+constexpr uint64_t BUILTIN_SEED = 0x9E3779B97F4A7C15ULL;
+
+// Feature weights
+constexpr float WORD_WEIGHT = 1.0f;
+constexpr float PART_WEIGHT = 0.7f;
+constexpr float PAIR_WEIGHT = 0.5f;
+constexpr float TRIGRAM_WEIGHT = 0.3f;
+constexpr float OPERATOR_WEIGHT = 0.3f;
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// FNV-1a over a kind byte and the feature text, then mixed so the top
+// bit (used as the sign) is as good as the low ones (the bucket)
+uint64_t feature_hash(char kind, const char* data, size_t size) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    h = (h ^ static_cast<unsigned char>(kind)) * 0x100000001B3ULL;
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * 0x100000001B3ULL;
+    }
+    return splitmix64(h);
+}
+
+// 64 entries of the +/-1 projection (set bit = +1), hashed from the
+// bucket and block of dimensions. No table is stored, and the matrix is
+// the same in every process, so stored vectors stay comparable.
+uint64_t projection_bits(size_t bucket, size_t block) {
+    return splitmix64(BUILTIN_SEED ^ ((static_cast<uint64_t>(bucket) << 32) | block));
+}
+
+// Eight +/-1 floats for each byte of projection bits (bit 0 first)
+using SignRow = std::array<float, 8>;
+constexpr std::array<SignRow, 256> make_sign_rows() {
+    std::array<SignRow, 256> rows{};
+    for (size_t byte = 0; byte < 256; ++byte) {
+        for (size_t bit = 0; bit < 8; ++bit) {
+            rows[byte][bit] = ((byte >> bit) & 1) ? 1.0f : -1.0f;
+        }
+    }
+    return rows;
+}
+constexpr std::array<SignRow, 256> SIGN_ROWS = make_sign_rows();
+
+bool is_identifier_char(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Signed bucket counts of one text's features
+class FeatureSketch {
+public:
+    FeatureSketch() : counts_(BUILTIN_BUCKETS, 0.0f), seen_(BUILTIN_BUCKETS, 0) {}
+
+    void add(uint64_t hash, float weight) {
+        size_t bucket = hash & (BUILTIN_BUCKETS - 1);
+        if (!seen_[bucket]) {
+            seen_[bucket] = 1;
+            touched_.push_back(static_cast<uint32_t>(bucket));
+        }
+        counts_[bucket] += (hash >> 63) ? -weight : weight;
+    }
+
+    void add_text(const std::string& text) {
+        uint64_t previous = 0;
+        size_t i = 0;
+        while (i < text.size()) {
+            char c = text[i];
+            if (is_identifier_char(c)) {
+                size_t begin = i;
+                while (i < text.size() && is_identifier_char(text[i])) ++i;
+                previous = add_identifier(text.data() + begin, i - begin, previous);
+            } else if (std::isspace(static_cast<unsigned char>(c)) || (c & 0x80)) {
+                ++i;
+            } else {
+                // Operator runs, up to three characters ("->", "::", "|=")
+                size_t begin = i;
+                while (i < text.size() && i - begin < 3 && !is_identifier_char(text[i]) &&
+                       !std::isspace(static_cast<unsigned char>(text[i])) && !(text[i] & 0x80)) {
+                    ++i;
+                }
+                add(feature_hash('o', text.data() + begin, i - begin), OPERATOR_WEIGHT);
+            }
+        }
+    }
+
+    /**
+     * Project the counts onto the output, damping repeated features.
+     */
+    void project(float* out, size_t dim) const {
+        const float scale = 1.0f / std::sqrt(static_cast<float>(dim));
+        for (uint32_t bucket : touched_) {
+            float v = counts_[bucket];
+            if (v == 0.0f) continue;
+            v = std::copysign(std::sqrt(std::fabs(v)), v) * scale;
+
+            // The bucket's row of signs, 64 dimensions per hash, expanded
+            // to floats so the update is a plain multiply-add over the
+            // block, which the compiler vectorizes
+            float signs[64];
+            for (size_t block = 0; block * 64 < dim; ++block) {
+                uint64_t bits = projection_bits(bucket, block);
+                for (size_t byte = 0; byte < 8; ++byte) {
+                    std::memcpy(signs + byte * 8, SIGN_ROWS[(bits >> (byte * 8)) & 0xFF].data(),
+                                sizeof(SignRow));
+                }
+                float* row = out + block * 64;
+                size_t n = std::min<size_t>(64, dim - block * 64);
+                for (size_t d = 0; d < n; ++d) {
+                    row[d] += v * signs[d];
+                }
+            }
+        }
+    }
+
+private:
+    // Returns the identifier's hash, for pairing with the next one
+    uint64_t add_identifier(const char* data, size_t size, uint64_t previous) {
+        lower_.assign(data, size);
+        for (char& ch : lower_) {
+            ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        }
+
+        uint64_t word = feature_hash('w', lower_.data(), lower_.size());
+        add(word, WORD_WEIGHT);
+        if (previous != 0) {
+            add(splitmix64(previous ^ (word * 31)), PAIR_WEIGHT);
+        }
+
+        // Parts: split at '_', letter/digit changes and camelCase humps
+        // (userId, user_id and UserID all share "user" and "id")
+        parts_.clear();
+        size_t begin = 0;
+        for (size_t k = 0; k < size; ++k) {
+            auto c = static_cast<unsigned char>(data[k]);
+            if (c == '_') {
+                if (k > begin) parts_.emplace_back(begin, k);
+                begin = k + 1;
+                continue;
+            }
+            if (k > begin) {
+                auto p = static_cast<unsigned char>(data[k - 1]);
+                bool hump = (std::islower(p) && std::isupper(c)) ||
+                            (std::isupper(p) && std::isupper(c) && k + 1 < size &&
+                             std::islower(static_cast<unsigned char>(data[k + 1])));
+                if (hump || (std::isdigit(p) != 0) != (std::isdigit(c) != 0)) {
+                    parts_.emplace_back(begin, k);
+                    begin = k;
+                }
+            }
+        }
+        if (size > begin) parts_.emplace_back(begin, size);
+        if (parts_.size() > 1) {
+            for (const auto& [part_begin, part_end] : parts_) {
+                add(feature_hash('w', lower_.data() + part_begin, part_end - part_begin), PART_WEIGHT);
+            }
+        }
+
+        // Character trigrams of "<word>", for spelling variants
+        if (size >= 2) {
+            trigram_buffer_.assign(1, '<');
+            trigram_buffer_ += lower_;
+            trigram_buffer_ += '>';
+            for (size_t k = 0; k + 3 <= trigram_buffer_.size(); ++k) {
+                add(feature_hash('g', trigram_buffer_.data() + k, 3), TRIGRAM_WEIGHT);
+            }
+        }
+        return word;
+    }
+
+    std::vector<float> counts_;
+    std::vector<uint8_t> seen_;
+    std::vector<uint32_t> touched_;
+    std::string lower_;
+    std::string trigram_buffer_;
+    std::vector<std::pair<size_t, size_t>> parts_;
+};
+
+}  // namespace
+
+BuiltinEmbedder::BuiltinEmbedder(EmbedderConfig config)
+    : config_(std::move(config))
+    , dimension_(config_.dimension > 0 ? config_.dimension : BUILTIN_DEFAULT_DIMENSION) {
+    config_.dimension = dimension_;
+}
+
+std::string BuiltinEmbedder::model_name() const {
+    return "builtin-hash-v2-" + std::to_string(dimension_);
+}
+
+Result<Embedding> BuiltinEmbedder::embed(const std::string& text) {
+    FeatureSketch sketch;
+    sketch.add_text(text);
+
+    Embedding embedding(dimension_, 0.0f);
+    sketch.project(embedding.data(), embedding.size());
+
+    if (config_.normalize) {
+        normalize(embedding);
+    }
+    return embedding;
+}
+
+Result<std::vector<Embedding>> BuiltinEmbedder::embed_batch(
+    const std::vector<std::string>& texts,
+    EmbedProgressCallback callback) {
+
+    std::vector<Embedding> results;
+    results.reserve(texts.size());
+
+    for (size_t i = 0; i < texts.size(); ++i) {
+        auto result = embed(texts[i]);
+        if (!result.ok()) {
+            return result.error();
+        }
+        results.push_back(std::move(result.value()));
+
+        if (callback) {
+            callback(i + 1, texts.size());
+        }
+    }
+
+    return results;
+}
+
+Result<EmbedderPtr> BuiltinEmbedder::create(EmbedderConfig config) {
+    if (config.dimension < 0 || config.dimension > 4096) {
+        return Error(ErrorCode::INVALID_ARGUMENT,
+            "Builtin embedder dimension must be between 1 and 4096");
+    }
+    return EmbedderPtr(std::make_unique<BuiltinEmbedder>(std::move(config)));
+}
+
 // ============================================================================
 // Embedder Factory
 // ============================================================================
 
 Result<EmbedderPtr> EmbedderFactory::create_from_env() {
+    if (const char* type = std::getenv("DAM_EMBEDDER"); type && type[0] != '\0') {
+        return create(type);
+    }
+
 #ifdef DAM_HAS_LLAMACPP
     // Try llama.cpp first if model path is set
     if (std::getenv("DAM_EMBEDDING_MODEL_PATH")) {
@@ -514,9 +765,8 @@ Result<EmbedderPtr> EmbedderFactory::create_from_env() {
         return ollama_result;
     }
 
-    return Error(ErrorCode::NOT_FOUND,
-        "No embedding provider available. Set DAM_EMBEDDING_MODEL_PATH "
-        "or ensure Ollama is running with nomic-embed-text.");
+    // Always available, so semantic search never silently drops out
+    return BuiltinEmbedder::create();
 }
 
 Result<EmbedderPtr> EmbedderFactory::create(const std::string& type) {
@@ -524,6 +774,10 @@ Result<EmbedderPtr> EmbedderFactory::create(const std::string& type) {
         return OllamaEmbedder::create_default();
     }
 
+    if (type == "builtin") {
+        return BuiltinEmbedder::create();
+    }
+
 #ifdef DAM_HAS_LLAMACPP
     if (type == "llamacpp") {
         return LlamaCppEmbedder::create_from_env();
@@ -1,4 +1,5 @@
 #include <dam/search/inverted_index.hpp>
+#include <dam/util/query_arena.hpp>
 
 #include <algorithm>
 #include <cmath>
@@ -402,7 +403,7 @@ Result<std::vector<SearchResult>> InvertedIndex::search_and(
             // Term not found, AND query returns empty
             return std::vector<SearchResult>{};
         }
-        lists.push_back(posting_opt.value());
+        lists.push_back(std::move(*posting_opt));
     }
 
     if (lists.empty()) {
@@ -426,7 +427,7 @@ Result<std::vector<SearchResult>> InvertedIndex::search_or(
 
         auto posting_opt = get_posting_list(normalized);
         if (posting_opt.has_value()) {
-            lists.push_back(posting_opt.value());
+            lists.push_back(std::move(*posting_opt));
         }
     }
 
@@ -462,7 +463,7 @@ Result<std::vector<SearchResult>> InvertedIndex::search_phrase(
         if (!posting_opt.has_value()) {
             return std::vector<SearchResult>{};
         }
-        lists.push_back(posting_opt.value());
+        lists.push_back(std::move(*posting_opt));
     }
 
     // Find documents containing all terms
@@ -486,6 +487,8 @@ Result<std::vector<SearchResult>> InvertedIndex::search(const std::string& query
         return std::vector<SearchResult>{};
     }
 
+    QueryArenaScope arena;
+
     // Separate into required, optional, and excluded
     std::vector<std::string> required_terms;
     std::vector<std::string> optional_terms;
@@ -532,7 +535,7 @@ Result<std::vector<SearchResult>> InvertedIndex::search(const std::string& query
         auto phrase_result = search_phrase(phrase);
         if (!phrase_result.ok()) continue;
 
-        std::set<FileId> phrase_docs;
+        std::pmr::set<FileId> phrase_docs(arena.resource());
         for (const auto& r : phrase_result.value()) {
             phrase_docs.insert(r.doc_id);
         }
@@ -547,7 +550,7 @@ Result<std::vector<SearchResult>> InvertedIndex::search(const std::string& query
 
     // Exclude documents
     if (!excluded_terms.empty()) {
-        std::set<FileId> excluded_docs;
+        std::pmr::set<FileId> excluded_docs(arena.resource());
         for (const auto& term : excluded_terms) {
             auto term_result = search_term(term);
             if (term_result.ok()) {
@@ -696,26 +699,33 @@ std::vector<SearchResult> InvertedIndex::merge_and_results(
         }
     }
 
-    // Get candidate documents from smallest list
-    std::set<FileId> candidates;
+    QueryArenaScope arena;
+
+    // Get candidate documents from smallest list (postings are sorted)
+    std::pmr::vector<FileId> candidates(arena.resource());
+    candidates.reserve(smallest_size);
     for (const auto& p : lists[smallest_idx].postings) {
-        candidates.insert(p.doc_id);
+        candidates.push_back(p.doc_id);
     }
 
     // Intersect with other lists
+    std::pmr::vector<FileId> intersection(arena.resource());
+    intersection.reserve(smallest_size);
     for (size_t i = 0; i < lists.size(); ++i) {
         if (i == smallest_idx) continue;
 
-        std::set<FileId> list_docs;
-        for (const auto& p : lists[i].postings) {
-            list_docs.insert(p.doc_id);
+        const auto& postings = lists[i].postings;
+        intersection.clear();
+        auto p = postings.begin();
+        for (FileId doc_id : candidates) {
+            p = std::lower_bound(p, postings.end(), doc_id,
+                [](const Posting& posting, FileId id) { return posting.doc_id < id; });
+            if (p == postings.end()) break;
+            if (p->doc_id == doc_id) {
+                intersection.push_back(doc_id);
+            }
         }
-
-        std::set<FileId> intersection;
-        std::set_intersection(candidates.begin(), candidates.end(),
-                              list_docs.begin(), list_docs.end(),
-                              std::inserter(intersection, intersection.begin()));
-        candidates = std::move(intersection);
+        candidates.swap(intersection);
 
         if (candidates.empty()) break;
     }
@@ -762,8 +772,10 @@ std::vector<SearchResult> InvertedIndex::merge_and_results(
 std::vector<SearchResult> InvertedIndex::merge_or_results(
     const std::vector<PostingList>& lists) const {
 
+    QueryArenaScope arena;
+
     // Collect all documents with their scores
-    std::map<FileId, SearchResult> doc_scores;
+    std::pmr::map<FileId, SearchResult> doc_scores(arena.resource());
 
     for (const auto& list : lists) {
         for (const auto& posting : list.postings) {
@@ -1,4 +1,5 @@
 #include <dam/search/search_router.hpp>
+#include <dam/util/query_arena.hpp>
 
 #include <algorithm>
 #include <cctype>
@@ -17,7 +18,9 @@ SearchRouter::SearchRouter(BufferPool* buffer_pool, SearchRouterConfig config)
     : buffer_pool_(buffer_pool)
     , config_(std::move(config)) {}
 
-SearchRouter::~SearchRouter() = default;
+SearchRouter::~SearchRouter() {
+    attach_memory_governor(nullptr);
+}
 
 Result<void> SearchRouter::initialize() {
     return initialize(INVALID_PAGE_ID, INVALID_PAGE_ID, "");
@@ -205,45 +208,65 @@ Result<std::vector<UnifiedSearchResult>> SearchRouter::search(
         mode = detect_search_mode(query);
     }
 
-    std::vector<UnifiedSearchResult> keyword_results;
-    std::vector<UnifiedSearchResult> fuzzy_results;
-    std::vector<UnifiedSearchResult> semantic_results;
+    // All intermediate state for this query lives in the thread's arena
+    QueryArenaScope arena;
+    std::pmr::memory_resource* mr = arena.resource();
+
+    CandidateList keyword_results(mr);
+    CandidateList fuzzy_results(mr);
+    CandidateList semantic_results(mr);
 
     switch (mode) {
         case SearchMode::KEYWORD:
-            keyword_results = do_keyword_search(query);
+            keyword_results = do_keyword_search(query, mr);
             break;
 
         case SearchMode::FUZZY:
-            fuzzy_results = do_fuzzy_search(query);
+            fuzzy_results = do_fuzzy_search(query, mr);
             break;
 
         case SearchMode::SUBSTRING:
-            fuzzy_results = do_substring_search(query);
+            fuzzy_results = do_substring_search(query, mr);
             break;
 
         case SearchMode::SEMANTIC:
-            semantic_results = do_semantic_search(query);
+            semantic_results = do_semantic_search(query, mr);
             break;
 
         case SearchMode::HYBRID:
         case SearchMode::AUTO:
         default:
-            keyword_results = do_keyword_search(query);
-            fuzzy_results = do_fuzzy_search(query);
-            semantic_results = do_semantic_search(query);
+            keyword_results = do_keyword_search(query, mr);
+            fuzzy_results = do_fuzzy_search(query, mr);
+            semantic_results = do_semantic_search(query, mr);
             break;
     }
 
-    auto results = merge_results(keyword_results, fuzzy_results,
-                                  semantic_results, query);
+    auto candidates = merge_results(keyword_results, fuzzy_results,
+                                    semantic_results, query, mr);
 
-    // Sort by final score
-    std::sort(results.begin(), results.end());
+    // Rank only as many candidates as will be returned
+    auto by_score = [](const Candidate& a, const Candidate& b) {
+        return a.final_score > b.final_score;
+    };
+    size_t limit = std::min(query.max_results, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + limit,
+                      candidates.end(), by_score);
 
-    // Limit results
-    if (results.size() > query.max_results) {
-        results.resize(query.max_results);
+    // Materialize the survivors outside the arena
+    std::vector<UnifiedSearchResult> results;
+    results.reserve(limit);
+    for (size_t i = 0; i < limit; ++i) {
+        const Candidate& c = candidates[i];
+        UnifiedSearchResult r;
+        r.doc_id = c.doc_id;
+        r.keyword_score = c.keyword_score;
+        r.fuzzy_score = c.fuzzy_score;
+        r.semantic_score = c.semantic_score;
+        r.final_score = c.final_score;
+        r.positions.assign(c.positions.begin(), c.positions.end());
+        r.matched_text.assign(c.matched_text.begin(), c.matched_text.end());
+        results.push_back(std::move(r));
     }
 
     return results;
@@ -428,10 +451,11 @@ SearchMode SearchRouter::detect_search_mode(const SearchQuery& query) const {
 // Individual Search Methods
 // ============================================================================
 
-std::vector<UnifiedSearchResult> SearchRouter::do_keyword_search(
-    const SearchQuery& query) const {
+SearchRouter::CandidateList SearchRouter::do_keyword_search(
+    const SearchQuery& query,
+    std::pmr::memory_resource* mr) const {
 
-    std::vector<UnifiedSearchResult> results;
+    CandidateList results(mr);
 
     if (!inverted_) {
         return results;
@@ -442,21 +466,22 @@ std::vector<UnifiedSearchResult> SearchRouter::do_keyword_search(
         return results;
     }
 
+    results.reserve(search_result.value().size());
     for (const auto& r : search_result.value()) {
-        UnifiedSearchResult ur;
-        ur.doc_id = r.doc_id;
-        ur.keyword_score = r.score;
-        ur.positions = r.positions;
-        results.push_back(ur);
+        Candidate& c = results.emplace_back(mr);
+        c.doc_id = r.doc_id;
+        c.keyword_score = r.score;
+        c.positions.assign(r.positions.begin(), r.positions.end());
     }
 
     return results;
 }
 
-std::vector<UnifiedSearchResult> SearchRouter::do_fuzzy_search(
-    const SearchQuery& query) const {
+SearchRouter::CandidateList SearchRouter::do_fuzzy_search(
+    const SearchQuery& query,
+    std::pmr::memory_resource* mr) const {
 
-    std::vector<UnifiedSearchResult> results;
+    CandidateList results(mr);
 
     if (!trigram_) {
         return results;
@@ -467,21 +492,22 @@ std::vector<UnifiedSearchResult> SearchRouter::do_fuzzy_search(
         return results;
     }
 
+    results.reserve(search_result.value().size());
     for (const auto& r : search_result.value()) {
-        UnifiedSearchResult ur;
-        ur.doc_id = r.doc_id;
-        ur.fuzzy_score = r.similarity;
-        ur.matched_text = r.matched_text;
-        results.push_back(ur);
+        Candidate& c = results.emplace_back(mr);
+        c.doc_id = r.doc_id;
+        c.fuzzy_score = r.similarity;
+        c.matched_text.assign(r.matched_text.begin(), r.matched_text.end());
     }
 
     return results;
 }
 
-std::vector<UnifiedSearchResult> SearchRouter::do_substring_search(
-    const SearchQuery& query) const {
+SearchRouter::CandidateList SearchRouter::do_substring_search(
+    const SearchQuery& query,
+    std::pmr::memory_resource* mr) const {
 
-    std::vector<UnifiedSearchResult> results;
+    CandidateList results(mr);
 
     if (!trigram_) {
         return results;
@@ -492,20 +518,21 @@ std::vector<UnifiedSearchResult> SearchRouter::do_substring_search(
         return results;
     }
 
+    results.reserve(search_result.value().size());
     for (const auto& doc_id : search_result.value()) {
-        UnifiedSearchResult ur;
-        ur.doc_id = doc_id;
-        ur.fuzzy_score = 1.0f;  // Exact substring match gets perfect score
-        results.push_back(ur);
+        Candidate& c = results.emplace_back(mr);
+        c.doc_id = doc_id;
+        c.fuzzy_score = 1.0f;  // Exact substring match gets perfect score
     }
 
     return results;
 }
 
-std::vector<UnifiedSearchResult> SearchRouter::do_semantic_search(
-    const SearchQuery& query) const {
+SearchRouter::CandidateList SearchRouter::do_semantic_search(
+    const SearchQuery& query,
+    std::pmr::memory_resource* mr) const {
 
-    std::vector<UnifiedSearchResult> results;
+    CandidateList results(mr);
 
     if (!vector_) {
         return results;
@@ -518,11 +545,11 @@ std::vector<UnifiedSearchResult> SearchRouter::do_semantic_search(
         return results;
     }
 
+    results.reserve(search_result.value().size());
     for (const auto& r : search_result.value()) {
-        UnifiedSearchResult ur;
-        ur.doc_id = r.doc_id;
-        ur.semantic_score = r.similarity;
-        results.push_back(ur);
+        Candidate& c = results.emplace_back(mr);
+        c.doc_id = r.doc_id;
+        c.semantic_score = r.similarity;
     }
 
     return results;
@@ -532,7 +559,7 @@ std::vector<UnifiedSearchResult> SearchRouter::do_semantic_search(
 // Result Merging
 // ============================================================================
 
-void SearchRouter::normalize_scores(std::vector<UnifiedSearchResult>& results) const {
+void SearchRouter::normalize_scores(CandidateList& results) const {
     if (results.empty()) return;
 
     // Find max scores for each type
@@ -554,53 +581,59 @@ void SearchRouter::normalize_scores(std::vector<UnifiedSearchResult>& results) c
     }
 }
 
-std::vector<UnifiedSearchResult> SearchRouter::merge_results(
-    std::vector<UnifiedSearchResult>& keyword_results,
-    std::vector<UnifiedSearchResult>& fuzzy_results,
-    std::vector<UnifiedSearchResult>& semantic_results,
-    const SearchQuery& query) const {
+SearchRouter::CandidateList SearchRouter::merge_results(
+    CandidateList& keyword_results,
+    CandidateList& fuzzy_results,
+    CandidateList& semantic_results,
+    const SearchQuery& query,
+    std::pmr::memory_resource* mr) const {
 
     // Normalize individual result sets
     normalize_scores(keyword_results);
     normalize_scores(fuzzy_results);
     normalize_scores(semantic_results);
 
-    // Merge by doc_id
-    std::map<SnippetId, UnifiedSearchResult> merged;
+    // Merge by doc_id: map each doc to its slot in the merged list
+    CandidateList merged(mr);
+    merged.reserve(keyword_results.size() + fuzzy_results.size() +
+                   semantic_results.size());
+    std::pmr::map<SnippetId, size_t> slots(mr);
 
-    for (const auto& r : keyword_results) {
-        merged[r.doc_id].doc_id = r.doc_id;
-        merged[r.doc_id].keyword_score = r.keyword_score;
-        merged[r.doc_id].positions = r.positions;
+    auto slot_for = [&](SnippetId doc_id) -> Candidate& {
+        auto [it, inserted] = slots.try_emplace(doc_id, merged.size());
+        if (inserted) {
+            merged.emplace_back(mr).doc_id = doc_id;
+        }
+        return merged[it->second];
+    };
+
+    for (auto& r : keyword_results) {
+        Candidate& m = slot_for(r.doc_id);
+        m.keyword_score = r.keyword_score;
+        m.positions = std::move(r.positions);
     }
 
-    for (const auto& r : fuzzy_results) {
-        merged[r.doc_id].doc_id = r.doc_id;
-        merged[r.doc_id].fuzzy_score = r.fuzzy_score;
-        if (merged[r.doc_id].matched_text.empty()) {
-            merged[r.doc_id].matched_text = r.matched_text;
+    for (auto& r : fuzzy_results) {
+        Candidate& m = slot_for(r.doc_id);
+        m.fuzzy_score = r.fuzzy_score;
+        if (m.matched_text.empty()) {
+            m.matched_text = std::move(r.matched_text);
         }
     }
 
     for (const auto& r : semantic_results) {
-        merged[r.doc_id].doc_id = r.doc_id;
-        merged[r.doc_id].semantic_score = r.semantic_score;
+        slot_for(r.doc_id).semantic_score = r.semantic_score;
     }
 
     // Calculate final scores
-    std::vector<UnifiedSearchResult> results;
-    results.reserve(merged.size());
-
-    for (auto& [doc_id, result] : merged) {
+    for (auto& result : merged) {
         result.final_score =
             query.keyword_weight * result.keyword_score +
             query.fuzzy_weight * result.fuzzy_score +
             query.semantic_weight * result.semantic_score;
-
-        results.push_back(std::move(result));
     }
 
-    return results;
+    return merged;
 }
 
 // ============================================================================
@@ -637,6 +670,27 @@ PageId SearchRouter::get_trigram_root_page_id() const {
     return trigram_ ? trigram_->get_root_page_id() : INVALID_PAGE_ID;
 }
 
+void SearchRouter::attach_memory_governor(MemoryGovernor* governor) {
+    if (governor_) {
+        if (vector_ && vector_->index()) {
+            governor_->unregister_consumer(vector_->index());
+        }
+        QueryArena::detach_memory_governor(governor_);
+    }
+
+    governor_ = governor;
+    if (vector_) {
+        vector_->attach_memory_governor(governor_);
+    }
+
+    if (governor_) {
+        if (vector_ && vector_->index()) {
+            governor_->register_consumer(vector_->index());
+        }
+        QueryArena::attach_memory_governor(governor_);
+    }
+}
+
 // ============================================================================
 // Factory
 // ============================================================================
@@ -650,6 +704,9 @@ Result<std::unique_ptr<SearchRouter>> SearchRouterFactory::create_from_env(
     if (!init_result.ok()) {
         return init_result.error();
     }
+    if (buffer_pool) {
+        router->attach_memory_governor(buffer_pool->memory_governor());
+    }
     return router;
 }
 
@@ -1,8 +1,10 @@
 #include <dam/search/trigram_index.hpp>
+#include <dam/util/query_arena.hpp>
 
 #include <algorithm>
 #include <cctype>
 #include <cstring>
+#include <iterator>
 #include <map>
 
 namespace dam::search {
@@ -247,6 +249,20 @@ std::set<FileId> TrigramIndex::get_documents_for_trigram(const std::string& trig
     return deserialize_doc_ids(data.value());
 }
 
+void TrigramIndex::read_documents_for_trigram(const std::string& trigram,
+                                              std::pmr::vector<FileId>& out) const {
+    out.clear();
+    auto data = tree_.find(trigram);
+    if (!data.has_value()) {
+        return;
+    }
+
+    const std::string& bytes = data.value();
+    size_t count = bytes.size() / sizeof(FileId);
+    out.resize(count);
+    std::memcpy(out.data(), bytes.data(), count * sizeof(FileId));
+}
+
 Result<std::vector<FileId>> TrigramIndex::search_substring(const std::string& pattern) const {
     if (pattern.empty()) {
         return std::vector<FileId>{};
@@ -261,22 +277,26 @@ Result<std::vector<FileId>> TrigramIndex::search_substring(const std::string& pa
         return std::vector<FileId>{};
     }
 
-    // Find documents that contain ALL pattern trigrams (intersection)
-    std::set<FileId> candidates;
+    QueryArenaScope arena;
+
+    // Find documents that contain ALL pattern trigrams (intersection).
+    // Doc-id lists are stored sorted, so intersection runs on flat vectors.
+    std::pmr::vector<FileId> candidates(arena.resource());
+    std::pmr::vector<FileId> docs(arena.resource());
+    std::pmr::vector<FileId> intersection(arena.resource());
     bool first = true;
 
     for (const auto& trigram : pattern_trigrams) {
-        auto docs = get_documents_for_trigram(trigram);
-
         if (first) {
-            candidates = docs;
+            read_documents_for_trigram(trigram, candidates);
             first = false;
         } else {
-            std::set<FileId> intersection;
+            read_documents_for_trigram(trigram, docs);
+            intersection.clear();
             std::set_intersection(candidates.begin(), candidates.end(),
                                   docs.begin(), docs.end(),
-                                  std::inserter(intersection, intersection.begin()));
-            candidates = std::move(intersection);
+                                  std::back_inserter(intersection));
+            candidates.swap(intersection);
         }
 
         if (candidates.empty()) {
@@ -304,12 +324,15 @@ Result<std::vector<FuzzyResult>> TrigramIndex::search_fuzzy(
         return std::vector<FuzzyResult>{};
     }
 
+    QueryArenaScope arena;
+
     // Collect all potentially matching documents
     // Weight by trigram rarity (IDF-like)
-    std::map<FileId, float> doc_scores;
+    std::pmr::map<FileId, float> doc_scores(arena.resource());
+    std::pmr::vector<FileId> docs(arena.resource());
 
     for (const auto& trigram : query_trigrams) {
-        auto docs = get_documents_for_trigram(trigram);
+        read_documents_for_trigram(trigram, docs);
         for (FileId doc_id : docs) {
             doc_scores[doc_id] += 1.0f;
         }
@@ -1,4 +1,5 @@
 #include <dam/search/vector_index.hpp>
+#include <dam/util/sha256.hpp>
 
 #include <algorithm>
 #include <cmath>
@@ -438,6 +439,19 @@ size_t VectorIndex::size() const {
     return 0;
 }
 
+size_t VectorIndex::memory_usage() const {
+    if (!initialized_) {
+        return 0;
+    }
+
+    // hnswlib preallocates level-0 storage for max_elements:
+    // 2*M links + link count + vector data + label per element
+    size_t per_element = config_.M * 2 * sizeof(uint32_t) + sizeof(uint32_t) +
+                         static_cast<size_t>(config_.dimension) * sizeof(float) +
+                         sizeof(size_t);
+    return config_.max_elements * per_element;
+}
+
 Result<std::unique_ptr<VectorIndex>> VectorIndex::create_with_embedder(
     Embedder* embedder,
     VectorIndexConfig config) {
@@ -461,18 +475,114 @@ Result<std::unique_ptr<VectorIndex>> VectorIndex::create_with_embedder(
 // VectorIndexWithEmbedder Implementation
 // ============================================================================
 
+namespace {
+
+// Approximate heap footprint of one cache entry (map node and order entry)
+size_t cache_entry_bytes(const std::string& hash, const Embedding& embedding) {
+    return 2 * hash.size() + embedding.size() * sizeof(float) + 96;
+}
+
+}  // namespace
+
 VectorIndexWithEmbedder::VectorIndexWithEmbedder(
     std::unique_ptr<VectorIndex> index,
     std::unique_ptr<Embedder> embedder)
     : index_(std::move(index))
     , embedder_(std::move(embedder)) {}
 
+VectorIndexWithEmbedder::~VectorIndexWithEmbedder() {
+    attach_memory_governor(nullptr);
+}
+
+void VectorIndexWithEmbedder::attach_memory_governor(MemoryGovernor* governor) {
+    if (governor_ == governor) {
+        return;
+    }
+    if (governor_) {
+        governor_->unregister_consumer(this);
+    }
+    governor_ = governor;
+    if (governor_) {
+        governor_->register_consumer(this);
+    }
+}
+
+size_t VectorIndexWithEmbedder::reclaim(size_t bytes) {
+    // Called by the governor, possibly while another thread indexes
+    std::unique_lock<std::mutex> lock(cache_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return 0;
+    }
+
+    size_t freed = 0;
+    while (freed < bytes && !cache_order_.empty()) {
+        freed += evict_oldest_locked();
+    }
+    return freed;
+}
+
+bool VectorIndexWithEmbedder::cached_embedding(const std::string& hash,
+                                               Embedding* embedding) const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto it = embedding_cache_.find(hash);
+    if (it == embedding_cache_.end()) {
+        return false;
+    }
+    if (embedding) {
+        *embedding = it->second;
+    }
+    return true;
+}
+
+void VectorIndexWithEmbedder::cache_embedding(const std::string& hash,
+                                              const Embedding& embedding) {
+    if (cached_embedding(hash, nullptr)) {
+        return;
+    }
+
+    // The cache is only an optimization: skip it when the budget is full
+    size_t bytes = cache_entry_bytes(hash, embedding);
+    if (governor_ && !governor_->request(this, bytes)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (!embedding_cache_.emplace(hash, embedding).second) {
+        return;
+    }
+    cache_order_.push_back(hash);
+    cache_bytes_ += bytes;
+    while (cache_order_.size() > MAX_CACHED_EMBEDDINGS) {
+        evict_oldest_locked();
+    }
+}
+
+size_t VectorIndexWithEmbedder::evict_oldest_locked() {
+    auto it = embedding_cache_.find(cache_order_.front());
+    size_t bytes = 0;
+    if (it != embedding_cache_.end()) {
+        bytes = cache_entry_bytes(it->first, it->second);
+        embedding_cache_.erase(it);
+    }
+    cache_order_.pop_front();
+    cache_bytes_ -= bytes;
+    return bytes;
+}
+
 Result<void> VectorIndexWithEmbedder::index_text(FileId doc_id, const std::string& text) {
+    // Identical content shares one embedding
+    std::string hash = SHA256::hex(text);
+    Embedding cached;
+    if (cached_embedding(hash, &cached)) {
+        return index_->add(doc_id, cached);
+    }
+
     auto embedding_result = embedder_->embed(text);
     if (!embedding_result.ok()) {
         return embedding_result.error();
     }
 
+    cache_embedding(hash, embedding_result.value());
     return index_->add(doc_id, embedding_result.value());
 }
 
@@ -485,12 +595,57 @@ Result<void> VectorIndexWithEmbedder::index_batch(
         return Error(ErrorCode::INVALID_ARGUMENT, "Size mismatch");
     }
 
-    auto embeddings_result = embedder_->embed_batch(texts, callback);
-    if (!embeddings_result.ok()) {
-        return embeddings_result.error();
+    // Embed only the distinct texts that are not cached. Hits are copied
+    // now, since the governor may reclaim the cache during the batch.
+    std::vector<std::string> hashes;
+    std::vector<std::string> pending;
+    std::unordered_map<std::string, size_t> pending_slot;
+    std::unordered_map<std::string, Embedding> hits;
+    hashes.reserve(texts.size());
+    for (const auto& text : texts) {
+        hashes.push_back(SHA256::hex(text));
+        const std::string& hash = hashes.back();
+        if (hits.count(hash) || pending_slot.count(hash)) {
+            continue;
+        }
+        Embedding cached;
+        if (cached_embedding(hash, &cached)) {
+            hits.emplace(hash, std::move(cached));
+        } else {
+            pending_slot.emplace(hash, pending.size());
+            pending.push_back(text);
+        }
+    }
+
+    std::vector<Embedding> computed;
+    if (!pending.empty()) {
+        auto embeddings_result = embedder_->embed_batch(pending, callback);
+        if (!embeddings_result.ok()) {
+            return embeddings_result.error();
+        }
+        computed = std::move(embeddings_result.value());
+    }
+
+    std::vector<Embedding> embeddings;
+    embeddings.reserve(texts.size());
+    for (const auto& hash : hashes) {
+        auto slot = pending_slot.find(hash);
+        auto hit = hits.find(hash);
+        if (slot != pending_slot.end() && slot->second < computed.size()) {
+            embeddings.push_back(computed[slot->second]);
+        } else if (hit != hits.end()) {
+            embeddings.push_back(hit->second);
+        } else {
+            return Error(ErrorCode::INTERNAL_ERROR, "Embedding missing from batch");
+        }
+    }
+    for (const auto& [hash, slot] : pending_slot) {
+        if (slot < computed.size()) {
+            cache_embedding(hash, computed[slot]);
+        }
     }
 
-    return index_->add_batch(doc_ids, embeddings_result.value());
+    return index_->add_batch(doc_ids, embeddings);
 }
 
 Result<std::vector<VectorSearchResult>> VectorIndexWithEmbedder::search(
@@ -1,21 +1,286 @@
 #include <dam/snippet_index.hpp>
+#include <dam/util/crc32.hpp>
+#include <dam/util/delta.hpp>
 #include <dam/util/serializer.hpp>
+#include <dam/util/sha256.hpp>
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
 
 namespace dam {
 
+namespace {
+
+// Format byte written after a record's tags, followed by the body codec.
+// Compressed and referenced bodies then add dictionary id(4) and
+// uncompressed size(4). Records from before compression end at the tags.
+// Format 1 was an unversioned trailer and is not read.
+constexpr uint8_t RECORD_FORMAT = 2;
+
+// Bytes a compressed body adds to the record over a raw one
+constexpr size_t COMPRESSED_FIELDS_SIZE = 8;
+
+// Record codec of records whose content field holds a body tree key
+constexpr uint8_t BODY_REFERENCE = 0x80;
+
+// Body tree value: reference count, CRC32 of the content, encoded content
+struct BodyRecord {
+    uint32_t refs = 0;
+    uint32_t crc = 0;
+    uint8_t codec = 0;
+    uint32_t dict_id = 0;
+    uint32_t raw_size = 0;
+    std::string encoded;
+
+    std::string serialize() const {
+        BinaryWriter writer;
+        writer.write_uint32(refs);
+        writer.write_uint32(crc);
+        writer.write_uint8(codec);
+        writer.write_uint32(dict_id);
+        writer.write_uint32(raw_size);
+        writer.write_string(encoded);
+        return writer.data();
+    }
+
+    bool deserialize(const std::string& data) {
+        BinaryReader reader(data);
+        return reader.read_uint32(&refs) && reader.read_uint32(&crc) &&
+               reader.read_uint8(&codec) && reader.read_uint32(&dict_id) &&
+               reader.read_uint32(&raw_size) && reader.read_string(&encoded);
+    }
+};
+
+// History codec of revisions stored as a delta against their successor
+constexpr uint8_t REVISION_DELTA = 0x40;
+
+// History tree value: codec, dictionary id, modification time, content
+// size, then the encoded content or delta
+struct RevisionRecord {
+    uint8_t codec = 0;
+    uint32_t dict_id = 0;
+    uint64_t modified_at = 0;
+    uint32_t raw_size = 0;
+    std::string payload;
+
+    std::string serialize() const {
+        BinaryWriter writer;
+        writer.write_uint8(codec);
+        writer.write_uint32(dict_id);
+        writer.write_uint64(modified_at);
+        writer.write_uint32(raw_size);
+        writer.write_string(payload);
+        return writer.data();
+    }
+
+    bool deserialize(const std::string& data) {
+        BinaryReader reader(data);
+        return reader.read_uint8(&codec) && reader.read_uint32(&dict_id) &&
+               reader.read_uint64(&modified_at) && reader.read_uint32(&raw_size) &&
+               reader.read_string(&payload);
+    }
+};
+
+// "id:revision", zero-padded so revisions sort numerically
+std::string history_key(SnippetId id, uint32_t revision) {
+    std::string number = std::to_string(revision);
+    return std::to_string(id) + ":" + std::string(10 - number.size(), '0') + number;
+}
+
+std::chrono::system_clock::time_point to_time_point(uint64_t ticks) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::system_clock::duration(static_cast<int64_t>(ticks)));
+}
+
+// Dictionaries shorter than this do not pay for themselves
+constexpr size_t MIN_DICTIONARY_SIZE = 64;
+
+// Rewrite a serialized record's tags and modification time, copying the
+// other fields (including the encoded body) through as bytes. Returns
+// false if the record is malformed or its tags would not change.
+bool patch_record_tags(const std::string& record,
+                       const std::vector<std::string>& add_tags,
+                       const std::vector<std::string>& remove_tags,
+                       uint64_t modified_time,
+                       std::string* out) {
+    // id(8) + checksum(4) + created(8), then modified(8)
+    constexpr size_t MODIFIED_OFFSET = 20;
+
+    BinaryReader reader(record);
+    if (!reader.skip(MODIFIED_OFFSET + sizeof(uint64_t))) {
+        return false;
+    }
+
+    // Name, body, language and description
+    for (int i = 0; i < 4; ++i) {
+        uint32_t len = 0;
+        if (!reader.read_uint32(&len) || !reader.skip(len)) {
+            return false;
+        }
+    }
+    size_t tags_start = record.size() - reader.remaining();
+
+    uint32_t tag_count = 0;
+    if (!reader.read_uint32(&tag_count)) {
+        return false;
+    }
+    std::vector<std::string> tags(tag_count);
+    for (auto& tag : tags) {
+        if (!reader.read_string(&tag)) {
+            return false;
+        }
+    }
+    size_t tags_end = record.size() - reader.remaining();
+
+    auto listed = [](const std::vector<std::string>& list, const std::string& tag) {
+        return std::find(list.begin(), list.end(), tag) != list.end();
+    };
+    std::vector<std::string> patched;
+    patched.reserve(tags.size() + add_tags.size());
+    for (const auto& tag : tags) {
+        if (!listed(remove_tags, tag) || listed(add_tags, tag)) {
+            patched.push_back(tag);
+        }
+    }
+    for (const auto& tag : add_tags) {
+        if (!listed(patched, tag)) {
+            patched.push_back(tag);
+        }
+    }
+    if (patched == tags) {
+        return false;
+    }
+
+    BinaryWriter writer;
+    writer.write_raw(record.data(), MODIFIED_OFFSET);
+    writer.write_uint64(modified_time);
+    writer.write_raw(record.data() + MODIFIED_OFFSET + sizeof(uint64_t),
+                     tags_start - MODIFIED_OFFSET - sizeof(uint64_t));
+    writer.write_uint32(static_cast<uint32_t>(patched.size()));
+    for (const auto& tag : patched) {
+        if (!writer.write_string(tag)) {
+            return false;
+        }
+    }
+    writer.write_raw(record.data() + tags_end, record.size() - tags_end);
+    *out = writer.release();
+    return true;
+}
+
+}  // namespace
+
 SnippetIndex::SnippetIndex(BufferPool* buffer_pool,
                            PageId primary_root,
-                           PageId name_root)
+                           PageId name_root,
+                           PageId dict_root,
+                           PageId body_root,
+                           PageId history_root)
     : primary_tree_(buffer_pool, primary_root)
     , name_tree_(buffer_pool, name_root)
+    , dict_tree_(buffer_pool, dict_root)
+    , body_tree_(buffer_pool, body_root)
+    , history_tree_(buffer_pool, history_root)
     , next_id_(1)
-{}
+    // A dictionary record must fit in one leaf
+    , max_dict_size_(std::min(LZ4::MAX_DICTIONARY_SIZE, buffer_pool->page_size() / 2))
+{
+    load_dictionaries();
+}
+
+void SnippetIndex::load_dictionaries() {
+    auto loaded = std::make_shared<DictionarySet>();
+    dict_tree_.for_each([this, &loaded](const std::string& key, const std::string& value) {
+        uint32_t id = 0;
+        try {
+            id = static_cast<uint32_t>(std::stoul(key));
+        } catch (const std::exception&) {
+            return true;  // Skip corrupted entry
+        }
+
+        BinaryReader reader(value);
+        std::string language;
+        std::string dictionary;
+        if (id == 0 || !reader.read_string(&language) || !reader.read_string(&dictionary)) {
+            return true;
+        }
+
+        loaded->by_id[id] = std::move(dictionary);
+        auto it = loaded->latest.find(language);
+        if (it == loaded->latest.end() || it->second < id) {
+            loaded->latest[language] = id;
+        }
+        next_dict_id_ = std::max(next_dict_id_, id + 1);
+        return true;
+    });
+    std::atomic_store(&dictionaries_, std::shared_ptr<const DictionarySet>(std::move(loaded)));
+}
 
-std::string SnippetIndex::serialize(const SnippetMetadata& s) {
+Codec SnippetIndex::encode_body(const std::string& content, const std::string& language,
+                                uint32_t* dict_id, std::string* encoded) const {
+    *dict_id = 0;
+    encoded->clear();
+
+    // Compress the body when it is large enough and compression wins
+    if (!compression_.enabled || content.size() < compression_.min_size ||
+        content.size() > UINT32_MAX) {
+        return Codec::NONE;
+    }
+
+    auto dicts = dictionary_set();
+    auto dict_it = dicts->latest.find(language);
+    std::string_view dictionary;
+    if (dict_it != dicts->latest.end()) {
+        *dict_id = dict_it->second;
+        dictionary = dicts->by_id.at(*dict_id);
+    }
+    *encoded = LZ4::compress(content, dictionary);
+    if (encoded->size() + COMPRESSED_FIELDS_SIZE < content.size()) {
+        return Codec::LZ4;
+    }
+
+    *dict_id = 0;
+    encoded->clear();
+    return Codec::NONE;
+}
+
+bool SnippetIndex::decode_body(uint8_t codec, uint32_t dict_id, uint32_t raw_size,
+                               const std::string& encoded, std::string* content) const {
+    if (codec == static_cast<uint8_t>(Codec::NONE)) {
+        *content = encoded;
+        return content->size() == raw_size;
+    }
+    if (codec != static_cast<uint8_t>(Codec::LZ4)) {
+        return false;
+    }
+
+    auto dicts = dictionary_set();
+    std::string_view dictionary;
+    if (dict_id != 0) {
+        auto it = dicts->by_id.find(dict_id);
+        if (it == dicts->by_id.end()) {
+            return false;
+        }
+        dictionary = it->second;
+    }
+    return LZ4::decompress(encoded, raw_size, content, dictionary);
+}
+
+std::string SnippetIndex::serialize(const SnippetMetadata& s,
+                                    const std::string& body_key) const {
     BinaryWriter writer;
 
+    // Referenced bodies live in the body tree; others are encoded inline
+    uint8_t codec = BODY_REFERENCE;
+    uint32_t dict_id = 0;
+    std::string compressed;
+    if (body_key.empty()) {
+        codec = static_cast<uint8_t>(encode_body(s.content, s.language, &dict_id, &compressed));
+    }
+    const std::string& body = !body_key.empty() ? body_key
+                            : (codec == static_cast<uint8_t>(Codec::NONE)) ? s.content
+                            : compressed;
+
     // Fixed-size fields
     writer.write_uint64(s.id);
     writer.write_uint32(s.checksum);
@@ -27,7 +292,7 @@ std::string SnippetIndex::serialize(const SnippetMetadata& s) {
 
     // Variable-size strings - check for overflow (strings > 4GB)
     if (!writer.write_string(s.name) ||
-        !writer.write_string(s.content) ||
+        !writer.write_string(body) ||
         !writer.write_string(s.language) ||
         !writer.write_string(s.description)) {
         return "";  // Return empty string on overflow
@@ -41,12 +306,25 @@ std::string SnippetIndex::serialize(const SnippetMetadata& s) {
         }
     }
 
+    writer.write_uint8(RECORD_FORMAT);
+    writer.write_uint8(codec);
+    if (codec != static_cast<uint8_t>(Codec::NONE)) {
+        writer.write_uint32(dict_id);
+        writer.write_uint32(static_cast<uint32_t>(s.content.size()));
+    }
+
     return writer.data();
 }
 
-SnippetMetadata SnippetIndex::deserialize(const std::string& data) {
+SnippetMetadata SnippetIndex::deserialize(const std::string& data,
+                                          std::string* body_key,
+                                          bool with_content,
+                                          size_t* content_size) const {
     SnippetMetadata s;
     BinaryReader reader(data);
+    if (body_key) {
+        body_key->clear();
+    }
 
     // Helper to mark object as invalid and return
     auto mark_invalid = [&s]() -> SnippetMetadata& {
@@ -106,6 +384,66 @@ SnippetMetadata SnippetIndex::deserialize(const std::string& data) {
         s.tags.push_back(std::move(tag));
     }
 
+    // Records from before compression end here and are stored raw
+    if (reader.remaining() == 0) {
+        if (content_size) {
+            *content_size = s.content.size();
+        }
+        return s;
+    }
+
+    uint8_t format = 0;
+    uint8_t codec = 0;
+    if (!reader.read_uint8(&format) || format != RECORD_FORMAT ||
+        !reader.read_uint8(&codec)) {
+        return mark_invalid();
+    }
+
+    if (codec == static_cast<uint8_t>(Codec::NONE)) {
+        if (reader.remaining() != 0) {
+            return mark_invalid();
+        }
+        if (content_size) {
+            *content_size = s.content.size();
+        }
+    } else {
+        uint32_t dict_id = 0;
+        uint32_t raw_size = 0;
+        if (!reader.read_uint32(&dict_id) || !reader.read_uint32(&raw_size) ||
+            reader.remaining() != 0) {
+            return mark_invalid();
+        }
+
+        if (content_size) {
+            *content_size = raw_size;
+        }
+        if (!with_content) {
+            s.content.clear();
+            return s;
+        }
+
+        if (codec == BODY_REFERENCE) {
+            auto stored = body_tree_.find(s.content);
+            BodyRecord body;
+            if (!stored.has_value() || !body.deserialize(stored.value()) ||
+                body.raw_size != raw_size) {
+                return mark_invalid();
+            }
+            if (body_key) {
+                *body_key = s.content;
+            }
+            codec = body.codec;
+            dict_id = body.dict_id;
+            s.content = std::move(body.encoded);
+        }
+
+        std::string content;
+        if (!decode_body(codec, dict_id, raw_size, s.content, &content)) {
+            return mark_invalid();
+        }
+        s.content = std::move(content);
+    }
+
     return s;
 }
 
@@ -113,6 +451,209 @@ SnippetId SnippetIndex::generate_id() {
     return next_id_++;
 }
 
+std::string SnippetIndex::acquire_body(const SnippetMetadata& snippet) {
+    const std::string& content = snippet.content;
+    if (!dedup_.enabled || content.size() < dedup_.min_size ||
+        content.size() > UINT32_MAX) {
+        return "";
+    }
+
+    // The hash addresses the body; the CRC is a cheap check against a
+    // colliding or damaged entry before the stored body is shared
+    std::string key = SHA256::hex(content);
+    uint32_t crc = CRC32::compute(content);
+
+    BodyRecord body;
+    auto stored = body_tree_.find(key);
+    if (stored.has_value()) {
+        if (!body.deserialize(stored.value()) || body.crc != crc ||
+            body.raw_size != content.size()) {
+            return "";  // Store this copy inline instead
+        }
+        ++body.refs;
+        return body_tree_.update(key, body.serialize()) ? key : "";
+    }
+
+    body.refs = 1;
+    body.crc = crc;
+    body.raw_size = static_cast<uint32_t>(content.size());
+    body.codec = static_cast<uint8_t>(
+        encode_body(content, snippet.language, &body.dict_id, &body.encoded));
+    if (body.codec == static_cast<uint8_t>(Codec::NONE)) {
+        body.encoded = content;
+    }
+    return body_tree_.insert(key, body.serialize()) ? key : "";
+}
+
+void SnippetIndex::release_body(const std::string& body_key) {
+    if (body_key.empty()) {
+        return;
+    }
+
+    BodyRecord body;
+    auto stored = body_tree_.find(body_key);
+    if (!stored.has_value() || !body.deserialize(stored.value())) {
+        return;
+    }
+
+    if (body.refs <= 1) {
+        body_tree_.remove(body_key);
+    } else {
+        --body.refs;
+        body_tree_.update(body_key, body.serialize());
+    }
+}
+
+void SnippetIndex::reencode_body(const std::string& body_key, const SnippetMetadata& snippet) {
+    BodyRecord body;
+    auto stored = body_tree_.find(body_key);
+    if (!stored.has_value() || !body.deserialize(stored.value())) {
+        return;
+    }
+
+    body.codec = static_cast<uint8_t>(
+        encode_body(snippet.content, snippet.language, &body.dict_id, &body.encoded));
+    if (body.codec == static_cast<uint8_t>(Codec::NONE)) {
+        body.encoded = snippet.content;
+    }
+    body_tree_.update(body_key, body.serialize());
+}
+
+std::vector<std::string> SnippetIndex::history_keys(SnippetId id) const {
+    // Keys "id:..." sort between "id:" and "id;"
+    KeyRange range;
+    range.lower = std::to_string(id) + ":";
+    range.upper = std::to_string(id) + ";";
+    range.has_upper = true;
+
+    std::vector<std::string> keys;
+    history_tree_.for_each_in_range(range, [&keys](const std::string& key, const std::string&) {
+        keys.push_back(key);
+        return true;
+    });
+    return keys;
+}
+
+void SnippetIndex::record_revision(const SnippetMetadata& replaced, uint32_t revision,
+                                   const std::string& successor_content) {
+    if (replaced.content.size() > UINT32_MAX) {
+        return;
+    }
+
+    RevisionRecord record;
+    record.modified_at = static_cast<uint64_t>(replaced.modified_at.time_since_epoch().count());
+    record.raw_size = static_cast<uint32_t>(replaced.content.size());
+
+    // Reverse delta against the successor, unless this is a keyframe or
+    // the delta doesn't beat the content itself
+    if (revision % HISTORY_KEYFRAME_INTERVAL != 0) {
+        record.codec = REVISION_DELTA;
+        record.payload = Delta::encode(successor_content, replaced.content);
+    }
+    if (record.codec != REVISION_DELTA || record.payload.size() >= replaced.content.size()) {
+        record.codec = static_cast<uint8_t>(
+            encode_body(replaced.content, replaced.language, &record.dict_id, &record.payload));
+        if (record.codec == static_cast<uint8_t>(Codec::NONE)) {
+            record.payload = replaced.content;
+        }
+    }
+
+    history_tree_.insert(history_key(replaced.id, revision), record.serialize());
+}
+
+std::optional<SnippetMetadata> SnippetIndex::get_revision(SnippetId id,
+                                                          uint32_t revision) const {
+    auto current = get(id);
+    if (!current.has_value() || current->id == INVALID_SNIPPET_ID) {
+        return std::nullopt;
+    }
+
+    std::vector<RevisionRecord> history;
+    for (const auto& key : history_keys(id)) {
+        auto data = history_tree_.find(key);
+        history.emplace_back();
+        if (!data.has_value() || !history.back().deserialize(data.value())) {
+            return std::nullopt;
+        }
+    }
+
+    if (revision == 0 || revision > history.size() + 1) {
+        return std::nullopt;
+    }
+    if (revision == history.size() + 1) {
+        return current;
+    }
+
+    // Start from the nearest newer version stored whole, then walk the
+    // reverse deltas back down to the requested revision
+    size_t start = revision - 1;
+    while (start < history.size() && history[start].codec == REVISION_DELTA) {
+        ++start;
+    }
+
+    std::string content;
+    if (start == history.size()) {
+        content = current->content;
+    } else {
+        const RevisionRecord& full = history[start];
+        if (!decode_body(full.codec, full.dict_id, full.raw_size, full.payload, &content)) {
+            return std::nullopt;
+        }
+    }
+    for (size_t i = start; i-- > revision - 1;) {
+        std::string older;
+        if (!Delta::apply(content, history[i].payload, &older) ||
+            older.size() != history[i].raw_size) {
+            return std::nullopt;
+        }
+        content = std::move(older);
+    }
+
+    SnippetMetadata snippet = std::move(*current);
+    snippet.content = std::move(content);
+    snippet.modified_at = to_time_point(history[revision - 1].modified_at);
+    snippet.checksum = CRC32::compute(snippet.content);
+    return snippet;
+}
+
+std::vector<SnippetRevision> SnippetIndex::get_revisions(SnippetId id) const {
+    std::vector<SnippetRevision> revisions;
+    auto current = get(id);
+    if (!current.has_value() || current->id == INVALID_SNIPPET_ID) {
+        return revisions;
+    }
+
+    for (const auto& key : history_keys(id)) {
+        auto data = history_tree_.find(key);
+        RevisionRecord record;
+        if (!data.has_value() || !record.deserialize(data.value())) {
+            continue;  // Skip corrupted entry
+        }
+
+        SnippetRevision revision;
+        revision.number = static_cast<uint32_t>(revisions.size() + 1);
+        revision.modified_at = to_time_point(record.modified_at);
+        revision.size = record.raw_size;
+        revisions.push_back(revision);
+    }
+
+    SnippetRevision latest;
+    latest.number = static_cast<uint32_t>(revisions.size() + 1);
+    latest.modified_at = current->modified_at;
+    latest.size = current->content.size();
+    revisions.push_back(latest);
+    return revisions;
+}
+
+uint32_t SnippetIndex::body_references(const std::string& content) const {
+    BodyRecord body;
+    auto stored = body_tree_.find(SHA256::hex(content));
+    if (!stored.has_value() || !body.deserialize(stored.value())) {
+        return 0;
+    }
+    return body.refs;
+}
+
 SnippetId SnippetIndex::insert(const SnippetMetadata& snippet) {
     SnippetMetadata s = snippet;
     if (s.id == INVALID_SNIPPET_ID) {
@@ -120,14 +661,17 @@ SnippetId SnippetIndex::insert(const SnippetMetadata& snippet) {
     }
 
     std::string key = std::to_string(s.id);
-    std::string value = serialize(s);
+    std::string body_key = acquire_body(s);
+    std::string value = serialize(s, body_key);
 
     // Check serialization succeeded (empty = overflow error)
     if (value.empty()) {
+        release_body(body_key);
         return INVALID_SNIPPET_ID;
     }
 
     if (!primary_tree_.insert(key, value)) {
+        release_body(body_key);
         return INVALID_SNIPPET_ID;
     }
 
@@ -135,6 +679,7 @@ SnippetId SnippetIndex::insert(const SnippetMetadata& snippet) {
     if (!name_tree_.insert(s.name, key)) {
         // Rollback: remove from primary tree
         primary_tree_.remove(key);
+        release_body(body_key);
         return INVALID_SNIPPET_ID;
     }
 
@@ -145,34 +690,53 @@ SnippetId SnippetIndex::insert(const SnippetMetadata& snippet) {
 bool SnippetIndex::update(SnippetId id, const SnippetMetadata& snippet) {
     std::string key = std::to_string(id);
 
-    // Serialize first to detect overflow errors early
-    std::string serialized = serialize(snippet);
-    if (serialized.empty()) {
-        return false;  // Serialization failed (overflow)
-    }
-
     // Get old snippet for name update
     auto old_data = primary_tree_.find(key);
     if (!old_data.has_value()) {
         return false;  // Snippet doesn't exist
     }
 
-    SnippetMetadata old_snippet = deserialize(old_data.value());
+    std::string old_body_key;
+    SnippetMetadata old_snippet = deserialize(old_data.value(), &old_body_key);
     if (old_snippet.name != snippet.name) {
         // Renaming: first check new name doesn't already exist
         auto existing = name_tree_.find(snippet.name);
         if (existing.has_value()) {
             return false;  // New name already in use
         }
+    }
+
+    // Serialize before touching the name index to detect overflow errors early
+    std::string body_key = acquire_body(snippet);
+    std::string serialized = serialize(snippet, body_key);
+    if (serialized.empty()) {
+        release_body(body_key);
+        return false;  // Serialization failed (overflow)
+    }
 
+    if (old_snippet.name != snippet.name) {
         // Insert new name first, then remove old (safer order)
         if (!name_tree_.insert(snippet.name, key)) {
+            release_body(body_key);
             return false;
         }
         name_tree_.remove(old_snippet.name);
     }
 
-    return primary_tree_.update(key, serialized);
+    if (!primary_tree_.update(key, serialized)) {
+        release_body(body_key);
+        return false;
+    }
+
+    // The new reference is taken first, so an unchanged body is never dropped
+    release_body(old_body_key);
+
+    // Keep the replaced content as the previous revision
+    if (old_snippet.id != INVALID_SNIPPET_ID && old_snippet.content != snippet.content) {
+        uint32_t revision = static_cast<uint32_t>(history_keys(id).size() + 1);
+        record_revision(old_snippet, revision, snippet.content);
+    }
+    return true;
 }
 
 bool SnippetIndex::remove(SnippetId id) {
@@ -184,12 +748,17 @@ bool SnippetIndex::remove(SnippetId id) {
         return false;  // Snippet doesn't exist
     }
 
-    SnippetMetadata s = deserialize(data.value());
+    std::string body_key;
+    SnippetMetadata s = deserialize(data.value(), &body_key);
 
     // Remove from primary tree first
     if (!primary_tree_.remove(key)) {
         return false;
     }
+    release_body(body_key);
+    for (const auto& history : history_keys(id)) {
+        history_tree_.remove(history);
+    }
 
     // Remove from name index (best effort - log if fails but don't fail remove)
     // Note: name_tree_.remove() failure is logged but doesn't rollback
@@ -201,6 +770,11 @@ bool SnippetIndex::remove(SnippetId id) {
 }
 
 std::optional<SnippetMetadata> SnippetIndex::get(SnippetId id) const {
+    return get(id, true);
+}
+
+std::optional<SnippetMetadata> SnippetIndex::get(SnippetId id, bool with_content,
+                                                 size_t* content_size) const {
     std::string key = std::to_string(id);
     auto data = primary_tree_.find(key);
 
@@ -208,7 +782,42 @@ std::optional<SnippetMetadata> SnippetIndex::get(SnippetId id) const {
         return std::nullopt;
     }
 
-    return deserialize(data.value());
+    return deserialize(data.value(), nullptr, with_content, content_size);
+}
+
+bool SnippetIndex::contains(SnippetId id) const {
+    return primary_tree_.contains(std::to_string(id));
+}
+
+std::vector<SnippetId> SnippetIndex::patch_tags(const std::vector<SnippetId>& ids,
+                                                const std::vector<std::string>& add_tags,
+                                                const std::vector<std::string>& remove_tags,
+                                                std::chrono::system_clock::time_point modified_at) {
+    // Visit records in key order, so each leaf is fetched once
+    std::vector<std::string> keys;
+    keys.reserve(ids.size());
+    for (SnippetId id : ids) {
+        keys.push_back(std::to_string(id));
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    uint64_t modified_time = static_cast<uint64_t>(modified_at.time_since_epoch().count());
+    std::vector<SnippetId> changed;
+    std::string patched;
+    for (const auto& key : keys) {
+        auto record = primary_tree_.find(key);
+        if (!record.has_value() ||
+            !patch_record_tags(record.value(), add_tags, remove_tags, modified_time, &patched)) {
+            continue;
+        }
+        if (primary_tree_.update(key, patched)) {
+            changed.push_back(static_cast<SnippetId>(std::stoull(key)));
+        }
+    }
+
+    std::sort(changed.begin(), changed.end());
+    return changed;
 }
 
 std::optional<SnippetId> SnippetIndex::find_by_name(const std::string& name) const {
@@ -225,20 +834,89 @@ std::optional<SnippetId> SnippetIndex::find_by_name(const std::string& name) con
     }
 }
 
-std::vector<SnippetMetadata> SnippetIndex::get_all() const {
-    std::vector<SnippetMetadata> result;
-    result.reserve(primary_tree_.size());
-
-    primary_tree_.for_each([&result](const std::string&, const std::string& value) {
-        SnippetMetadata snippet = deserialize(value);
-        // Skip corrupted entries with invalid IDs
-        if (snippet.id != INVALID_SNIPPET_ID) {
-            result.push_back(std::move(snippet));
-        }
+std::vector<std::string> SnippetIndex::names() const {
+    std::vector<std::string> result;
+    name_tree_.for_each([&result](const std::string& name, const std::string&) {
+        result.push_back(name);
         return true;
     });
-
     return result;
 }
 
+size_t SnippetIndex::train_dictionary(const std::string& language, size_t max_samples) {
+    auto snippets = filter([&language](const SnippetMetadata& s) {
+        return s.language == language;
+    });
+
+    std::vector<std::string> samples;
+    size_t step = std::max<size_t>(1, snippets.size() / std::max<size_t>(max_samples, 1));
+    for (size_t i = 0; i < snippets.size() && samples.size() < max_samples; i += step) {
+        samples.push_back(snippets[i].content);
+    }
+
+    std::string dictionary = DictionaryTrainer::train(samples, max_dict_size_);
+    if (dictionary.size() < MIN_DICTIONARY_SIZE) {
+        return 0;
+    }
+
+    BinaryWriter writer;
+    writer.write_string(language);
+    writer.write_string(dictionary);
+
+    uint32_t dict_id = next_dict_id_;
+    if (!dict_tree_.insert(std::to_string(dict_id), writer.data())) {
+        return 0;
+    }
+    ++next_dict_id_;
+
+    // Publish a new set; scans already decoding keep the one they hold
+    auto updated = std::make_shared<DictionarySet>(*dictionary_set());
+    updated->by_id[dict_id] = dictionary;
+    updated->latest[language] = dict_id;
+    std::atomic_store(&dictionaries_, std::shared_ptr<const DictionarySet>(std::move(updated)));
+
+    // Re-encode the language's records (or their shared bodies) against
+    // the new dictionary
+    for (const auto& snippet : snippets) {
+        std::string key = std::to_string(snippet.id);
+        std::string body_key;
+        auto data = primary_tree_.find(key);
+        if (data.has_value()) {
+            deserialize(data.value(), &body_key);
+        }
+
+        if (!body_key.empty()) {
+            reencode_body(body_key, snippet);
+            continue;
+        }
+        std::string serialized = serialize(snippet);
+        if (!serialized.empty()) {
+            primary_tree_.update(key, serialized);
+        }
+    }
+
+    return dictionary.size();
+}
+
+std::vector<SnippetMetadata> SnippetIndex::get_all() const {
+    return filter([](const SnippetMetadata&) { return true; });
+}
+
+std::vector<SnippetMetadata> SnippetIndex::filter(
+    const std::function<bool(const SnippetMetadata&)>& predicate) const
+{
+    using Snippets = std::vector<SnippetMetadata>;
+    return parallel_scan<Snippets>(
+        [&predicate](Snippets& partial, SnippetMetadata&& snippet) {
+            if (predicate(snippet)) {
+                partial.push_back(std::move(snippet));
+            }
+        },
+        [](Snippets& into, Snippets&& from) {
+            into.insert(into.end(),
+                        std::make_move_iterator(from.begin()),
+                        std::make_move_iterator(from.end()));
+        });
+}
+
 }  // namespace dam
@@ -0,0 +1,694 @@
+#include <dam/snippet_pack.hpp>
+#include <dam/search/embedder.hpp>
+#include <dam/search/tokenizer.hpp>
+#include <dam/util/compression.hpp>
+#include <dam/util/crc32.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+
+#if defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DAM_HAS_MMAP 1
+#endif
+
+namespace dam {
+
+namespace {
+
+// Pack file structure:
+// - PackHeader
+// - SectionEntry[section_count] (offset table, CRC32 in the header)
+// - Sections, each 8-byte aligned:
+//   RECORDS   SnippetPack::Record[snippet_count], sorted by name
+//   STRINGS   names, languages, descriptions and '\n'-joined tags
+//   BODIES    content, LZ4 blocks or raw
+//   TAGS      posting table keyed by tag
+//   TERMS     posting table keyed by code term
+//   TRIGRAMS  posting table keyed by lowercase trigram
+//   VECTORS   float[snippet_count][vector_dim] (optional)
+//
+// Posting table structure:
+// - uint32: key count
+// - uint32: reserved
+// - TableEntry[key count], sorted by key
+// - uint32[]: postings (record ordinals, ascending per key)
+// - char[]: key bytes
+constexpr char PACK_MAGIC[8] = {'D', 'A', 'M', 'P', 'A', 'C', 'K', '\0'};
+constexpr uint32_t PACK_VERSION = 1;
+
+enum SectionId : uint32_t {
+    SECTION_RECORDS = 1,
+    SECTION_STRINGS = 2,
+    SECTION_BODIES = 3,
+    SECTION_TAGS = 4,
+    SECTION_TERMS = 5,
+    SECTION_TRIGRAMS = 6,
+    SECTION_VECTORS = 7,
+};
+
+struct PackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t snippet_count;
+    uint32_t vector_dim;
+    uint32_t table_checksum;
+};
+
+struct SectionEntry {
+    uint32_t id;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct TableEntry {
+    uint32_t key_offset;
+    uint32_t key_length;
+    uint32_t first_posting;
+    uint32_t posting_count;
+};
+
+static_assert(sizeof(PackHeader) == 32, "PackHeader must be 32 bytes");
+static_assert(sizeof(SectionEntry) == 24, "SectionEntry must be 24 bytes");
+
+constexpr size_t TABLE_HEADER_SIZE = 2 * sizeof(uint32_t);
+
+using Postings = std::map<std::string, std::vector<uint32_t>>;
+
+void pad_to_8(std::string& out) {
+    out.append((8 - out.size() % 8) % 8, '\0');
+}
+
+std::string encode_table(const Postings& postings) {
+    std::vector<TableEntry> entries;
+    entries.reserve(postings.size());
+    std::vector<uint32_t> ordinals;
+    std::string keys;
+    for (const auto& [key, list] : postings) {
+        entries.push_back({static_cast<uint32_t>(keys.size()),
+                           static_cast<uint32_t>(key.size()),
+                           static_cast<uint32_t>(ordinals.size()),
+                           static_cast<uint32_t>(list.size())});
+        ordinals.insert(ordinals.end(), list.begin(), list.end());
+        keys += key;
+    }
+
+    std::string out;
+    uint32_t header[2] = {static_cast<uint32_t>(entries.size()), 0};
+    out.append(reinterpret_cast<const char*>(header), sizeof(header));
+    out.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(TableEntry));
+    out.append(reinterpret_cast<const char*>(ordinals.data()), ordinals.size() * sizeof(uint32_t));
+    out += keys;
+    return out;
+}
+
+std::string to_lower(std::string_view s) {
+    std::string result(s);
+    for (char& c : result) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+// Intersect sorted ordinal lists, shortest first
+std::vector<size_t> intersect(std::vector<std::pair<const uint32_t*, size_t>> lists) {
+    std::vector<size_t> result;
+    if (lists.empty()) {
+        return result;
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const auto& a, const auto& b) { return a.second < b.second; });
+
+    result.assign(lists[0].first, lists[0].first + lists[0].second);
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        const uint32_t* begin = lists[i].first;
+        const uint32_t* end = begin + lists[i].second;
+        auto out = result.begin();
+        for (size_t ordinal : result) {
+            begin = std::lower_bound(begin, end, static_cast<uint32_t>(ordinal));
+            if (begin != end && *begin == ordinal) {
+                *out++ = ordinal;
+            }
+        }
+        result.erase(out, result.end());
+    }
+    return result;
+}
+
+}  // namespace
+
+// ============================================================================
+// On-disk views
+// ============================================================================
+
+struct SnippetPack::Record {
+    int64_t created_at;     // system_clock ticks, as in SnippetIndex
+    int64_t modified_at;
+    uint64_t body_offset;
+    uint32_t body_size;
+    uint32_t raw_size;
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint32_t language_offset;
+    uint32_t language_length;
+    uint32_t description_offset;
+    uint32_t description_length;
+    uint32_t tags_offset;
+    uint32_t tags_length;
+    uint32_t checksum;
+    uint8_t codec;
+    uint8_t reserved[3];
+};
+
+struct SnippetPack::PostingTable {
+    const TableEntry* entries = nullptr;
+    size_t count = 0;
+    const uint32_t* postings = nullptr;
+    size_t posting_count = 0;
+    std::string_view keys;
+
+    std::string_view key(size_t i) const {
+        const TableEntry& e = entries[i];
+        if (e.key_offset > keys.size() || e.key_length > keys.size() - e.key_offset) {
+            return {};
+        }
+        return keys.substr(e.key_offset, e.key_length);
+    }
+
+    // Postings of a key (empty if absent)
+    std::pair<const uint32_t*, size_t> find(std::string_view k) const {
+        size_t lo = 0, hi = count;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (key(mid) < k) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo == count || key(lo) != k) {
+            return {nullptr, 0};
+        }
+        return postings_of(lo);
+    }
+
+    std::pair<const uint32_t*, size_t> postings_of(size_t i) const {
+        const TableEntry& e = entries[i];
+        if (e.first_posting > posting_count || e.posting_count > posting_count - e.first_posting) {
+            return {nullptr, 0};
+        }
+        return {postings + e.first_posting, e.posting_count};
+    }
+};
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+Result<PackStats> SnippetPack::write(const fs::path& path,
+                                     const std::vector<SnippetMetadata>& snippets,
+                                     const PackOptions& options) {
+    // Records are laid out in name order
+    std::vector<const SnippetMetadata*> sorted;
+    sorted.reserve(snippets.size());
+    for (const auto& snippet : snippets) {
+        sorted.push_back(&snippet);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const auto* a, const auto* b) { return a->name < b->name; });
+
+    PackStats stats;
+    stats.snippets = sorted.size();
+
+    std::vector<Record> records(sorted.size());
+    std::string strings;
+    std::string bodies;
+    Postings tags, terms, trigrams;
+    search::Tokenizer tokenizer;
+
+    auto add_string = [&strings](std::string_view s, uint32_t& offset, uint32_t& length) {
+        offset = static_cast<uint32_t>(strings.size());
+        length = static_cast<uint32_t>(s.size());
+        strings.append(s);
+    };
+
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const SnippetMetadata& snippet = *sorted[i];
+        const uint32_t ordinal = static_cast<uint32_t>(i);
+        Record& record = records[i];
+        std::memset(&record, 0, sizeof(record));
+
+        std::string joined_tags;
+        for (const auto& tag : snippet.tags) {
+            if (!joined_tags.empty()) joined_tags += '\n';
+            joined_tags += tag;
+            auto& list = tags[tag];
+            if (list.empty() || list.back() != ordinal) list.push_back(ordinal);
+        }
+
+        record.created_at = snippet.created_at.time_since_epoch().count();
+        record.modified_at = snippet.modified_at.time_since_epoch().count();
+        record.checksum = CRC32::compute(snippet.content);
+        add_string(snippet.name, record.name_offset, record.name_length);
+        add_string(snippet.language, record.language_offset, record.language_length);
+        add_string(snippet.description, record.description_offset, record.description_length);
+        add_string(joined_tags, record.tags_offset, record.tags_length);
+
+        // Keep the LZ4 block only when it is smaller
+        std::string compressed;
+        if (options.compress && !snippet.content.empty()) {
+            compressed = LZ4::compress(snippet.content);
+        }
+        bool use_lz4 = !compressed.empty() && compressed.size() < snippet.content.size();
+        const std::string& body = use_lz4 ? compressed : snippet.content;
+        record.codec = static_cast<uint8_t>(use_lz4 ? Codec::LZ4 : Codec::NONE);
+        record.body_offset = bodies.size();
+        record.body_size = static_cast<uint32_t>(body.size());
+        record.raw_size = static_cast<uint32_t>(snippet.content.size());
+        bodies += body;
+
+        std::set<std::string> snippet_terms;
+        for (auto& term : tokenizer.tokenize_code(snippet.name)) snippet_terms.insert(std::move(term));
+        for (auto& term : tokenizer.tokenize_code(snippet.content)) snippet_terms.insert(std::move(term));
+        for (const auto& term : snippet_terms) {
+            terms[term].push_back(ordinal);
+        }
+
+        std::string text = to_lower(snippet.name + "\n" + snippet.content + "\n" + joined_tags);
+        std::set<std::string_view> snippet_trigrams;
+        for (size_t j = 0; j + 3 <= text.size(); ++j) {
+            snippet_trigrams.insert(std::string_view(text).substr(j, 3));
+        }
+        for (auto trigram : snippet_trigrams) {
+            trigrams[std::string(trigram)].push_back(ordinal);
+        }
+    }
+
+    if (strings.size() > UINT32_MAX) {
+        return Error(ErrorCode::OUT_OF_SPACE, "Pack string section exceeds 4GB");
+    }
+
+    // Optional embeddings, one row per record
+    std::vector<float> vectors;
+    uint32_t vector_dim = 0;
+    if (options.embedder != nullptr && !sorted.empty()) {
+        for (const auto* snippet : sorted) {
+            auto embedding = options.embedder->embed(snippet->name + "\n" + snippet->content);
+            if (!embedding.ok()) {
+                return embedding.error();
+            }
+            if (vector_dim == 0) {
+                vector_dim = static_cast<uint32_t>(embedding.value().size());
+            } else if (embedding.value().size() != vector_dim) {
+                return Error(ErrorCode::INVALID_ARGUMENT, "Embedder returned mixed dimensions");
+            }
+            vectors.insert(vectors.end(), embedding.value().begin(), embedding.value().end());
+        }
+    }
+
+    std::vector<std::pair<uint32_t, std::string>> sections;
+    sections.emplace_back(SECTION_RECORDS, std::string(reinterpret_cast<const char*>(records.data()),
+                                                       records.size() * sizeof(Record)));
+    sections.emplace_back(SECTION_STRINGS, std::move(strings));
+    sections.emplace_back(SECTION_BODIES, std::move(bodies));
+    sections.emplace_back(SECTION_TAGS, encode_table(tags));
+    sections.emplace_back(SECTION_TERMS, encode_table(terms));
+    sections.emplace_back(SECTION_TRIGRAMS, encode_table(trigrams));
+    if (vector_dim > 0) {
+        sections.emplace_back(SECTION_VECTORS, std::string(reinterpret_cast<const char*>(vectors.data()),
+                                                           vectors.size() * sizeof(float)));
+    }
+
+    // Offset table, then the sections in order
+    std::vector<SectionEntry> table(sections.size());
+    uint64_t offset = sizeof(PackHeader) + table.size() * sizeof(SectionEntry);
+    offset = (offset + 7) & ~uint64_t(7);
+    for (size_t i = 0; i < sections.size(); ++i) {
+        table[i] = {sections[i].first, 0, offset, sections[i].second.size()};
+        offset = (offset + sections[i].second.size() + 7) & ~uint64_t(7);
+    }
+
+    PackHeader header;
+    std::memcpy(header.magic, PACK_MAGIC, sizeof(header.magic));
+    header.version = PACK_VERSION;
+    header.section_count = static_cast<uint32_t>(table.size());
+    header.snippet_count = sorted.size();
+    header.vector_dim = vector_dim;
+    header.table_checksum = CRC32::compute(reinterpret_cast<const char*>(table.data()),
+                                           table.size() * sizeof(SectionEntry));
+
+    std::string out;
+    out.reserve(offset);
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.append(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SectionEntry));
+    for (const auto& section : sections) {
+        pad_to_8(out);
+        out += section.second;
+    }
+    pad_to_8(out);
+
+    fs::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return Error(ErrorCode::IO_ERROR, "Failed to create pack: " + tmp.string());
+        }
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        if (!file.good()) {
+            return Error(ErrorCode::IO_ERROR, "Failed to write pack: " + tmp.string());
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        return Error(ErrorCode::IO_ERROR, "Failed to write pack: " + ec.message());
+    }
+
+    stats.bytes = out.size();
+    stats.terms = terms.size();
+    stats.trigrams = trigrams.size();
+    stats.vector_dimension = static_cast<int>(vector_dim);
+    return stats;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+Result<std::unique_ptr<SnippetPack>> SnippetPack::open(const fs::path& path) {
+    auto pack = std::unique_ptr<SnippetPack>(new SnippetPack());
+    pack->path_ = path;
+
+#ifdef DAM_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Error(ErrorCode::NOT_FOUND, "Cannot open pack: " + path.string());
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return Error(ErrorCode::IO_ERROR, "Cannot stat pack: " + path.string());
+    }
+    pack->size_ = static_cast<size_t>(st.st_size);
+    if (pack->size_ > 0) {
+        void* p = ::mmap(nullptr, pack->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            pack->data_ = static_cast<const char*>(p);
+            pack->mapped_ = true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    // No mmap: read the file (heap blocks are aligned enough for the sections)
+    if (!pack->mapped_) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return Error(ErrorCode::NOT_FOUND, "Cannot open pack: " + path.string());
+        }
+        pack->buffer_.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(pack->buffer_.data(), static_cast<std::streamsize>(pack->buffer_.size()));
+        pack->data_ = pack->buffer_.data();
+        pack->size_ = pack->buffer_.size();
+    }
+
+    auto loaded = pack->load();
+    if (!loaded.ok()) {
+        return loaded.error();
+    }
+    return pack;
+}
+
+SnippetPack::~SnippetPack() {
+#ifdef DAM_HAS_MMAP
+    if (mapped_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+Result<void> SnippetPack::load() {
+    static_assert(sizeof(Record) == 72, "Record must be 72 bytes");
+
+    auto corrupt = [this](const std::string& what) {
+        return Error(ErrorCode::CORRUPTION, "Invalid pack " + path_.string() + ": " + what);
+    };
+
+    if (size_ < sizeof(PackHeader)) {
+        return corrupt("file too small");
+    }
+    PackHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0) {
+        return corrupt("bad magic");
+    }
+    if (header.version != PACK_VERSION) {
+        return corrupt("unsupported version " + std::to_string(header.version));
+    }
+
+    size_t table_size = static_cast<size_t>(header.section_count) * sizeof(SectionEntry);
+    if (header.section_count > 64 || size_ - sizeof(PackHeader) < table_size) {
+        return corrupt("bad offset table");
+    }
+    const char* table_data = data_ + sizeof(PackHeader);
+    if (CRC32::compute(table_data, table_size) != header.table_checksum) {
+        return corrupt("offset table checksum mismatch");
+    }
+
+    std::map<uint32_t, std::string_view> sections;
+    for (uint32_t i = 0; i < header.section_count; ++i) {
+        SectionEntry entry;
+        std::memcpy(&entry, table_data + i * sizeof(SectionEntry), sizeof(entry));
+        if (entry.offset % 8 != 0 || entry.offset > size_ || entry.size > size_ - entry.offset) {
+            return corrupt("section out of bounds");
+        }
+        sections[entry.id] = std::string_view(data_ + entry.offset, entry.size);
+    }
+    for (uint32_t id : {SECTION_RECORDS, SECTION_STRINGS, SECTION_BODIES,
+                        SECTION_TAGS, SECTION_TERMS, SECTION_TRIGRAMS}) {
+        if (sections.count(id) == 0) {
+            return corrupt("missing section " + std::to_string(id));
+        }
+    }
+
+    count_ = static_cast<size_t>(header.snippet_count);
+    auto records = sections[SECTION_RECORDS];
+    if (records.size() / sizeof(Record) != count_ || records.size() % sizeof(Record) != 0) {
+        return corrupt("record section size mismatch");
+    }
+    records_ = reinterpret_cast<const Record*>(records.data());
+    strings_ = sections[SECTION_STRINGS];
+    bodies_ = sections[SECTION_BODIES];
+
+    vector_dim_ = header.vector_dim;
+    if (vector_dim_ > 0) {
+        auto vectors = sections[SECTION_VECTORS];
+        if (vectors.size() != count_ * vector_dim_ * sizeof(float)) {
+            return corrupt("vector section size mismatch");
+        }
+        vectors_ = reinterpret_cast<const float*>(vectors.data());
+    }
+
+    for (uint32_t id : {SECTION_TAGS, SECTION_TERMS, SECTION_TRIGRAMS}) {
+        auto section = sections[id];
+        if (section.size() < TABLE_HEADER_SIZE) {
+            return corrupt("posting table too small");
+        }
+        uint32_t keys;
+        std::memcpy(&keys, section.data(), sizeof(keys));
+        size_t entries_size = static_cast<size_t>(keys) * sizeof(TableEntry);
+        if (section.size() - TABLE_HEADER_SIZE < entries_size) {
+            return corrupt("posting table truncated");
+        }
+
+        PostingTable table;
+        table.entries = reinterpret_cast<const TableEntry*>(section.data() + TABLE_HEADER_SIZE);
+        table.count = keys;
+
+        // Postings run up to the first key byte
+        size_t postings_start = TABLE_HEADER_SIZE + entries_size;
+        size_t total = 0;
+        for (size_t i = 0; i < table.count; ++i) {
+            total = std::max<size_t>(total, static_cast<size_t>(table.entries[i].first_posting) +
+                                            table.entries[i].posting_count);
+        }
+        if ((section.size() - postings_start) / sizeof(uint32_t) < total) {
+            return corrupt("posting table truncated");
+        }
+        table.postings = reinterpret_cast<const uint32_t*>(section.data() + postings_start);
+        table.posting_count = total;
+        table.keys = section.substr(postings_start + total * sizeof(uint32_t));
+        tables_.push_back(table);
+    }
+
+    return Ok();
+}
+
+const SnippetPack::PostingTable* SnippetPack::table(uint32_t section) const {
+    size_t index = section - SECTION_TAGS;
+    return index < tables_.size() ? &tables_[index] : nullptr;
+}
+
+std::string_view SnippetPack::string_at(uint32_t offset, uint32_t length) const {
+    if (offset > strings_.size() || length > strings_.size() - offset) {
+        return {};
+    }
+    return strings_.substr(offset, length);
+}
+
+std::string_view SnippetPack::name(size_t ordinal) const {
+    if (ordinal >= count_) return {};
+    return string_at(records_[ordinal].name_offset, records_[ordinal].name_length);
+}
+
+std::string_view SnippetPack::language(size_t ordinal) const {
+    if (ordinal >= count_) return {};
+    return string_at(records_[ordinal].language_offset, records_[ordinal].language_length);
+}
+
+Result<SnippetMetadata> SnippetPack::get(size_t ordinal) const {
+    if (ordinal >= count_) {
+        return Error(ErrorCode::NOT_FOUND, "Snippet not found");
+    }
+    const Record& record = records_[ordinal];
+
+    SnippetMetadata snippet;
+    snippet.name = std::string(name(ordinal));
+    snippet.language = std::string(language(ordinal));
+    snippet.description = std::string(string_at(record.description_offset,
+                                                record.description_length));
+    snippet.created_at = std::chrono::system_clock::time_point(
+        std::chrono::system_clock::duration(record.created_at));
+    snippet.modified_at = std::chrono::system_clock::time_point(
+        std::chrono::system_clock::duration(record.modified_at));
+    snippet.checksum = record.checksum;
+
+    std::string_view tags = string_at(record.tags_offset, record.tags_length);
+    while (!tags.empty()) {
+        size_t end = std::min(tags.find('\n'), tags.size());
+        snippet.tags.emplace_back(tags.substr(0, end));
+        tags.remove_prefix(std::min(end + 1, tags.size()));
+    }
+
+    if (record.body_offset > bodies_.size() || record.body_size > bodies_.size() - record.body_offset) {
+        return Error(ErrorCode::CORRUPTION, "Pack body out of bounds");
+    }
+    std::string_view body = bodies_.substr(record.body_offset, record.body_size);
+    if (record.codec == static_cast<uint8_t>(Codec::LZ4)) {
+        if (!LZ4::decompress(body, record.raw_size, &snippet.content)) {
+            return Error(ErrorCode::CORRUPTION, "Pack body failed to decompress");
+        }
+    } else {
+        snippet.content = std::string(body);
+    }
+
+    return snippet;
+}
+
+std::optional<std::string_view> SnippetPack::stored_body(size_t ordinal) const {
+    if (ordinal >= count_) {
+        return std::nullopt;
+    }
+    const Record& record = records_[ordinal];
+    if (record.codec != static_cast<uint8_t>(Codec::NONE) ||
+        record.body_offset > bodies_.size() || record.body_size > bodies_.size() - record.body_offset) {
+        return std::nullopt;
+    }
+    return bodies_.substr(record.body_offset, record.body_size);
+}
+
+uint32_t SnippetPack::checksum(size_t ordinal) const {
+    return ordinal < count_ ? records_[ordinal].checksum : 0;
+}
+
+std::optional<size_t> SnippetPack::find(std::string_view target) const {
+    size_t lo = 0, hi = count_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (name(mid) < target) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < count_ && name(lo) == target) {
+        return lo;
+    }
+    return std::nullopt;
+}
+
+std::vector<size_t> SnippetPack::find_by_tag(std::string_view tag) const {
+    auto [postings, n] = table(SECTION_TAGS)->find(tag);
+    return std::vector<size_t>(postings, postings + n);
+}
+
+std::vector<std::pair<std::string, size_t>> SnippetPack::tag_counts() const {
+    const PostingTable* tags = table(SECTION_TAGS);
+    std::vector<std::pair<std::string, size_t>> result;
+    result.reserve(tags->count);
+    for (size_t i = 0; i < tags->count; ++i) {
+        result.emplace_back(std::string(tags->key(i)), tags->postings_of(i).second);
+    }
+    return result;
+}
+
+std::vector<size_t> SnippetPack::search_terms(const std::string& query) const {
+    search::Tokenizer tokenizer;
+    std::set<std::string> query_terms;
+    for (auto& term : tokenizer.tokenize_code(query)) query_terms.insert(std::move(term));
+
+    const PostingTable* terms = table(SECTION_TERMS);
+    std::vector<std::pair<const uint32_t*, size_t>> lists;
+    for (const auto& term : query_terms) {
+        auto list = terms->find(term);
+        if (list.second == 0) {
+            return {};
+        }
+        lists.push_back(list);
+    }
+    return intersect(std::move(lists));
+}
+
+std::optional<std::vector<size_t>> SnippetPack::substring_candidates(const std::string& pattern) const {
+    std::string lower = to_lower(pattern);
+    if (lower.size() < 3) {
+        return std::nullopt;
+    }
+
+    std::set<std::string_view> pattern_trigrams;
+    for (size_t i = 0; i + 3 <= lower.size(); ++i) {
+        pattern_trigrams.insert(std::string_view(lower).substr(i, 3));
+    }
+
+    const PostingTable* trigrams = table(SECTION_TRIGRAMS);
+    std::vector<std::pair<const uint32_t*, size_t>> lists;
+    for (auto trigram : pattern_trigrams) {
+        auto list = trigrams->find(trigram);
+        if (list.second == 0) {
+            return std::vector<size_t>{};
+        }
+        lists.push_back(list);
+    }
+    return intersect(std::move(lists));
+}
+
+const float* SnippetPack::vector(size_t ordinal) const {
+    if (vectors_ == nullptr || ordinal >= count_) {
+        return nullptr;
+    }
+    return vectors_ + ordinal * vector_dim_;
+}
+
+}  // namespace dam
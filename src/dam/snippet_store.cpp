@@ -2,8 +2,11 @@
 #include <dam/util/crc32.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 
 namespace dam {
 
@@ -15,6 +18,14 @@ namespace {
 // - uint32: snippet_index name root
 // - uint32: tag_index root
 // - uint64: next_id
+// - uint64: snippet_count
+// - uint32: compression dictionary root (absent in older files)
+// - uint32: reserved
+// - uint32: shared body root (absent in older files)
+// - uint32: reserved
+// - uint32: revision history root (absent in older files)
+// - uint32: similarity index root (absent in older files)
+// - uint32: page LSN counter (absent in older files)
 constexpr uint32_t METADATA_MAGIC = 0xDAD01234;
 
 struct StoreMetadata {
@@ -24,21 +35,55 @@ struct StoreMetadata {
     PageId tag_root = INVALID_PAGE_ID;
     uint64_t next_id = 1;
     uint64_t snippet_count = 0;
+    PageId dict_root = INVALID_PAGE_ID;
+    uint32_t reserved = 0;  // Was struct padding; may hold garbage in older files
+    PageId body_root = INVALID_PAGE_ID;
+    uint32_t reserved2 = 0;  // Likewise
+    PageId history_root = INVALID_PAGE_ID;
+    PageId similarity_root = INVALID_PAGE_ID;
+    uint32_t page_lsn = 1;
 };
 
+// Size of the metadata written before fields were appended
+constexpr size_t LEGACY_METADATA_SIZE = offsetof(StoreMetadata, dict_root);
+
+// Bytes written; trailing struct padding is left out of the file
+constexpr size_t METADATA_SIZE = offsetof(StoreMetadata, page_lsn) + sizeof(uint32_t);
+
+// read_content() hands bodies over in chunks of this size
+constexpr size_t CONTENT_CHUNK_SIZE = 64 * 1024;
+
 bool load_metadata(const fs::path& path, StoreMetadata& meta) {
     std::ifstream file(path, std::ios::binary);
     if (!file) return false;
 
-    file.read(reinterpret_cast<char*>(&meta), sizeof(meta));
-    return file.good() && meta.magic == METADATA_MAGIC;
+    // Older files end early; the missing fields keep their defaults
+    file.read(reinterpret_cast<char*>(&meta), METADATA_SIZE);
+    return static_cast<size_t>(file.gcount()) >= LEGACY_METADATA_SIZE &&
+           meta.magic == METADATA_MAGIC;
+}
+
+std::string lowercase(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+    return s;
+}
+
+// The text filter of a selector: a substring of the name, content or a tag
+bool matches_text(const SnippetMetadata& snippet, const std::string& text_lower) {
+    if (lowercase(snippet.name).find(text_lower) != std::string::npos ||
+        lowercase(snippet.content).find(text_lower) != std::string::npos) {
+        return true;
+    }
+    return std::any_of(snippet.tags.begin(), snippet.tags.end(), [&](const std::string& tag) {
+        return lowercase(tag).find(text_lower) != std::string::npos;
+    });
 }
 
 bool save_metadata(const fs::path& path, const StoreMetadata& meta) {
     std::ofstream file(path, std::ios::binary | std::ios::trunc);
     if (!file) return false;
 
-    file.write(reinterpret_cast<const char*>(&meta), sizeof(meta));
+    file.write(reinterpret_cast<const char*>(&meta), METADATA_SIZE);
     return file.good();
 }
 
@@ -64,25 +109,54 @@ Result<std::unique_ptr<SnippetStore>> SnippetStore::open(const Config& config) {
     fs::path meta_path = config.root_directory / "dam.meta";
 
     // Initialize disk manager
-    store->disk_manager_ = std::make_unique<DiskManager>(db_path);
+    store->disk_manager_ = std::make_unique<DiskManager>(db_path, config.page_size);
     if (!store->disk_manager_->is_valid()) {
         return Error(ErrorCode::IO_ERROR,
                                "Failed to open database file");
     }
 
-    // Initialize buffer pool
+    // Initialize buffer pool (explicit frame count wins over the byte budget)
+    size_t page_size = store->disk_manager_->get_page_size();
+    size_t pool_frames = config.buffer_pool_size > 0
+        ? config.buffer_pool_size
+        : BufferPool::frames_for_budget(config.buffer_pool_bytes, page_size);
+    size_t max_frames = config.memory_budget_bytes / page_size;
     store->buffer_pool_ = std::make_unique<BufferPool>(
-        config.buffer_pool_size, store->disk_manager_.get());
+        pool_frames, store->disk_manager_.get(), max_frames);
+
+    // Let the pool grow into the shared budget when it pays off
+    if (config.memory_budget_bytes > 0) {
+        store->memory_governor_ =
+            std::make_unique<MemoryGovernor>(config.memory_budget_bytes);
+        BufferPoolPolicy policy;
+        policy.min_frames = std::min(policy.min_frames, pool_frames);
+        store->buffer_pool_->enable_adaptive_sizing(
+            store->memory_governor_.get(), policy);
+    }
 
     // Load metadata (if exists)
     StoreMetadata meta;
     load_metadata(meta_path, meta);
+    store->disk_manager_->set_lsn(meta.page_lsn);
 
     // Initialize indexes with persisted root page IDs
     store->snippet_index_ = std::make_unique<SnippetIndex>(
         store->buffer_pool_.get(),
         meta.snippet_primary_root,
-        meta.snippet_name_root);
+        meta.snippet_name_root,
+        meta.dict_root,
+        meta.body_root,
+        meta.history_root);
+
+    CompressionOptions compression;
+    compression.enabled = config.compress_content;
+    compression.min_size = config.compression_threshold;
+    store->snippet_index_->set_compression(compression);
+
+    DeduplicationOptions dedup;
+    dedup.enabled = config.dedup_content;
+    dedup.min_size = config.dedup_threshold;
+    store->snippet_index_->set_deduplication(dedup);
 
     // Reset next_id to 1 if store is empty (allows ID reuse after all snippets removed)
     if (meta.snippet_count == 0) {
@@ -97,8 +171,52 @@ Result<std::unique_ptr<SnippetStore>> SnippetStore::open(const Config& config) {
         store->buffer_pool_.get(),
         meta.tag_root);
 
+    // Stores from before the similarity index get one built on first open,
+    // and one in an older key layout is rebuilt
+    store->similarity_index_ = std::make_unique<SimilarityIndex>(
+        store->buffer_pool_.get(),
+        meta.similarity_root);
+    if (meta.similarity_root == INVALID_PAGE_ID ||
+        !store->similarity_index_->has_current_layout()) {
+        auto cleared = store->similarity_index_->clear();
+        if (!cleared.ok()) {
+            return cleared.error();
+        }
+        for (const auto& snippet : store->snippet_index_->get_all()) {
+            auto indexed = store->similarity_index_->add(snippet.id, snippet.content);
+            if (!indexed.ok()) {
+                return indexed.error();
+            }
+        }
+    }
+
     store->is_open_ = true;
 
+    // Mount distributed packs in file name order, so their IDs are stable
+    std::vector<fs::path> pack_files;
+    for (const auto& entry : fs::directory_iterator(config.root_directory / "packs", ec)) {
+        if (entry.path().extension() == ".dampack") {
+            pack_files.push_back(entry.path());
+        }
+    }
+    std::sort(pack_files.begin(), pack_files.end());
+    for (const auto& pack_file : pack_files) {
+        auto mounted = store->mount_pack(pack_file);
+        if (!mounted.ok()) {
+            std::cerr << "Warning: skipping pack: " << mounted.error().message() << std::endl;
+        }
+    }
+
+    // Rebuild the completion index if it is missing or older than a pack
+    fs::path completion_path = config.root_directory / CompletionIndex::FILE_NAME;
+    auto completion_time = fs::last_write_time(completion_path, ec);
+    store->completions_stale_ = static_cast<bool>(ec);
+    for (const auto& pack_file : pack_files) {
+        if (!store->completions_stale_ && fs::last_write_time(pack_file, ec) > completion_time) {
+            store->completions_stale_ = true;
+        }
+    }
+
     if (config.verbose) {
         std::cout << "DAM store opened at: " << config.root_directory << std::endl;
     }
@@ -109,28 +227,50 @@ Result<std::unique_ptr<SnippetStore>> SnippetStore::open(const Config& config) {
 void SnippetStore::close() {
     if (!is_open_) return;
 
-    // Save metadata before closing
+    checkpoint();
+
+    // Release resources
+    packs_.clear();
+    similarity_index_.reset();
+    tag_index_.reset();
+    snippet_index_.reset();
+    buffer_pool_.reset();
+    disk_manager_.reset();
+    memory_governor_.reset();
+
+    is_open_ = false;
+}
+
+Result<void> SnippetStore::checkpoint() {
+    // Save metadata, then flush the pages it points at
     fs::path meta_path = root_dir_ / "dam.meta";
     StoreMetadata meta;
     meta.snippet_primary_root = snippet_index_->get_primary_root_id();
     meta.snippet_name_root = snippet_index_->get_name_root_id();
+    meta.dict_root = snippet_index_->get_dict_root_id();
+    meta.body_root = snippet_index_->get_body_root_id();
+    meta.history_root = snippet_index_->get_history_root_id();
+    meta.similarity_root = similarity_index_->get_root_page_id();
     meta.tag_root = tag_index_->get_root_page_id();
     meta.next_id = snippet_index_->get_next_id();
     meta.snippet_count = static_cast<uint64_t>(snippet_index_->size());
-    save_metadata(meta_path, meta);
+    meta.page_lsn = disk_manager_->get_lsn();
+    bool saved = save_metadata(meta_path, meta);
 
-    // Flush buffer pool
     if (buffer_pool_) {
         buffer_pool_->flush_all_pages();
     }
 
-    // Release resources
-    tag_index_.reset();
-    snippet_index_.reset();
-    buffer_pool_.reset();
-    disk_manager_.reset();
+    // The completion index is only a cache; a failed write is retried at
+    // the next checkpoint
+    if (completions_stale_ && write_completion_index().ok()) {
+        completions_stale_ = false;
+    }
 
-    is_open_ = false;
+    if (!saved) {
+        return Error(ErrorCode::IO_ERROR, "Failed to save store metadata");
+    }
+    return Ok();
 }
 
 Result<SnippetId> SnippetStore::add(const std::string& content,
@@ -211,6 +351,14 @@ Result<SnippetId> SnippetStore::add(const std::string& content,
                                "Failed to add tags to snippet");
     }
 
+    auto indexed = similarity_index_->add(id, content);
+    if (!indexed.ok()) {
+        // A failed add leaves nothing behind
+        tag_index_->remove_file_from_all_tags(id, tags);
+        snippet_index_->remove(id);
+        return indexed.error();
+    }
+    completions_stale_ = true;
     return id;
 }
 
@@ -218,6 +366,9 @@ Result<SnippetMetadata> SnippetStore::get(SnippetId id) const {
     if (!is_open_) {
         return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
     }
+    if (is_pack_snippet(id)) {
+        return get_pack_snippet(id);
+    }
     auto result = snippet_index_->get(id);
     if (!result.has_value()) {
         return Error(ErrorCode::NOT_FOUND, "Snippet not found");
@@ -225,21 +376,105 @@ Result<SnippetMetadata> SnippetStore::get(SnippetId id) const {
     return result.value();
 }
 
-Result<SnippetId> SnippetStore::find_by_name(const std::string& name) const {
+Result<uint64_t> SnippetStore::read_content(SnippetId id, const ContentSink& sink) const {
     if (!is_open_) {
         return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
     }
-    auto result = snippet_index_->find_by_name(name);
+
+    std::string decoded;
+    std::string_view content;
+    uint32_t checksum = 0;
+    if (is_pack_snippet(id)) {
+        size_t pack = static_cast<size_t>(id >> PACK_ID_SHIFT) - 1;
+        size_t ordinal = static_cast<size_t>(id & ((SnippetId(1) << PACK_ID_SHIFT) - 1));
+        if (pack >= packs_.size() || ordinal >= packs_[pack]->size()) {
+            return Error(ErrorCode::NOT_FOUND, "Snippet not found");
+        }
+        checksum = packs_[pack]->checksum(ordinal);
+        if (auto body = packs_[pack]->stored_body(ordinal)) {
+            content = *body;
+        } else {
+            auto snippet = packs_[pack]->get(ordinal);
+            if (!snippet.ok()) {
+                return snippet.error();
+            }
+            decoded = std::move(snippet.value().content);
+            content = decoded;
+        }
+    } else {
+        auto snippet = snippet_index_->get(id);
+        if (!snippet.has_value()) {
+            return Error(ErrorCode::NOT_FOUND, "Snippet not found");
+        }
+        checksum = snippet->checksum;
+        decoded = std::move(snippet->content);
+        content = decoded;
+    }
+
+    // Each chunk is checksummed while it is still in cache for the sink
+    uint32_t crc = 0;
+    uint64_t written = 0;
+    while (written < content.size()) {
+        std::string_view chunk = content.substr(written, CONTENT_CHUNK_SIZE);
+        crc = CRC32::update(crc, reinterpret_cast<const uint8_t*>(chunk.data()), chunk.size());
+        if (!sink(chunk)) {
+            return Error(ErrorCode::IO_ERROR, "Failed to write snippet content");
+        }
+        written += chunk.size();
+    }
+    if (crc != checksum) {
+        return Error(ErrorCode::CORRUPTION, "Snippet content checksum mismatch");
+    }
+    return written;
+}
+
+Result<SnippetMetadata> SnippetStore::get_revision(SnippetId id, uint32_t revision) const {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+    auto result = snippet_index_->get_revision(id, revision);
     if (!result.has_value()) {
-        return Error(ErrorCode::NOT_FOUND, "Snippet not found");
+        return Error(ErrorCode::NOT_FOUND, "Revision not found");
     }
     return result.value();
 }
 
+Result<std::vector<SnippetRevision>> SnippetStore::get_revisions(SnippetId id) const {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+    auto revisions = snippet_index_->get_revisions(id);
+    if (revisions.empty()) {
+        return Error(ErrorCode::NOT_FOUND, "Snippet not found");
+    }
+    return revisions;
+}
+
+Result<SnippetId> SnippetStore::find_by_name(const std::string& name) const {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+    auto result = snippet_index_->find_by_name(name);
+    if (result.has_value()) {
+        return result.value();
+    }
+
+    for (size_t pack = 0; pack < packs_.size(); ++pack) {
+        auto ordinal = packs_[pack]->find(name);
+        if (ordinal.has_value()) {
+            return pack_snippet_id(pack, *ordinal);
+        }
+    }
+    return Error(ErrorCode::NOT_FOUND, "Snippet not found");
+}
+
 Result<void> SnippetStore::remove(SnippetId id) {
     if (!is_open_) {
         return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
     }
+    if (is_pack_snippet(id)) {
+        return Error(ErrorCode::PERMISSION_DENIED, "Snippet belongs to a read-only pack");
+    }
 
     auto snippet = snippet_index_->get(id);
     if (!snippet.has_value()) {
@@ -259,6 +494,11 @@ Result<void> SnippetStore::remove(SnippetId id) {
                                "Failed to remove snippet");
     }
 
+    auto unindexed = similarity_index_->remove(id);
+    completions_stale_ = true;
+    if (!unindexed.ok()) {
+        return unindexed.error();
+    }
     return Ok();
 }
 
@@ -271,6 +511,9 @@ Result<void> SnippetStore::update(SnippetId id,
     if (!is_open_) {
         return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
     }
+    if (is_pack_snippet(id)) {
+        return Error(ErrorCode::PERMISSION_DENIED, "Snippet belongs to a read-only pack");
+    }
 
     if (name.empty()) {
         return Error(ErrorCode::INVALID_ARGUMENT, "Snippet name cannot be empty");
@@ -367,6 +610,64 @@ Result<void> SnippetStore::update(SnippetId id,
         return Error(ErrorCode::INTERNAL_ERROR, "Failed to update snippet");
     }
 
+    completions_stale_ = true;
+    if (content != existing->content) {
+        auto indexed = similarity_index_->add(id, content);
+        if (!indexed.ok()) {
+            return indexed.error();
+        }
+    }
+    return Ok();
+}
+
+Result<void> SnippetStore::annotate(SnippetId id,
+                                     const std::string& description,
+                                     const std::vector<std::string>& tags) {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+    if (is_pack_snippet(id)) {
+        return Error(ErrorCode::PERMISSION_DENIED, "Snippet belongs to a read-only pack");
+    }
+
+    auto existing = snippet_index_->get(id);
+    if (!existing.has_value()) {
+        return Error(ErrorCode::NOT_FOUND, "Snippet not found");
+    }
+
+    std::set<std::string> old_tags(existing->tags.begin(), existing->tags.end());
+    std::set<std::string> new_tags(tags.begin(), tags.end());
+    std::vector<std::string> added_tags;
+    for (const auto& tag : new_tags) {
+        if (old_tags.count(tag)) {
+            continue;
+        }
+        if (!tag_index_->add_file_to_tag(tag, id)) {
+            for (const auto& added : added_tags) {
+                tag_index_->remove_file_from_tag(added, id);
+            }
+            return Error(ErrorCode::INTERNAL_ERROR, "Failed to update tags");
+        }
+        added_tags.push_back(tag);
+    }
+
+    // The content is unchanged, so SnippetIndex records no revision
+    SnippetMetadata annotated = std::move(*existing);
+    annotated.description = description;
+    annotated.tags = tags;
+    if (!snippet_index_->update(id, annotated)) {
+        for (const auto& added : added_tags) {
+            tag_index_->remove_file_from_tag(added, id);
+        }
+        return Error(ErrorCode::INTERNAL_ERROR, "Failed to update snippet");
+    }
+
+    for (const auto& tag : old_tags) {
+        if (!new_tags.count(tag)) {
+            tag_index_->remove_file_from_tag(tag, id);
+        }
+    }
+    completions_stale_ = true;
     return Ok();
 }
 
@@ -374,6 +675,9 @@ Result<void> SnippetStore::add_tag(SnippetId id, const std::string& tag) {
     if (!is_open_) {
         return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
     }
+    if (is_pack_snippet(id)) {
+        return Error(ErrorCode::PERMISSION_DENIED, "Snippet belongs to a read-only pack");
+    }
 
     auto snippet = snippet_index_->get(id);
     if (!snippet.has_value()) {
@@ -407,6 +711,7 @@ Result<void> SnippetStore::add_tag(SnippetId id, const std::string& tag) {
                                "Failed to update snippet");
     }
 
+    completions_stale_ = true;
     return Ok();
 }
 
@@ -414,6 +719,9 @@ Result<void> SnippetStore::remove_tag(SnippetId id, const std::string& tag) {
     if (!is_open_) {
         return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
     }
+    if (is_pack_snippet(id)) {
+        return Error(ErrorCode::PERMISSION_DENIED, "Snippet belongs to a read-only pack");
+    }
 
     auto snippet = snippet_index_->get(id);
     if (!snippet.has_value()) {
@@ -447,14 +755,143 @@ Result<void> SnippetStore::remove_tag(SnippetId id, const std::string& tag) {
                                "Failed to update snippet");
     }
 
+    completions_stale_ = true;
     return Ok();
 }
 
+Result<SnippetSelector> SnippetSelector::parse(const std::string& query) {
+    SnippetSelector selector;
+    std::istringstream words(query);
+    std::string word;
+    while (words >> word) {
+        if (word.rfind("tag:", 0) == 0 && word.size() > 4) {
+            selector.tags.push_back(word.substr(4));
+        } else if (word.rfind("lang:", 0) == 0 && word.size() > 5) {
+            selector.language = word.substr(5);
+        } else if (word.rfind("id:", 0) == 0) {
+            try {
+                size_t used = 0;
+                selector.ids.push_back(std::stoull(word.substr(3), &used));
+                if (used != word.size() - 3) throw std::invalid_argument(word);
+            } catch (const std::exception&) {
+                return Error(ErrorCode::INVALID_ARGUMENT, "Invalid snippet ID: " + word.substr(3));
+            }
+        } else {
+            if (!selector.text.empty()) selector.text += ' ';
+            selector.text += word;
+        }
+    }
+    return selector;
+}
+
+Result<std::vector<SnippetId>> SnippetStore::select(const SnippetSelector& selector) const {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+    if (selector.empty()) {
+        return Error(ErrorCode::INVALID_ARGUMENT, "Selector matches nothing");
+    }
+
+    // IDs and tags narrow the candidates without reading any record
+    std::optional<std::set<SnippetId>> candidates;
+    if (!selector.ids.empty()) {
+        candidates.emplace();
+        for (SnippetId id : selector.ids) {
+            if (!is_pack_snippet(id) && snippet_index_->contains(id)) {
+                candidates->insert(id);
+            }
+        }
+    }
+    if (!selector.tags.empty()) {
+        std::set<SnippetId> tagged = tag_index_->get_files_for_all_tags(selector.tags);
+        if (candidates.has_value()) {
+            std::set<SnippetId> both;
+            std::set_intersection(candidates->begin(), candidates->end(),
+                                  tagged.begin(), tagged.end(),
+                                  std::inserter(both, both.end()));
+            candidates = std::move(both);
+        } else {
+            candidates = std::move(tagged);
+        }
+    }
+
+    std::string text_lower = lowercase(selector.text);
+    auto matches = [&](const SnippetMetadata& snippet) {
+        return (selector.language.empty() || snippet.language == selector.language) &&
+               (text_lower.empty() || matches_text(snippet, text_lower));
+    };
+    bool reads_records = !selector.language.empty() || !selector.text.empty();
+
+    std::vector<SnippetId> ids;
+    if (!candidates.has_value()) {
+        for (const auto& snippet : snippet_index_->filter(matches)) {
+            ids.push_back(snippet.id);
+        }
+        std::sort(ids.begin(), ids.end());
+    } else if (!reads_records) {
+        ids.assign(candidates->begin(), candidates->end());
+    } else {
+        for (SnippetId id : *candidates) {
+            auto snippet = snippet_index_->get(id);
+            if (snippet.has_value() && matches(*snippet)) {
+                ids.push_back(id);
+            }
+        }
+    }
+    return ids;
+}
+
+Result<size_t> SnippetStore::retag(const SnippetSelector& selector,
+                                   const std::vector<std::string>& add_tags,
+                                   const std::vector<std::string>& remove_tags) {
+    auto selected = select(selector);
+    if (!selected.ok()) {
+        return selected.error();
+    }
+
+    std::vector<SnippetId> changed = snippet_index_->patch_tags(
+        selected.value(), add_tags, remove_tags, std::chrono::system_clock::now());
+    if (changed.empty()) {
+        return size_t{0};
+    }
+
+    // One set difference or union per tag, over the snippets that changed
+    std::set<SnippetId> changed_ids(changed.begin(), changed.end());
+    bool indexed = true;
+    for (const auto& tag : remove_tags) {
+        if (std::find(add_tags.begin(), add_tags.end(), tag) == add_tags.end()) {
+            indexed &= tag_index_->remove_files_from_tag(tag, changed_ids);
+        }
+    }
+    for (const auto& tag : add_tags) {
+        indexed &= tag_index_->add_files_to_tag(tag, changed_ids);
+    }
+    if (!indexed) {
+        return Error(ErrorCode::INTERNAL_ERROR, "Failed to update tag index");
+    }
+
+    completions_stale_ = true;
+    return changed.size();
+}
+
 Result<std::vector<SnippetMetadata>> SnippetStore::list_all() const {
     if (!is_open_) {
         return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
     }
-    return snippet_index_->get_all();
+    auto result = snippet_index_->get_all();
+    for (size_t pack = 0; pack < packs_.size(); ++pack) {
+        std::vector<size_t> ordinals(packs_[pack]->size());
+        for (size_t i = 0; i < ordinals.size(); ++i) ordinals[i] = i;
+        append_pack_snippets(pack, ordinals, result);
+    }
+    return result;
+}
+
+Result<SnippetCursor> SnippetStore::scan(const ScanOptions& options) const {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+    return SnippetCursor(this, options);
 }
 
 Result<std::vector<SnippetMetadata>> SnippetStore::find_by_tag(const std::string& tag) const {
@@ -473,6 +910,10 @@ Result<std::vector<SnippetMetadata>> SnippetStore::find_by_tag(const std::string
         }
     }
 
+    for (size_t pack = 0; pack < packs_.size(); ++pack) {
+        append_pack_snippets(pack, packs_[pack]->find_by_tag(tag), result);
+    }
+
     return result;
 }
 
@@ -481,15 +922,18 @@ Result<std::vector<SnippetMetadata>> SnippetStore::find_by_language(const std::s
         return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
     }
 
-    std::vector<SnippetMetadata> result;
-    auto all = snippet_index_->get_all();
+    auto result = snippet_index_->filter([&language](const SnippetMetadata& snippet) {
+        return snippet.language == language;
+    });
 
-    for (auto& snippet : all) {
-        if (snippet.language == language) {
-            result.push_back(std::move(snippet));
+    // Pack languages are checked before anything is decoded
+    for (size_t pack = 0; pack < packs_.size(); ++pack) {
+        std::vector<size_t> ordinals;
+        for (size_t i = 0; i < packs_[pack]->size(); ++i) {
+            if (packs_[pack]->language(i) == language) ordinals.push_back(i);
         }
+        append_pack_snippets(pack, ordinals, result);
     }
-
     return result;
 }
 
@@ -497,7 +941,16 @@ Result<std::vector<std::string>> SnippetStore::get_all_tags() const {
     if (!is_open_) {
         return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
     }
-    return tag_index_->get_all_tags();
+    auto tags = tag_index_->get_all_tags();
+    if (packs_.empty()) {
+        return tags;
+    }
+
+    std::set<std::string> merged(tags.begin(), tags.end());
+    for (const auto& pack : packs_) {
+        for (const auto& [tag, n] : pack->tag_counts()) merged.insert(tag);
+    }
+    return std::vector<std::string>(merged.begin(), merged.end());
 }
 
 Result<std::map<std::string, size_t>> SnippetStore::get_tag_counts() const {
@@ -511,13 +964,62 @@ Result<std::map<std::string, size_t>> SnippetStore::get_tag_counts() const {
     for (const auto& tag : tags) {
         result[tag] = tag_index_->get_tag_count(tag);
     }
+    for (const auto& pack : packs_) {
+        for (const auto& [tag, n] : pack->tag_counts()) result[tag] += n;
+    }
 
     return result;
 }
 
+Result<size_t> SnippetStore::train_compression_dictionaries(size_t min_samples) {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+
+    // Count snippets per language in one parallel pass
+    using Counts = std::map<std::string, size_t>;
+    Counts counts = snippet_index_->parallel_scan<Counts>(
+        [](Counts& partial, const SnippetMetadata& snippet) { ++partial[snippet.language]; },
+        [](Counts& into, Counts&& from) {
+            for (const auto& [language, n] : from) into[language] += n;
+        });
+
+    size_t trained = 0;
+    for (const auto& [language, n] : counts) {
+        if (n >= min_samples && snippet_index_->train_dictionary(language) > 0) {
+            ++trained;
+        }
+    }
+
+    return trained;
+}
+
+Result<std::vector<SimilarMatch>> SnippetStore::find_similar(SnippetId id,
+                                                             float threshold,
+                                                             size_t max_results) const {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+    if (!snippet_index_->get(id).has_value()) {
+        return Error(ErrorCode::NOT_FOUND, "Snippet not found");
+    }
+    return similarity_index_->find_similar(id, threshold, max_results);
+}
+
+Result<std::vector<SimilarPair>> SnippetStore::find_near_duplicates(float threshold) const {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+    return similarity_index_->find_duplicates(threshold);
+}
+
 size_t SnippetStore::count() const {
     if (!is_open_) return 0;
-    return snippet_index_->size();
+    size_t total = snippet_index_->size();
+    for (const auto& pack : packs_) {
+        total += pack->size();
+    }
+    return total;
 }
 
 Result<std::vector<SearchResult>> SnippetStore::search(const std::string& query,
@@ -530,15 +1032,13 @@ Result<std::vector<SearchResult>> SnippetStore::search(const std::string& query,
         return std::vector<SearchResult>{};
     }
 
-    // Simple substring search implementation
-    // For more advanced search, consider using SearchRouter internally
-    std::vector<SearchResult> results;
-    auto all_snippets = snippet_index_->get_all();
-
+    // Simple substring search implementation, scored in parallel across
+    // the index. For more advanced search, consider using SearchRouter.
     std::string query_lower = query;
     std::transform(query_lower.begin(), query_lower.end(), query_lower.begin(), ::tolower);
 
-    for (const auto& snippet : all_snippets) {
+    auto score_snippet = [&query_lower](std::vector<SearchResult>& results,
+                                        const SnippetMetadata& snippet) {
         // Search in name
         std::string name_lower = snippet.name;
         std::transform(name_lower.begin(), name_lower.end(), name_lower.begin(), ::tolower);
@@ -585,6 +1085,30 @@ Result<std::vector<SearchResult>> SnippetStore::search(const std::string& query,
             result.matched_text = matched_text;
             results.push_back(result);
         }
+    };
+
+    auto results = snippet_index_->parallel_scan<std::vector<SearchResult>>(
+        score_snippet,
+        [](std::vector<SearchResult>& into, std::vector<SearchResult>&& from) {
+            into.insert(into.end(), from.begin(), from.end());
+        });
+
+    // Packs only decode the snippets holding every trigram of the query
+    for (size_t pack = 0; pack < packs_.size(); ++pack) {
+        auto candidates = packs_[pack]->substring_candidates(query_lower);
+        std::vector<size_t> ordinals;
+        if (candidates.has_value()) {
+            ordinals = std::move(*candidates);
+        } else {
+            ordinals.resize(packs_[pack]->size());
+            for (size_t i = 0; i < ordinals.size(); ++i) ordinals[i] = i;
+        }
+
+        std::vector<SnippetMetadata> snippets;
+        append_pack_snippets(pack, ordinals, snippets);
+        for (const auto& snippet : snippets) {
+            score_snippet(results, snippet);
+        }
     }
 
     // Sort by score descending
@@ -601,4 +1125,258 @@ Result<std::vector<SearchResult>> SnippetStore::search(const std::string& query,
     return results;
 }
 
+Result<void> SnippetStore::write_completion_index() const {
+    std::vector<std::string> names = snippet_index_->names();
+    std::vector<std::string> tags = tag_index_->get_all_tags();
+    for (const auto& pack : packs_) {
+        for (size_t i = 0; i < pack->size(); ++i) {
+            names.emplace_back(pack->name(i));
+        }
+        for (const auto& [tag, n] : pack->tag_counts()) {
+            tags.push_back(tag);
+        }
+    }
+    return CompletionIndex::write(root_dir_ / CompletionIndex::FILE_NAME,
+                                  std::move(names), std::move(tags));
+}
+
+// ============================================================================
+// Backup
+// ============================================================================
+
+Result<std::unique_ptr<StoreBackup>> SnippetStore::begin_backup(const fs::path& dest,
+                                                                const BackupOptions& options) {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+
+    // Get every page onto disk, then freeze the file as of this point. A
+    // page left in memory would be missing from the frozen image.
+    auto flushed = buffer_pool_->flush_all_pages();
+    if (!flushed.ok()) {
+        return flushed.error();
+    }
+    auto lsn = disk_manager_->begin_snapshot();
+    if (!lsn.ok()) {
+        return lsn.error();
+    }
+
+    // The metadata is saved after the snapshot so it carries the new LSN;
+    // a restored store then keeps stamping pages newer than the backup
+    auto saved = checkpoint();
+    if (!saved.ok()) {
+        disk_manager_->end_snapshot();
+        return saved.error();
+    }
+
+    std::ifstream meta_file(root_dir_ / "dam.meta", std::ios::binary);
+    std::string metadata((std::istreambuf_iterator<char>(meta_file)),
+                         std::istreambuf_iterator<char>());
+    if (metadata.empty()) {
+        disk_manager_->end_snapshot();
+        return Error(ErrorCode::IO_ERROR, "Failed to read store metadata");
+    }
+
+    return std::unique_ptr<StoreBackup>(new StoreBackup(
+        disk_manager_.get(), dest, std::move(metadata), lsn.value(), options));
+}
+
+Result<BackupStats> SnippetStore::backup(const fs::path& dest, const BackupOptions& options) {
+    auto pending = begin_backup(dest, options);
+    if (!pending.ok()) {
+        return pending.error();
+    }
+    return pending.value()->run();
+}
+
+Result<void> SnippetStore::restore(const fs::path& backup_dir, const fs::path& root_dir) {
+    auto restored = StoreBackup::restore(backup_dir, root_dir);
+    if (restored.ok()) {
+        // Rebuilt from the restored data on next open
+        std::error_code ec;
+        fs::remove(root_dir / CompletionIndex::FILE_NAME, ec);
+    }
+    return restored;
+}
+
+// ============================================================================
+// Packs
+// ============================================================================
+
+Result<PackStats> SnippetStore::export_pack(const fs::path& path,
+                                            const PackOptions& options) const {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+    return SnippetPack::write(path, snippet_index_->get_all(), options);
+}
+
+Result<size_t> SnippetStore::mount_pack(const fs::path& path) {
+    if (!is_open_) {
+        return Error(ErrorCode::STORE_NOT_OPEN, "Store is not open");
+    }
+    if (packs_.size() + 1 >= (SnippetId(1) << (64 - PACK_ID_SHIFT))) {
+        return Error(ErrorCode::OUT_OF_SPACE, "Too many packs mounted");
+    }
+
+    auto pack = SnippetPack::open(path);
+    if (!pack.ok()) {
+        return pack.error();
+    }
+    size_t size = pack.value()->size();
+    packs_.push_back(std::move(pack.value()));
+    completions_stale_ = true;
+    return size;
+}
+
+Result<SnippetMetadata> SnippetStore::get_pack_snippet(SnippetId id) const {
+    size_t pack = static_cast<size_t>(id >> PACK_ID_SHIFT) - 1;
+    size_t ordinal = static_cast<size_t>(id & ((SnippetId(1) << PACK_ID_SHIFT) - 1));
+    if (pack >= packs_.size()) {
+        return Error(ErrorCode::NOT_FOUND, "Snippet not found");
+    }
+
+    auto snippet = packs_[pack]->get(ordinal);
+    if (snippet.ok()) {
+        snippet.value().id = id;
+    }
+    return snippet;
+}
+
+void SnippetStore::append_pack_snippets(size_t pack, const std::vector<size_t>& ordinals,
+                                        std::vector<SnippetMetadata>& out) const {
+    out.reserve(out.size() + ordinals.size());
+    for (size_t ordinal : ordinals) {
+        auto snippet = packs_[pack]->get(ordinal);
+        if (snippet.ok()) {
+            snippet.value().id = pack_snippet_id(pack, ordinal);
+            out.push_back(std::move(snippet.value()));
+        }
+    }
+}
+
+// ============================================================================
+// Streaming scans
+// ============================================================================
+
+SnippetCursor::SnippetCursor(const SnippetStore* store, ScanOptions options)
+    : store_(store)
+    , options_(std::move(options))
+    , skip_(options_.offset)
+    , by_tag_(!options_.tag.empty())
+    , records_(by_tag_ ? BPlusTreeIterator(nullptr, INVALID_PAGE_ID, 0)
+                       : store->snippet_index_->records())
+{
+    if (by_tag_) {
+        std::set<FileId> ids = store->tag_index_->get_files_for_tag(options_.tag);
+        tagged_.assign(ids.begin(), ids.end());
+    }
+}
+
+bool SnippetCursor::next() {
+    if (options_.limit != 0 && returned_ == options_.limit) {
+        return false;
+    }
+    if (next_stored() || next_packed()) {
+        ++returned_;
+        return true;
+    }
+    return false;
+}
+
+std::optional<SnippetMetadata> SnippetCursor::read_stored(bool with_content) {
+    if (by_tag_) {
+        return store_->snippet_index_->get(tagged_[tagged_pos_], with_content, &content_size_);
+    }
+    return store_->snippet_index_->decode_record(records_.value(), with_content, &content_size_);
+}
+
+bool SnippetCursor::next_stored() {
+    bool filtered = !options_.language.empty();
+
+    // Every record matches, so the offset is skipped without reading any
+    if (skip_ > 0 && !filtered) {
+        if (by_tag_) {
+            size_t n = std::min(skip_, tagged_.size() - tagged_pos_);
+            tagged_pos_ += n;
+            skip_ -= n;
+        } else {
+            skip_ -= records_.skip(skip_);
+        }
+    }
+
+    while (by_tag_ ? tagged_pos_ < tagged_.size() : records_.valid()) {
+        // Filtered records are checked before their bodies are decoded
+        auto snippet = read_stored(options_.with_content && !filtered);
+        bool match = snippet.has_value() && snippet->id != INVALID_SNIPPET_ID &&
+                     (!filtered || snippet->language == options_.language);
+        if (match && skip_ > 0) {
+            --skip_;
+            match = false;
+        }
+        if (match && filtered && options_.with_content) {
+            snippet = read_stored(true);
+            match = snippet.has_value() && snippet->id != INVALID_SNIPPET_ID;
+        }
+
+        if (by_tag_) {
+            ++tagged_pos_;
+        } else {
+            ++records_;
+        }
+        if (match) {
+            current_ = std::move(*snippet);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SnippetCursor::next_packed() {
+    const auto& packs = store_->packs_;
+    while (pack_ < packs.size()) {
+        const SnippetPack& pack = *packs[pack_];
+
+        // Pack filters and offsets are resolved before anything is decoded
+        if (!pack_loaded_) {
+            if (by_tag_) {
+                pack_ordinals_ = pack.find_by_tag(options_.tag);
+            } else {
+                pack_ordinals_.resize(pack.size());
+                for (size_t i = 0; i < pack_ordinals_.size(); ++i) pack_ordinals_[i] = i;
+            }
+            if (!options_.language.empty()) {
+                pack_ordinals_.erase(
+                    std::remove_if(pack_ordinals_.begin(), pack_ordinals_.end(),
+                                   [&](size_t ordinal) {
+                                       return pack.language(ordinal) != options_.language;
+                                   }),
+                    pack_ordinals_.end());
+            }
+            pack_pos_ = std::min(skip_, pack_ordinals_.size());
+            skip_ -= pack_pos_;
+            pack_loaded_ = true;
+        }
+
+        while (pack_pos_ < pack_ordinals_.size()) {
+            size_t ordinal = pack_ordinals_[pack_pos_++];
+            auto snippet = pack.get(ordinal);
+            if (!snippet.ok()) {
+                continue;
+            }
+            current_ = std::move(snippet.value());
+            current_.id = SnippetStore::pack_snippet_id(pack_, ordinal);
+            content_size_ = current_.content.size();
+            if (!options_.with_content) {
+                current_.content.clear();
+            }
+            return true;
+        }
+
+        ++pack_;
+        pack_loaded_ = false;
+    }
+    return false;
+}
+
 }  // namespace dam
@@ -1,4 +1,5 @@
 #include <dam/storage/btree.hpp>
+#include <iterator>
 #include <stack>
 
 namespace dam {
@@ -122,7 +123,9 @@ bool BPlusTree::insert_into_leaf(PageId leaf_id, const std::string& key, const s
         return false;  // Duplicate key
     }
 
-    // Try to insert directly
+    // Try to insert directly, reclaiming space left by removes and
+    // updates before resorting to a split
+    bool compacted = !leaf.has_space(key.size(), value.size()) && leaf.compact();
     if (leaf.has_space(key.size(), value.size())) {
         bool success = leaf.insert(key, value);
         buffer_pool_->unpin_page(leaf_id, true);
@@ -132,7 +135,7 @@ bool BPlusTree::insert_into_leaf(PageId leaf_id, const std::string& key, const s
         return success;
     }
 
-    buffer_pool_->unpin_page(leaf_id, false);
+    buffer_pool_->unpin_page(leaf_id, compacted);
 
     // Need to split
     PageId new_leaf_id = split_leaf(leaf_id, key, value);
@@ -183,7 +186,21 @@ PageId BPlusTree::split_leaf(PageId leaf_id, const std::string& key, const std::
     // Don't set node_type - LeafPage constructor will set it and call init()
     LeafPage reset_old(old_page);
 
-    size_t mid = entries.size() / 2;
+    // Split where the bytes balance. Halving the count can overflow one
+    // side when entry sizes differ widely.
+    auto entry_bytes = [](const auto& entry) {
+        return LeafPage::SLOT_SIZE + entry.first.size() + entry.second.size();
+    };
+    size_t total = 0;
+    for (const auto& entry : entries) {
+        total += entry_bytes(entry);
+    }
+    size_t mid = 1;
+    size_t left = entry_bytes(entries[0]);
+    while (mid + 1 < entries.size() && 2 * left + entry_bytes(entries[mid]) <= total) {
+        left += entry_bytes(entries[mid]);
+        ++mid;
+    }
 
     // First half stays in old leaf - verify all inserts succeed
     bool insert_failed = false;
@@ -204,9 +221,20 @@ PageId BPlusTree::split_leaf(PageId leaf_id, const std::string& key, const std::
         }
     }
 
-    // If any insert failed, clean up and return failure
+    // If any insert failed, put the old leaf back, clean up and return failure
     if (insert_failed) {
-        buffer_pool_->unpin_page(leaf_id, false);
+        old_page->reset();
+        old_page->set_page_id(leaf_id);
+        old_page->set_parent_page_id(old_parent);
+        LeafPage restored(old_page);
+        for (const auto& entry : entries) {
+            if (entry.first != key) {
+                restored.insert(entry.first, entry.second);
+            }
+        }
+        restored.set_prev_leaf(old_prev);
+        restored.set_next_leaf(old_next);
+        buffer_pool_->unpin_page(leaf_id, true);
         buffer_pool_->unpin_page(new_leaf_id, false);
         buffer_pool_->delete_page(new_leaf_id);
         return INVALID_PAGE_ID;
@@ -386,6 +414,17 @@ PageId BPlusTree::split_internal(PageId internal_id, const std::string& key, Pag
         return INVALID_PAGE_ID;
     }
 
+    // The new child may have stayed in the old node; it has no parent yet
+    for (size_t i = 0; i < mid; ++i) {
+        if (entries[i].second == right_child) {
+            Page* child_page = buffer_pool_->fetch_page(right_child);
+            if (child_page) {
+                child_page->set_parent_page_id(internal_id);
+                buffer_pool_->unpin_page(right_child, true);
+            }
+        }
+    }
+
     // Update parent pointers of children that moved
     for (size_t i = mid; i < entries.size(); ++i) {
         Page* child_page = buffer_pool_->fetch_page(entries[i].second);
@@ -454,7 +493,9 @@ bool BPlusTree::update(const std::string& key, const std::string& value) {
     }
 
     LeafPage leaf(page);
-    bool success = leaf.update(key, value);
+    std::string old_value;
+    bool found = leaf.find(key, &old_value);
+    bool success = found && leaf.update(key, value);
     buffer_pool_->unpin_page(leaf_id, success);
 
     if (!success) {
@@ -463,10 +504,14 @@ bool BPlusTree::update(const std::string& key, const std::string& value) {
         // Note: LeafPage::update now checks space before modifying,
         // so the key should still exist at this point.
         // remove() decrements size_, insert() increments it, so net effect is zero.
-        if (!remove(key)) {
+        if (!found || !remove(key)) {
             return false;  // Key doesn't exist
         }
-        return insert(key, value);
+        if (!insert(key, value)) {
+            // Too large even for an empty leaf: keep the old value
+            insert(key, old_value);
+            return false;
+        }
     }
 
     return true;
@@ -592,6 +637,120 @@ void BPlusTree::for_each(
     }
 }
 
+std::vector<KeyRange> BPlusTree::partition(size_t max_ranges) const {
+    max_ranges = std::max<size_t>(max_ranges, 1);
+
+    // Descend level by level, collecting every separator on the level.
+    // Separators of a level include those of the levels above it.
+    std::vector<std::string> separators;
+    std::vector<PageId> level;
+    if (root_page_id_ != INVALID_PAGE_ID) {
+        level.push_back(root_page_id_);
+    }
+
+    while (!level.empty() && separators.size() + 1 < max_ranges) {
+        std::vector<PageId> next_level;
+        std::vector<std::string> level_keys;
+        bool reached_leaves = false;
+
+        for (PageId page_id : level) {
+            Page* page = buffer_pool_->fetch_page(page_id);
+            if (!page) {
+                continue;
+            }
+            if (page->is_leaf()) {
+                buffer_pool_->unpin_page(page_id, false);
+                reached_leaves = true;
+                break;
+            }
+
+            InternalPage internal(page);
+            uint16_t num_keys = page->get_num_keys();
+            for (size_t i = 0; i < num_keys; ++i) {
+                next_level.push_back(internal.get_child_at(i));
+                level_keys.push_back(internal.get_key_at(i));
+            }
+            next_level.push_back(internal.get_child_at(num_keys));
+            buffer_pool_->unpin_page(page_id, false);
+        }
+
+        if (reached_leaves) {
+            break;
+        }
+
+        // Nodes are visited left to right, so level_keys is sorted;
+        // parent separators fall between its runs
+        std::vector<std::string> merged;
+        merged.reserve(separators.size() + level_keys.size());
+        std::merge(separators.begin(), separators.end(),
+                   level_keys.begin(), level_keys.end(),
+                   std::back_inserter(merged));
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+        separators = std::move(merged);
+        level = std::move(next_level);
+    }
+
+    // Pick evenly spaced boundaries when the level has more than needed
+    std::vector<std::string> bounds;
+    if (separators.size() + 1 <= max_ranges) {
+        bounds = std::move(separators);
+    } else {
+        for (size_t i = 1; i < max_ranges; ++i) {
+            bounds.push_back(separators[i * separators.size() / max_ranges]);
+        }
+        bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+    }
+
+    std::vector<KeyRange> ranges(bounds.size() + 1);
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        ranges[i].upper = bounds[i];
+        ranges[i].has_upper = true;
+        ranges[i + 1].lower = bounds[i];
+    }
+    return ranges;
+}
+
+void BPlusTree::for_each_in_range(
+    const KeyRange& range,
+    const std::function<bool(const std::string&, const std::string&)>& callback) const
+{
+    PageId leaf_id = range.lower.empty() ? get_leftmost_leaf() : find_leaf(range.lower);
+
+    while (leaf_id != INVALID_PAGE_ID) {
+        Page* page = buffer_pool_->fetch_page(leaf_id);
+        if (!page) break;
+
+        LeafPage leaf(page);
+        auto entries = leaf.get_all();
+        PageId next_leaf = leaf.get_next_leaf();
+        buffer_pool_->unpin_page(leaf_id, false);
+
+        for (const auto& entry : entries) {
+            if (range.has_upper && entry.first >= range.upper) {
+                return;
+            }
+            if (entry.first >= range.lower && !callback(entry.first, entry.second)) {
+                return;
+            }
+        }
+
+        leaf_id = next_leaf;
+    }
+}
+
+BPlusTreeIterator BPlusTree::seek(const std::string& key) const {
+    PageId leaf_id = key.empty() ? get_leftmost_leaf() : find_leaf(key);
+    BPlusTreeIterator it(buffer_pool_, leaf_id, 0);
+    while (it.valid() && it.key() < key) {
+        ++it;
+    }
+    return it;
+}
+
+size_t BPlusTree::default_scan_workers() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
 PageId BPlusTree::get_leftmost_leaf() const {
     if (root_page_id_ == INVALID_PAGE_ID) {
         return INVALID_PAGE_ID;
@@ -678,37 +837,31 @@ BPlusTreeIterator::BPlusTreeIterator(BufferPool* buffer_pool, PageId leaf_id, si
     , leaf_id_(leaf_id)
     , index_(index)
 {
-    cache_current_entry();  // Cache the initial entry
+    load_leaf();
 }
 
-void BPlusTreeIterator::cache_current_entry() {
-    cached_valid_ = false;
-    cached_entry_ = {"", ""};
-
-    if (leaf_id_ == INVALID_PAGE_ID) {
-        return;
-    }
-
-    Page* page = buffer_pool_->fetch_page(leaf_id_);
-    if (!page) {
-        leaf_id_ = INVALID_PAGE_ID;
-        return;
-    }
+void BPlusTreeIterator::load_leaf() {
+    while (leaf_id_ != INVALID_PAGE_ID) {
+        Page* page = buffer_pool_->fetch_page(leaf_id_);
+        if (!page) {
+            break;
+        }
 
-    LeafPage leaf(page);
-    auto entries = leaf.get_all();
+        LeafPage leaf(page);
+        entries_ = leaf.get_all();
+        next_leaf_ = leaf.get_next_leaf();
+        buffer_pool_->unpin_page(leaf_id_, false);
 
-    if (index_ < entries.size()) {
-        cached_entry_ = entries[index_];
-        cached_valid_ = true;
+        if (index_ < entries_.size()) {
+            return;
+        }
+        index_ -= entries_.size();
+        leaf_id_ = next_leaf_;
     }
 
-    buffer_pool_->unpin_page(leaf_id_, false);
-}
-
-std::pair<std::string, std::string> BPlusTreeIterator::operator*() const {
-    // Return cached entry to avoid use-after-free
-    return cached_entry_;
+    leaf_id_ = INVALID_PAGE_ID;
+    index_ = 0;
+    entries_.clear();
 }
 
 BPlusTreeIterator& BPlusTreeIterator::operator++() {
@@ -716,33 +869,55 @@ BPlusTreeIterator& BPlusTreeIterator::operator++() {
         return *this;
     }
 
-    Page* page = buffer_pool_->fetch_page(leaf_id_);
-    if (!page) {
-        leaf_id_ = INVALID_PAGE_ID;
-        cached_valid_ = false;
-        return *this;
+    if (++index_ == entries_.size()) {
+        leaf_id_ = next_leaf_;
+        index_ = 0;
+        load_leaf();
     }
+    return *this;
+}
 
-    LeafPage leaf(page);
-    size_t num_keys = page->get_num_keys();
-
-    if (index_ + 1 < num_keys) {
-        ++index_;
-    } else {
-        // Move to next leaf
-        leaf_id_ = leaf.get_next_leaf();
-        index_ = 0;
+size_t BPlusTreeIterator::skip(size_t n) {
+    if (!valid()) {
+        return 0;
     }
 
-    buffer_pool_->unpin_page(page->get_page_id(), false);
+    size_t remaining = entries_.size() - index_;
+    if (n < remaining) {
+        index_ += n;
+        return n;
+    }
 
-    // Cache the new current entry
-    cache_current_entry();
+    // Count whole leaves from their headers until the target is inside one
+    size_t skipped = remaining;
+    PageId leaf_id = next_leaf_;
+    while (leaf_id != INVALID_PAGE_ID) {
+        Page* page = buffer_pool_->fetch_page(leaf_id);
+        if (!page) {
+            leaf_id = INVALID_PAGE_ID;
+            break;
+        }
+        size_t num_keys = page->get_num_keys();
+        if (skipped + num_keys > n) {
+            buffer_pool_->unpin_page(leaf_id, false);
+            break;
+        }
+        PageId next_leaf = LeafPage(page).get_next_leaf();
+        buffer_pool_->unpin_page(leaf_id, false);
+        skipped += num_keys;
+        leaf_id = next_leaf;
+    }
 
-    return *this;
+    leaf_id_ = leaf_id;
+    index_ = leaf_id == INVALID_PAGE_ID ? 0 : n - skipped;
+    load_leaf();
+    return valid() ? n : skipped;
 }
 
 bool BPlusTreeIterator::operator==(const BPlusTreeIterator& other) const {
+    if (!valid() || !other.valid()) {
+        return valid() == other.valid();
+    }
     return leaf_id_ == other.leaf_id_ && index_ == other.index_;
 }
 
@@ -1,23 +1,33 @@
 #include <dam/storage/buffer_pool.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace dam {
 
-BufferPool::BufferPool(size_t pool_size, DiskManager* disk_manager)
+BufferPool::BufferPool(size_t pool_size, DiskManager* disk_manager,
+                       size_t max_pool_size)
     : pool_size_(pool_size)
     , disk_manager_(disk_manager)
+    , frames_(pool_size, max_pool_size, disk_manager->get_page_size())
+    , frame_info_(pool_size)
     , replacer_(pool_size)
 {
-    // Allocate page frames
-    pages_.reserve(pool_size);
-    frame_info_.resize(pool_size);
-
+    free_frames_.reserve(pool_size);
     for (size_t i = 0; i < pool_size; ++i) {
-        pages_.push_back(std::make_unique<Page>());
         free_frames_.push_back(i);
     }
 }
 
+size_t BufferPool::frames_for_budget(size_t budget_bytes, size_t page_size) {
+    return std::max<size_t>(1, budget_bytes / page_size);
+}
+
 BufferPool::~BufferPool() {
+    if (governor_) {
+        governor_->unregister_consumer(this);
+    }
+
     // Flush all dirty pages before destruction
     flush_all_pages();
 }
@@ -35,7 +45,9 @@ Page* BufferPool::fetch_page(PageId page_id) {
         size_t frame_id = it->second;
         frame_info_[frame_id].pin_count++;
         replacer_.pin(frame_id);  // Remove from eviction candidates
-        return pages_[frame_id].get();
+        Page* page = frame(frame_id);
+        record_access_locked(frame_id, true);
+        return page;
     }
 
     // Need to load from disk - find a frame
@@ -55,12 +67,15 @@ Page* BufferPool::fetch_page(PageId page_id) {
     }
 
     // Load page from disk
-    Page* page = pages_[frame_id].get();
+    Page* page = frame(frame_id);
     auto result = disk_manager_->read_page(page_id, page->get_raw_data());
     if (!result.ok()) {
         // Page might not exist yet on disk, initialize empty
-        page->reset();
+        page->format(page_size());
         page->set_page_id(page_id);
+    } else {
+        // Freshly allocated (zeroed) pages carry no size stamp yet
+        page->set_page_size(page_size());
     }
 
     // Update metadata
@@ -69,6 +84,7 @@ Page* BufferPool::fetch_page(PageId page_id) {
     frame_info_[frame_id].pin_count = 1;
     page_table_[page_id] = static_cast<size_t>(frame_id);
     replacer_.pin(static_cast<size_t>(frame_id));
+    record_access_locked(static_cast<size_t>(frame_id), false);
 
     return page;
 }
@@ -101,8 +117,8 @@ Page* BufferPool::new_page() {
     }
 
     // Initialize the new page
-    Page* page = pages_[frame_id].get();
-    page->reset();
+    Page* page = frame(frame_id);
+    page->format(page_size());
     page->set_page_id(page_id);
 
     // Update metadata
@@ -111,6 +127,7 @@ Page* BufferPool::new_page() {
     frame_info_[frame_id].pin_count = 1;
     page_table_[page_id] = static_cast<size_t>(frame_id);
     replacer_.pin(static_cast<size_t>(frame_id));
+    record_access_locked(static_cast<size_t>(frame_id), false);
 
     return page;
 }
@@ -163,7 +180,7 @@ Result<void> BufferPool::flush_page(PageId page_id) {
     FrameInfo& info = frame_info_[frame_id];
 
     if (info.is_dirty) {
-        Page* page = pages_[frame_id].get();
+        Page* page = frame(frame_id);
         page->update_checksum();
 
         auto result = disk_manager_->write_page(page_id, page->get_raw_data());
@@ -180,9 +197,10 @@ Result<void> BufferPool::flush_page(PageId page_id) {
 Result<void> BufferPool::flush_all_pages() {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    for (size_t i = 0; i < pool_size_; ++i) {
+    size_t pool_size = pool_size_.load();
+    for (size_t i = 0; i < pool_size; ++i) {
         if (frame_info_[i].page_id != INVALID_PAGE_ID && frame_info_[i].is_dirty) {
-            Page* page = pages_[i].get();
+            Page* page = frame(i);
             page->update_checksum();
 
             auto result = disk_manager_->write_page(
@@ -218,7 +236,7 @@ bool BufferPool::delete_page(PageId page_id) {
         info.page_id = INVALID_PAGE_ID;
         info.is_dirty = false;
         info.pin_count = 0;
-        pages_[frame_id]->reset();
+        frame(frame_id)->reset();
         free_frames_.push_back(frame_id);
     }
 
@@ -271,7 +289,7 @@ Result<void> BufferPool::evict_page(size_t frame_id) {
 
     if (info.is_dirty) {
         // Write dirty page to disk
-        Page* page = pages_[frame_id].get();
+        Page* page = frame(frame_id);
         page->update_checksum();
 
         auto result = disk_manager_->write_page(info.page_id, page->get_raw_data());
@@ -287,8 +305,218 @@ Result<void> BufferPool::evict_page(size_t frame_id) {
     info.page_id = INVALID_PAGE_ID;
     info.is_dirty = false;
     info.pin_count = 0;
+    stats_.evictions++;
+
+    return Ok();
+}
+
+// ============================================================================
+// Resizing
+// ============================================================================
+
+Result<void> BufferPool::resize(size_t new_pool_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (new_pool_size == 0) {
+        return Error(ErrorCode::INVALID_ARGUMENT, "Pool size must be positive");
+    }
+
+    size_t current = pool_size_.load();
+    if (new_pool_size > current) {
+        if (new_pool_size > frames_.capacity_frames()) {
+            return Error(ErrorCode::OUT_OF_SPACE,
+                "Pool size exceeds reserved capacity of " +
+                std::to_string(frames_.capacity_frames()) + " frames");
+        }
+        if (governor_ &&
+            !governor_->request(this, (new_pool_size - current) * page_size())) {
+            return Error(ErrorCode::OUT_OF_SPACE, "Memory budget exhausted");
+        }
+        grow_locked(new_pool_size);
+    } else if (new_pool_size < current) {
+        shrink_locked(new_pool_size);
+        if (pool_size_.load() != new_pool_size) {
+            return Error(ErrorCode::PAGE_PINNED,
+                "Pool shrank to " + std::to_string(pool_size_.load()) +
+                " frames; remaining frames are pinned");
+        }
+    }
 
     return Ok();
 }
 
+void BufferPool::enable_adaptive_sizing(MemoryGovernor* governor,
+                                        BufferPoolPolicy policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (governor_ && governor_ != governor) {
+        governor_->unregister_consumer(this);
+    }
+    governor_ = governor;
+    policy_ = policy;
+    adaptive_ = true;
+    if (governor_) {
+        governor_->register_consumer(this);
+    }
+}
+
+MemoryGovernor* BufferPool::memory_governor() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return governor_;
+}
+
+BufferPool::Stats BufferPool::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.pool_size = pool_size_.load();
+    return stats;
+}
+
+size_t BufferPool::reclaim(size_t bytes) {
+    // Called by the governor, possibly while another pool holds our lock
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return 0;
+    }
+
+    size_t current = pool_size_.load();
+    size_t frames = (bytes + page_size() - 1) / page_size();
+    size_t floor = std::max<size_t>(policy_.min_frames, 1);
+    if (current <= floor) {
+        return 0;
+    }
+
+    size_t target = current > floor + frames ? current - frames : floor;
+    shrink_locked(target);
+    return (current - pool_size_.load()) * page_size();
+}
+
+void BufferPool::grow_locked(size_t new_pool_size) {
+    size_t current = pool_size_.load();
+    new_pool_size = std::min(new_pool_size, frames_.capacity_frames());
+    if (new_pool_size <= current || !frames_.resize(new_pool_size)) {
+        return;
+    }
+
+    frame_info_.resize(new_pool_size);
+    for (size_t i = current; i < new_pool_size; ++i) {
+        free_frames_.push_back(i);
+    }
+    replacer_.set_capacity(new_pool_size);
+    pool_size_ = new_pool_size;
+}
+
+void BufferPool::shrink_locked(size_t new_pool_size) {
+    size_t size = pool_size_.load();
+    new_pool_size = std::max<size_t>(new_pool_size, 1);
+
+    // Free frames below the cut can take over pages from released frames
+    std::vector<size_t> low_free;
+    for (size_t frame_id : free_frames_) {
+        if (frame_id < new_pool_size) {
+            low_free.push_back(frame_id);
+        }
+    }
+
+    while (size > new_pool_size) {
+        size_t frame_id = size - 1;
+        FrameInfo& info = frame_info_[frame_id];
+
+        if (info.pin_count > 0) {
+            break;  // Cannot move a frame someone holds a pointer to
+        }
+
+        if (info.page_id != INVALID_PAGE_ID) {
+            replacer_.pin(frame_id);  // Remove from eviction candidates
+
+            if (!low_free.empty()) {
+                // Migrate the page instead of evicting it
+                size_t target = low_free.back();
+                low_free.pop_back();
+                std::memcpy(frame(target), frame(frame_id), page_size());
+                frame_info_[target] = info;
+                page_table_[info.page_id] = target;
+                replacer_.unpin(target);
+                free_frames_.erase(
+                    std::find(free_frames_.begin(), free_frames_.end(), target));
+                info = FrameInfo{};
+            } else if (!evict_page(frame_id).ok()) {
+                replacer_.unpin(frame_id);
+                break;
+            }
+        }
+
+        --size;
+    }
+
+    if (size == pool_size_.load()) {
+        return;
+    }
+
+    free_frames_.erase(
+        std::remove_if(free_frames_.begin(), free_frames_.end(),
+                       [size](size_t frame_id) { return frame_id >= size; }),
+        free_frames_.end());
+    frame_info_.resize(size);
+    frames_.resize(size);
+    replacer_.set_capacity(size);
+    pool_size_ = size;
+}
+
+// ============================================================================
+// Adaptive Sizing
+// ============================================================================
+
+void BufferPool::record_access_locked(size_t frame_id, bool hit) {
+    frame_info_[frame_id].referenced = true;
+    if (hit) {
+        stats_.hits++;
+        window_hits_++;
+    } else {
+        stats_.misses++;
+    }
+
+    // A window must be long enough to touch the whole working set, or the
+    // reference bits would understate it and the pool would oscillate
+    if (adaptive_ &&
+        ++window_accesses_ >= std::max<uint64_t>(policy_.adapt_interval,
+                                                 2 * pool_size_.load())) {
+        adapt_locked();
+    }
+}
+
+void BufferPool::adapt_locked() {
+    double hit_rate = static_cast<double>(window_hits_) /
+                      static_cast<double>(window_accesses_);
+    window_accesses_ = 0;
+    window_hits_ = 0;
+
+    // Working set: frames touched during the window
+    size_t size = pool_size_.load();
+    size_t working_set = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (frame_info_[i].referenced) {
+            working_set++;
+            frame_info_[i].referenced = false;
+        }
+    }
+
+    if (hit_rate < policy_.target_hit_rate && free_frames_.empty() &&
+        size < frames_.capacity_frames()) {
+        // Saturated and missing: the working set does not fit
+        size_t target = std::max(size + 1,
+            static_cast<size_t>(static_cast<double>(size) * policy_.grow_factor));
+        target = std::min(target, frames_.capacity_frames());
+
+        if (!governor_ || governor_->request(this, (target - size) * page_size())) {
+            grow_locked(target);
+        }
+    } else if (hit_rate >= policy_.target_hit_rate && working_set * 2 < size) {
+        // Mostly idle frames: shrink toward the working set with headroom
+        size_t target = std::max(policy_.min_frames, working_set + working_set / 4);
+        if (target < size) {
+            shrink_locked(target);
+        }
+    }
+}
+
 }  // namespace dam
@@ -1,27 +1,44 @@
 #include <dam/storage/disk_manager.hpp>
+#include <dam/storage/page.hpp>
 #include <dam/util/crc32.hpp>
 #include <algorithm>
+#include <cstddef>
 #include <cstring>
 
 namespace dam {
 
-// File header structure (stored in page 0)
-// Fixed header fields: 28 bytes, free list fills remaining space
-constexpr size_t FREE_LIST_HEADER_SIZE = 28;  // magic(8) + version(4) + num_pages(4) + next_page_id(4) + free_list_count(4) + checksum(4)
-constexpr size_t FREE_LIST_MAX_ENTRIES = (PAGE_SIZE - FREE_LIST_HEADER_SIZE) / sizeof(PageId);  // 1017 entries
+namespace {
+
+// File header structure (stored in page 0, which spans one full page)
+//
+// Version 1 (default PAGE_SIZE):
+//   magic(8) + version(4) + num_pages(4) + next_page_id(4) +
+//   free_list_count(4) + checksum(4), free list from byte 28
+// Version 2 (any other page size): as version 1, plus page_size(4) at
+//   byte 28 and the free list from byte 32
+constexpr uint32_t HEADER_VERSION_DEFAULT = 1;
+constexpr uint32_t HEADER_VERSION_PAGE_SIZE = 2;
+constexpr size_t FREE_LIST_HEADER_SIZE_V1 = 28;
+constexpr size_t FREE_LIST_HEADER_SIZE_V2 = 32;
 
 struct FileHeader {
     char magic[8] = {'D', 'O', 'C', 'S', 'T', 'O', 'R', 'E'};
-    uint32_t version = 1;
+    uint32_t version = HEADER_VERSION_DEFAULT;
     PageId num_pages = 1;  // Header is page 0
     PageId next_page_id = 1;
     uint32_t free_list_count = 0;  // Number of free pages stored
     uint32_t checksum = 0;  // CRC32 checksum of header (excluding free_list)
-    PageId free_list[FREE_LIST_MAX_ENTRIES] = {};  // Free page IDs
+    uint32_t page_size = PAGE_SIZE;  // Version 2 only
 
-    // Compute checksum over header data (fixed fields only, 24 bytes)
+    // Compute checksum over the fixed fields (24 bytes, plus page_size in v2)
     uint32_t compute_checksum() const {
-        return CRC32::compute(reinterpret_cast<const char*>(this), 24);
+        if (version < HEADER_VERSION_PAGE_SIZE) {
+            return CRC32::compute(reinterpret_cast<const char*>(this), 24);
+        }
+        char buf[28];
+        std::memcpy(buf, this, 24);
+        std::memcpy(buf + 24, &page_size, sizeof(page_size));
+        return CRC32::compute(buf, sizeof(buf));
     }
 
     void update_checksum() {
@@ -31,12 +48,21 @@ struct FileHeader {
     bool verify_checksum() const {
         return checksum == compute_checksum();
     }
+
+    size_t free_list_offset() const {
+        return version < HEADER_VERSION_PAGE_SIZE ? FREE_LIST_HEADER_SIZE_V1
+                                                  : FREE_LIST_HEADER_SIZE_V2;
+    }
 };
 
-static_assert(sizeof(FileHeader) == PAGE_SIZE, "FileHeader must be PAGE_SIZE");
+static_assert(sizeof(FileHeader) == FREE_LIST_HEADER_SIZE_V2,
+              "FileHeader fixed fields must be 32 bytes");
 
-DiskManager::DiskManager(const fs::path& db_path)
+}  // namespace
+
+DiskManager::DiskManager(const fs::path& db_path, size_t page_size)
     : db_path_(db_path)
+    , page_size_(page_size)
     , num_pages_(0)
     , next_page_id_(1)
     , is_open_(false)
@@ -51,6 +77,7 @@ DiskManager::DiskManager(const fs::path& db_path)
 DiskManager::~DiskManager() {
     // Implementation moved to non-virtual close method would be cleaner
     // but for now just check and close
+    end_snapshot();
     if (is_open_) {
         flush();
         write_header();
@@ -62,16 +89,28 @@ DiskManager::~DiskManager() {
 // InMemoryDiskManager Implementation
 // ============================================================================
 
-InMemoryDiskManager::InMemoryDiskManager()
+InMemoryDiskManager::InMemoryDiskManager(size_t page_size)
     : DiskManager(fs::temp_directory_path() / "inmemory_dummy.db")
+    , page_size_(page_size)
     , next_page_id_(1)
 {}
 
+size_t DiskManager::free_list_capacity() const {
+    size_t offset = page_size_ == PAGE_SIZE ? FREE_LIST_HEADER_SIZE_V1
+                                            : FREE_LIST_HEADER_SIZE_V2;
+    return (page_size_ - offset) / sizeof(PageId);
+}
+
 Result<void> DiskManager::open_file() {
     std::lock_guard<std::mutex> lock(mutex_);
 
     bool file_exists = fs::exists(db_path_);
 
+    if (!file_exists && !is_valid_page_size(page_size_)) {
+        return Error(ErrorCode::INVALID_ARGUMENT,
+                     "Invalid page size: " + std::to_string(page_size_));
+    }
+
     if (file_exists) {
         // Open existing file
         db_file_.open(db_path_, std::ios::in | std::ios::out | std::ios::binary);
@@ -118,20 +157,38 @@ Result<void> DiskManager::read_header() {
         return Error(ErrorCode::CORRUPTION, "Invalid database file format");
     }
 
+    if (header.version > HEADER_VERSION_PAGE_SIZE) {
+        return Error(ErrorCode::CORRUPTION,
+                     "Unsupported file version " + std::to_string(header.version));
+    }
+    if (header.version < HEADER_VERSION_PAGE_SIZE) {
+        header.page_size = PAGE_SIZE;
+    }
+
     // Verify checksum (skip for legacy files where checksum was 0)
     if (header.checksum != 0 && !header.verify_checksum()) {
         return Error(ErrorCode::CORRUPTION, "Header checksum mismatch");
     }
 
+    if (!is_valid_page_size(header.page_size)) {
+        return Error(ErrorCode::CORRUPTION,
+                     "Invalid page size in header: " + std::to_string(header.page_size));
+    }
+
+    // The file's page size wins over the one requested at construction
+    page_size_ = header.page_size;
     num_pages_ = header.num_pages;
     next_page_id_ = header.next_page_id;
 
-    // Load free list from header
+    // Load free list from the rest of the header page
     free_pages_.clear();
-    if (header.free_list_count > 0 && header.free_list_count <= FREE_LIST_MAX_ENTRIES) {
-        free_pages_.reserve(header.free_list_count);
-        for (uint32_t i = 0; i < header.free_list_count; ++i) {
-            free_pages_.push_back(header.free_list[i]);
+    if (header.free_list_count > 0 && header.free_list_count <= free_list_capacity()) {
+        free_pages_.resize(header.free_list_count);
+        db_file_.seekg(static_cast<std::streamoff>(header.free_list_offset()));
+        db_file_.read(reinterpret_cast<char*>(free_pages_.data()),
+                      static_cast<std::streamsize>(free_pages_.size() * sizeof(PageId)));
+        if (!db_file_.good()) {
+            return Error(ErrorCode::IO_ERROR, "Failed to read free list");
         }
     }
 
@@ -139,31 +196,49 @@ Result<void> DiskManager::read_header() {
 }
 
 Result<void> DiskManager::write_header() {
+    std::vector<char> buf;
+    auto result = build_header(buf);
+    if (!result.ok()) {
+        return result;
+    }
+
+    db_file_.seekp(0);
+    db_file_.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+
+    if (!db_file_.good()) {
+        return Error(ErrorCode::IO_ERROR, "Failed to write file header");
+    }
+
+    return Ok();
+}
+
+Result<void> DiskManager::build_header(std::vector<char>& buf) const {
     FileHeader header;
     header.num_pages = num_pages_;
     header.next_page_id = next_page_id_;
+    if (page_size_ != PAGE_SIZE) {
+        header.version = HEADER_VERSION_PAGE_SIZE;
+        header.page_size = static_cast<uint32_t>(page_size_);
+    }
 
     // Check for free list overflow - fail if we'd lose pages
-    if (free_pages_.size() > FREE_LIST_MAX_ENTRIES) {
+    size_t max_entries = free_list_capacity();
+    if (free_pages_.size() > max_entries) {
         return Error(ErrorCode::OUT_OF_SPACE,
                      "Free list overflow: " + std::to_string(free_pages_.size()) +
-                     " pages exceed max " + std::to_string(FREE_LIST_MAX_ENTRIES) +
+                     " pages exceed max " + std::to_string(max_entries) +
                      ". Run compaction to reclaim space.");
     }
 
-    // Save free list
     header.free_list_count = static_cast<uint32_t>(free_pages_.size());
-    for (uint32_t i = 0; i < header.free_list_count; ++i) {
-        header.free_list[i] = free_pages_[i];
-    }
-
     header.update_checksum();  // Compute and set checksum
 
-    db_file_.seekp(0);
-    db_file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
-
-    if (!db_file_.good()) {
-        return Error(ErrorCode::IO_ERROR, "Failed to write file header");
+    // Assemble the full header page: fixed fields, then the free list
+    buf.assign(page_size_, 0);
+    std::memcpy(buf.data(), &header, header.free_list_offset());
+    if (!free_pages_.empty()) {
+        std::memcpy(buf.data() + header.free_list_offset(), free_pages_.data(),
+                    free_pages_.size() * sizeof(PageId));
     }
 
     return Ok();
@@ -185,12 +260,12 @@ Result<void> DiskManager::read_page(PageId page_id, char* data) {
     // Validate file is large enough (detect truncation/corruption)
     db_file_.seekg(0, std::ios::end);
     auto file_size = db_file_.tellg();
-    if (file_size < 0 || static_cast<uint64_t>(file_size) < offset + PAGE_SIZE) {
+    if (file_size < 0 || static_cast<uint64_t>(file_size) < offset + page_size_) {
         return Error(ErrorCode::CORRUPTION, "File too small for page ID");
     }
 
     db_file_.seekg(static_cast<std::streamoff>(offset));
-    db_file_.read(data, PAGE_SIZE);
+    db_file_.read(data, static_cast<std::streamsize>(page_size_));
 
     if (!db_file_.good()) {
         return Error(ErrorCode::IO_ERROR, "Failed to read page");
@@ -217,9 +292,22 @@ Result<void> DiskManager::write_page(PageId page_id, const char* data) {
                      "Cannot write to unallocated page (use allocate_page first)");
     }
 
+    auto preserved = preserve_page_locked(page_id);
+    if (!preserved.ok()) {
+        return preserved;
+    }
+
+    // Stamp the current LSN into the page header on the way out
+    constexpr size_t LSN_OFFSET = offsetof(PageHeader, page_lsn);
+    char header[Page::HEADER_SIZE];
+    std::memcpy(header, data, sizeof(header));
+    std::memcpy(header + LSN_OFFSET, &lsn_, sizeof(lsn_));
+
     uint64_t offset = get_file_offset(page_id);
     db_file_.seekp(static_cast<std::streamoff>(offset));
-    db_file_.write(data, PAGE_SIZE);
+    db_file_.write(header, sizeof(header));
+    db_file_.write(data + sizeof(header),
+                   static_cast<std::streamsize>(page_size_ - sizeof(header)));
 
     if (!db_file_.good()) {
         return Error(ErrorCode::IO_ERROR, "Failed to write page");
@@ -246,11 +334,16 @@ PageId DiskManager::allocate_page() {
         page_id = next_page_id_++;
     }
 
+    if (from_free_list && !preserve_page_locked(page_id).ok()) {
+        free_pages_.push_back(page_id);
+        return INVALID_PAGE_ID;
+    }
+
     // Initialize the page with zeros
-    char zero_page[PAGE_SIZE] = {0};
+    std::vector<char> zero_page(page_size_, 0);
     uint64_t offset = get_file_offset(page_id);
     db_file_.seekp(static_cast<std::streamoff>(offset));
-    db_file_.write(zero_page, PAGE_SIZE);
+    db_file_.write(zero_page.data(), static_cast<std::streamsize>(page_size_));
 
     // Check if write succeeded - if not, rollback allocation
     if (!db_file_.good()) {
@@ -298,16 +391,141 @@ uint64_t DiskManager::get_file_size() const {
     return static_cast<uint64_t>(fs::file_size(db_path_, ec));
 }
 
+// ============================================================================
+// Snapshots
+// ============================================================================
+
+uint32_t DiskManager::get_lsn() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lsn_;
+}
+
+void DiskManager::set_lsn(uint32_t lsn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lsn_ = std::max<uint32_t>(lsn, 1);
+}
+
+Result<uint32_t> DiskManager::begin_snapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (snapshot_active_) {
+        return Error(ErrorCode::INVALID_ARGUMENT, "A snapshot is already active");
+    }
+
+    auto result = build_header(snapshot_header_);
+    if (!result.ok()) {
+        return result.error();
+    }
+
+    snapshot_path_ = db_path_;
+    snapshot_path_ += ".snapshot";
+    snapshot_file_.open(snapshot_path_,
+                        std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!snapshot_file_) {
+        return Error(ErrorCode::IO_ERROR, "Failed to create snapshot file: " +
+                     snapshot_path_.string());
+    }
+
+    snapshot_active_ = true;
+    snapshot_pages_ = next_page_id_;
+    snapshot_saved_.clear();
+
+    // Pages written from now on belong to the next interval
+    return lsn_++;
+}
+
+Result<void> DiskManager::read_snapshot_page(PageId page_id, char* data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!snapshot_active_) {
+        return Error(ErrorCode::INVALID_ARGUMENT, "No active snapshot");
+    }
+    if (page_id >= snapshot_pages_) {
+        return Error(ErrorCode::INVALID_ARGUMENT, "Page not in snapshot");
+    }
+
+    if (page_id == 0) {
+        std::memcpy(data, snapshot_header_.data(), page_size_);
+        return Ok();
+    }
+
+    auto it = snapshot_saved_.find(page_id);
+    if (it != snapshot_saved_.end()) {
+        snapshot_file_.seekg(static_cast<std::streamoff>(it->second) *
+                             static_cast<std::streamoff>(page_size_));
+        snapshot_file_.read(data, static_cast<std::streamsize>(page_size_));
+        if (!snapshot_file_.good()) {
+            snapshot_file_.clear();
+            return Error(ErrorCode::IO_ERROR, "Failed to read saved snapshot page");
+        }
+        return Ok();
+    }
+
+    db_file_.seekg(static_cast<std::streamoff>(get_file_offset(page_id)));
+    db_file_.read(data, static_cast<std::streamsize>(page_size_));
+
+    if (!db_file_.good()) {
+        return Error(ErrorCode::IO_ERROR, "Failed to read page");
+    }
+
+    return Ok();
+}
+
+PageId DiskManager::get_snapshot_pages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot_active_ ? snapshot_pages_ : 0;
+}
+
+void DiskManager::end_snapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_active_ = false;
+    snapshot_pages_ = 0;
+    snapshot_header_.clear();
+    snapshot_saved_.clear();
+    if (snapshot_file_.is_open()) {
+        snapshot_file_.close();
+        std::error_code ec;
+        fs::remove(snapshot_path_, ec);
+    }
+}
+
+Result<void> DiskManager::preserve_page_locked(PageId page_id) {
+    if (!snapshot_active_ || page_id >= snapshot_pages_ ||
+        snapshot_saved_.count(page_id) > 0) {
+        return Ok();
+    }
+
+    std::vector<char> image(page_size_);
+    db_file_.seekg(static_cast<std::streamoff>(get_file_offset(page_id)));
+    db_file_.read(image.data(), static_cast<std::streamsize>(page_size_));
+    if (!db_file_.good()) {
+        // Never written (allocated but still sparse); the snapshot sees zeros
+        db_file_.clear();
+        std::fill(image.begin(), image.end(), 0);
+    }
+
+    auto slot = static_cast<uint32_t>(snapshot_saved_.size());
+    snapshot_file_.seekp(static_cast<std::streamoff>(slot) *
+                         static_cast<std::streamoff>(page_size_));
+    snapshot_file_.write(image.data(), static_cast<std::streamsize>(page_size_));
+    if (!snapshot_file_.good()) {
+        snapshot_file_.clear();
+        return Error(ErrorCode::IO_ERROR, "Failed to save page for snapshot");
+    }
+    snapshot_saved_.emplace(page_id, slot);
+    return Ok();
+}
+
 Result<void> InMemoryDiskManager::read_page(PageId page_id, char* data) {
     std::lock_guard<std::mutex> lock(in_memory_mutex_);
 
     auto it = pages_.find(page_id);
     if (it == pages_.end()) {
-        std::memset(data, 0, PAGE_SIZE);
+        std::memset(data, 0, page_size_);
         return Ok();
     }
 
-    std::memcpy(data, it->second.data(), PAGE_SIZE);
+    std::memcpy(data, it->second.data(), page_size_);
     return Ok();
 }
 
@@ -315,7 +533,8 @@ Result<void> InMemoryDiskManager::write_page(PageId page_id, const char* data) {
     std::lock_guard<std::mutex> lock(in_memory_mutex_);
 
     auto& page = pages_[page_id];
-    std::memcpy(page.data(), data, PAGE_SIZE);
+    page.resize(page_size_);
+    std::memcpy(page.data(), data, page_size_);
     return Ok();
 }
 
@@ -330,7 +549,7 @@ PageId InMemoryDiskManager::allocate_page() {
         page_id = next_page_id_++;
     }
 
-    pages_[page_id] = {};  // Initialize to zeros
+    pages_[page_id].assign(page_size_, 0);  // Initialize to zeros
     return page_id;
 }
 
@@ -0,0 +1,119 @@
+#include <dam/storage/frame_arena.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+#include <sys/mman.h>
+#define DAM_HAS_MMAP 1
+#endif
+
+namespace dam {
+
+static_assert(std::is_trivially_destructible_v<Page>,
+              "FrameArena releases frames without running destructors");
+
+// ============================================================================
+// FrameArena Implementation
+// ============================================================================
+
+FrameArena::FrameArena(size_t num_frames, size_t max_frames, size_t frame_size)
+    : frame_size_(frame_size)
+    , num_frames_(num_frames)
+    , capacity_frames_(std::max(num_frames, max_frames)) {
+    size_t bytes = capacity_frames_ * frame_size_;
+    if (bytes == 0) {
+        bytes = frame_size_;
+    }
+
+#ifdef DAM_HAS_MMAP
+    bool growable = capacity_frames_ > num_frames_;
+    if (bytes >= HUGE_PAGE_SIZE || growable) {
+        size_t rounded = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+
+#ifdef MAP_HUGETLB
+        // Explicit huge pages: only succeeds if the admin reserved them.
+        // Not used for growable arenas, which would pin the whole reservation.
+        void* p = growable ? MAP_FAILED : mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            base_ = static_cast<char*>(p);
+            mapped_bytes_ = rounded;
+            huge_pages_ = true;
+            mmapped_ = true;
+        }
+#endif
+
+        if (!base_) {
+            void* q = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (q != MAP_FAILED) {
+                base_ = static_cast<char*>(q);
+                mapped_bytes_ = rounded;
+                mmapped_ = true;
+#ifdef MADV_HUGEPAGE
+                huge_pages_ = madvise(q, rounded, MADV_HUGEPAGE) == 0;
+#endif
+            }
+        }
+    }
+#endif
+
+    if (!base_) {
+        // Small fixed pools (or no mmap): frame-aligned heap allocation.
+        // Without mmap there is no cheap way to reserve, so growth is off.
+        capacity_frames_ = num_frames_;
+        bytes = std::max<size_t>(num_frames_, 1) * frame_size_;
+        base_ = static_cast<char*>(std::aligned_alloc(frame_size_, bytes));
+        if (!base_) {
+            throw std::bad_alloc();
+        }
+        mapped_bytes_ = bytes;
+    }
+
+    for (size_t i = 0; i < num_frames_; ++i) {
+        init_frame(i);
+    }
+}
+
+void FrameArena::init_frame(size_t index) {
+    Page* page = new (frame(index)) Page();
+    if (frame_size_ != PAGE_SIZE) {
+        page->format(frame_size_);
+    }
+}
+
+bool FrameArena::resize(size_t num_frames) {
+    if (num_frames > capacity_frames_) {
+        return false;
+    }
+
+    if (num_frames > num_frames_) {
+        for (size_t i = num_frames_; i < num_frames; ++i) {
+            init_frame(i);
+        }
+    } else if (num_frames < num_frames_) {
+#if defined(DAM_HAS_MMAP) && defined(MADV_DONTNEED)
+        if (mmapped_) {
+            madvise(frame(num_frames), (num_frames_ - num_frames) * frame_size_,
+                    MADV_DONTNEED);
+        }
+#endif
+    }
+
+    num_frames_ = num_frames;
+    return true;
+}
+
+FrameArena::~FrameArena() {
+#ifdef DAM_HAS_MMAP
+    if (mmapped_) {
+        munmap(base_, mapped_bytes_);
+        return;
+    }
+#endif
+    std::free(base_);
+}
+
+}  // namespace dam
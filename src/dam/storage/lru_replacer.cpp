@@ -58,6 +58,11 @@ size_t LRUReplacer::size() const {
     return lru_list_.size();
 }
 
+void LRUReplacer::set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+}
+
 bool LRUReplacer::contains(size_t frame_id) const {
     std::lock_guard<std::mutex> lock(mutex_);
     return frame_map_.find(frame_id) != frame_map_.end();
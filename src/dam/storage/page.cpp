@@ -4,9 +4,29 @@
 
 namespace dam {
 
+namespace {
+
+// Unaligned little-endian field access (wide slots are not 4-byte aligned)
+uint16_t load16(const uint8_t* p) {
+    uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void store16(uint8_t* p, uint16_t v) { std::memcpy(p, &v, sizeof(v)); }
+void store32(uint8_t* p, uint32_t v) { std::memcpy(p, &v, sizeof(v)); }
+
+}  // namespace
+
 uint32_t Page::compute_checksum() const {
     // Compute checksum over data only (not header)
-    return CRC32::compute(data_.data(), DATA_SIZE);
+    return CRC32::compute(get_data(), data_size());
 }
 
 // ============================================================================
@@ -16,80 +36,131 @@ uint32_t Page::compute_checksum() const {
 void LeafPage::init() {
     set_prev_leaf(INVALID_PAGE_ID);
     set_next_leaf(INVALID_PAGE_ID);
-    set_free_space_offset(LEAF_HEADER_SIZE);
-    set_data_offset(static_cast<uint16_t>(Page::DATA_SIZE));
+    set_free_space_offset(static_cast<uint32_t>(header_size()));
+    set_data_offset(static_cast<uint32_t>(page_->data_size()));
     page_->set_num_keys(0);
 }
 
 PageId LeafPage::get_prev_leaf() const {
-    const uint8_t* d = data();
-    return *reinterpret_cast<const PageId*>(d);
+    return load32(data());
 }
 
 void LeafPage::set_prev_leaf(PageId id) {
-    uint8_t* d = data();
-    *reinterpret_cast<PageId*>(d) = id;
+    store32(data(), id);
 }
 
 PageId LeafPage::get_next_leaf() const {
-    const uint8_t* d = data();
-    return *reinterpret_cast<const PageId*>(d + 4);
+    return load32(data() + 4);
 }
 
 void LeafPage::set_next_leaf(PageId id) {
-    uint8_t* d = data();
-    *reinterpret_cast<PageId*>(d + 4) = id;
+    store32(data() + 4, id);
 }
 
-uint16_t LeafPage::get_free_space_offset() const {
-    const uint8_t* d = data();
-    return *reinterpret_cast<const uint16_t*>(d + 8);
+uint32_t LeafPage::get_free_space_offset() const {
+    return wide() ? load32(data() + 8) : load16(data() + 8);
 }
 
-void LeafPage::set_free_space_offset(uint16_t offset) {
-    uint8_t* d = data();
-    *reinterpret_cast<uint16_t*>(d + 8) = offset;
+void LeafPage::set_free_space_offset(uint32_t offset) {
+    if (wide()) {
+        store32(data() + 8, offset);
+    } else {
+        store16(data() + 8, static_cast<uint16_t>(offset));
+    }
 }
 
-uint16_t LeafPage::get_data_offset() const {
-    const uint8_t* d = data();
-    return *reinterpret_cast<const uint16_t*>(d + 10);
+uint32_t LeafPage::get_data_offset() const {
+    return wide() ? load32(data() + 12) : load16(data() + 10);
 }
 
-void LeafPage::set_data_offset(uint16_t offset) {
-    uint8_t* d = data();
-    *reinterpret_cast<uint16_t*>(d + 10) = offset;
+void LeafPage::set_data_offset(uint32_t offset) {
+    if (wide()) {
+        store32(data() + 12, offset);
+    } else {
+        store16(data() + 10, static_cast<uint16_t>(offset));
+    }
 }
 
 LeafPage::Slot LeafPage::get_slot(size_t index) const {
-    const uint8_t* d = data() + LEAF_HEADER_SIZE + index * SLOT_SIZE;
+    const uint8_t* d = data() + header_size() + index * slot_size();
     Slot slot;
-    slot.offset = *reinterpret_cast<const uint16_t*>(d);
-    slot.key_len = *reinterpret_cast<const uint16_t*>(d + 2);
-    slot.val_len = *reinterpret_cast<const uint16_t*>(d + 4);
+    if (wide()) {
+        slot.offset = load32(d);
+        slot.key_len = load16(d + 4);
+        slot.val_len = load32(d + 6);
+    } else {
+        slot.offset = load16(d);
+        slot.key_len = load16(d + 2);
+        slot.val_len = load16(d + 4);
+    }
     return slot;
 }
 
 void LeafPage::set_slot(size_t index, const Slot& slot) {
-    uint8_t* d = data() + LEAF_HEADER_SIZE + index * SLOT_SIZE;
-    *reinterpret_cast<uint16_t*>(d) = slot.offset;
-    *reinterpret_cast<uint16_t*>(d + 2) = slot.key_len;
-    *reinterpret_cast<uint16_t*>(d + 4) = slot.val_len;
+    uint8_t* d = data() + header_size() + index * slot_size();
+    if (wide()) {
+        store32(d, slot.offset);
+        store16(d + 4, slot.key_len);
+        store32(d + 6, slot.val_len);
+    } else {
+        store16(d, static_cast<uint16_t>(slot.offset));
+        store16(d + 2, slot.key_len);
+        store16(d + 4, static_cast<uint16_t>(slot.val_len));
+    }
 }
 
 bool LeafPage::has_space(size_t key_len, size_t val_len) const {
-    uint16_t free_start = get_free_space_offset();
-    uint16_t data_start = get_data_offset();
+    if (page_->get_num_keys() >= Page::MAX_KEYS) {
+        return false;
+    }
+
+    uint32_t free_start = get_free_space_offset();
+    uint32_t data_start = get_data_offset();
 
     // Prevent underflow on corrupted pages
     if (data_start < free_start) {
         return false;
     }
 
-    size_t needed = SLOT_SIZE + key_len + val_len;
+    size_t needed = slot_size() + key_len + val_len;
     return (data_start - free_start) >= needed;
 }
 
+bool LeafPage::compact() {
+    uint16_t num_keys = page_->get_num_keys();
+    size_t live = 0;
+    for (size_t i = 0; i < num_keys; ++i) {
+        Slot slot = get_slot(i);
+        live += slot.key_len + slot.val_len;
+    }
+
+    size_t used = page_->data_size() - get_data_offset();
+    if (used <= live) {
+        return false;
+    }
+
+    // Slots keep their order; only the data moves
+    auto entries = get_all();
+    if (entries.size() != num_keys) {
+        return false;  // Corrupted slots are left for get_all() to skip
+    }
+
+    uint8_t* d = data();
+    uint32_t data_offset = static_cast<uint32_t>(page_->data_size());
+    for (size_t i = 0; i < num_keys; ++i) {
+        const auto& [key, value] = entries[i];
+        data_offset -= static_cast<uint32_t>(key.size() + value.size());
+        std::memcpy(d + data_offset, key.data(), key.size());
+        std::memcpy(d + data_offset + key.size(), value.data(), value.size());
+
+        Slot slot = get_slot(i);
+        slot.offset = data_offset;
+        set_slot(i, slot);
+    }
+    set_data_offset(data_offset);
+    return true;
+}
+
 bool LeafPage::insert(const std::string& key, const std::string& value) {
     if (!has_space(key.size(), value.size())) {
         return false;
@@ -97,10 +168,17 @@ bool LeafPage::insert(const std::string& key, const std::string& value) {
 
     uint16_t num_keys = page_->get_num_keys();
 
-    // Find insertion position (maintain sorted order)
+    // Find insertion position (maintain sorted order). Binary search, as a
+    // large page holds tens of thousands of keys.
     size_t pos = 0;
-    while (pos < num_keys && get_key_at(pos) < key) {
-        ++pos;
+    size_t end = num_keys;
+    while (pos < end) {
+        size_t mid = pos + (end - pos) / 2;
+        if (get_key_at(mid) < key) {
+            pos = mid + 1;
+        } else {
+            end = mid;
+        }
     }
 
     // Check for duplicate
@@ -114,14 +192,14 @@ bool LeafPage::insert(const std::string& key, const std::string& value) {
     }
 
     // Allocate space for key-value data at the end
-    uint16_t data_offset = get_data_offset();
+    uint32_t data_offset = get_data_offset();
     size_t total_len = key.size() + value.size();
 
     // Defensive check: prevent underflow on corrupted pages
     if (data_offset < total_len) {
         return false;
     }
-    data_offset -= static_cast<uint16_t>(total_len);
+    data_offset -= static_cast<uint32_t>(total_len);
 
     // Write key and value
     uint8_t* d = data();
@@ -132,12 +210,12 @@ bool LeafPage::insert(const std::string& key, const std::string& value) {
     Slot slot;
     slot.offset = data_offset;
     slot.key_len = static_cast<uint16_t>(key.size());
-    slot.val_len = static_cast<uint16_t>(value.size());
+    slot.val_len = static_cast<uint32_t>(value.size());
     set_slot(pos, slot);
 
     // Update metadata
     set_data_offset(data_offset);
-    set_free_space_offset(static_cast<uint16_t>(LEAF_HEADER_SIZE + (num_keys + 1) * SLOT_SIZE));
+    set_free_space_offset(static_cast<uint32_t>(header_size() + (num_keys + 1) * slot_size()));
     page_->set_num_keys(num_keys + 1);
 
     return true;
@@ -162,7 +240,7 @@ bool LeafPage::remove(const std::string& key) {
     }
 
     // Update metadata (we don't compact data region for simplicity)
-    set_free_space_offset(static_cast<uint16_t>(LEAF_HEADER_SIZE + (num_keys - 1) * SLOT_SIZE));
+    set_free_space_offset(static_cast<uint32_t>(header_size() + (num_keys - 1) * slot_size()));
     page_->set_num_keys(num_keys - 1);
 
     return true;
@@ -192,7 +270,7 @@ bool LeafPage::find(const std::string& key, std::string* value) const {
 
         // Validate slot data stays within page bounds
         size_t end_offset = static_cast<size_t>(slot.offset) + slot.key_len + slot.val_len;
-        if (slot.offset < LEAF_HEADER_SIZE || end_offset > Page::DATA_SIZE) {
+        if (slot.offset < header_size() || end_offset > page_->data_size()) {
             return false;  // Corrupted slot - out of bounds
         }
 
@@ -212,8 +290,9 @@ bool LeafPage::update(const std::string& key, const std::string& new_value) {
         return false;
     }
 
-    if (old_value.size() == new_value.size()) {
-        // Can update in place
+    if (new_value.size() <= old_value.size()) {
+        // Same size or shrinking: rewrite in place (a shrink leaves a gap
+        // in the data region, which is not compacted)
         uint16_t num_keys = page_->get_num_keys();
         for (size_t i = 0; i < num_keys; ++i) {
             if (get_key_at(i) == key) {
@@ -221,28 +300,26 @@ bool LeafPage::update(const std::string& key, const std::string& new_value) {
                 uint8_t* d = data();
                 std::memcpy(d + slot.offset + slot.key_len,
                            new_value.data(), new_value.size());
+                slot.val_len = static_cast<uint32_t>(new_value.size());
+                set_slot(i, slot);
                 return true;
             }
         }
+        return false;
     }
 
-    // For value size changes, check if we have space BEFORE removing.
-    // Calculate space: after removing the old entry, we free SLOT_SIZE from slot array.
-    // The data region doesn't get compacted, but we need contiguous space for new data.
-    // Since we can't easily determine if there's enough contiguous space at data end
-    // after accounting for fragmentation, just check if new value fits assuming no compaction.
-    // If the new value is larger than old value and doesn't fit, return false to trigger
-    // tree-level handling (split).
-    if (new_value.size() > old_value.size()) {
-        // Check if there's space for the size difference
-        uint16_t free_start = get_free_space_offset();
-        uint16_t data_start = get_data_offset();
-        size_t available = data_start - free_start;
-        size_t extra_needed = new_value.size() - old_value.size();
-        if (available < extra_needed) {
-            // Not enough space - return false to trigger tree-level split
-            return false;
-        }
+    // Growing: check for space BEFORE removing. Removing frees the slot,
+    // but not the old data, so the re-inserted key and value need fresh
+    // contiguous space, after reclaiming earlier gaps if necessary. If it
+    // doesn't fit, return false to trigger tree-level handling (split).
+    auto fits = [&] {
+        uint32_t free_start = get_free_space_offset();
+        uint32_t data_start = get_data_offset();
+        return data_start >= free_start &&
+               data_start - free_start >= key.size() + new_value.size();
+    };
+    if (!fits() && (!compact() || !fits())) {
+        return false;
     }
 
     // Remove and re-insert
@@ -259,7 +336,7 @@ std::vector<std::pair<std::string, std::string>> LeafPage::get_all() const {
 
         // Validate slot data stays within page bounds
         size_t end_offset = static_cast<size_t>(slot.offset) + slot.key_len + slot.val_len;
-        if (slot.offset < LEAF_HEADER_SIZE || end_offset > Page::DATA_SIZE) {
+        if (slot.offset < header_size() || end_offset > page_->data_size()) {
             continue;  // Skip corrupted slot
         }
 
@@ -279,7 +356,7 @@ std::string LeafPage::get_key_at(size_t index) const {
 
     // Validate slot data stays within page bounds
     size_t end_offset = static_cast<size_t>(slot.offset) + slot.key_len;
-    if (slot.offset < LEAF_HEADER_SIZE || end_offset > Page::DATA_SIZE) {
+    if (slot.offset < header_size() || end_offset > page_->data_size()) {
         return "";  // Return empty string for corrupted slot
     }
 
@@ -311,7 +388,7 @@ std::string LeafPage::split(LeafPage* new_leaf) {
 
     // Update our metadata
     page_->set_num_keys(mid);
-    set_free_space_offset(static_cast<uint16_t>(LEAF_HEADER_SIZE + mid * SLOT_SIZE));
+    set_free_space_offset(static_cast<uint32_t>(header_size() + mid * slot_size()));
 
     // Update sibling pointers
     PageId old_next = get_next_leaf();
@@ -325,7 +402,7 @@ std::string LeafPage::split(LeafPage* new_leaf) {
 bool LeafPage::is_half_full() const {
     uint16_t num_keys = page_->get_num_keys();
     // At least half the slots should be used
-    size_t max_slots = (Page::DATA_SIZE - LEAF_HEADER_SIZE) / SLOT_SIZE;
+    size_t max_slots = (page_->data_size() - header_size()) / slot_size();
     return num_keys >= max_slots / 2;
 }
 
@@ -335,55 +412,67 @@ bool LeafPage::is_half_full() const {
 
 void InternalPage::init() {
     set_first_child(INVALID_PAGE_ID);
-    set_free_space_offset(INTERNAL_HEADER_SIZE);
-    set_data_offset(static_cast<uint16_t>(Page::DATA_SIZE));
+    set_free_space_offset(static_cast<uint32_t>(header_size()));
+    set_data_offset(static_cast<uint32_t>(page_->data_size()));
     page_->set_num_keys(0);
 }
 
 PageId InternalPage::get_first_child() const {
-    const uint8_t* d = data();
-    return *reinterpret_cast<const PageId*>(d);
+    return load32(data());
 }
 
 void InternalPage::set_first_child(PageId id) {
-    uint8_t* d = data();
-    *reinterpret_cast<PageId*>(d) = id;
+    store32(data(), id);
 }
 
-uint16_t InternalPage::get_free_space_offset() const {
-    const uint8_t* d = data();
-    return *reinterpret_cast<const uint16_t*>(d + 4);
+uint32_t InternalPage::get_free_space_offset() const {
+    return wide() ? load32(data() + 4) : load16(data() + 4);
 }
 
-void InternalPage::set_free_space_offset(uint16_t offset) {
-    uint8_t* d = data();
-    *reinterpret_cast<uint16_t*>(d + 4) = offset;
+void InternalPage::set_free_space_offset(uint32_t offset) {
+    if (wide()) {
+        store32(data() + 4, offset);
+    } else {
+        store16(data() + 4, static_cast<uint16_t>(offset));
+    }
 }
 
-uint16_t InternalPage::get_data_offset() const {
-    const uint8_t* d = data();
-    return *reinterpret_cast<const uint16_t*>(d + 6);
+uint32_t InternalPage::get_data_offset() const {
+    return wide() ? load32(data() + 8) : load16(data() + 6);
 }
 
-void InternalPage::set_data_offset(uint16_t offset) {
-    uint8_t* d = data();
-    *reinterpret_cast<uint16_t*>(d + 6) = offset;
+void InternalPage::set_data_offset(uint32_t offset) {
+    if (wide()) {
+        store32(data() + 8, offset);
+    } else {
+        store16(data() + 6, static_cast<uint16_t>(offset));
+    }
 }
 
 InternalPage::Slot InternalPage::get_slot(size_t index) const {
-    const uint8_t* d = data() + INTERNAL_HEADER_SIZE + index * SLOT_SIZE;
+    const uint8_t* d = data() + header_size() + index * slot_size();
     Slot slot;
-    slot.child_id = *reinterpret_cast<const PageId*>(d);
-    slot.offset = *reinterpret_cast<const uint16_t*>(d + 4);
-    slot.key_len = *reinterpret_cast<const uint16_t*>(d + 6);
+    slot.child_id = load32(d);
+    if (wide()) {
+        slot.offset = load32(d + 4);
+        slot.key_len = load16(d + 8);
+    } else {
+        slot.offset = load16(d + 4);
+        slot.key_len = load16(d + 6);
+    }
     return slot;
 }
 
 void InternalPage::set_slot(size_t index, const Slot& slot) {
-    uint8_t* d = data() + INTERNAL_HEADER_SIZE + index * SLOT_SIZE;
-    *reinterpret_cast<PageId*>(d) = slot.child_id;
-    *reinterpret_cast<uint16_t*>(d + 4) = slot.offset;
-    *reinterpret_cast<uint16_t*>(d + 6) = slot.key_len;
+    uint8_t* d = data() + header_size() + index * slot_size();
+    store32(d, slot.child_id);
+    if (wide()) {
+        store32(d + 4, slot.offset);
+        store16(d + 8, slot.key_len);
+    } else {
+        store16(d + 4, static_cast<uint16_t>(slot.offset));
+        store16(d + 6, slot.key_len);
+    }
 }
 
 std::string InternalPage::get_key_at(size_t index) const {
@@ -417,15 +506,19 @@ PageId InternalPage::find_child(const std::string& key) const {
 }
 
 bool InternalPage::has_space(size_t key_len) const {
-    uint16_t free_start = get_free_space_offset();
-    uint16_t data_start = get_data_offset();
+    if (page_->get_num_keys() >= Page::MAX_KEYS) {
+        return false;
+    }
+
+    uint32_t free_start = get_free_space_offset();
+    uint32_t data_start = get_data_offset();
 
     // Prevent underflow on corrupted pages
     if (data_start < free_start) {
         return false;
     }
 
-    size_t needed = SLOT_SIZE + key_len;
+    size_t needed = slot_size() + key_len;
     return (data_start - free_start) >= needed;
 }
 
@@ -436,10 +529,16 @@ bool InternalPage::insert(const std::string& key, PageId right_child) {
 
     uint16_t num_keys = page_->get_num_keys();
 
-    // Find insertion position
+    // Find insertion position (binary search, see LeafPage::insert)
     size_t pos = 0;
-    while (pos < num_keys && get_key_at(pos) < key) {
-        ++pos;
+    size_t end = num_keys;
+    while (pos < end) {
+        size_t mid = pos + (end - pos) / 2;
+        if (get_key_at(mid) < key) {
+            pos = mid + 1;
+        } else {
+            end = mid;
+        }
     }
 
     // Shift slots to make room
@@ -448,13 +547,13 @@ bool InternalPage::insert(const std::string& key, PageId right_child) {
     }
 
     // Allocate space for key at the end
-    uint16_t data_offset = get_data_offset();
+    uint32_t data_offset = get_data_offset();
 
     // Defensive check: prevent underflow on corrupted pages
     if (data_offset < key.size()) {
         return false;
     }
-    data_offset -= static_cast<uint16_t>(key.size());
+    data_offset -= static_cast<uint32_t>(key.size());
 
     // Write key
     uint8_t* d = data();
@@ -469,7 +568,7 @@ bool InternalPage::insert(const std::string& key, PageId right_child) {
 
     // Update metadata
     set_data_offset(data_offset);
-    set_free_space_offset(static_cast<uint16_t>(INTERNAL_HEADER_SIZE + (num_keys + 1) * SLOT_SIZE));
+    set_free_space_offset(static_cast<uint32_t>(header_size() + (num_keys + 1) * slot_size()));
     page_->set_num_keys(num_keys + 1);
 
     return true;
@@ -494,7 +593,7 @@ bool InternalPage::remove(const std::string& key) {
     }
 
     // Update metadata
-    set_free_space_offset(static_cast<uint16_t>(INTERNAL_HEADER_SIZE + (num_keys - 1) * SLOT_SIZE));
+    set_free_space_offset(static_cast<uint32_t>(header_size() + (num_keys - 1) * slot_size()));
     page_->set_num_keys(num_keys - 1);
 
     return true;
@@ -519,7 +618,7 @@ std::string InternalPage::split(InternalPage* new_internal) {
 
     // Update our metadata
     page_->set_num_keys(mid);
-    set_free_space_offset(static_cast<uint16_t>(INTERNAL_HEADER_SIZE + mid * SLOT_SIZE));
+    set_free_space_offset(static_cast<uint32_t>(header_size() + mid * slot_size()));
 
     return promoted_key;
 }
@@ -0,0 +1,258 @@
+#include <dam/store_backup.hpp>
+#include <dam/storage/page.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace dam {
+
+namespace {
+
+// backup.info file structure:
+// - uint32: magic number (0xDADBAC01)
+// - uint32: format version
+// - uint32: snapshot LSN
+// - uint32: page size
+// - uint32: number of pages (including the header page)
+// - uint32: complete flag (0 while the new files are renamed into place)
+constexpr uint32_t BACKUP_MAGIC = 0xDADBAC01;
+constexpr uint32_t BACKUP_VERSION = 1;
+
+constexpr const char* INFO_FILE = "backup.info";
+constexpr const char* DB_FILE = "dam.db";
+constexpr const char* META_FILE = "dam.meta";
+
+struct BackupInfo {
+    uint32_t magic = BACKUP_MAGIC;
+    uint32_t version = BACKUP_VERSION;
+    uint32_t lsn = 0;
+    uint32_t page_size = 0;
+    uint32_t num_pages = 0;
+    uint32_t complete = 0;
+};
+
+bool load_info(const fs::path& path, BackupInfo& info) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    file.read(reinterpret_cast<char*>(&info), sizeof(info));
+    return static_cast<size_t>(file.gcount()) == sizeof(info) &&
+           info.magic == BACKUP_MAGIC && info.version == BACKUP_VERSION;
+}
+
+bool save_info(const fs::path& path, const BackupInfo& info) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    file.write(reinterpret_cast<const char*>(&info), sizeof(info));
+    file.flush();
+    return file.good();
+}
+
+// Write a whole file under a temporary name, then rename it into place
+bool replace_file(const fs::path& path, const std::string& contents) {
+    fs::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        file.flush();
+        if (!file.good()) return false;
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    return !ec;
+}
+
+// Rename, or copy and delete when the directories are on different devices
+bool move_file(const fs::path& from, const fs::path& to) {
+    std::error_code ec;
+    fs::rename(from, to, ec);
+    if (!ec) return true;
+
+    ec.clear();
+    fs::copy_file(from, to, fs::copy_options::overwrite_existing, ec);
+    if (ec) return false;
+    fs::remove(from, ec);
+    return true;
+}
+
+uint32_t page_lsn_of(const char* page) {
+    uint32_t lsn;
+    std::memcpy(&lsn, page + offsetof(PageHeader, page_lsn), sizeof(lsn));
+    return lsn;
+}
+
+}  // namespace
+
+StoreBackup::StoreBackup(DiskManager* disk_manager, fs::path dest, std::string metadata,
+                         uint32_t lsn, BackupOptions options)
+    : disk_manager_(disk_manager)
+    , dest_(std::move(dest))
+    , metadata_(std::move(metadata))
+    , lsn_(lsn)
+    , options_(options)
+{}
+
+StoreBackup::~StoreBackup() {
+    if (!finished_) {
+        disk_manager_->end_snapshot();
+    }
+}
+
+Result<BackupStats> StoreBackup::run() {
+    if (finished_) {
+        return Error(ErrorCode::INVALID_ARGUMENT, "Backup has already run");
+    }
+
+    // The snapshot is released however the copy ends
+    struct EndSnapshot {
+        StoreBackup* backup;
+        ~EndSnapshot() {
+            backup->disk_manager_->end_snapshot();
+            backup->finished_ = true;
+        }
+    } end_snapshot{this};
+
+    std::error_code ec;
+    fs::create_directories(dest_, ec);
+    if (ec) {
+        return Error(ErrorCode::IO_ERROR,
+                     "Failed to create backup directory: " + ec.message());
+    }
+
+    size_t page_size = disk_manager_->get_page_size();
+    PageId num_pages = disk_manager_->get_snapshot_pages();
+    fs::path db_path = dest_ / DB_FILE;
+    fs::path info_path = dest_ / INFO_FILE;
+
+    // An incremental backup needs a complete, older backup of the same layout
+    BackupInfo base;
+    bool incremental = options_.incremental &&
+                       load_info(info_path, base) &&
+                       base.complete != 0 &&
+                       base.page_size == page_size &&
+                       base.lsn < lsn_ &&
+                       fs::exists(db_path);
+
+    BackupStats stats;
+    stats.lsn = lsn_;
+    stats.pages_total = num_pages;
+    stats.incremental = incremental;
+
+    // The new image is built beside the old one (an incremental backup
+    // starts from a copy of it), so the previous backup stays usable
+    // until this one is complete
+    fs::path target = db_path;
+    target += ".tmp";
+    if (incremental) {
+        fs::copy_file(db_path, target, fs::copy_options::overwrite_existing, ec);
+        if (ec) {
+            return Error(ErrorCode::IO_ERROR, "Failed to copy base backup: " + ec.message());
+        }
+    }
+    std::fstream file(target, incremental
+        ? std::ios::in | std::ios::out | std::ios::binary
+        : std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file) {
+        return Error(ErrorCode::IO_ERROR, "Failed to open backup file: " + target.string());
+    }
+
+    std::vector<char> page(page_size);
+    for (PageId page_id = 0; page_id < num_pages; ++page_id) {
+        auto read = disk_manager_->read_snapshot_page(page_id, page.data());
+        if (!read.ok()) {
+            return read.error();
+        }
+
+        // Pages unchanged since the base backup are already there
+        if (incremental && page_id != 0 && page_id < base.num_pages &&
+            page_lsn_of(page.data()) <= base.lsn) {
+            continue;
+        }
+
+        file.seekp(static_cast<std::streamoff>(page_id) * static_cast<std::streamoff>(page_size));
+        file.write(page.data(), static_cast<std::streamsize>(page_size));
+        if (!file.good()) {
+            return Error(ErrorCode::IO_ERROR, "Failed to write backup page");
+        }
+        ++stats.pages_copied;
+    }
+
+    file.flush();
+    if (!file.good()) {
+        return Error(ErrorCode::IO_ERROR, "Failed to write backup file");
+    }
+    file.close();
+
+    if (incremental) {
+        fs::resize_file(target, static_cast<uintmax_t>(num_pages) * page_size, ec);
+        if (ec) {
+            return Error(ErrorCode::IO_ERROR, "Failed to finish backup file: " + ec.message());
+        }
+    }
+
+    // Only the renames run with the backup marked incomplete
+    BackupInfo info;
+    info.lsn = lsn_;
+    info.page_size = static_cast<uint32_t>(page_size);
+    info.num_pages = num_pages;
+    if (!save_info(info_path, info)) {
+        return Error(ErrorCode::IO_ERROR, "Failed to write backup info");
+    }
+
+    fs::rename(target, db_path, ec);
+    if (ec) {
+        return Error(ErrorCode::IO_ERROR, "Failed to finish backup file: " + ec.message());
+    }
+
+    if (!replace_file(dest_ / META_FILE, metadata_)) {
+        return Error(ErrorCode::IO_ERROR, "Failed to write backup metadata");
+    }
+
+    info.complete = 1;
+    if (!save_info(info_path, info)) {
+        return Error(ErrorCode::IO_ERROR, "Failed to write backup info");
+    }
+
+    return stats;
+}
+
+Result<void> StoreBackup::restore(const fs::path& backup_dir, const fs::path& root_dir) {
+    fs::path info_path = backup_dir / INFO_FILE;
+    BackupInfo info;
+    if (!load_info(info_path, info)) {
+        return Error(ErrorCode::NOT_FOUND, "No backup found in " + backup_dir.string());
+    }
+    if (info.complete == 0) {
+        return Error(ErrorCode::CORRUPTION, "Backup is incomplete: " + backup_dir.string());
+    }
+
+    std::error_code ec;
+    fs::create_directories(root_dir, ec);
+    if (ec) {
+        return Error(ErrorCode::IO_ERROR,
+                     "Failed to create root directory: " + ec.message());
+    }
+
+    // The backup is consumed; drop its marker first so a half-moved one
+    // is never restored again
+    fs::remove(info_path, ec);
+    if (ec) {
+        return Error(ErrorCode::IO_ERROR, "Failed to remove backup info: " + ec.message());
+    }
+
+    for (const char* name : {DB_FILE, META_FILE}) {
+        if (!move_file(backup_dir / name, root_dir / name)) {
+            return Error(ErrorCode::IO_ERROR, std::string("Failed to restore ") + name);
+        }
+    }
+
+    return Ok();
+}
+
+}  // namespace dam
@@ -0,0 +1,258 @@
+#include <dam/util/compression.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace dam {
+
+namespace {
+
+// LZ4 block format limits
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;   // Final bytes are always literals
+constexpr size_t MF_LIMIT = 12;       // Last match must start this far from the end
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 12;
+
+uint32_t read32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+void write_length(std::string& out, size_t len) {
+    while (len >= 255) {
+        out.push_back(static_cast<char>(255));
+        len -= 255;
+    }
+    out.push_back(static_cast<char>(len));
+}
+
+void emit_sequence(std::string& out, const char* literals, size_t literal_len,
+                   size_t offset, size_t match_len) {
+    size_t ml = match_len - MIN_MATCH;
+    uint8_t token = static_cast<uint8_t>((std::min<size_t>(literal_len, 15) << 4) |
+                                         std::min<size_t>(ml, 15));
+    out.push_back(static_cast<char>(token));
+    if (literal_len >= 15) {
+        write_length(out, literal_len - 15);
+    }
+    out.append(literals, literal_len);
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (ml >= 15) {
+        write_length(out, ml - 15);
+    }
+}
+
+void emit_last_literals(std::string& out, const char* literals, size_t literal_len) {
+    uint8_t token = static_cast<uint8_t>(std::min<size_t>(literal_len, 15) << 4);
+    out.push_back(static_cast<char>(token));
+    if (literal_len >= 15) {
+        write_length(out, literal_len - 15);
+    }
+    out.append(literals, literal_len);
+}
+
+bool read_length(const uint8_t*& ip, const uint8_t* end, size_t* len) {
+    uint8_t b;
+    do {
+        if (ip >= end) return false;
+        b = *ip++;
+        *len += b;
+    } while (b == 255);
+    return true;
+}
+
+}  // namespace
+
+// ============================================================================
+// LZ4 Implementation
+// ============================================================================
+
+std::string LZ4::compress(std::string_view input, std::string_view dictionary) {
+    if (dictionary.size() > MAX_DICTIONARY_SIZE) {
+        dictionary = dictionary.substr(dictionary.size() - MAX_DICTIONARY_SIZE);
+    }
+
+    // Matches are found over dictionary + input as one history
+    std::string history;
+    history.reserve(dictionary.size() + input.size());
+    history.append(dictionary);
+    history.append(input);
+    const char* base = history.data();
+    const size_t start = dictionary.size();
+    const size_t end = history.size();
+
+    std::string out;
+    out.reserve(input.size() / 2 + 16);
+
+    // Positions are stored +1 so that 0 means empty
+    std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+    for (size_t p = 0; p + MIN_MATCH <= start; ++p) {
+        table[hash4(read32(base + p))] = static_cast<uint32_t>(p + 1);
+    }
+
+    size_t anchor = start;
+    size_t ip = start;
+    while (input.size() >= MF_LIMIT && ip + MF_LIMIT <= end) {
+        uint32_t seq = read32(base + ip);
+        uint32_t h = hash4(seq);
+        size_t ref = table[h];
+        table[h] = static_cast<uint32_t>(ip + 1);
+
+        if (ref == 0 || ip - (ref - 1) > MAX_OFFSET || read32(base + ref - 1) != seq) {
+            ++ip;
+            continue;
+        }
+        ref -= 1;
+
+        // Extend backward over pending literals, then forward
+        while (ip > anchor && ref > 0 && base[ip - 1] == base[ref - 1]) {
+            --ip;
+            --ref;
+        }
+        size_t len = MIN_MATCH;
+        while (ip + len < end - LAST_LITERALS && base[ref + len] == base[ip + len]) {
+            ++len;
+        }
+
+        emit_sequence(out, base + anchor, ip - anchor, ip - ref, len);
+        ip += len;
+        anchor = ip;
+
+        // Index a position inside the match to help the next search
+        if (ip >= 2 && ip + MIN_MATCH <= end) {
+            table[hash4(read32(base + ip - 2))] = static_cast<uint32_t>(ip - 2 + 1);
+        }
+    }
+
+    emit_last_literals(out, base + anchor, end - anchor);
+    return out;
+}
+
+bool LZ4::decompress(std::string_view input, size_t raw_size,
+                     std::string* output, std::string_view dictionary) {
+    if (dictionary.size() > MAX_DICTIONARY_SIZE) {
+        dictionary = dictionary.substr(dictionary.size() - MAX_DICTIONARY_SIZE);
+    }
+
+    std::string buf;
+    buf.reserve(dictionary.size() + raw_size);
+    buf.append(dictionary);
+    const size_t limit = dictionary.size() + raw_size;
+
+    const uint8_t* ip = reinterpret_cast<const uint8_t*>(input.data());
+    const uint8_t* end = ip + input.size();
+
+    while (ip < end) {
+        uint8_t token = *ip++;
+
+        size_t literal_len = token >> 4;
+        if (literal_len == 15 && !read_length(ip, end, &literal_len)) {
+            return false;
+        }
+        if (static_cast<size_t>(end - ip) < literal_len ||
+            buf.size() + literal_len > limit) {
+            return false;
+        }
+        buf.append(reinterpret_cast<const char*>(ip), literal_len);
+        ip += literal_len;
+
+        // The last sequence has literals only
+        if (ip == end) {
+            break;
+        }
+
+        if (end - ip < 2) {
+            return false;
+        }
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+
+        size_t match_len = token & 0x0F;
+        if (match_len == 15 && !read_length(ip, end, &match_len)) {
+            return false;
+        }
+        match_len += MIN_MATCH;
+
+        if (offset == 0 || offset > buf.size() || buf.size() + match_len > limit) {
+            return false;
+        }
+
+        // Byte-wise copy: matches may overlap the bytes they produce
+        size_t from = buf.size() - offset;
+        for (size_t i = 0; i < match_len; ++i) {
+            buf.push_back(buf[from + i]);
+        }
+    }
+
+    if (buf.size() != limit) {
+        return false;
+    }
+
+    output->assign(buf, dictionary.size(), raw_size);
+    return true;
+}
+
+// ============================================================================
+// DictionaryTrainer Implementation
+// ============================================================================
+
+std::string DictionaryTrainer::train(const std::vector<std::string>& samples,
+                                     size_t max_size) {
+    max_size = std::min(max_size, LZ4::MAX_DICTIONARY_SIZE);
+
+    // Document frequency of each line (with its newline)
+    std::unordered_map<std::string_view, size_t> doc_freq;
+    for (const auto& sample : samples) {
+        std::unordered_set<std::string_view> seen;
+        size_t pos = 0;
+        while (pos < sample.size()) {
+            size_t nl = sample.find('\n', pos);
+            size_t stop = (nl == std::string::npos) ? sample.size() : nl + 1;
+            std::string_view line(sample.data() + pos, stop - pos);
+            if (line.size() > MIN_MATCH && seen.insert(line).second) {
+                ++doc_freq[line];
+            }
+            pos = stop;
+        }
+    }
+
+    // Keep lines that recur, best first
+    std::vector<std::pair<size_t, std::string_view>> scored;
+    for (const auto& [line, freq] : doc_freq) {
+        if (freq >= 2) {
+            scored.emplace_back((freq - 1) * line.size(), line);
+        }
+    }
+    std::sort(scored.begin(), scored.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    std::vector<std::string_view> chosen;
+    size_t total = 0;
+    for (const auto& [score, line] : scored) {
+        if (total + line.size() > max_size) {
+            continue;
+        }
+        chosen.push_back(line);
+        total += line.size();
+    }
+
+    // Best lines last, closest to the data being compressed
+    std::string dictionary;
+    dictionary.reserve(total);
+    for (auto it = chosen.rbegin(); it != chosen.rend(); ++it) {
+        dictionary.append(*it);
+    }
+    return dictionary;
+}
+
+}  // namespace dam
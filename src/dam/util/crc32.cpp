@@ -2,7 +2,7 @@
 
 namespace dam {
 
-uint32_t CRC32::table_[256];
+uint32_t CRC32::table_[8][256];
 bool CRC32::table_initialized_ = false;
 
 void CRC32::init_table() {
@@ -13,20 +13,22 @@ void CRC32::init_table() {
         for (int j = 0; j < 8; ++j) {
             crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
         }
-        table_[i] = crc;
+        table_[0][i] = crc;
+    }
+
+    // table_[k][i] is the CRC of byte i followed by k zero bytes
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (int k = 1; k < 8; ++k) {
+            uint32_t prev = table_[k - 1][i];
+            table_[k][i] = (prev >> 8) ^ table_[0][prev & 0xFF];
+        }
     }
 
     table_initialized_ = true;
 }
 
 uint32_t CRC32::compute(const uint8_t* data, size_t len) {
-    init_table();
-
-    uint32_t crc = 0xFFFFFFFF;
-    for (size_t i = 0; i < len; ++i) {
-        crc = table_[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
-    }
-    return crc ^ 0xFFFFFFFF;
+    return update(0, data, len);
 }
 
 uint32_t CRC32::compute(const char* data, size_t len) {
@@ -41,8 +43,27 @@ uint32_t CRC32::update(uint32_t crc, const uint8_t* data, size_t len) {
     init_table();
 
     crc = ~crc;
+
+    // Slicing-by-8: fold eight bytes per step through the shifted tables
+    while (len >= 8) {
+        uint32_t lo = crc ^ (static_cast<uint32_t>(data[0]) |
+                             static_cast<uint32_t>(data[1]) << 8 |
+                             static_cast<uint32_t>(data[2]) << 16 |
+                             static_cast<uint32_t>(data[3]) << 24);
+        uint32_t hi = static_cast<uint32_t>(data[4]) |
+                      static_cast<uint32_t>(data[5]) << 8 |
+                      static_cast<uint32_t>(data[6]) << 16 |
+                      static_cast<uint32_t>(data[7]) << 24;
+        crc = table_[7][lo & 0xFF] ^ table_[6][(lo >> 8) & 0xFF] ^
+              table_[5][(lo >> 16) & 0xFF] ^ table_[4][lo >> 24] ^
+              table_[3][hi & 0xFF] ^ table_[2][(hi >> 8) & 0xFF] ^
+              table_[1][(hi >> 16) & 0xFF] ^ table_[0][hi >> 24];
+        data += 8;
+        len -= 8;
+    }
+
     for (size_t i = 0; i < len; ++i) {
-        crc = table_[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        crc = table_[0][(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
     }
     return ~crc;
 }
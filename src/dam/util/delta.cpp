@@ -0,0 +1,117 @@
+#include <dam/util/delta.hpp>
+#include <dam/util/serializer.hpp>
+
+#include <string_view>
+#include <unordered_map>
+
+namespace dam {
+
+namespace {
+
+constexpr uint8_t OP_COPY = 1;
+constexpr uint8_t OP_INSERT = 2;
+
+// A copy costs op(1) + offset(4) + length(4); shorter lines are cheaper
+// to insert unless they continue an existing copy
+constexpr size_t MIN_COPY_LINE = 9;
+
+size_t line_end(const std::string& s, size_t pos) {
+    size_t nl = s.find('\n', pos);
+    return (nl == std::string::npos) ? s.size() : nl + 1;
+}
+
+}  // namespace
+
+std::string Delta::encode(const std::string& base, const std::string& target) {
+    // First offset of each base line (with its newline)
+    std::unordered_map<std::string_view, size_t> base_lines;
+    for (size_t pos = 0; pos < base.size();) {
+        size_t end = line_end(base, pos);
+        base_lines.emplace(std::string_view(base.data() + pos, end - pos), pos);
+        pos = end;
+    }
+
+    BinaryWriter writer;
+    size_t copy_offset = 0;
+    size_t copy_len = 0;
+    std::string pending;
+
+    auto flush_copy = [&]() {
+        if (copy_len > 0) {
+            writer.write_uint8(OP_COPY);
+            writer.write_uint32(static_cast<uint32_t>(copy_offset));
+            writer.write_uint32(static_cast<uint32_t>(copy_len));
+            copy_len = 0;
+        }
+    };
+    auto flush_insert = [&]() {
+        if (!pending.empty()) {
+            writer.write_uint8(OP_INSERT);
+            writer.write_string(pending);
+            pending.clear();
+        }
+    };
+
+    for (size_t pos = 0; pos < target.size();) {
+        size_t end = line_end(target, pos);
+        std::string_view line(target.data() + pos, end - pos);
+        pos = end;
+
+        // Continue the current copy while the base keeps matching
+        size_t next = copy_offset + copy_len;
+        if (copy_len > 0 && base.compare(next, line.size(), line) == 0) {
+            copy_len += line.size();
+            continue;
+        }
+
+        auto it = base_lines.find(line);
+        if (it != base_lines.end() && line.size() >= MIN_COPY_LINE) {
+            flush_copy();
+            flush_insert();
+            copy_offset = it->second;
+            copy_len = line.size();
+            continue;
+        }
+
+        flush_copy();
+        pending.append(line);
+    }
+    flush_copy();
+    flush_insert();
+
+    return writer.data();
+}
+
+bool Delta::apply(const std::string& base, const std::string& delta,
+                  std::string* target) {
+    BinaryReader reader(delta);
+    std::string out;
+
+    while (reader.remaining() > 0) {
+        uint8_t op = 0;
+        reader.read_uint8(&op);
+
+        if (op == OP_COPY) {
+            uint32_t offset = 0;
+            uint32_t length = 0;
+            if (!reader.read_uint32(&offset) || !reader.read_uint32(&length) ||
+                offset > base.size() || length > base.size() - offset) {
+                return false;
+            }
+            out.append(base, offset, length);
+        } else if (op == OP_INSERT) {
+            std::string bytes;
+            if (!reader.read_string(&bytes)) {
+                return false;
+            }
+            out.append(bytes);
+        } else {
+            return false;
+        }
+    }
+
+    *target = std::move(out);
+    return true;
+}
+
+}  // namespace dam
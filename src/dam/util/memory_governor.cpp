@@ -0,0 +1,96 @@
+#include <dam/util/memory_governor.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace dam {
+
+// ============================================================================
+// MemoryGovernor Implementation
+// ============================================================================
+
+MemoryGovernor::MemoryGovernor(size_t budget_bytes)
+    : budget_(budget_bytes) {}
+
+void MemoryGovernor::register_consumer(MemoryConsumer* consumer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (std::find(consumers_.begin(), consumers_.end(), consumer) == consumers_.end()) {
+        consumers_.push_back(consumer);
+    }
+}
+
+void MemoryGovernor::unregister_consumer(MemoryConsumer* consumer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    consumers_.erase(std::remove(consumers_.begin(), consumers_.end(), consumer),
+                     consumers_.end());
+}
+
+bool MemoryGovernor::request(const MemoryConsumer* requester, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t used = usage_locked();
+    if (used + bytes <= budget_) {
+        return true;
+    }
+
+    size_t needed = used + bytes - budget_;
+
+    // Reclaim from the largest other consumers first
+    std::vector<std::pair<size_t, MemoryConsumer*>> victims;
+    for (MemoryConsumer* c : consumers_) {
+        if (c != requester) {
+            victims.emplace_back(c->memory_usage(), c);
+        }
+    }
+    std::sort(victims.begin(), victims.end(),
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    for (auto& [usage, consumer] : victims) {
+        if (needed == 0) break;
+        size_t freed = consumer->reclaim(needed);
+        needed -= std::min(freed, needed);
+    }
+
+    return needed == 0;
+}
+
+size_t MemoryGovernor::budget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+void MemoryGovernor::set_budget(size_t budget_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = budget_bytes;
+}
+
+size_t MemoryGovernor::usage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return usage_locked();
+}
+
+size_t MemoryGovernor::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t used = usage_locked();
+    return used < budget_ ? budget_ - used : 0;
+}
+
+std::vector<MemoryGovernor::ConsumerUsage> MemoryGovernor::report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ConsumerUsage> result;
+    result.reserve(consumers_.size());
+    for (const MemoryConsumer* c : consumers_) {
+        result.push_back({c->consumer_name(), c->memory_usage()});
+    }
+    return result;
+}
+
+size_t MemoryGovernor::usage_locked() const {
+    size_t total = 0;
+    for (const MemoryConsumer* c : consumers_) {
+        total += c->memory_usage();
+    }
+    return total;
+}
+
+}  // namespace dam
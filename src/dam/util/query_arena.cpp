@@ -0,0 +1,187 @@
+#include <dam/util/query_arena.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+namespace dam {
+
+namespace {
+
+// Bytes held by all threads' arena buffers, and the per-thread cap
+std::atomic<size_t> g_retained_bytes{0};
+std::atomic<size_t> g_retain_limit{QueryArena::MAX_RETAINED_SIZE};
+std::atomic<MemoryGovernor*> g_governor{nullptr};
+
+// Every live arena, so idle ones can be trimmed from another thread
+std::mutex g_arenas_mutex;
+std::vector<QueryArena*> g_arenas;
+
+class QueryArenaConsumer : public MemoryConsumer {
+public:
+    std::string consumer_name() const override { return "query_arenas"; }
+
+    size_t memory_usage() const override { return g_retained_bytes.load(); }
+
+    size_t reclaim(size_t bytes) override {
+        // Arenas in the middle of a query cannot be trimmed now; halving
+        // the cap makes them trim at their next reset
+        size_t limit = g_retain_limit.load();
+        g_retain_limit = std::max(QueryArena::INITIAL_SIZE, limit / 2);
+        return QueryArena::trim_idle(bytes);
+    }
+};
+
+// The retention cap for an arena whose last query used `wanted` bytes. A
+// cap lowered by reclaim() is lifted once the governor has room for that.
+size_t retain_limit(size_t wanted) {
+    size_t limit = g_retain_limit.load();
+    if (limit < QueryArena::MAX_RETAINED_SIZE && wanted > limit) {
+        MemoryGovernor* governor = g_governor.load();
+        if (!governor || governor->available() >= wanted) {
+            g_retain_limit = QueryArena::MAX_RETAINED_SIZE;
+            limit = QueryArena::MAX_RETAINED_SIZE;
+        }
+    }
+    return limit;
+}
+
+}  // namespace
+
+// ============================================================================
+// QueryArena Implementation
+// ============================================================================
+
+void* QueryArena::CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    allocated += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void QueryArena::CountingResource::do_deallocate(void* p, size_t bytes,
+                                                 size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+QueryArena::QueryArena() {
+    set_buffer_size(INITIAL_SIZE);
+    monotonic_.emplace(buffer_.data(), buffer_.size(), &upstream_);
+
+    std::lock_guard<std::mutex> lock(g_arenas_mutex);
+    g_arenas.push_back(this);
+}
+
+QueryArena::~QueryArena() {
+    {
+        std::lock_guard<std::mutex> lock(g_arenas_mutex);
+        g_arenas.erase(std::remove(g_arenas.begin(), g_arenas.end(), this), g_arenas.end());
+    }
+    monotonic_.reset();
+    g_retained_bytes -= buffer_.size();
+}
+
+MemoryConsumer& QueryArena::memory_consumer() {
+    static QueryArenaConsumer consumer;
+    return consumer;
+}
+
+void QueryArena::attach_memory_governor(MemoryGovernor* governor) {
+    MemoryGovernor* previous = g_governor.exchange(governor);
+    if (previous == governor) {
+        return;
+    }
+    if (previous) {
+        previous->unregister_consumer(&memory_consumer());
+    }
+    if (governor) {
+        governor->register_consumer(&memory_consumer());
+    } else {
+        g_retain_limit = MAX_RETAINED_SIZE;
+    }
+}
+
+void QueryArena::detach_memory_governor(MemoryGovernor* governor) {
+    if (governor && g_governor.load() == governor) {
+        attach_memory_governor(nullptr);
+    }
+}
+
+size_t QueryArena::trim_idle(size_t bytes) {
+    std::lock_guard<std::mutex> lock(g_arenas_mutex);
+
+    size_t freed = 0;
+    for (QueryArena* arena : g_arenas) {
+        if (freed >= bytes) {
+            break;
+        }
+        if (arena->buffer_.size() <= INITIAL_SIZE || !arena->try_acquire()) {
+            continue;
+        }
+        size_t before = arena->buffer_.size();
+        arena->monotonic_.reset();
+        arena->set_buffer_size(INITIAL_SIZE);
+        arena->monotonic_.emplace(arena->buffer_.data(), arena->buffer_.size(),
+                                  &arena->upstream_);
+        arena->release();
+        freed += before - INITIAL_SIZE;
+    }
+    return freed;
+}
+
+void QueryArena::set_buffer_size(size_t size) {
+    g_retained_bytes -= buffer_.size();
+    std::vector<std::byte>(size).swap(buffer_);
+    g_retained_bytes += buffer_.size();
+}
+
+QueryArena& QueryArena::for_this_thread() {
+    thread_local QueryArena arena;
+    return arena;
+}
+
+void QueryArena::acquire() {
+    // trim_idle() holds an idle arena only for one buffer swap
+    while (!try_acquire()) {
+        std::this_thread::yield();
+    }
+}
+
+void QueryArena::reset() {
+    size_t high_water = buffer_.size() + upstream_.allocated;
+
+    // Destroying the monotonic resource returns overflow chunks to the heap
+    monotonic_.reset();
+    upstream_.allocated = 0;
+
+    size_t limit = retain_limit(high_water);
+    if (buffer_.size() > limit) {
+        set_buffer_size(std::max(limit, INITIAL_SIZE));
+    } else if (high_water > buffer_.size() && buffer_.size() < limit) {
+        size_t target = std::min(high_water, limit);
+        MemoryGovernor* governor = g_governor.load();
+        if (!governor || governor->request(&memory_consumer(), target - buffer_.size())) {
+            set_buffer_size(target);
+        }
+    }
+
+    monotonic_.emplace(buffer_.data(), buffer_.size(), &upstream_);
+}
+
+// ============================================================================
+// QueryArenaScope Implementation
+// ============================================================================
+
+QueryArenaScope::QueryArenaScope()
+    : arena_(QueryArena::for_this_thread()) {
+    if (arena_.depth_++ == 0) {
+        arena_.acquire();
+    }
+}
+
+QueryArenaScope::~QueryArenaScope() {
+    if (--arena_.depth_ == 0) {
+        arena_.reset();
+        arena_.release();
+    }
+}
+
+}  // namespace dam
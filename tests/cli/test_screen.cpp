@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "screen.hpp"
+#include "terminal.hpp"
+
+#include <string>
+
+using namespace dam::cli;
+
+namespace {
+
+// A frame hides the cursor, draws, then parks the cursor at the origin
+std::string frame(const std::string& rows) {
+    return "\033[?25l" + rows + "\033[1;1H\033[?25h";
+}
+
+// Draw one row as a fresh frame and return what diff() sends
+std::string repaint(Screen& screen, const std::string& text) {
+    screen.clear();
+    screen.put(0, 0, text);
+    return screen.diff();
+}
+
+}  // namespace
+
+TEST(ScreenTest, PutAdvancesByDisplayWidth) {
+    Screen screen(10, 1);
+    EXPECT_EQ(screen.put(0, 0, "aé漢b"), 5);
+
+    // Combining marks take no column and are dropped
+    EXPECT_EQ(screen.put(0, 5, "e\xCC\x81!"), 7);
+    EXPECT_EQ(screen.diff(), frame("\033[1;1Haé漢be!\033[K"));
+}
+
+TEST(ScreenTest, RepaintAfterWideCharactersMovesToDisplayColumn) {
+    Screen screen(10, 1);
+    ASSERT_EQ(repaint(screen, "aé漢b"), frame("\033[1;1Haé漢b\033[K"));
+
+    // 'b' is the fifth column though the seventh byte
+    EXPECT_EQ(repaint(screen, "aé漢c"), "\033[?25l\033[1;5Hc\033[1;1H\033[?25h");
+
+    // Changing the wide character repaints both of its columns
+    EXPECT_EQ(repaint(screen, "aé字c"), "\033[?25l\033[1;3H字\033[1;1H\033[?25h");
+    EXPECT_EQ(repaint(screen, "aéxyc"), "\033[?25l\033[1;3Hxy\033[1;1H\033[?25h");
+    EXPECT_EQ(repaint(screen, "aéxyc"), "");
+}
+
+TEST(ScreenTest, OverwritingHalfAWideCharacterBlanksTheOtherHalf) {
+    Screen screen(6, 1);
+    ASSERT_EQ(repaint(screen, "a漢b"), frame("\033[1;1Ha漢b\033[K"));
+
+    screen.clear();
+    screen.put(0, 0, "a漢b");
+    screen.put(0, 2, "z", colors::BOLD);
+    EXPECT_EQ(screen.diff(), "\033[?25l\033[1;2H \033[0m\033[1mz\033[0m\033[1;1H\033[?25h");
+}
+
+TEST(ScreenTest, ClipsAtDisplayColumns) {
+    Screen screen(5, 1);
+    EXPECT_EQ(screen.put(0, 0, "漢字漢字"), 5);
+    EXPECT_EQ(screen.diff(), frame("\033[1;1H漢字\033[K"));
+
+    // A wide character with only its second half on screen shows as a space
+    EXPECT_EQ(repaint(screen, "éé"), "\033[?25l\033[1;1Héé\033[K\033[1;1H\033[?25h");
+    screen.clear();
+    EXPECT_EQ(screen.put(0, -1, "漢x"), 2);
+    EXPECT_EQ(screen.diff(), "\033[?25l\033[1;1H x\033[1;1H\033[?25h");
+}
+
+TEST(ScreenTest, MalformedBytesDrawAsQuestionMarks) {
+    Screen screen(6, 1);
+    EXPECT_EQ(screen.put(0, 0, "a\xFF\xC3z\xE6\xBC"), 6);
+    EXPECT_EQ(screen.diff(), frame("\033[1;1Ha??z??"));
+}
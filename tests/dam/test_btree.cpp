@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
+#include <dam/index/similarity_index.hpp>
 #include <dam/storage/btree.hpp>
 #include <dam/storage/buffer_pool.hpp>
 #include <dam/storage/disk_manager.hpp>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
+#include <new>
+#include <vector>
 
 using namespace dam;
 namespace fs = std::filesystem;
@@ -91,6 +96,82 @@ TEST_F(BPlusTreeTest, Contains) {
     EXPECT_FALSE(tree.contains("other"));
 }
 
+TEST(LeafPageTest, UpdateOnFullLeafKeepsKey) {
+    Page page;
+    LeafPage leaf(&page);
+
+    int count = 0;
+    while (true) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "k%04d", count);
+        if (!leaf.has_space(std::strlen(key), 20)) break;
+        ASSERT_TRUE(leaf.insert(key, std::string(20, 'v')));
+        ++count;
+    }
+    ASSERT_GT(count, 10);
+
+    // Leave exactly 10 free bytes
+    size_t filler = 30;
+    while (!leaf.has_space(4, filler + 10)) --filler;
+    ASSERT_TRUE(leaf.insert("zzzz", std::string(filler, 'f')));
+    ASSERT_TRUE(leaf.has_space(0, 10 - LeafPage::SLOT_SIZE));
+    ASSERT_FALSE(leaf.has_space(0, 11 - LeafPage::SLOT_SIZE));
+
+    // Growing by less than the free space, but without room for the whole
+    // entry, is refused and keeps the old value
+    std::string value;
+    EXPECT_FALSE(leaf.update("k0005", std::string(28, 'w')));
+    ASSERT_TRUE(leaf.find("k0005", &value));
+    EXPECT_EQ(value, std::string(20, 'v'));
+
+    // Shrinking rewrites in place, whatever the free space
+    EXPECT_TRUE(leaf.update("k0003", std::string(10, 's')));
+    ASSERT_TRUE(leaf.find("k0003", &value));
+    EXPECT_EQ(value, std::string(10, 's'));
+    EXPECT_EQ(leaf.get_all().size(), static_cast<size_t>(count + 1));
+}
+
+// A 3-byte big-endian key, so keys sort in insertion order
+std::string small_key(uint32_t i) {
+    return {static_cast<char>(i >> 16), static_cast<char>(i >> 8), static_cast<char>(i)};
+}
+
+TEST(LeafPageTest, MaxSizePageStopsAtKeyLimit) {
+    std::vector<std::byte> frame(MAX_PAGE_SIZE);
+    Page* page = new (frame.data()) Page();
+    page->format(MAX_PAGE_SIZE);
+    LeafPage leaf(page);
+
+    // Minimal entries would fit more than num_keys can count
+    uint32_t count = 0;
+    while (leaf.insert(small_key(count), "")) {
+        ++count;
+    }
+    EXPECT_EQ(count, Page::MAX_KEYS);
+    EXPECT_FALSE(leaf.has_space(3, 0));
+    EXPECT_EQ(page->get_num_keys(), Page::MAX_KEYS);
+
+    std::string value;
+    EXPECT_TRUE(leaf.find(small_key(0), &value));
+    EXPECT_TRUE(leaf.find(small_key(count - 1), &value));
+    EXPECT_EQ(leaf.get_all().size(), Page::MAX_KEYS);
+}
+
+TEST(InternalPageTest, MaxSizePageStopsAtKeyLimit) {
+    std::vector<std::byte> frame(MAX_PAGE_SIZE);
+    Page* page = new (frame.data()) Page();
+    page->format(MAX_PAGE_SIZE);
+    InternalPage node(page);
+
+    uint32_t count = 0;
+    while (node.insert(small_key(count), count + 1)) {
+        ++count;
+    }
+    EXPECT_EQ(count, Page::MAX_KEYS);
+    EXPECT_FALSE(node.has_space(3));
+    EXPECT_EQ(node.get_key_at(count - 1), small_key(count - 1));
+}
+
 TEST_F(BPlusTreeTest, LargeInserts) {
     BPlusTree tree(buffer_pool_.get());
 
@@ -110,3 +191,233 @@ TEST_F(BPlusTreeTest, LargeInserts) {
         EXPECT_EQ(*v, expected);
     }
 }
+
+TEST_F(BPlusTreeTest, InternalSplitsKeepEveryKey) {
+    BPlusTree tree(buffer_pool_.get());
+
+    // Enough entries for internal nodes to split
+    const int count = 30000;
+    for (int i = 1; i <= count; ++i) {
+        ASSERT_TRUE(tree.insert(std::to_string(i), std::string(60, 'v')));
+    }
+    ASSERT_GE(tree.height(), 3u);
+    EXPECT_TRUE(tree.verify());
+
+    for (int i = 1; i <= count; i += 97) {
+        EXPECT_TRUE(tree.contains(std::to_string(i))) << i;
+    }
+}
+
+TEST_F(BPlusTreeTest, ParallelScanMatchesSequentialOrder) {
+    BPlusTree tree(buffer_pool_.get());
+
+    for (int i = 0; i < 2000; ++i) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "key%05d", i);
+        ASSERT_TRUE(tree.insert(key, std::string(40, 'v') + std::to_string(i)));
+    }
+    ASSERT_GT(tree.height(), 1u);
+
+    auto ranges = tree.partition(4);
+    EXPECT_GT(ranges.size(), 1u);
+    EXPECT_LE(ranges.size(), 4u);
+
+    using Keys = std::vector<std::string>;
+    Keys keys = tree.parallel_scan<Keys>(
+        [](Keys& out, const std::string& key, const std::string&) { out.push_back(key); },
+        [](Keys& into, Keys&& from) { into.insert(into.end(), from.begin(), from.end()); },
+        4);
+
+    Keys expected;
+    tree.for_each([&](const std::string& key, const std::string&) {
+        expected.push_back(key);
+        return true;
+    });
+    EXPECT_EQ(keys.size(), 2000u);
+    EXPECT_EQ(keys, expected);
+}
+
+TEST_F(BPlusTreeTest, GrowingUpdatesReclaimLeafSpace) {
+    BPlusTree tree(buffer_pool_.get());
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(tree.insert("k" + std::to_string(i), std::string(20, 'v')));
+    }
+    ASSERT_TRUE(tree.insert("grow", "x"));
+
+    // Each update leaves the previous value behind as a gap
+    for (size_t size = 8; size <= 2048; size += 8) {
+        ASSERT_TRUE(tree.update("grow", std::string(size, 'x'))) << size;
+        auto value = tree.find("grow");
+        ASSERT_TRUE(value.has_value()) << size;
+        ASSERT_EQ(value->size(), size);
+    }
+    EXPECT_TRUE(tree.verify());
+}
+
+TEST_F(BPlusTreeTest, FailedUpdateKeepsOldValue) {
+    BPlusTree tree(buffer_pool_.get());
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(tree.insert("k" + std::to_string(i), std::string(20, 'v')));
+    }
+    ASSERT_TRUE(tree.insert("big", std::string(2048, 'x')));
+
+    // A value too large for any leaf is refused without losing the key
+    EXPECT_FALSE(tree.update("big", std::string(PAGE_SIZE * 2, 'x')));
+    auto value = tree.find("big");
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(*value, std::string(2048, 'x'));
+    EXPECT_EQ(tree.size(), 51);
+    EXPECT_TRUE(tree.verify());
+}
+
+TEST_F(BPlusTreeTest, IteratorSeeksAndSkipsLeaves) {
+    BPlusTree tree(buffer_pool_.get());
+
+    for (int i = 0; i < 2000; ++i) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "key%05d", i);
+        ASSERT_TRUE(tree.insert(key, std::string(40, 'v')));
+    }
+    ASSERT_GT(tree.height(), 1u);
+
+    auto it = tree.seek("key00100x");
+    ASSERT_TRUE(it.valid());
+    EXPECT_EQ(it.key(), "key00101");
+
+    // Skips across many leaves land on the right key
+    EXPECT_EQ(it.skip(1500), 1500u);
+    ASSERT_TRUE(it.valid());
+    EXPECT_EQ(it.key(), "key01601");
+    ++it;
+    EXPECT_EQ(it.key(), "key01602");
+
+    EXPECT_EQ(it.skip(1000), 398u);
+    EXPECT_FALSE(it.valid());
+    EXPECT_FALSE(tree.seek("key99999").valid());
+
+    size_t count = 0;
+    for (auto all = tree.seek(""); all.valid(); ++all) {
+        ++count;
+    }
+    EXPECT_EQ(count, 2000u);
+}
+
+TEST_F(BPlusTreeTest, SplitBalancesMixedEntrySizes) {
+    BPlusTree tree(buffer_pool_.get());
+
+    // Many small entries followed by a few large ones: a split by count
+    // would leave all the large ones, and more than a page, on one side
+    for (int i = 0; i < 120; ++i) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "a%04d", i);
+        ASSERT_TRUE(tree.insert(key, ""));
+    }
+    for (int i = 0; i < 40; ++i) {
+        ASSERT_TRUE(tree.insert("z" + std::to_string(100 + i), std::string(512, 'v'))) << i;
+    }
+    EXPECT_EQ(tree.size(), 160u);
+    EXPECT_TRUE(tree.verify());
+    EXPECT_EQ(tree.find("z139").value_or(""), std::string(512, 'v'));
+}
+
+TEST_F(BPlusTreeTest, SimilarityBucketsScaleWithDocumentCount) {
+    SimilarityIndex index(buffer_pool_.get());
+    std::string body;
+    for (int i = 0; i < 20; ++i) {
+        body += "total += weights[" + std::to_string(i) + "] * inputs[i];\n";
+    }
+
+    // Identical bodies share every bucket; their IDs outgrow any one page
+    constexpr FileId COUNT = 600;
+    for (FileId id = 1; id <= COUNT; ++id) {
+        auto added = index.add(id, body);
+        ASSERT_TRUE(added.ok()) << added.error().to_string();
+        ASSERT_TRUE(*added);
+    }
+    EXPECT_FALSE(*index.add(COUNT + 1, "ab"));
+
+    auto similar = index.find_similar(COUNT, 0.9f, COUNT);
+    ASSERT_EQ(similar.size(), COUNT - 1);
+    EXPECT_EQ(similar.front().id, 1u);
+    EXPECT_EQ(similar.back().id, COUNT - 1);
+    EXPECT_EQ(index.find_duplicates(0.9f).size(), COUNT * (COUNT - 1) / 2);
+
+    for (FileId id = 1; id < COUNT; ++id) {
+        auto removed = index.remove(id);
+        ASSERT_TRUE(removed.ok());
+        ASSERT_TRUE(*removed);
+    }
+    EXPECT_FALSE(*index.remove(1));
+    EXPECT_TRUE(index.find_similar(COUNT, 0.5f).empty());
+    EXPECT_TRUE(index.find_duplicates(0.5f).empty());
+}
+
+TEST_F(BPlusTreeTest, SimilarityIndexRebuildsOlderLayout) {
+    PageId root;
+    {
+        // One bucket in the earlier layout: a set of IDs under one key
+        BPlusTree tree(buffer_pool_.get());
+        ASSERT_TRUE(tree.insert("band:00:0123456789abcdef", std::string(16, '\0')));
+        root = tree.get_root_page_id();
+    }
+
+    SimilarityIndex index(buffer_pool_.get(), root);
+    EXPECT_FALSE(index.has_current_layout());
+    ASSERT_TRUE(index.clear().ok());
+    EXPECT_TRUE(index.has_current_layout());
+    EXPECT_TRUE(index.find_duplicates(0.0f).empty());
+
+    EXPECT_TRUE(SimilarityIndex(buffer_pool_.get()).has_current_layout());
+}
+
+// Page size is per database file; large pages switch to 32-bit offsets
+class BPlusTreePageSizeTest : public ::testing::TestWithParam<size_t> {
+protected:
+    void SetUp() override {
+        test_dir_ = fs::temp_directory_path() / "btree_page_size_test";
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_);
+    }
+
+    void TearDown() override {
+        fs::remove_all(test_dir_);
+    }
+
+    fs::path test_dir_;
+};
+
+TEST_P(BPlusTreePageSizeTest, LargeValuesSurviveReopen) {
+    const size_t page_size = GetParam();
+    const std::string big(3000, 'x');
+    PageId root = INVALID_PAGE_ID;
+
+    {
+        DiskManager disk(test_dir_ / "test.db", page_size);
+        ASSERT_TRUE(disk.is_valid());
+        BufferPool pool(64, &disk);
+        EXPECT_EQ(pool.page_size(), page_size);
+
+        BPlusTree tree(&pool);
+        for (int i = 0; i < 200; ++i) {
+            ASSERT_TRUE(tree.insert("key" + std::to_string(i), big + std::to_string(i)));
+        }
+        EXPECT_EQ(tree.size(), 200);
+        root = tree.get_root_page_id();
+    }
+
+    // The header's page size wins over the default requested here
+    DiskManager disk(test_dir_ / "test.db");
+    ASSERT_TRUE(disk.is_valid());
+    EXPECT_EQ(disk.get_page_size(), page_size);
+    BufferPool pool(64, &disk);
+
+    BPlusTree tree(&pool, root);
+    for (int i = 0; i < 200; ++i) {
+        auto v = tree.find("key" + std::to_string(i));
+        ASSERT_TRUE(v.has_value()) << "Key not found: key" << i;
+        EXPECT_EQ(*v, big + std::to_string(i));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(PageSizes, BPlusTreePageSizeTest,
+                         ::testing::Values(PAGE_SIZE, 16 * 1024, 256 * 1024));
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include <dam/storage/buffer_pool.hpp>
 #include <dam/storage/disk_manager.hpp>
+#include <dam/search/vector_index.hpp>
+#include <dam/util/query_arena.hpp>
 #include <filesystem>
+#include <vector>
 
 using namespace dam;
 namespace fs = std::filesystem;
@@ -108,3 +111,182 @@ TEST_F(BufferPoolTest, MultiplePages) {
         EXPECT_TRUE(buffer_pool_->contains_page(id));
     }
 }
+
+TEST_F(BufferPoolTest, FramesArePageAligned) {
+    std::vector<PageId> page_ids;
+
+    for (int i = 0; i < 10; ++i) {
+        Page* page = buffer_pool_->new_page();
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(page) % PAGE_SIZE, 0u);
+        page_ids.push_back(page->get_page_id());
+    }
+
+    for (PageId id : page_ids) {
+        buffer_pool_->unpin_page(id, false);
+    }
+}
+
+TEST(FrameArenaTest, LargeArenaIsContiguous) {
+    size_t frames = BufferPool::frames_for_budget(4 * HUGE_PAGE_SIZE);
+    FrameArena arena(frames);
+
+    EXPECT_EQ(arena.num_frames(), frames);
+    EXPECT_GE(arena.mapped_bytes(), frames * PAGE_SIZE);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(arena.frame(0)) % PAGE_SIZE, 0u);
+    EXPECT_EQ(reinterpret_cast<char*>(arena.frame(frames - 1)) -
+              reinterpret_cast<char*>(arena.frame(0)),
+              static_cast<ptrdiff_t>((frames - 1) * PAGE_SIZE));
+    EXPECT_EQ(arena.frame(frames - 1)->get_page_id(), INVALID_PAGE_ID);
+}
+
+TEST_F(BufferPoolTest, ResizePreservesPages) {
+    BufferPool pool(8, disk_manager_.get(), 64);
+    std::vector<PageId> page_ids;
+
+    for (int i = 0; i < 8; ++i) {
+        Page* page = pool.new_page();
+        ASSERT_NE(page, nullptr);
+        page->get_data()[0] = static_cast<uint8_t>(i + 1);
+        page_ids.push_back(page->get_page_id());
+        pool.unpin_page(page->get_page_id(), true);
+    }
+
+    ASSERT_TRUE(pool.resize(32).ok());
+    EXPECT_EQ(pool.get_pool_size(), 32u);
+    EXPECT_EQ(pool.get_free_frame_count(), 32u);
+
+    ASSERT_TRUE(pool.resize(4).ok());
+    EXPECT_EQ(pool.get_pool_size(), 4u);
+
+    for (size_t i = 0; i < page_ids.size(); ++i) {
+        Page* page = pool.fetch_page(page_ids[i]);
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(page->get_data()[0], static_cast<uint8_t>(i + 1));
+        pool.unpin_page(page_ids[i], false);
+    }
+
+    EXPECT_FALSE(pool.resize(128).ok());
+}
+
+TEST_F(BufferPoolTest, ShrinkStopsAtPinnedFrame) {
+    BufferPool pool(4, disk_manager_.get(), 16);
+    std::vector<Page*> pages;
+    for (int i = 0; i < 4; ++i) {
+        pages.push_back(pool.new_page());
+        ASSERT_NE(pages.back(), nullptr);
+    }
+
+    auto result = pool.resize(1);
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(pool.get_pool_size(), 4u);
+
+    for (Page* page : pages) {
+        pool.unpin_page(page->get_page_id(), false);
+    }
+    EXPECT_TRUE(pool.resize(1).ok());
+}
+
+TEST_F(BufferPoolTest, AdaptiveSizingGrowsUnderMisses) {
+    BufferPool pool(4, disk_manager_.get(), 256);
+    MemoryGovernor governor(256 * PAGE_SIZE * 2);
+    BufferPoolPolicy policy;
+    policy.min_frames = 4;
+    policy.adapt_interval = 32;
+    pool.enable_adaptive_sizing(&governor, policy);
+
+    std::vector<PageId> page_ids;
+    for (int i = 0; i < 64; ++i) {
+        Page* page = pool.new_page();
+        ASSERT_NE(page, nullptr);
+        page_ids.push_back(page->get_page_id());
+        pool.unpin_page(page->get_page_id(), true);
+    }
+
+    // Cycle through a working set larger than the initial pool
+    for (int round = 0; round < 10; ++round) {
+        for (PageId id : page_ids) {
+            ASSERT_NE(pool.fetch_page(id), nullptr);
+            pool.unpin_page(id, false);
+        }
+    }
+
+    EXPECT_GE(pool.get_pool_size(), page_ids.size());
+    EXPECT_EQ(governor.usage(), pool.memory_usage());
+}
+
+TEST(MemoryGovernorTest, ReclaimsFromOtherConsumers) {
+    InMemoryDiskManager disk;
+    BufferPool pool(64, &disk, 64);
+    MemoryGovernor governor(pool.memory_usage());
+    pool.enable_adaptive_sizing(&governor, BufferPoolPolicy{8});
+
+    struct Requester : MemoryConsumer {
+        std::string consumer_name() const override { return "test"; }
+        size_t memory_usage() const override { return 0; }
+    } requester;
+    governor.register_consumer(&requester);
+
+    EXPECT_TRUE(governor.request(&requester, 16 * PAGE_SIZE));
+    EXPECT_LT(pool.get_pool_size(), 64u);
+    EXPECT_GE(pool.get_pool_size(), 8u);
+    EXPECT_FALSE(governor.request(&requester, 1024 * PAGE_SIZE));
+
+    governor.unregister_consumer(&requester);
+}
+
+TEST(MemoryGovernorTest, ConsumersShareOneBudget) {
+    InMemoryDiskManager disk;
+    BufferPool pool(8, &disk, 1024);
+    MemoryGovernor governor(256 * 1024 * 1024);
+    pool.enable_adaptive_sizing(&governor, BufferPoolPolicy{8});
+
+    // A query that overflows this thread's arena grows its buffer
+    QueryArena::attach_memory_governor(&governor);
+    auto big_query = [] {
+        QueryArenaScope scope;
+        std::pmr::vector<char> scratch(2 * 1024 * 1024, 'x', scope.resource());
+    };
+    big_query();
+    QueryArena& arena = QueryArena::for_this_thread();
+    ASSERT_GT(arena.capacity(), QueryArena::INITIAL_SIZE);
+
+    search::VectorIndexWithEmbedder vectors(
+        std::make_unique<search::VectorIndex>(),
+        std::make_unique<search::BuiltinEmbedder>());
+    vectors.attach_memory_governor(&governor);
+    for (int i = 0; i < 200; ++i) {
+        (void)vectors.index_text(i, "int f" + std::to_string(i) + "() { return " +
+                                        std::to_string(i) + "; }");
+    }
+    size_t cache_before = vectors.memory_usage();
+    ASSERT_GT(cache_before, 0u);
+
+    // With the budget used up, growing the pool takes memory back from the
+    // idle arena (largest first) and then from the embedding cache
+    governor.set_budget(governor.usage());
+    size_t arena_spare = arena.capacity() - QueryArena::INITIAL_SIZE;
+    size_t frames = (arena_spare + cache_before / 2) / PAGE_SIZE + 1;
+    ASSERT_TRUE(pool.resize(pool.get_pool_size() + frames).ok());
+    EXPECT_EQ(arena.capacity(), QueryArena::INITIAL_SIZE);
+    EXPECT_LT(vectors.memory_usage(), cache_before);
+    EXPECT_GT(vectors.memory_usage(), 0u);
+
+    // Repeated pressure lowers the arenas' retention cap, which stays down
+    // while the budget is full ...
+    for (int i = 0; i < 8; ++i) {
+        QueryArena::memory_consumer().reclaim(0);
+    }
+    governor.set_budget(governor.usage());
+    big_query();
+    EXPECT_EQ(arena.capacity(), QueryArena::INITIAL_SIZE);
+
+    // ... and is lifted once there is room again
+    governor.set_budget(256 * 1024 * 1024);
+    big_query();
+    EXPECT_GT(arena.capacity(), QueryArena::INITIAL_SIZE);
+
+    vectors.attach_memory_governor(nullptr);
+    QueryArena::attach_memory_governor(nullptr);
+    EXPECT_EQ(governor.report().size(), 1u);
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <dam/search/embedder.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace dam;
+using namespace dam::search;
+
+namespace {
+
+Embedding embed(const std::string& text, EmbedderConfig config = {}) {
+    BuiltinEmbedder embedder(config);
+    auto result = embedder.embed(text);
+    EXPECT_TRUE(result.ok());
+    return result.ok() ? result.value() : Embedding{};
+}
+
+float norm(const Embedding& embedding) {
+    float sum = 0.0f;
+    for (float v : embedding) sum += v * v;
+    return std::sqrt(sum);
+}
+
+float similarity(const std::string& a, const std::string& b) {
+    return Embedder::cosine_similarity(embed(a), embed(b));
+}
+
+// Sets an environment variable for one scope
+class ScopedEnv {
+public:
+    ScopedEnv(const char* name, const char* value) : name_(name) {
+        if (const char* old = std::getenv(name)) {
+            had_old_ = true;
+            old_ = old;
+        }
+        if (value) {
+            setenv(name, value, 1);
+        } else {
+            unsetenv(name);
+        }
+    }
+
+    ~ScopedEnv() {
+        if (had_old_) {
+            setenv(name_, old_.c_str(), 1);
+        } else {
+            unsetenv(name_);
+        }
+    }
+
+private:
+    const char* name_;
+    bool had_old_ = false;
+    std::string old_;
+};
+
+}  // namespace
+
+// ============================================================================
+// BuiltinEmbedder
+// ============================================================================
+
+TEST(BuiltinEmbedderTest, DeterministicUnitVectors) {
+    const std::string text = "for (int i = 0; i < n; ++i) total += values[i];";
+    Embedding first = embed(text);
+    Embedding second = embed(text);
+    ASSERT_EQ(first.size(), 256u);
+    EXPECT_EQ(first, second);
+    EXPECT_NEAR(norm(first), 1.0f, 1e-5f);
+
+    // Other dimensions, and unnormalized output
+    EmbedderConfig config;
+    config.dimension = 100;
+    EXPECT_EQ(embed(text, config).size(), 100u);
+    EXPECT_NEAR(norm(embed(text, config)), 1.0f, 1e-5f);
+    config.normalize = false;
+    EXPECT_GT(norm(embed(text, config)), 1.0f);
+
+    // Nothing to hash gives the zero vector, not NaNs
+    Embedding empty = embed("  \n\t");
+    ASSERT_EQ(empty.size(), 256u);
+    EXPECT_EQ(norm(empty), 0.0f);
+}
+
+TEST(BuiltinEmbedderTest, Tokenization) {
+    // Whitespace and non-ASCII bytes separate tokens but are not features
+    EXPECT_EQ(embed("a+b"), embed("a  +\n b"));
+    EXPECT_EQ(embed("x = 1"), embed("x = 1 \xC3\xA9"));
+
+    // Identifiers are case-folded
+    EXPECT_EQ(embed("Value"), embed("value"));
+
+    // camelCase and snake_case spellings share their parts
+    EXPECT_GT(similarity("userId", "user_id"), similarity("userId", "orderTotal"));
+    EXPECT_GT(similarity("parseHTTPResponse", "parse_http_response"),
+              similarity("parseHTTPResponse", "render_svg_icon"));
+
+    // Trigrams tie spelling variants together
+    EXPECT_GT(similarity("colour", "color"), similarity("colour", "width"));
+
+    // Operators count: the same names with different operators differ
+    EXPECT_NE(embed("a + b"), embed("a - b"));
+}
+
+TEST(BuiltinEmbedderTest, SimilarCodeScoresAboveUnrelated) {
+    const std::string query = "int getUserId(const User& user) { return user.id; }";
+    const std::string similar = "long get_user_id(User *user) { return user->id; }";
+    const std::vector<std::string> unrelated = {
+        "SELECT name, total FROM orders WHERE total > 100 ORDER BY total DESC;",
+        "for f in *.png; do convert \"$f\" -resize 50% \"small_$f\"; done",
+        "plt.plot(xs, ys, color='red'); plt.savefig('chart.svg')",
+    };
+
+    float near = similarity(query, similar);
+    for (const auto& text : unrelated) {
+        EXPECT_GT(near, similarity(query, text) + 0.2f) << text;
+    }
+}
+
+TEST(BuiltinEmbedderTest, BatchMatchesSingle) {
+    BuiltinEmbedder embedder;
+    std::vector<std::string> texts = {"a", "b + c", "def f(): pass"};
+    std::vector<size_t> progress;
+    auto batch = embedder.embed_batch(texts, [&](size_t done, size_t total) {
+        EXPECT_EQ(total, texts.size());
+        progress.push_back(done);
+    });
+    ASSERT_TRUE(batch.ok());
+    ASSERT_EQ(batch->size(), texts.size());
+    for (size_t i = 0; i < texts.size(); ++i) {
+        EXPECT_EQ((*batch)[i], embed(texts[i]));
+    }
+    EXPECT_EQ(progress, (std::vector<size_t>{1, 2, 3}));
+}
+
+TEST(BuiltinEmbedderTest, CreateChecksDimension) {
+    EmbedderConfig config;
+    config.dimension = 5000;
+    EXPECT_EQ(BuiltinEmbedder::create(config).error_code(), ErrorCode::INVALID_ARGUMENT);
+    config.dimension = 4096;
+    auto created = BuiltinEmbedder::create(config);
+    ASSERT_TRUE(created.ok());
+    EXPECT_EQ((*created)->dimension(), 4096);
+}
+
+// ============================================================================
+// EmbedderFactory
+// ============================================================================
+
+TEST(EmbedderFactoryTest, NamedType) {
+    ScopedEnv type("DAM_EMBEDDER", "builtin");
+    auto embedder = EmbedderFactory::create_from_env();
+    ASSERT_TRUE(embedder.ok());
+    EXPECT_EQ((*embedder)->model_name(), "builtin-hash-v2-256");
+
+    EXPECT_EQ(EmbedderFactory::create("no-such-embedder").error_code(),
+              ErrorCode::INVALID_ARGUMENT);
+}
+
+TEST(EmbedderFactoryTest, FallsBackToBuiltin) {
+    // Nothing configured and no Ollama listening
+    ScopedEnv type("DAM_EMBEDDER", nullptr);
+    ScopedEnv model("DAM_EMBEDDING_MODEL_PATH", nullptr);
+    ScopedEnv url("DAM_OLLAMA_URL", "http://127.0.0.1:1");
+
+    auto embedder = EmbedderFactory::create_from_env();
+    ASSERT_TRUE(embedder.ok());
+    EXPECT_TRUE((*embedder)->is_available());
+    EXPECT_EQ((*embedder)->model_name(), "builtin-hash-v2-256");
+}
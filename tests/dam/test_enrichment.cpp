@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+#include <dam/dam.hpp>
+#include <dam/llm/enrichment.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dam;
+using namespace dam::llm;
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * A provider that gives every request the same reply, or fails them all.
+ */
+class FixedReplyProvider : public LLMProvider {
+public:
+    explicit FixedReplyProvider(std::string reply, bool fail = false)
+        : reply_(std::move(reply)), fail_(fail) {}
+
+    ProviderInfo info() const override {
+        ProviderInfo info;
+        info.name = "fixed";
+        info.model_id = "fixed";
+        info.is_local = true;
+        return info;
+    }
+
+    Result<void> initialize() override { return Ok(); }
+    void shutdown() override {}
+    bool is_available() const override { return true; }
+
+    Result<CompletionResult> complete(const CompletionRequest&) override {
+        calls++;
+        if (fail_) {
+            return Error(ErrorCode::INTERNAL_ERROR, "model failed");
+        }
+        CompletionResult result;
+        result.content = reply_;
+        result.stop_reason = "eos";
+        return result;
+    }
+
+    void abort() override {}
+    bool is_aborted() const override { return false; }
+    void reset_abort() override {}
+
+    std::atomic<int> calls{0};
+
+private:
+    std::string reply_;
+    bool fail_;
+};
+
+EnrichmentOptions test_options() {
+    EnrichmentOptions options;
+    options.idle_delay = std::chrono::milliseconds(0);
+    options.max_duty_cycle = 1.0;
+    options.rescan_interval = std::chrono::hours(1);
+    return options;
+}
+
+// Poll until nothing is queued or waiting to be applied
+void drain(EnrichmentWorker& worker) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    do {
+        auto polled = worker.poll();
+        ASSERT_TRUE(polled.ok()) << polled.error().to_string();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    } while (worker.busy() && std::chrono::steady_clock::now() < deadline);
+    ASSERT_FALSE(worker.busy());
+}
+
+}  // namespace
+
+// ============================================================================
+// Response parsing
+// ============================================================================
+
+TEST(EnrichmentParseTest, LabelledReply) {
+    auto enrichment = parse_enrichment(
+        "Description: Sorts a list in place.\nTags: Python, sorting, #algorithms\n", 5);
+    EXPECT_EQ(enrichment.description, "Sorts a list in place.");
+    EXPECT_EQ(enrichment.tags, (std::vector<std::string>{"python", "sorting", "algorithms"}));
+
+    // Labels are case-insensitive, in any order, around stray lines
+    enrichment = parse_enrichment("Sure!\n\nTAGS: bash\n**description:** \"Lists files.\"\n", 5);
+    EXPECT_EQ(enrichment.description, "Lists files.");
+    EXPECT_EQ(enrichment.tags, (std::vector<std::string>{"bash"}));
+}
+
+TEST(EnrichmentParseTest, MalformedReplies) {
+    auto enrichment = parse_enrichment("", 5);
+    EXPECT_TRUE(enrichment.description.empty());
+    EXPECT_TRUE(enrichment.tags.empty());
+
+    // Unlabelled prose: the first line is the description
+    enrichment = parse_enrichment("  \n`Reverses a string.`\nIt uses two pointers.\n", 5);
+    EXPECT_EQ(enrichment.description, "Reverses a string.");
+    EXPECT_TRUE(enrichment.tags.empty());
+
+    // Empty labels, and a label without its colon
+    enrichment = parse_enrichment("Description:\nTags:\n", 5);
+    EXPECT_TRUE(enrichment.description.empty());
+    EXPECT_TRUE(enrichment.tags.empty());
+    enrichment = parse_enrichment("Description - opens a socket", 5);
+    EXPECT_EQ(enrichment.description, "Description - opens a socket");
+
+    // Empty, repeated and overlong tags are dropped; spaces become hyphens
+    enrichment = parse_enrichment(
+        "Tags: a,, A , multi word, " + std::string(40, 'x') + ", #, b", 5);
+    EXPECT_EQ(enrichment.tags, (std::vector<std::string>{"a", "multi-word", "b"}));
+
+    enrichment = parse_enrichment("Tags: a, b, c, d", 2);
+    EXPECT_EQ(enrichment.tags, (std::vector<std::string>{"a", "b"}));
+}
+
+// ============================================================================
+// EnrichmentWorker
+// ============================================================================
+
+class EnrichmentWorkerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = fs::temp_directory_path() / "dam_enrichment_test";
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_);
+
+        Config config;
+        config.root_directory = test_dir_;
+        config.buffer_pool_size = 100;
+        auto store = SnippetStore::open(config);
+        ASSERT_TRUE(store.ok()) << store.error().to_string();
+        store_ = std::move(store.value());
+    }
+
+    void TearDown() override {
+        store_.reset();
+        fs::remove_all(test_dir_);
+    }
+
+    FixedReplyProvider* use_provider(std::string reply, bool fail = false) {
+        LLMRouterConfig config;
+        config.enable_cache = false;  // Model calls are counted
+        router_ = std::make_unique<LLMRouter>(config);
+        auto provider = std::make_unique<FixedReplyProvider>(std::move(reply), fail);
+        FixedReplyProvider* raw = provider.get();
+        router_->add_local_provider(std::move(provider));
+        return raw;
+    }
+
+    fs::path test_dir_;
+    std::unique_ptr<SnippetStore> store_;
+    std::unique_ptr<LLMRouter> router_;
+};
+
+TEST_F(EnrichmentWorkerTest, FillsEmptyFieldsWithoutRevision) {
+    auto* provider = use_provider("Description: Prints a greeting.\nTags: python, hello");
+    auto plain = store_->add("print('hello')", "hello");
+    auto described = store_->add("print('bye')", "bye", {}, "python", "Says goodbye.");
+    ASSERT_TRUE(plain.ok() && described.ok());
+    auto before = store_->get(*plain);
+    ASSERT_TRUE(before.ok());
+
+    EnrichmentWorker worker(*store_, *router_, test_options());
+    ASSERT_TRUE(worker.start().ok());
+    drain(worker);
+    ASSERT_TRUE(worker.stop().ok());
+
+    auto after = store_->get(*plain);
+    ASSERT_TRUE(after.ok());
+    EXPECT_EQ(after->description, "Prints a greeting.");
+    EXPECT_EQ(after->tags, (std::vector<std::string>{"python", "hello"}));
+    EXPECT_EQ(after->modified_at, before->modified_at);
+    auto revisions = store_->get_revisions(*plain);
+    ASSERT_TRUE(revisions.ok());
+    EXPECT_EQ(revisions->size(), 1u);
+
+    // The tag index follows
+    auto tagged = store_->find_by_tag("hello");
+    ASSERT_TRUE(tagged.ok());
+    ASSERT_EQ(tagged->size(), 2u);
+
+    // What the user wrote is kept
+    auto kept = store_->get(*described);
+    ASSERT_TRUE(kept.ok());
+    EXPECT_EQ(kept->description, "Says goodbye.");
+    EXPECT_EQ(kept->tags, (std::vector<std::string>{"python", "hello"}));
+    EXPECT_EQ(provider->calls.load(), 2);
+}
+
+TEST_F(EnrichmentWorkerTest, CacheHitsAndInvalidation) {
+    auto* provider = use_provider("Description: Adds two numbers.\nTags: math");
+    auto first = store_->add("a + b", "add");
+    ASSERT_TRUE(first.ok());
+    {
+        EnrichmentWorker worker(*store_, *router_, test_options());
+        ASSERT_TRUE(worker.start().ok());
+        drain(worker);
+        ASSERT_TRUE(worker.stop().ok());
+    }
+    EXPECT_EQ(provider->calls.load(), 1);
+    EXPECT_TRUE(fs::exists(test_dir_ / "enrichment.cache"));
+
+    // A copy is filled from the cache, which was saved and loaded again
+    auto copy = store_->add("a + b", "add-copy");
+    ASSERT_TRUE(copy.ok());
+    EnrichmentWorker worker(*store_, *router_, test_options());
+    ASSERT_TRUE(worker.start().ok());
+    drain(worker);
+    EXPECT_EQ(provider->calls.load(), 1);
+    EXPECT_EQ(worker.stats().from_cache, 1u);
+    auto copied = store_->get(*copy);
+    ASSERT_TRUE(copied.ok());
+    EXPECT_EQ(copied->description, "Adds two numbers.");
+    ASSERT_TRUE(worker.stop().ok());
+
+    // Edited content is a different key and goes to the model again
+    ASSERT_TRUE(store_->update(*copy, "a - b", "add-copy", {}, "", "").ok());
+    ASSERT_TRUE(worker.start().ok());
+    drain(worker);
+    ASSERT_TRUE(worker.stop().ok());
+    EXPECT_EQ(provider->calls.load(), 2);
+}
+
+TEST_F(EnrichmentWorkerTest, FailedContentIsRetriedThenLeft) {
+    use_provider("", /*fail=*/true);
+    ASSERT_TRUE(store_->add("x = 1", "x").ok());
+
+    auto options = test_options();
+    options.rescan_interval = std::chrono::milliseconds(1);
+    options.max_failures = 3;
+    EnrichmentWorker worker(*store_, *router_, options);
+    ASSERT_TRUE(worker.start().ok());
+
+    // The backoff is 1, 2 then 4 ms; polling well past it finds no more work
+    auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (std::chrono::steady_clock::now() < until) {
+        ASSERT_TRUE(worker.poll().ok());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    drain(worker);
+    auto stats = worker.stats();
+    EXPECT_EQ(stats.queued, 3u);
+    EXPECT_EQ(stats.failed, 3u);
+    EXPECT_EQ(stats.abandoned, 1u);
+    ASSERT_TRUE(worker.stop().ok());
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <dam/llm/llamacpp_provider.hpp>
+
+#include <cstdlib>
+
+using namespace dam;
+using namespace dam::llm;
+
+// ============================================================================
+// KV cache type selection
+// ============================================================================
+
+TEST(LlamaCppKVCacheTest, ValuesQuantizedOnlyWithFlashAttention) {
+    LlamaCppConfig config;
+    auto types = kv_cache_types(config);
+    EXPECT_EQ(types.k, KVCacheType::F16);
+    EXPECT_EQ(types.v, KVCacheType::F16);
+
+    config.kv_cache_type = KVCacheType::Q8_0;
+    types = kv_cache_types(config);
+    EXPECT_EQ(types.k, KVCacheType::Q8_0);
+    EXPECT_EQ(types.v, KVCacheType::F16);
+
+    config.flash_attn = true;
+    types = kv_cache_types(config);
+    EXPECT_EQ(types.k, KVCacheType::Q8_0);
+    EXPECT_EQ(types.v, KVCacheType::Q8_0);
+
+    config.kv_cache_type = KVCacheType::Q4_0;
+    types = kv_cache_types(config);
+    EXPECT_EQ(types.k, KVCacheType::Q4_0);
+    EXPECT_EQ(types.v, KVCacheType::Q4_0);
+}
+
+TEST(LlamaCppKVCacheTest, ParsesTypeNames) {
+    EXPECT_EQ(*parse_kv_cache_type("f16"), KVCacheType::F16);
+    EXPECT_EQ(*parse_kv_cache_type("q8_0"), KVCacheType::Q8_0);
+    EXPECT_EQ(*parse_kv_cache_type("q8"), KVCacheType::Q8_0);
+    EXPECT_EQ(*parse_kv_cache_type("q4_0"), KVCacheType::Q4_0);
+    EXPECT_EQ(*parse_kv_cache_type("q4"), KVCacheType::Q4_0);
+
+    auto bad = parse_kv_cache_type("q5_1");
+    ASSERT_FALSE(bad.ok());
+    EXPECT_EQ(bad.error_code(), ErrorCode::INVALID_ARGUMENT);
+    EXPECT_FALSE(parse_kv_cache_type("").ok());
+    EXPECT_FALSE(parse_kv_cache_type("F16").ok());
+}
+
+TEST(LlamaCppKVCacheTest, EnvironmentRejectsUnknownType) {
+    setenv("DAM_LLAMACPP_MODEL_PATH", "/nonexistent/model.gguf", 1);
+    setenv("DAM_LLAMACPP_KV_CACHE", "q3", 1);
+    auto provider = LlamaCppProvider::create_from_env();
+    unsetenv("DAM_LLAMACPP_KV_CACHE");
+    unsetenv("DAM_LLAMACPP_MODEL_PATH");
+
+    ASSERT_FALSE(provider.ok());
+    EXPECT_EQ(provider.error_code(), ErrorCode::INVALID_ARGUMENT);
+}
+
+// ============================================================================
+// Context shift arithmetic
+// ============================================================================
+
+TEST(LlamaCppContextTest, KeepsSystemPrefixUpToHalfTheContext) {
+    EXPECT_EQ(context_keep_tokens(0, 4096), 0u);
+    EXPECT_EQ(context_keep_tokens(300, 4096), 300u);
+    EXPECT_EQ(context_keep_tokens(2048, 4096), 2048u);
+    EXPECT_EQ(context_keep_tokens(3000, 4096), 2048u);
+}
+
+TEST(LlamaCppContextTest, ShiftDiscardsOlderHalfAfterKeep) {
+    EXPECT_EQ(context_shift_discard(4096, 96), 2000u);
+    EXPECT_EQ(context_shift_discard(4096, 0), 2048u);
+    EXPECT_EQ(context_shift_discard(101, 0), 50u);
+
+    // Nothing to drop once only the kept tokens (or one more) remain
+    EXPECT_EQ(context_shift_discard(96, 96), 0u);
+    EXPECT_EQ(context_shift_discard(97, 96), 0u);
+    EXPECT_EQ(context_shift_discard(10, 96), 0u);
+
+    // Repeated shifts converge on the kept prefix without underflow
+    size_t n_tokens = 4096;
+    for (int i = 0; i < 20; i++) {
+        n_tokens -= context_shift_discard(n_tokens, 96);
+        EXPECT_GE(n_tokens, 96u);
+    }
+    EXPECT_LE(n_tokens, 97u);
+}
+
+TEST(LlamaCppContextTest, WindowOffsetLeavesRoomToGenerate) {
+    // Fits with room to spare
+    EXPECT_EQ(context_window_offset(1000, 100, 4096, 256), 0u);
+    EXPECT_EQ(context_window_offset(3840, 100, 4096, 256), 0u);
+
+    // One token too many: room is 4096 - 100 - 256 = 3740 after the keep
+    EXPECT_EQ(context_window_offset(3841, 100, 4096, 256), 1u);
+    EXPECT_EQ(context_window_offset(10000, 100, 4096, 256), 10000u - 100 - 3740);
+
+    // The reserve is capped at a quarter of the context
+    EXPECT_EQ(context_window_offset(10000, 0, 4096, 100000), 10000u - 3072);
+    EXPECT_EQ(context_window_offset(10000, 0, 4096, -5), 10000u - 4096);
+
+    // Degenerate sizes do not underflow
+    EXPECT_EQ(context_window_offset(50, 100, 4096, 256), 0u);
+    EXPECT_EQ(context_window_offset(10, 8, 8, 4), 10u - 8);
+}
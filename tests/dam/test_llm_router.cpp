@@ -0,0 +1,542 @@
+#include <gtest/gtest.h>
+#include <dam/llm/batch_journal.hpp>
+#include <dam/llm/router.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dam;
+using namespace dam::llm;
+
+namespace {
+
+/**
+ * A provider that streams a fixed list of chunks. It sends the first
+ * chunk, then holds the rest back until release() is called.
+ */
+class ScriptedProvider : public LLMProvider {
+public:
+    explicit ScriptedProvider(std::vector<std::string> chunks)
+        : chunks_(std::move(chunks)) {}
+
+    ProviderInfo info() const override {
+        ProviderInfo info;
+        info.name = "scripted";
+        info.model_id = "scripted";
+        info.is_local = true;
+        return info;
+    }
+
+    Result<void> initialize() override { return Ok(); }
+    void shutdown() override {}
+    bool is_available() const override { return true; }
+
+    Result<CompletionResult> complete(const CompletionRequest& request) override {
+        calls++;
+        asked_to_stream = static_cast<bool>(request.on_chunk);
+        caller = std::this_thread::get_id();
+        CompletionResult result;
+        result.stop_reason = "eos";
+        for (size_t i = 0; i < chunks_.size(); i++) {
+            if (i == 1) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                released_cv_.wait(lock, [this]() { return released_; });
+            }
+            result.content += chunks_[i];
+            if (request.on_chunk && !request.on_chunk(chunks_[i])) {
+                result.stop_reason = "aborted";
+                stopped_early = true;
+                break;
+            }
+        }
+        return result;
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released_ = true;
+        released_cv_.notify_all();
+    }
+
+    void abort() override { release(); }
+    bool is_aborted() const override { return false; }
+    void reset_abort() override {}
+
+    std::atomic<int> calls{0};
+    std::atomic<bool> stopped_early{false};
+    std::atomic<bool> asked_to_stream{false};
+    std::thread::id caller;
+
+private:
+    std::vector<std::string> chunks_;
+    std::mutex mutex_;
+    std::condition_variable released_cv_;
+    bool released_ = false;
+};
+
+/**
+ * A provider for batches: each call takes call_ms, the first calls fail
+ * with the scripted errors, and the peak number of overlapping calls is
+ * recorded.
+ */
+class BatchProvider : public LLMProvider {
+public:
+    BatchProvider(std::string name, int max_concurrency, int call_ms = 10,
+                  std::vector<ErrorCode> errors = {})
+        : name_(std::move(name))
+        , max_concurrency_(max_concurrency)
+        , call_ms_(call_ms)
+        , errors_(std::move(errors)) {}
+
+    ProviderInfo info() const override {
+        ProviderInfo info;
+        info.name = name_;
+        info.model_id = name_;
+        info.is_local = true;
+        info.max_concurrency = max_concurrency_;
+        return info;
+    }
+
+    Result<void> initialize() override { return Ok(); }
+    void shutdown() override {}
+    bool is_available() const override { return true; }
+
+    Result<CompletionResult> complete(const CompletionRequest& request) override {
+        int call = calls++;
+        int now_active = ++active;
+        int seen = peak.load();
+        while (now_active > seen && !peak.compare_exchange_weak(seen, now_active)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(call_ms_));
+        --active;
+
+        if (call < static_cast<int>(errors_.size())) {
+            return Error(errors_[call], "scripted failure");
+        }
+        CompletionResult result;
+        result.content = name_ + ":" + request.messages.at(0).content;
+        result.stop_reason = "eos";
+        return result;
+    }
+
+    void abort() override {}
+    bool is_aborted() const override { return false; }
+    void reset_abort() override {}
+
+    std::atomic<int> calls{0};
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+
+private:
+    std::string name_;
+    int max_concurrency_;
+    int call_ms_;
+    std::vector<ErrorCode> errors_;
+};
+
+std::vector<CompletionRequest> numbered_requests(size_t count) {
+    std::vector<CompletionRequest> requests(count);
+    for (size_t i = 0; i < count; ++i) {
+        requests[i].messages.push_back(Message::user(std::to_string(i)));
+    }
+    return requests;
+}
+
+CompletionRequest make_request() {
+    CompletionRequest request;
+    request.messages.push_back(Message::user("complete this"));
+    return request;
+}
+
+void wait_for(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(done());
+}
+
+}  // namespace
+
+class LLMRouterCoalescingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        LLMRouterConfig config;
+        config.enable_cache = false;  // Late callers must join, not hit the cache
+        router_ = std::make_unique<LLMRouter>(config);
+        auto provider = std::make_unique<ScriptedProvider>(
+            std::vector<std::string>{"a", "b", "c"});
+        provider_ = provider.get();
+        router_->add_local_provider(std::move(provider));
+    }
+
+    std::unique_ptr<LLMRouter> router_;
+    ScriptedProvider* provider_ = nullptr;
+};
+
+TEST_F(LLMRouterCoalescingTest, ConcurrentIdenticalRequestsMakeOneCall) {
+    constexpr int N = 8;
+    std::atomic<int> first_chunk_seen{0};
+    std::vector<std::string> streamed(N);
+    std::vector<Result<CompletionResult>> results(N, Error(ErrorCode::INTERNAL_ERROR, "unset"));
+    std::vector<std::thread> callers;
+
+    for (int i = 0; i < N; i++) {
+        callers.emplace_back([&, i]() {
+            auto request = make_request();
+            request.on_chunk = [&, i](const std::string& chunk) {
+                if (streamed[i].empty()) first_chunk_seen++;
+                streamed[i] += chunk;
+                return true;
+            };
+            results[i] = router_->complete(request);
+        });
+    }
+
+    // Joiners receive "a" as a replay, so all have joined once all saw it
+    wait_for([&]() { return first_chunk_seen.load() == N; });
+    provider_->release();
+    for (auto& t : callers) t.join();
+
+    EXPECT_EQ(provider_->calls.load(), 1);
+    for (int i = 0; i < N; i++) {
+        ASSERT_TRUE(results[i].ok());
+        EXPECT_EQ(results[i]->content, "abc");
+        EXPECT_EQ(results[i]->stop_reason, "eos");
+        EXPECT_EQ(streamed[i], "abc");
+    }
+}
+
+TEST_F(LLMRouterCoalescingTest, DecliningLeaderLeavesOthersRunning) {
+    constexpr int N = 3;
+    std::atomic<int> first_chunk_seen{0};
+    std::vector<std::string> streamed(N);
+    std::vector<Result<CompletionResult>> results(N, Error(ErrorCode::INTERNAL_ERROR, "unset"));
+
+    auto call = [&](int i) {
+        auto request = make_request();
+        request.on_chunk = [&, i](const std::string& chunk) {
+            if (streamed[i].empty()) first_chunk_seen++;
+            streamed[i] += chunk;
+            if (i != 0) return true;
+
+            // The first caller stops listening once the others have joined.
+            // They join while this callback runs, so it holds no lock.
+            wait_for([&]() { return first_chunk_seen.load() == N; });
+            return false;
+        };
+        results[i] = router_->complete(request);
+    };
+
+    std::thread leader(call, 0);
+    wait_for([&]() { return provider_->calls.load() == 1; });
+    std::vector<std::thread> joiners;
+    for (int i = 1; i < N; i++) {
+        joiners.emplace_back(call, i);
+    }
+    wait_for([&]() { return first_chunk_seen.load() == N; });
+
+    // The leader runs the generation, so it returns once that is done, but
+    // with only what it heard
+    provider_->release();
+    leader.join();
+    for (auto& t : joiners) t.join();
+    ASSERT_TRUE(results[0].ok());
+    EXPECT_EQ(results[0]->stop_reason, "aborted");
+    EXPECT_EQ(results[0]->content, "a");
+
+    EXPECT_EQ(provider_->calls.load(), 1);
+    EXPECT_FALSE(provider_->stopped_early.load());
+    EXPECT_EQ(streamed[0], "a");
+    for (int i = 1; i < N; i++) {
+        ASSERT_TRUE(results[i].ok());
+        EXPECT_EQ(results[i]->content, "abc");
+        EXPECT_EQ(results[i]->stop_reason, "eos");
+        EXPECT_EQ(streamed[i], "abc");
+    }
+}
+
+TEST_F(LLMRouterCoalescingTest, AllDecliningStopsGeneration) {
+    std::atomic<int> first_chunk_seen{0};
+    auto call = [&]() {
+        auto request = make_request();
+        request.on_chunk = [&](const std::string&) {
+            first_chunk_seen++;
+            wait_for([&]() { return first_chunk_seen.load() == 2; });
+            return false;
+        };
+        auto result = router_->complete(request);
+        ASSERT_TRUE(result.ok());
+        EXPECT_EQ(result->stop_reason, "aborted");
+    };
+
+    std::thread first(call);
+    wait_for([&]() { return provider_->calls.load() == 1; });
+    std::thread second(call);
+    first.join();
+    second.join();
+    EXPECT_EQ(first_chunk_seen.load(), 2);
+
+    // Nobody is listening, so the generation ended after the first chunk
+    wait_for([&]() { return provider_->stopped_early.load(); });
+    EXPECT_EQ(provider_->calls.load(), 1);
+}
+
+TEST_F(LLMRouterCoalescingTest, LeaderWithoutCallbackDoesNotStream) {
+    provider_->release();
+    auto result = router_->complete(make_request());
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(result->content, "abc");
+
+    // The provider ran on the caller's thread, as it does uncoalesced
+    EXPECT_FALSE(provider_->asked_to_stream.load());
+    EXPECT_EQ(provider_->caller, std::this_thread::get_id());
+
+    auto request = make_request();
+    std::string streamed;
+    request.on_chunk = [&](const std::string& chunk) {
+        streamed += chunk;
+        return true;
+    };
+    ASSERT_TRUE(router_->complete(request).ok());
+    EXPECT_TRUE(provider_->asked_to_stream.load());
+    EXPECT_EQ(streamed, "abc");
+}
+
+TEST(LLMRouterCacheTest, SamplingParametersAreInTheKey) {
+    LLMRouter router;
+    auto provider = std::make_unique<ScriptedProvider>(std::vector<std::string>{"x"});
+    ScriptedProvider* scripted = provider.get();
+    router.add_local_provider(std::move(provider));
+
+    auto request = make_request();
+    ASSERT_TRUE(router.complete(request).ok());
+    ASSERT_TRUE(router.complete(request).ok());
+    EXPECT_EQ(scripted->calls.load(), 1);
+
+    auto changed = request;
+    changed.top_k = 1;
+    ASSERT_TRUE(router.complete(changed).ok());
+    changed = request;
+    changed.top_p = 0.5f;
+    ASSERT_TRUE(router.complete(changed).ok());
+    changed = request;
+    changed.repeat_penalty = 1.3f;
+    ASSERT_TRUE(router.complete(changed).ok());
+    changed = request;
+    changed.timeout_ms = 1000;
+    ASSERT_TRUE(router.complete(changed).ok());
+    EXPECT_EQ(scripted->calls.load(), 5);
+}
+
+// ============================================================================
+// Batches
+// ============================================================================
+
+class LLMRouterBatchTest : public ::testing::Test {
+protected:
+    LLMRouterBatchTest() {
+        LLMRouterConfig config;
+        config.enable_cache = false;
+        router_ = std::make_unique<LLMRouter>(config);
+    }
+
+    BatchProvider* add(std::unique_ptr<BatchProvider> provider) {
+        BatchProvider* raw = provider.get();
+        router_->add_local_provider(std::move(provider));
+        return raw;
+    }
+
+    std::unique_ptr<LLMRouter> router_;
+};
+
+TEST_F(LLMRouterBatchTest, ResultsInRequestOrder) {
+    add(std::make_unique<BatchProvider>("p", 4, 1));
+    auto requests = numbered_requests(20);
+
+    std::vector<int> reported(requests.size(), 0);
+    BatchOptions options;
+    options.max_concurrency_per_provider = 4;
+    options.on_result = [&](size_t index, const Result<CompletionResult>& result) {
+        EXPECT_TRUE(result.ok());
+        reported[index]++;
+    };
+    auto results = router_->complete_batch(requests, options);
+
+    ASSERT_EQ(results.size(), requests.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        ASSERT_TRUE(results[i].ok());
+        EXPECT_EQ(results[i]->content, "p:" + std::to_string(i));
+        EXPECT_EQ(reported[i], 1);
+    }
+}
+
+TEST_F(LLMRouterBatchTest, ConcurrencyIsCappedPerProvider) {
+    auto* single = add(std::make_unique<BatchProvider>("local", 1));
+    auto* remote = add(std::make_unique<BatchProvider>("remote", 8));
+
+    // The local provider serves one call at a time however many are asked for
+    BatchOptions options;
+    options.max_concurrency_per_provider = 4;
+    auto results = router_->complete_batch(numbered_requests(40), options);
+    EXPECT_TRUE(std::all_of(results.begin(), results.end(),
+                            [](const auto& r) { return r.ok(); }));
+    EXPECT_EQ(single->peak.load(), 1);
+    EXPECT_LE(remote->peak.load(), 4);
+    EXPECT_GT(remote->peak.load(), 1);
+    EXPECT_EQ(single->calls.load() + remote->calls.load(), 40);
+
+    // A per-provider setting overrides the default, still within the cap
+    remote->peak = 0;
+    options.concurrency_by_provider = {{"remote", 2}, {"local", 3}};
+    results = router_->complete_batch(numbered_requests(40), options);
+    EXPECT_EQ(single->peak.load(), 1);
+    EXPECT_EQ(remote->peak.load(), 2);
+}
+
+TEST_F(LLMRouterBatchTest, RetriesTransientErrorsWithBackoff) {
+    auto* provider = add(std::make_unique<BatchProvider>(
+        "p", 1, 0, std::vector<ErrorCode>{ErrorCode::TIMEOUT, ErrorCode::NETWORK_ERROR}));
+
+    BatchOptions options;
+    options.initial_backoff_ms = 20;
+    auto started = std::chrono::steady_clock::now();
+    auto results = router_->complete_batch(numbered_requests(1), options);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    ASSERT_TRUE(results[0].ok());
+    EXPECT_EQ(provider->calls.load(), 3);
+    EXPECT_GE(elapsed, std::chrono::milliseconds(20 + 40));
+}
+
+TEST_F(LLMRouterBatchTest, GivesUpAfterMaxAttempts) {
+    auto* provider = add(std::make_unique<BatchProvider>(
+        "p", 1, 0, std::vector<ErrorCode>(5, ErrorCode::TIMEOUT)));
+
+    BatchOptions options;
+    options.max_attempts = 3;
+    options.initial_backoff_ms = 1;
+    auto results = router_->complete_batch(numbered_requests(1), options);
+    EXPECT_EQ(results[0].error_code(), ErrorCode::TIMEOUT);
+    EXPECT_EQ(provider->calls.load(), 3);
+}
+
+TEST_F(LLMRouterBatchTest, OtherErrorsAreNotRetried) {
+    auto* provider = add(std::make_unique<BatchProvider>(
+        "p", 1, 0, std::vector<ErrorCode>{ErrorCode::INVALID_ARGUMENT}));
+
+    auto results = router_->complete_batch(numbered_requests(1), BatchOptions{});
+    EXPECT_EQ(results[0].error_code(), ErrorCode::INVALID_ARGUMENT);
+    EXPECT_EQ(provider->calls.load(), 1);
+}
+
+TEST_F(LLMRouterBatchTest, OtherErrorsFailOverToHealthyProvider) {
+    auto* broken = add(std::make_unique<BatchProvider>(
+        "broken", 1, 0, std::vector<ErrorCode>(100, ErrorCode::INTERNAL_ERROR)));
+    auto* healthy = add(std::make_unique<BatchProvider>("healthy", 1, 5));
+
+    // Each request is tried on the broken provider at most once
+    auto results = router_->complete_batch(numbered_requests(6), BatchOptions{});
+    for (size_t i = 0; i < results.size(); ++i) {
+        ASSERT_TRUE(results[i].ok()) << i;
+        EXPECT_EQ(results[i]->content, "healthy:" + std::to_string(i));
+    }
+    EXPECT_GE(broken->calls.load(), 1);
+    EXPECT_LE(broken->calls.load(), 6);
+    EXPECT_EQ(healthy->calls.load(), 6);
+
+}
+
+TEST_F(LLMRouterBatchTest, FailsOnceEveryProviderRefuses) {
+    auto* first = add(std::make_unique<BatchProvider>(
+        "first", 1, 0, std::vector<ErrorCode>{ErrorCode::INTERNAL_ERROR}));
+    auto* second = add(std::make_unique<BatchProvider>(
+        "second", 1, 0, std::vector<ErrorCode>{ErrorCode::INVALID_ARGUMENT}));
+
+    auto results = router_->complete_batch(numbered_requests(1), BatchOptions{});
+    EXPECT_EQ(results[0].error_code(), ErrorCode::INVALID_ARGUMENT);
+    EXPECT_EQ(first->calls.load(), 1);
+    EXPECT_EQ(second->calls.load(), 1);
+}
+
+TEST_F(LLMRouterBatchTest, RateLimitedProviderCoolsDown) {
+    auto* limited = add(std::make_unique<BatchProvider>(
+        "limited", 1, 0, std::vector<ErrorCode>{ErrorCode::RATE_LIMITED}));
+    auto* spare = add(std::make_unique<BatchProvider>("spare", 1, 20));
+
+    // While the first provider cools down the other one takes the work;
+    // the rate-limited request is retried once the backoff has passed
+    BatchOptions options;
+    options.initial_backoff_ms = 300;
+    auto results = router_->complete_batch(numbered_requests(4), options);
+    EXPECT_TRUE(std::all_of(results.begin(), results.end(),
+                            [](const auto& r) { return r.ok(); }));
+    EXPECT_EQ(limited->calls.load(), 2);
+    EXPECT_EQ(spare->calls.load(), 3);
+}
+
+// ============================================================================
+// BatchJournal
+// ============================================================================
+
+class BatchJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = std::filesystem::temp_directory_path() / "dam_batch_journal_test";
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::filesystem::path path_;
+};
+
+TEST_F(BatchJournalTest, ResumesWithRecordedKeys) {
+    {
+        auto journal = BatchJournal::open(path_);
+        ASSERT_TRUE(journal.ok());
+        EXPECT_EQ(journal->size(), 0u);
+        ASSERT_TRUE(journal->record("job-1").ok());
+        ASSERT_TRUE(journal->record("job-2").ok());
+        EXPECT_TRUE(journal->done("job-1"));
+        EXPECT_EQ(journal->record("two\nlines").error_code(), ErrorCode::INVALID_ARGUMENT);
+    }
+
+    auto journal = BatchJournal::open(path_);
+    ASSERT_TRUE(journal.ok());
+    EXPECT_EQ(journal->size(), 2u);
+    EXPECT_TRUE(journal->done("job-1"));
+    EXPECT_TRUE(journal->done("job-2"));
+    EXPECT_FALSE(journal->done("job-3"));
+}
+
+TEST_F(BatchJournalTest, TornLastLineIsNotDone) {
+    {
+        std::ofstream file(path_, std::ios::binary);
+        file << "1\r\n\n2\n12";  // "123" was cut off
+    }
+    {
+        auto journal = BatchJournal::open(path_);
+        ASSERT_TRUE(journal.ok());
+        EXPECT_EQ(journal->size(), 2u);
+        EXPECT_TRUE(journal->done("1"));
+        EXPECT_FALSE(journal->done("12"));
+        ASSERT_TRUE(journal->record("123").ok());
+    }
+
+    auto journal = BatchJournal::open(path_);
+    ASSERT_TRUE(journal.ok());
+    EXPECT_EQ(journal->size(), 3u);
+    EXPECT_TRUE(journal->done("123"));
+    EXPECT_FALSE(journal->done("12"));
+}
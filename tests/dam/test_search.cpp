@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include <dam/search/inverted_index.hpp>
+#include <dam/search/trigram_index.hpp>
+#include <dam/storage/buffer_pool.hpp>
+#include <dam/storage/disk_manager.hpp>
+#include <dam/util/query_arena.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace dam;
+using namespace dam::search;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Each trigram's and term's postings are one B+tree value, so no trigram
+// may be shared by more than a few hundred documents. Four groups with
+// their own words keep them apart while a query naming all four touches
+// every document.
+constexpr FileId GROUP_SIZE = 450;
+constexpr FileId DOCS = 4 * GROUP_SIZE;
+constexpr FileId TERM_DOCS = 150;
+const char* const GROUP_WORDS[] = {"alpha", "bravo", "charlie", "delta"};
+
+std::string document(FileId i) {
+    return std::string(GROUP_WORDS[i / GROUP_SIZE]) + " " + std::to_string(i % GROUP_SIZE);
+}
+
+std::string code_document(FileId i) {
+    std::string text = "int handler_" + std::to_string(i) + "(request req) { ";
+    if (i % 2 == 0) text += "alpha(req); ";
+    if (i % 3 == 0) text += "beta(req); ";
+    return text + "return lookup(" + std::to_string(i % 7) + "); }";
+}
+
+std::vector<FileId> sorted_ids(const std::vector<SearchResult>& results) {
+    std::vector<FileId> ids;
+    for (const auto& result : results) ids.push_back(result.doc_id);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+std::vector<std::pair<FileId, float>> by_doc(const std::vector<FuzzyResult>& results) {
+    std::vector<std::pair<FileId, float>> scores;
+    for (const auto& result : results) scores.emplace_back(result.doc_id, result.similarity);
+    std::sort(scores.begin(), scores.end());
+    return scores;
+}
+
+std::vector<FileId> code_ids_where(bool (*keep)(FileId)) {
+    std::vector<FileId> ids;
+    for (FileId i = 0; i < TERM_DOCS; ++i) {
+        if (keep(i)) ids.push_back(i);
+    }
+    return ids;
+}
+
+}  // namespace
+
+class QueryArenaSearchTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        test_dir_ = fs::temp_directory_path() / "dam_search_test";
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_);
+        disk_manager_ = new DiskManager(test_dir_ / "test.db");
+        buffer_pool_ = new BufferPool(256, disk_manager_);
+
+        TrigramIndexConfig trigram_config;
+        trigram_config.max_results = DOCS;
+        trigrams_ = new TrigramIndex(buffer_pool_, INVALID_PAGE_ID, trigram_config);
+        for (FileId i = 0; i < DOCS; ++i) {
+            ASSERT_TRUE(trigrams_->index_document(i, document(i)).ok());
+        }
+
+        InvertedIndexConfig inverted_config;
+        inverted_config.max_results = TERM_DOCS;
+        inverted_ = new InvertedIndex(buffer_pool_, INVALID_PAGE_ID, inverted_config);
+        for (FileId i = 0; i < TERM_DOCS; ++i) {
+            ASSERT_TRUE(inverted_->index_code(i, code_document(i)).ok());
+        }
+    }
+
+    static void TearDownTestSuite() {
+        delete inverted_;
+        delete trigrams_;
+        delete buffer_pool_;
+        delete disk_manager_;
+        fs::remove_all(test_dir_);
+    }
+
+    void SetUp() override {
+        // Every test starts from a cold arena
+        QueryArena::trim_idle(SIZE_MAX);
+        ASSERT_EQ(arena().capacity(), QueryArena::INITIAL_SIZE);
+    }
+
+    static QueryArena& arena() { return QueryArena::for_this_thread(); }
+
+    // Run a query inside an outer scope and report how much of it the
+    // arena's buffer could not hold
+    template <typename Query>
+    static auto run(Query query, size_t* overflow) {
+        QueryArenaScope scope;
+        auto result = query();
+        *overflow = arena().overflow_bytes();
+        return result;
+    }
+
+    static fs::path test_dir_;
+    static DiskManager* disk_manager_;
+    static BufferPool* buffer_pool_;
+    static TrigramIndex* trigrams_;
+    static InvertedIndex* inverted_;
+};
+
+fs::path QueryArenaSearchTest::test_dir_;
+DiskManager* QueryArenaSearchTest::disk_manager_ = nullptr;
+BufferPool* QueryArenaSearchTest::buffer_pool_ = nullptr;
+TrigramIndex* QueryArenaSearchTest::trigrams_ = nullptr;
+InvertedIndex* QueryArenaSearchTest::inverted_ = nullptr;
+
+const char* const EVERY_GROUP = "alpha bravo charlie delta";
+
+TEST_F(QueryArenaSearchTest, FuzzyResultsMatchHeapReference) {
+    // The reference counts shared trigrams in plain heap containers
+    auto query = trigrams_->extract_trigrams(EVERY_GROUP, true);
+    std::vector<std::pair<FileId, float>> expected;
+    for (FileId i = 0; i < DOCS; ++i) {
+        auto have = trigrams_->extract_trigrams(document(i), true);
+        size_t shared = 0;
+        for (const auto& trigram : query) shared += have.count(trigram);
+        float similarity = static_cast<float>(shared) / static_cast<float>(query.size());
+        if (shared > 0 && similarity >= 0.05f * 0.5f) {
+            expected.emplace_back(i, similarity);
+        }
+    }
+    ASSERT_EQ(expected.size(), DOCS);
+
+    // Once with the heap taking the overflow, once from the grown buffer
+    size_t cold_overflow = 0;
+    size_t warm_overflow = 0;
+    auto cold = run([&]() { return trigrams_->search_fuzzy(EVERY_GROUP, 0.05f); }, &cold_overflow);
+    auto warm = run([&]() { return trigrams_->search_fuzzy(EVERY_GROUP, 0.05f); }, &warm_overflow);
+    ASSERT_TRUE(cold.ok() && warm.ok());
+    EXPECT_GT(cold_overflow, 0u);
+    EXPECT_EQ(warm_overflow, 0u);
+    EXPECT_EQ(by_doc(cold.value()), expected);
+    EXPECT_EQ(by_doc(warm.value()), expected);
+}
+
+TEST_F(QueryArenaSearchTest, SubstringResultsMatchHeapReference) {
+    for (const std::string pattern : {"alpha", "charlie 1", "ta 44", "lie 9"}) {
+        auto wanted = trigrams_->extract_trigrams(pattern, false);
+        std::vector<FileId> expected;
+        for (FileId i = 0; i < DOCS; ++i) {
+            auto have = trigrams_->extract_trigrams(document(i), false);
+            if (std::includes(have.begin(), have.end(), wanted.begin(), wanted.end())) {
+                expected.push_back(i);
+            }
+        }
+        ASSERT_FALSE(expected.empty()) << pattern;
+
+        size_t overflow = 0;
+        auto found = run([&]() { return trigrams_->search_substring(pattern); }, &overflow);
+        ASSERT_TRUE(found.ok());
+        std::vector<FileId> ids = found.value();
+        std::sort(ids.begin(), ids.end());
+        EXPECT_EQ(ids, expected) << pattern;
+    }
+}
+
+TEST_F(QueryArenaSearchTest, TermResultsMatchHeapReference) {
+    auto both = code_ids_where([](FileId i) { return i % 2 == 0 && i % 3 == 0; });
+    auto either = code_ids_where([](FileId i) { return i % 2 == 0 || i % 3 == 0; });
+    auto only_alpha = code_ids_where([](FileId i) { return i % 2 == 0 && i % 3 != 0; });
+
+    for (int pass = 0; pass < 2; ++pass) {
+        size_t overflow = 0;
+        auto and_results = run([&]() { return inverted_->search_and({"alpha", "beta"}); }, &overflow);
+        ASSERT_TRUE(and_results.ok());
+        EXPECT_EQ(sorted_ids(and_results.value()), both);
+
+        auto or_results = run([&]() { return inverted_->search("alpha OR beta"); }, &overflow);
+        ASSERT_TRUE(or_results.ok());
+        EXPECT_EQ(sorted_ids(or_results.value()), either);
+
+        auto excluded = run([&]() { return inverted_->search("+alpha -beta"); }, &overflow);
+        ASSERT_TRUE(excluded.ok());
+        EXPECT_EQ(sorted_ids(excluded.value()), only_alpha);
+    }
+}
+
+TEST_F(QueryArenaSearchTest, ArenaResetsBetweenQueries) {
+    size_t overflow = 0;
+    auto first = run([&]() { return trigrams_->search_fuzzy(EVERY_GROUP, 0.05f); }, &overflow);
+    ASSERT_TRUE(first.ok());
+    ASSERT_GT(overflow, 0u);
+
+    // The reset returned the overflow and grew the buffer to the high-water mark
+    EXPECT_EQ(arena().overflow_bytes(), 0u);
+    size_t grown = arena().capacity();
+    EXPECT_GT(grown, QueryArena::INITIAL_SIZE);
+
+    // Each query starts from an empty buffer, so repeats fit in it
+    for (int i = 0; i < 20; ++i) {
+        auto again = run([&]() { return trigrams_->search_fuzzy(EVERY_GROUP, 0.05f); }, &overflow);
+        ASSERT_TRUE(again.ok());
+        EXPECT_EQ(again.value().size(), first.value().size());
+        EXPECT_EQ(overflow, 0u);
+        EXPECT_EQ(arena().capacity(), grown);
+    }
+
+    // Nested searches share the outer scope: nothing is released between
+    // them, so two queries no longer fit in a buffer sized for one
+    {
+        QueryArenaScope outer;
+        ASSERT_TRUE(trigrams_->search_fuzzy(EVERY_GROUP, 0.05f).ok());
+        EXPECT_EQ(arena().overflow_bytes(), 0u);
+        ASSERT_TRUE(trigrams_->search_fuzzy(EVERY_GROUP, 0.05f).ok());
+        EXPECT_GT(arena().overflow_bytes(), 0u);
+    }
+    EXPECT_EQ(arena().overflow_bytes(), 0u);
+}
@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 #include <dam/dam.hpp>
+#include <dam/util/serializer.hpp>
+#include <csignal>
 #include <filesystem>
 
+#include <sys/resource.h>
+
 using namespace dam;
 namespace fs = std::filesystem;
 
@@ -257,6 +261,104 @@ TEST_F(SnippetStoreTest, ExplicitLanguageOverridesDetection) {
     EXPECT_EQ(snippet.value().language, "python");
 }
 
+TEST_F(SnippetStoreTest, RetagBySelector) {
+    std::string big_body = std::string(2000, '#') + "\nprint('done')\n";
+    SnippetId big, small, other, untouched;
+    {
+        auto store = open_store();
+        big = store->add(big_body, "big.py", {"legacy", "keep"}, "python").value();
+        small = store->add("print(1)", "small.py", {"legacy"}, "python").value();
+        other = store->add("echo hi", "other.sh", {"legacy"}, "bash").value();
+        untouched = store->add("print(2)", "fresh.py", {}, "python").value();
+
+        auto selector = SnippetSelector::parse("tag:legacy lang:python");
+        ASSERT_TRUE(selector.ok());
+        auto changed = store->retag(selector.value(), {"reviewed"}, {"legacy"});
+        ASSERT_TRUE(changed.ok()) << changed.error().to_string();
+        EXPECT_EQ(changed.value(), 2u);
+
+        // Running it again selects nothing: the tag is gone
+        EXPECT_EQ(store->retag(selector.value(), {"reviewed"}, {"legacy"}).value(), 0u);
+        store->close();
+    }
+
+    auto store = open_store();
+    auto snippet = store->get(big);
+    ASSERT_TRUE(snippet.ok());
+    EXPECT_EQ(snippet.value().content, big_body);
+    EXPECT_EQ(snippet.value().tags, (std::vector<std::string>{"keep", "reviewed"}));
+    EXPECT_EQ(store->get(other).value().tags, std::vector<std::string>{"legacy"});
+    EXPECT_TRUE(store->get(untouched).value().tags.empty());
+
+    auto reviewed = store->find_by_tag("reviewed");
+    ASSERT_TRUE(reviewed.ok());
+    EXPECT_EQ(reviewed.value().size(), 2u);
+    EXPECT_EQ(store->find_by_tag("legacy").value().size(), 1u);
+
+    // Text and ID terms
+    auto by_text = store->select(SnippetSelector::parse("PRINT(").value());
+    EXPECT_EQ(by_text.value(), (std::vector<SnippetId>{big, small, untouched}));
+    auto by_id = store->select(SnippetSelector::parse("id:" + std::to_string(small)).value());
+    EXPECT_EQ(by_id.value(), std::vector<SnippetId>{small});
+    EXPECT_FALSE(SnippetSelector::parse("id:abc").ok());
+    EXPECT_FALSE(store->select(SnippetSelector{}).ok());
+}
+
+TEST_F(SnippetStoreTest, ScanStreamsPages) {
+    auto store = open_store();
+    std::vector<SnippetId> ids;
+    for (int i = 0; i < 300; ++i) {
+        std::string lang = i % 3 == 0 ? "python" : "bash";
+        std::vector<std::string> tags;
+        if (i % 2 == 0) tags.push_back("even");
+        ids.push_back(store->add(std::string(300, 'x') + std::to_string(i),
+                                 "s" + std::to_string(i), tags, lang).value());
+    }
+
+    auto collect = [&](ScanOptions options) {
+        std::vector<SnippetId> out;
+        auto cursor = store->scan(options);
+        EXPECT_TRUE(cursor.ok());
+        while (cursor.value().next()) {
+            out.push_back(cursor.value().snippet().id);
+        }
+        return out;
+    };
+
+    // Pages tile the full scan, which matches list_all()
+    ScanOptions all;
+    auto everything = collect(all);
+    std::vector<SnippetId> listed;
+    for (const auto& s : store->list_all().value()) listed.push_back(s.id);
+    EXPECT_EQ(everything, listed);
+
+    std::vector<SnippetId> paged;
+    for (size_t offset = 0; offset < everything.size(); offset += 70) {
+        ScanOptions page;
+        page.offset = offset;
+        page.limit = 70;
+        auto part = collect(page);
+        paged.insert(paged.end(), part.begin(), part.end());
+    }
+    EXPECT_EQ(paged, everything);
+
+    // Filters combine; the summary projection keeps sizes but not bodies
+    ScanOptions filtered;
+    filtered.tag = "even";
+    filtered.language = "python";
+    filtered.with_content = false;
+    filtered.offset = 10;
+    auto cursor = store->scan(filtered);
+    ASSERT_TRUE(cursor.ok());
+    ASSERT_TRUE(cursor.value().next());
+    EXPECT_EQ(cursor.value().snippet().id, ids[60]);
+    EXPECT_TRUE(cursor.value().snippet().content.empty());
+    EXPECT_EQ(cursor.value().content_size(), 302u);
+    size_t rest = 1;
+    while (cursor.value().next()) ++rest;
+    EXPECT_EQ(rest, 40u);
+}
+
 // ============================================================================
 // Persistence
 // ============================================================================
@@ -632,6 +734,502 @@ TEST_F(SnippetStoreTest, SearchScoreOrdering) {
     EXPECT_GE(results.value()[0].score, results.value()[1].score);
 }
 
+// ============================================================================
+// Compression
+// ============================================================================
+
+TEST_F(SnippetStoreTest, LargeCompressibleContentRoundTrips) {
+    // Raw, this body would not fit in a 4KB leaf
+    std::string content;
+    for (int i = 0; i < 200; ++i) {
+        content += "echo \"step " + std::to_string(i % 7) + "\" >> build.log\n";
+    }
+    ASSERT_GT(content.size(), PAGE_SIZE);
+
+    auto store = open_store();
+    auto id = store->add(content, "build-steps", {}, "bash");
+    ASSERT_TRUE(id.ok()) << id.error().to_string();
+
+    auto snippet = store->get(id.value());
+    ASSERT_TRUE(snippet.ok());
+    EXPECT_EQ(snippet.value().content, content);
+}
+
+TEST_F(SnippetStoreTest, TrainedDictionariesSurviveReopen) {
+    const std::string header =
+        "#!/usr/bin/env python3\n"
+        "# Copyright (c) Example Corp. Licensed under the Apache License 2.0\n"
+        "import os\nimport sys\nimport json\n";
+    std::vector<SnippetId> ids;
+
+    {
+        auto store = open_store();
+        for (int i = 0; i < 20; ++i) {
+            auto id = store->add(header + "print(" + std::to_string(i) + ")\n",
+                                 "script" + std::to_string(i), {}, "python");
+            ASSERT_TRUE(id.ok());
+            ids.push_back(id.value());
+        }
+
+        auto trained = store->train_compression_dictionaries(16);
+        ASSERT_TRUE(trained.ok());
+        EXPECT_EQ(trained.value(), 1u);
+        store->close();
+    }
+
+    auto store = open_store();
+    for (int i = 0; i < 20; ++i) {
+        auto snippet = store->get(ids[i]);
+        ASSERT_TRUE(snippet.ok());
+        EXPECT_EQ(snippet.value().content, header + "print(" + std::to_string(i) + ")\n");
+    }
+}
+
+TEST(SnippetIndexTest, IdenticalBodiesShareStorage) {
+    InMemoryDiskManager disk;
+    BufferPool pool(64, &disk);
+    SnippetIndex index(&pool);
+
+    SnippetMetadata snippet;
+    snippet.content = std::string(1024, 'x') + "\n";
+    snippet.language = "text";
+
+    snippet.name = "first";
+    SnippetId first = index.insert(snippet);
+    snippet.name = "second";
+    SnippetId second = index.insert(snippet);
+    ASSERT_NE(first, INVALID_SNIPPET_ID);
+    ASSERT_NE(second, INVALID_SNIPPET_ID);
+    EXPECT_EQ(index.body_references(snippet.content), 2u);
+
+    // Editing one copy moves it off the shared body
+    snippet.id = second;
+    snippet.content = "short";
+    ASSERT_TRUE(index.update(second, snippet));
+    EXPECT_EQ(index.body_references(std::string(1024, 'x') + "\n"), 1u);
+
+    ASSERT_TRUE(index.remove(first));
+    EXPECT_EQ(index.body_references(std::string(1024, 'x') + "\n"), 0u);
+    EXPECT_EQ(index.get(second).value().content, "short");
+}
+
+TEST(SnippetIndexTest, RecordFormatByte) {
+    InMemoryDiskManager disk;
+    BufferPool pool(64, &disk);
+
+    // A record as written before compression: nothing after the tags
+    auto record = [](const std::string& content) {
+        BinaryWriter writer;
+        writer.write_uint64(1);
+        writer.write_uint32(0);
+        writer.write_uint64(0);
+        writer.write_uint64(0);
+        writer.write_string("legacy");
+        writer.write_string(content);
+        writer.write_string("text");
+        writer.write_string("");
+        writer.write_uint32(1);
+        writer.write_string("old");
+        return writer.release();
+    };
+
+    const std::string content(200, 'y');
+    BPlusTree primary(&pool);
+    ASSERT_TRUE(primary.insert("1", record(content)));
+    ASSERT_TRUE(primary.insert("2", record("z") + std::string("\x01\x01\0\0\0\0\x05\0\0\0", 10)));
+    ASSERT_TRUE(primary.insert("3", record("z") + std::string("\x02\x00\x00", 3)));
+
+    SnippetIndex index(&pool, primary.get_root_page_id());
+    auto legacy = index.get(1);
+    ASSERT_TRUE(legacy.has_value());
+    EXPECT_EQ(legacy->content, content);
+    EXPECT_EQ(legacy->tags, std::vector<std::string>{"old"});
+
+    // An unknown format, or bytes past the fields, is not guessed at
+    EXPECT_EQ(index.get(2)->id, INVALID_SNIPPET_ID);
+    EXPECT_EQ(index.get(3)->id, INVALID_SNIPPET_ID);
+
+    // Records written now round-trip raw and compressed
+    index.set_next_id(4);
+    SnippetMetadata snippet;
+    snippet.language = "text";
+    snippet.name = "small";
+    snippet.content = "short";
+    SnippetId small = index.insert(snippet);
+    snippet.name = "large";
+    snippet.content = std::string(200, 'q');
+    SnippetId large = index.insert(snippet);
+    EXPECT_EQ(index.get(small)->content, "short");
+    EXPECT_EQ(index.get(large)->content, std::string(200, 'q'));
+}
+
+TEST_F(SnippetStoreTest, RemovingDuplicateKeepsSharedBody) {
+    const std::string body = "// Licensed under the Apache License, Version 2.0\n" +
+                             std::string(512, '-') + "\n";
+    SnippetId first, second;
+
+    {
+        auto store = open_store();
+        first = store->add(body, "license-a.txt").value();
+        second = store->add(body, "license-b.txt").value();
+        store->close();
+    }
+
+    auto store = open_store();
+    ASSERT_TRUE(store->remove(first).ok());
+
+    auto snippet = store->get(second);
+    ASSERT_TRUE(snippet.ok());
+    EXPECT_EQ(snippet.value().content, body);
+}
+
+TEST_F(SnippetStoreTest, RevisionHistoryRebuildsEarlierVersions) {
+    std::string body;
+    for (int line = 0; line < 40; ++line) {
+        body += "value_" + std::to_string(line) + " = compute(" + std::to_string(line) + ")\n";
+    }
+
+    // Revision n differs from the original in line n
+    std::vector<std::string> versions{body};
+    SnippetId id;
+    {
+        auto store = open_store();
+        id = store->add(body, "history.py", {}, "python").value();
+        for (int n = 1; n < 40; ++n) {
+            std::string next = versions.back();
+            size_t pos = next.find("compute(" + std::to_string(n) + ")");
+            next.replace(pos, 7, "refine");
+            versions.push_back(next);
+            ASSERT_TRUE(store->update(id, next, "history.py", {}, "python", "").ok());
+        }
+        // Tag changes keep the content and add no revision
+        ASSERT_TRUE(store->add_tag(id, "tracked").ok());
+        store->close();
+    }
+
+    auto store = open_store();
+    auto revisions = store->get_revisions(id);
+    ASSERT_TRUE(revisions.ok());
+    ASSERT_EQ(revisions.value().size(), versions.size());
+
+    for (uint32_t n = 1; n <= versions.size(); ++n) {
+        auto revision = store->get_revision(id, n);
+        ASSERT_TRUE(revision.ok()) << "revision " << n;
+        EXPECT_EQ(revision.value().content, versions[n - 1]) << "revision " << n;
+    }
+    EXPECT_FALSE(store->get_revision(id, 0).ok());
+    EXPECT_FALSE(store->get_revision(id, versions.size() + 1).ok());
+
+    ASSERT_TRUE(store->remove(id).ok());
+    EXPECT_FALSE(store->get_revisions(id).ok());
+}
+
+TEST_F(SnippetStoreTest, FindsNearDuplicateSnippets) {
+    std::string original;
+    for (int i = 0; i < 30; ++i) {
+        original += "total_count += process_record(records[" + std::to_string(i) + "]);\n";
+    }
+    std::string renamed = original;
+    renamed.replace(renamed.find("total_count"), 11, "grand_total");
+
+    SnippetId a, b, c;
+    {
+        auto store = open_store();
+        a = store->add(original, "original.cpp").value();
+        b = store->add(renamed, "renamed.cpp").value();
+        c = store->add("SELECT name, email FROM users WHERE active = 1 ORDER BY name;",
+                       "query.sql").value();
+        store->close();
+    }
+
+    auto store = open_store();
+    auto pairs = store->find_near_duplicates(0.9f);
+    ASSERT_TRUE(pairs.ok());
+    ASSERT_EQ(pairs.value().size(), 1u);
+    EXPECT_EQ(pairs.value()[0].first, a);
+    EXPECT_EQ(pairs.value()[0].second, b);
+
+    auto similar = store->find_similar(b, 0.5f);
+    ASSERT_TRUE(similar.ok());
+    ASSERT_EQ(similar.value().size(), 1u);
+    EXPECT_EQ(similar.value()[0].id, a);
+    EXPECT_TRUE(store->find_similar(c, 0.5f).value().empty());
+
+    ASSERT_TRUE(store->remove(a).ok());
+    EXPECT_TRUE(store->find_near_duplicates(0.9f).value().empty());
+}
+
+TEST_F(SnippetStoreTest, IncrementalBackupRestoresSnapshot) {
+    fs::path backup_dir = test_dir_ / "backup";
+    fs::path restore_dir = test_dir_ / "restored";
+    std::string body(512, 'x');
+
+    auto store = open_store();
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(store->add(body + std::to_string(i), "before" + std::to_string(i)).ok());
+    }
+
+    auto full = store->backup(backup_dir);
+    ASSERT_TRUE(full.ok()) << full.error().to_string();
+    EXPECT_FALSE(full.value().incremental);
+    EXPECT_EQ(full.value().pages_copied, full.value().pages_total);
+
+    SnippetId later = store->add("added after the full backup", "later").value();
+
+    BackupOptions options;
+    options.incremental = true;
+    auto pending = store->begin_backup(backup_dir, options);
+    ASSERT_TRUE(pending.ok()) << pending.error().to_string();
+
+    // Writes while the backup is pending evict pages under the snapshot;
+    // their old images are kept in a side file, not in memory
+    for (int i = 0; i < 300; ++i) {
+        ASSERT_TRUE(store->add(body + std::to_string(i), "during" + std::to_string(i)).ok());
+    }
+    fs::path saved_pages = test_dir_ / "dam.db.snapshot";
+    ASSERT_TRUE(fs::exists(saved_pages));
+    EXPECT_GT(fs::file_size(saved_pages), 0u);
+
+    auto incremental = pending.value()->run();
+    ASSERT_TRUE(incremental.ok()) << incremental.error().to_string();
+    EXPECT_FALSE(fs::exists(saved_pages));
+    EXPECT_TRUE(incremental.value().incremental);
+    EXPECT_LT(incremental.value().pages_copied, incremental.value().pages_total);
+    pending.value().reset();
+    store->close();
+
+    ASSERT_TRUE(SnippetStore::restore(backup_dir, restore_dir).ok());
+    EXPECT_FALSE(SnippetStore::restore(backup_dir, restore_dir).ok());
+
+    Config config;
+    config.root_directory = restore_dir;
+    auto restored = SnippetStore::open(config);
+    ASSERT_TRUE(restored.ok());
+    EXPECT_EQ(restored.value()->count(), 21u);
+    EXPECT_EQ(restored.value()->get(later).value().name, "later");
+    SnippetId before = restored.value()->find_by_name("before7").value();
+    EXPECT_EQ(restored.value()->get(before).value().content, body + "7");
+    EXPECT_FALSE(restored.value()->find_by_name("during0").ok());
+}
+
+TEST_F(SnippetStoreTest, FailedBackupKeepsPreviousOne) {
+    fs::path backup_dir = test_dir_ / "backup";
+    fs::path restore_dir = test_dir_ / "restored";
+
+    auto store = open_store();
+    ASSERT_TRUE(store->add("kept", "kept").ok());
+    ASSERT_TRUE(store->backup(backup_dir).ok());
+    ASSERT_TRUE(store->add("lost", "lost").ok());
+
+    // The new image cannot be written, so the backup fails part way
+    fs::create_directories(backup_dir / "dam.db.tmp");
+    BackupOptions options;
+    options.incremental = true;
+    EXPECT_FALSE(store->backup(backup_dir, options).ok());
+    EXPECT_FALSE(store->backup(backup_dir).ok());
+    store->close();
+
+    ASSERT_TRUE(SnippetStore::restore(backup_dir, restore_dir).ok());
+    Config config;
+    config.root_directory = restore_dir;
+    auto restored = SnippetStore::open(config);
+    ASSERT_TRUE(restored.ok());
+    EXPECT_EQ(restored.value()->count(), 1u);
+    EXPECT_TRUE(restored.value()->find_by_name("kept").ok());
+}
+
+TEST_F(SnippetStoreTest, BackupFailsWhenPagesCannotBeFlushed) {
+    fs::path backup_dir = test_dir_ / "backup";
+
+    auto store = open_store();
+    ASSERT_TRUE(store->add("kept", "kept").ok());
+    ASSERT_TRUE(store->backup(backup_dir).ok());
+    ASSERT_TRUE(store->add("unflushed", "unflushed").ok());
+
+    // Writes past the header page fail, as on a full disk
+    struct rlimit old_limit;
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &old_limit), 0);
+    auto old_handler = std::signal(SIGXFSZ, SIG_IGN);
+    struct rlimit limit = old_limit;
+    limit.rlim_cur = PAGE_SIZE;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limit), 0);
+
+    auto backup = store->backup(backup_dir);
+
+    setrlimit(RLIMIT_FSIZE, &old_limit);
+    std::signal(SIGXFSZ, old_handler);
+
+    // No snapshot was taken of a file missing the dirty pages
+    ASSERT_FALSE(backup.ok());
+    EXPECT_EQ(backup.error_code(), ErrorCode::IO_ERROR);
+    EXPECT_FALSE(fs::exists(test_dir_ / "dam.db.snapshot"));
+    EXPECT_FALSE(fs::exists(backup_dir / "dam.db.tmp"));
+    store.reset();
+
+    // The previous backup is untouched
+    fs::path restore_dir = test_dir_ / "restored";
+    ASSERT_TRUE(SnippetStore::restore(backup_dir, restore_dir).ok());
+    Config config;
+    config.root_directory = restore_dir;
+    auto restored = SnippetStore::open(config);
+    ASSERT_TRUE(restored.ok());
+    EXPECT_EQ(restored.value()->count(), 1u);
+}
+
+TEST_F(SnippetStoreTest, MountsExportedPackReadOnly) {
+    fs::path pack_path = test_dir_ / "curated.dampack";
+    {
+        auto store = open_store();
+        ASSERT_TRUE(store->add("def parse_config(path):\n    return load(path)\n",
+                               "parse_config.py", {"config", "python"}).ok());
+        ASSERT_TRUE(store->add(std::string(4096, 'a') + "unique_marker",
+                               "big.txt", {"config"}).ok());
+        ASSERT_TRUE(store->add("SELECT * FROM users;", "users.sql").ok());
+
+        auto stats = store->export_pack(pack_path);
+        ASSERT_TRUE(stats.ok()) << stats.error().to_string();
+        EXPECT_EQ(stats.value().snippets, 3u);
+        EXPECT_LT(stats.value().bytes, 4096u);  // The big body is compressed
+    }
+
+    auto pack = SnippetPack::open(pack_path);
+    ASSERT_TRUE(pack.ok()) << pack.error().to_string();
+    EXPECT_EQ(pack.value()->search_terms("parse config").size(), 1u);
+    EXPECT_EQ(pack.value()->substring_candidates("FROM USERS").value().size(), 1u);
+    EXPECT_FALSE(pack.value()->substring_candidates("ab").has_value());
+
+    // A second store picks the pack up from its packs directory
+    fs::path other_dir = test_dir_ / "other";
+    fs::create_directories(other_dir / "packs");
+    fs::copy_file(pack_path, other_dir / "packs" / "curated.dampack");
+
+    Config config;
+    config.root_directory = other_dir;
+    auto opened = SnippetStore::open(config);
+    ASSERT_TRUE(opened.ok());
+    auto& store = opened.value();
+    ASSERT_EQ(store->packs().size(), 1u);
+    EXPECT_EQ(store->count(), 3u);
+
+    SnippetId local = store->add("local content", "local.txt").value();
+    EXPECT_FALSE(SnippetStore::is_pack_snippet(local));
+
+    auto id = store->find_by_name("big.txt");
+    ASSERT_TRUE(id.ok());
+    EXPECT_TRUE(SnippetStore::is_pack_snippet(id.value()));
+    auto big = store->get(id.value());
+    ASSERT_TRUE(big.ok());
+    EXPECT_EQ(big.value().content, std::string(4096, 'a') + "unique_marker");
+    EXPECT_EQ(big.value().tags, std::vector<std::string>{"config"});
+
+    EXPECT_EQ(store->find_by_tag("config").value().size(), 2u);
+    EXPECT_EQ(store->get_tag_counts().value()["config"], 2u);
+    EXPECT_EQ(store->list_all().value().size(), 4u);
+
+    auto results = store->search("unique_marker");
+    ASSERT_TRUE(results.ok());
+    ASSERT_EQ(results.value().size(), 1u);
+    EXPECT_EQ(results.value()[0].id, id.value());
+
+    auto removed = store->remove(id.value());
+    ASSERT_FALSE(removed.ok());
+    EXPECT_EQ(removed.error().code(), ErrorCode::PERMISSION_DENIED);
+}
+
+TEST_F(SnippetStoreTest, ReadContentStreamsVerifiedChunks) {
+    // Large but repetitive, so its record still fits in a page
+    std::string block;
+    for (int i = 0; i < 32; ++i) {
+        block += "line " + std::to_string(i) + " of a generated block\n";
+    }
+    std::string body;
+    while (body.size() < 300 * 1024) {
+        body += block;
+    }
+
+    auto store = open_store();
+    SnippetId id = store->add(body, "big.txt").value();
+
+    auto collect = [&](SnippetId target, size_t* chunks) {
+        std::string out;
+        auto read = store->read_content(target, [&](std::string_view chunk) {
+            out.append(chunk);
+            ++*chunks;
+            return true;
+        });
+        EXPECT_TRUE(read.ok()) << read.error().to_string();
+        EXPECT_EQ(read.value(), out.size());
+        return out;
+    };
+
+    size_t chunks = 0;
+    EXPECT_EQ(collect(id, &chunks), body);
+    EXPECT_GT(chunks, 1u);
+
+    // Uncompressed pack bodies are streamed from the mapping
+    fs::path pack_path = test_dir_ / "raw.dampack";
+    PackOptions options;
+    options.compress = false;
+    ASSERT_TRUE(store->export_pack(pack_path, options).ok());
+    auto pack = SnippetPack::open(pack_path);
+    ASSERT_TRUE(pack.ok());
+    ASSERT_TRUE(pack.value()->stored_body(0).has_value());
+    ASSERT_TRUE(store->mount_pack(pack_path).ok());
+    chunks = 0;
+    EXPECT_EQ(collect(SnippetStore::pack_snippet_id(0, 0), &chunks), body);
+
+    // A sink can stop early
+    auto stopped = store->read_content(id, [](std::string_view) { return false; });
+    EXPECT_FALSE(stopped.ok());
+    EXPECT_FALSE(store->read_content(id + 100, [](std::string_view) { return true; }).ok());
+}
+
+TEST_F(SnippetStoreTest, CompletionIndexTracksNamesAndTags) {
+    fs::path path = test_dir_ / CompletionIndex::FILE_NAME;
+    SnippetId deploy;
+    {
+        auto store = open_store();
+        deploy = store->add("kubectl apply -f .", "deploy-k8s", {"kubernetes", "ops"}).value();
+        store->add("docker build .", "docker-build", {"docker"});
+        store->add("docker ps", "docker-ps", {"docker", "ops"});
+        store->close();
+    }
+
+    auto index = CompletionIndex::open(path);
+    ASSERT_TRUE(index.ok()) << index.error().to_string();
+    EXPECT_EQ(index.value()->size(CompletionIndex::Kind::NAMES), 3u);
+    auto names = index.value()->complete(CompletionIndex::Kind::NAMES, "do");
+    ASSERT_EQ(names.size(), 2u);
+    EXPECT_EQ(names[0], "docker-build");
+    EXPECT_EQ(names[1], "docker-ps");
+    EXPECT_EQ(index.value()->complete(CompletionIndex::Kind::NAMES, "do", 1).size(), 1u);
+    EXPECT_TRUE(index.value()->complete(CompletionIndex::Kind::NAMES, "x").empty());
+    auto tags = index.value()->complete(CompletionIndex::Kind::TAGS, "");
+    ASSERT_EQ(tags.size(), 3u);
+    EXPECT_EQ(tags[0], "docker");
+    index.value().reset();
+
+    // Renames and removals show up after the next checkpoint
+    {
+        auto store = open_store();
+        auto old = store->get(deploy).value();
+        ASSERT_TRUE(store->update(deploy, old.content, "apply-k8s", {"k8s"},
+                                  old.language, old.description).ok());
+        store->close();
+    }
+    index = CompletionIndex::open(path);
+    ASSERT_TRUE(index.ok());
+    EXPECT_TRUE(index.value()->complete(CompletionIndex::Kind::NAMES, "deploy").empty());
+    EXPECT_EQ(index.value()->complete(CompletionIndex::Kind::NAMES, "ap").size(), 1u);
+    EXPECT_EQ(index.value()->complete(CompletionIndex::Kind::TAGS, "k").size(), 1u);
+    index.value().reset();
+
+    // A missing index is rebuilt on open
+    fs::remove(path);
+    open_store()->close();
+    EXPECT_TRUE(fs::exists(path));
+}
+
 // ============================================================================
 // Language Detector Unit Tests
 // ============================================================================
@@ -671,3 +1269,33 @@ TEST(LanguageDetectorTest, UnknownReturnsText) {
     EXPECT_EQ(LanguageDetector::detect("random content", ""), "text");
     EXPECT_EQ(LanguageDetector::detect("", "file.unknown"), "text");
 }
+
+TEST(LanguageDetectorTest, DetectFromContent) {
+    EXPECT_EQ(LanguageDetector::detect(
+        "def load(path):\n    with open(path) as f:\n        return f.read()\n"), "python");
+    EXPECT_EQ(LanguageDetector::detect(
+        "#include <stdio.h>\nint main(void) {\n    printf(\"hi\\n\");\n    return 0;\n}\n"), "c");
+    EXPECT_EQ(LanguageDetector::detect(
+        "package main\n\nfunc main() {\n\tx := 1\n\tfmt.Println(x)\n}\n"), "go");
+    EXPECT_EQ(LanguageDetector::detect(
+        "SELECT id, name FROM users WHERE active = 1 ORDER BY name;\n"), "sql");
+    EXPECT_EQ(LanguageDetector::detect(
+        "FROM alpine:3.19\nRUN apk add curl\nCMD [\"sh\"]\n"), "dockerfile");
+
+    // The extension still wins over the content
+    EXPECT_EQ(LanguageDetector::detect("SELECT 1;", "notes.md"), "markdown");
+}
+
+TEST(LanguageDetectorTest, ClassifyReportsConfidence) {
+    auto guess = LanguageDetector::classify(
+        "fn main() {\n    let mut v: Vec<u32> = Vec::new();\n    v.push(1);\n}\n");
+    EXPECT_EQ(guess.language, "rust");
+    EXPECT_GT(guess.confidence, LanguageDetector::MIN_CONFIDENCE);
+    EXPECT_LE(guess.confidence, 1.0f);
+
+    // Prose stays text
+    EXPECT_EQ(LanguageDetector::classify("Notes from the meeting, see you then.").language,
+              "text");
+    // Binary data is not classified
+    EXPECT_EQ(LanguageDetector::classify(std::string("fn main\0\x01", 9)).language, "text");
+}
@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+#include <dam/llm/provider.hpp>
+#include <dam/llm/stop_conditions.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace dam::llm;
+
+namespace {
+
+// Feed chunks through a StopController the way a provider does and
+// collect what is streamed
+struct Run {
+    std::string content;
+    std::string stop_reason;
+    std::vector<std::string> streamed;
+};
+
+Run run(const CompletionRequest& request, const std::vector<std::string>& chunks) {
+    Run out;
+    StopController stop(request);
+    auto collect = [&out](const std::string& chunk) {
+        out.streamed.push_back(chunk);
+        return true;
+    };
+    for (const auto& chunk : chunks) {
+        bool done = stop.append(chunk);
+        stop.stream(collect);
+        if (done) break;
+    }
+    stop.finish();
+    stop.stream(collect);
+    out.content = stop.content();
+    out.stop_reason = stop.stop_reason();
+    return out;
+}
+
+std::string joined(const std::vector<std::string>& chunks) {
+    std::string text;
+    for (const auto& chunk : chunks) text += chunk;
+    return text;
+}
+
+CompletionRequest structured(StopMode mode, std::string context = {}) {
+    CompletionRequest request;
+    request.stop_mode = mode;
+    request.stop_context = std::move(context);
+    return request;
+}
+
+}  // namespace
+
+// ============================================================================
+// StopSequenceMatcher
+// ============================================================================
+
+TEST(StopSequenceMatcherTest, MatchesAtLastByte) {
+    StopSequenceMatcher matcher({"END"});
+    std::string text = "abcEND";
+    std::vector<size_t> lengths;
+    for (char c : text) lengths.push_back(matcher.step(c));
+    EXPECT_EQ(lengths, (std::vector<size_t>{0, 0, 0, 0, 0, 3}));
+}
+
+TEST(StopSequenceMatcherTest, OverlappingPatterns) {
+    StopSequenceMatcher matcher({"he", "she", "hers"});
+    std::string text = "ushers";
+    std::vector<size_t> lengths;
+    for (char c : text) lengths.push_back(matcher.step(c));
+    // "she" and "he" end at the same 'e'; the longer one is reported
+    EXPECT_EQ(lengths, (std::vector<size_t>{0, 0, 0, 3, 0, 4}));
+}
+
+TEST(StopSequenceMatcherTest, FallsBackOnMismatch) {
+    StopSequenceMatcher matcher({"aab"});
+    size_t found = 0;
+    for (char c : std::string("aaab")) found = matcher.step(c);
+    EXPECT_EQ(found, 3u);
+
+    // A pattern inside a longer one is found while the longer is pending
+    StopSequenceMatcher nested({"abcd", "bc"});
+    std::vector<size_t> lengths;
+    for (char c : std::string("xabc")) lengths.push_back(nested.step(c));
+    EXPECT_EQ(lengths, (std::vector<size_t>{0, 0, 0, 2}));
+}
+
+TEST(StopSequenceMatcherTest, PendingIsLongestLivePrefix) {
+    StopSequenceMatcher matcher({"<|end|>"});
+    EXPECT_FALSE(matcher.empty());
+    for (char c : std::string("text<|e")) matcher.step(c);
+    EXPECT_EQ(matcher.pending(), 3u);
+    matcher.step('x');
+    EXPECT_EQ(matcher.pending(), 0u);
+
+    EXPECT_TRUE(StopSequenceMatcher().empty());
+    EXPECT_TRUE(StopSequenceMatcher({""}).empty());
+}
+
+// ============================================================================
+// StopController: stop sequences
+// ============================================================================
+
+TEST(StopControllerTest, StopSequenceSplitAcrossChunks) {
+    CompletionRequest request;
+    request.stop_sequences = {"</code>"};
+
+    auto out = run(request, {"int x;</c", "od", "e>trailing"});
+    EXPECT_EQ(out.stop_reason, "stop_sequence");
+    EXPECT_EQ(out.content, "int x;");
+    // The partial "</c" was held back, never streamed and taken back
+    EXPECT_EQ(joined(out.streamed), "int x;");
+    ASSERT_FALSE(out.streamed.empty());
+    EXPECT_EQ(out.streamed[0], "int x;");
+}
+
+TEST(StopControllerTest, HeldBackPrefixIsReleasedWhenItDiverges) {
+    CompletionRequest request;
+    request.stop_sequences = {"</code>"};
+
+    auto out = run(request, {"a </c", "ite> b"});
+    EXPECT_TRUE(out.stop_reason.empty());
+    EXPECT_EQ(out.content, "a </cite> b");
+    EXPECT_EQ(joined(out.streamed), "a </cite> b");
+}
+
+TEST(StopControllerTest, AbortingCallbackIsReported) {
+    CompletionRequest request;
+    StopController stop(request);
+    stop.append("abc");
+    EXPECT_FALSE(stop.stream([](const std::string&) { return false; }));
+}
+
+// ============================================================================
+// StopController: structure
+// ============================================================================
+
+TEST(StopControllerTest, LineModeStopsAtFirstLine) {
+    auto out = run(structured(StopMode::LINE), {"return a + b;  ", "\n", "}\n"});
+    EXPECT_EQ(out.stop_reason, "structure");
+    EXPECT_EQ(out.content, "return a + b;");
+    // Trailing spaces were held back in case the line ended there
+    EXPECT_EQ(joined(out.streamed), "return a + b;");
+}
+
+TEST(StopControllerTest, LineModeContinuesInsideBrackets) {
+    auto out = run(structured(StopMode::LINE), {"call(a,\n", "     b)\n", "next();"});
+    EXPECT_EQ(out.stop_reason, "structure");
+    EXPECT_EQ(out.content, "call(a,\n     b)");
+}
+
+TEST(StopControllerTest, BracketsInStringsAreIgnored) {
+    auto out = run(structured(StopMode::LINE), {"s = \")]}\" + '(';\n", "more"});
+    EXPECT_EQ(out.content, "s = \")]}\" + '(';");
+
+    // An escaped quote does not end the string
+    out = run(structured(StopMode::LINE), {"s = \"\\\"(\";\n", "more"});
+    EXPECT_EQ(out.content, "s = \"\\\"(\";");
+
+    // In BLOCK mode a '}' in a string does not close the enclosing block
+    out = run(structured(StopMode::BLOCK, "if (x) {\n    "),
+              {"log(\"}\");\n", "    next();\n", "}\n"});
+    EXPECT_EQ(out.stop_reason, "structure");
+    EXPECT_EQ(out.content, "log(\"}\");");
+}
+
+TEST(StopControllerTest, BracketsInCommentsAreIgnored) {
+    auto out = run(structured(StopMode::LINE), {"f(); // close )}\n", "g();"});
+    EXPECT_EQ(out.content, "f(); // close )}");
+
+    out = run(structured(StopMode::LINE), {"f(/* ) */ 1);\n", "g();"});
+    EXPECT_EQ(out.content, "f(/* ) */ 1);");
+
+    // A block comment spanning lines does not end the line
+    out = run(structured(StopMode::LINE), {"x = 1; /* {\n", "} */ y = 2;\n", "z"});
+    EXPECT_EQ(out.content, "x = 1; /* {\n} */ y = 2;");
+
+    // '#' comments in scripting languages
+    out = run(structured(StopMode::LINE), {"x = 1  # (\n", "y"});
+    EXPECT_EQ(out.content, "x = 1  # (");
+}
+
+TEST(StopControllerTest, UnterminatedStringEndsWithItsLine) {
+    auto out = run(structured(StopMode::LINE), {"s = \"abc(\n", "def"});
+    EXPECT_EQ(out.stop_reason, "structure");
+    EXPECT_EQ(out.content, "s = \"abc(");
+}
+
+TEST(StopControllerTest, ClosingBracketOfContextStops) {
+    auto out = run(structured(StopMode::BLOCK, "result = compute(a,\n                 "),
+                   {"b) * 2\n"});
+    EXPECT_EQ(out.stop_reason, "structure");
+    EXPECT_EQ(out.content, "b");
+
+    // A bracket opened on the cursor line may be closed
+    out = run(structured(StopMode::BLOCK, "result = compute("), {"a, b) * 2;\n", "next();"});
+    EXPECT_EQ(out.stop_reason, "structure");
+    EXPECT_EQ(out.content, "a, b) * 2;");
+}
+
+TEST(StopControllerTest, BlockModeFinishesBraceBlock) {
+    auto out = run(structured(StopMode::BLOCK, "void f() {\n    "),
+                   {"if (x) {\n", "        y();\n", "    }\n", "    z();\n"});
+    EXPECT_EQ(out.stop_reason, "structure");
+    EXPECT_EQ(out.content, "if (x) {\n        y();\n    }");
+}
+
+TEST(StopControllerTest, BlockModeFollowsIndentation) {
+    auto out = run(structured(StopMode::BLOCK),
+                   {"if x:\n", "    y()\n", "else:\n", "    z()\n", "done()\n"});
+    EXPECT_EQ(out.stop_reason, "structure");
+    EXPECT_EQ(out.content, "if x:\n    y()\nelse:\n    z()");
+}
+
+TEST(StopControllerTest, UnterminatedFenceDoesNotSwallowLines) {
+    // A fence opened by the model is not a template string running on
+    auto out = run(structured(StopMode::LINE), {"```python\n", "print(1)\n", "print(2)\n"});
+    EXPECT_EQ(out.stop_reason, "structure");
+    EXPECT_EQ(out.content, "```python\nprint(1)");
+
+    out = run(structured(StopMode::BLOCK), {"```\n", "f();\n", "g();\n"});
+    EXPECT_EQ(out.stop_reason, "structure");
+    EXPECT_EQ(out.content, "```\nf();");
+
+    // A fence left open when generation ends releases everything
+    out = run(structured(StopMode::BLOCK), {"```\n", "f(1,"});
+    EXPECT_TRUE(out.stop_reason.empty());
+    EXPECT_EQ(joined(out.streamed), "```\nf(1,");
+
+    // Template strings still span lines
+    out = run(structured(StopMode::LINE), {"s = `a\n", "b`;\n", "c"});
+    EXPECT_EQ(out.content, "s = `a\nb`;");
+}
+
+TEST(StopControllerTest, NoneModeOnlyStopsOnSequences) {
+    auto out = run(CompletionRequest{}, {"a;\n", "}\n", "b"});
+    EXPECT_TRUE(out.stop_reason.empty());
+    EXPECT_EQ(out.content, "a;\n}\nb");
+}
+
+// ============================================================================
+// Grammar selection
+// ============================================================================
+
+TEST(GrammarTest, SelectedByStopMode) {
+    EXPECT_STREQ(grammars::for_stop_mode(StopMode::LINE), grammars::SINGLE_LINE);
+    EXPECT_STREQ(grammars::for_stop_mode(StopMode::BLOCK), grammars::NO_CODE_FENCE);
+    EXPECT_STREQ(grammars::for_stop_mode(StopMode::NONE), "");
+}
+
+TEST(GrammarTest, RulesStartAtRoot) {
+    for (const char* grammar : {grammars::SINGLE_LINE, grammars::NO_CODE_FENCE}) {
+        EXPECT_EQ(std::string(grammar).rfind("root ::= ", 0), 0u) << grammar;
+    }
+}
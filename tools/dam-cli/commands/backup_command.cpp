@@ -0,0 +1,52 @@
+#include "backup_command.hpp"
+
+namespace dam::cli {
+
+void BackupCommand::setup(CLI::App& app) {
+    app.add_option("directory", directory_, "Backup directory")
+        ->required()
+        ->type_name("<dir>");
+
+    app.add_flag("-i,--incremental", incremental_,
+                 "Only copy pages changed since the backup in <dir>");
+    app.add_flag("--restore", restore_,
+                 "Replace the store with the backup in <dir> (consumes the backup)");
+}
+
+int BackupCommand::execute(CommandContext& ctx) {
+    if (restore_) {
+        ctx.store->close();
+
+        auto result = SnippetStore::restore(directory_, ctx.store_path);
+        if (!result.ok()) {
+            std::cerr << "Error: " << result.error().to_string() << "\n";
+            return result.error().code() == ErrorCode::NOT_FOUND
+                ? DAM_EXIT_NOT_FOUND : DAM_EXIT_IO_ERROR;
+        }
+
+        std::cout << "Restored store from " << directory_ << "\n";
+        return DAM_EXIT_SUCCESS;
+    }
+
+    BackupOptions options;
+    options.incremental = incremental_;
+
+    auto stats = ctx.store->backup(directory_, options);
+    if (!stats.ok()) {
+        std::cerr << "Error: " << stats.error().to_string() << "\n";
+        return DAM_EXIT_IO_ERROR;
+    }
+
+    const auto& s = stats.value();
+    if (incremental_ && !s.incremental) {
+        std::cout << "No earlier backup in " << directory_ << "; made a full backup.\n";
+    }
+    std::cout << (s.incremental ? "Incremental" : "Full") << " backup to " << directory_
+              << ": copied " << s.pages_copied << " of " << s.pages_total << " pages\n";
+    if (ctx.verbose) {
+        std::cout << "Snapshot LSN: " << s.lsn << "\n";
+    }
+    return DAM_EXIT_SUCCESS;
+}
+
+}  // namespace dam::cli
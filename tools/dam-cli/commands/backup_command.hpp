@@ -0,0 +1,27 @@
+#pragma once
+
+#include "command.hpp"
+#include "exit_codes.hpp"
+
+namespace dam::cli {
+
+/**
+ * Back up the store to a directory, or restore it from one.
+ */
+class BackupCommand : public Command {
+public:
+    void setup(CLI::App& app) override;
+    int execute(CommandContext& ctx) override;
+
+    std::string name() const override { return "backup"; }
+    std::string description() const override {
+        return "Back up or restore the store";
+    }
+
+private:
+    std::string directory_;
+    bool incremental_ = false;
+    bool restore_ = false;
+};
+
+}  // namespace dam::cli
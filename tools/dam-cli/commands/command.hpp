@@ -14,7 +14,7 @@ namespace dam::cli {
  * Contains shared resources like the snippet store.
  */
 struct CommandContext {
-    SnippetStore* store = nullptr;
+    SnippetStore* store = nullptr;  // nullptr if the command does not need it
     bool verbose = false;
     std::filesystem::path store_path;
 };
@@ -56,6 +56,11 @@ public:
      * Get a brief description for help text.
      */
     virtual std::string description() const = 0;
+
+    /**
+     * Whether execute() needs ctx.store opened first.
+     */
+    virtual bool needs_store() const { return true; }
 };
 
 // Helper functions used by multiple commands
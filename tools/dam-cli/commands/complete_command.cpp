@@ -0,0 +1,48 @@
+#include "complete_command.hpp"
+
+#include <dam/completion_index.hpp>
+
+#include <cstdio>
+
+namespace dam::cli {
+
+void CompleteCommand::setup(CLI::App& app) {
+    app.add_option("prefix", prefix_, "Prefix to complete")
+        ->type_name("<prefix>");
+
+    app.add_flag("--tags", tags_, "Complete tags instead of snippet names");
+
+    app.add_option("-n,--limit", limit_, "Maximum matches (0 = all)")
+        ->type_name("<n>");
+}
+
+int CompleteCommand::execute(CommandContext& ctx) {
+    auto path = ctx.store_path / CompletionIndex::FILE_NAME;
+    auto index = CompletionIndex::open(path);
+    if (!index.ok()) {
+        // Missing or unreadable: opening and closing the store rebuilds it
+        auto store = open_store(ctx.store_path, ctx.verbose);
+        if (!store) {
+            return DAM_EXIT_IO_ERROR;
+        }
+        store->close();
+        index = CompletionIndex::open(path);
+        if (!index.ok()) {
+            if (ctx.verbose) {
+                std::cerr << "Error: " << index.error().to_string() << "\n";
+            }
+            return DAM_EXIT_IO_ERROR;
+        }
+    }
+
+    auto kind = tags_ ? CompletionIndex::Kind::TAGS : CompletionIndex::Kind::NAMES;
+    std::string out;
+    for (std::string_view match : index.value()->complete(kind, prefix_, limit_)) {
+        out.append(match);
+        out += '\n';
+    }
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    return DAM_EXIT_SUCCESS;
+}
+
+}  // namespace dam::cli
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "command.hpp"
+#include "exit_codes.hpp"
+
+namespace dam::cli {
+
+/**
+ * Complete snippet names or tags for shell completion scripts.
+ *
+ * Answers from the store's completion index (dam.complete) without opening
+ * the database, and prints one match per line.
+ */
+class CompleteCommand : public Command {
+public:
+    void setup(CLI::App& app) override;
+    int execute(CommandContext& ctx) override;
+
+    std::string name() const override { return "__complete"; }
+    std::string description() const override {
+        return "Complete snippet names or tags";
+    }
+    bool needs_store() const override { return false; }
+
+private:
+    std::string prefix_;
+    bool tags_ = false;
+    size_t limit_ = 0;
+};
+
+}  // namespace dam::cli
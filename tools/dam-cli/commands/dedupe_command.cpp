@@ -0,0 +1,77 @@
+#include "dedupe_command.hpp"
+#include <iomanip>
+
+namespace dam::cli {
+
+namespace {
+
+std::string snippet_name(SnippetStore* store, SnippetId id) {
+    auto snippet = store->get(id);
+    return snippet.ok() ? snippet.value().name : "#" + std::to_string(id);
+}
+
+}  // namespace
+
+void DedupeCommand::setup(CLI::App& app) {
+    app.add_option("id_or_name", id_or_name_, "Only show snippets similar to this one")
+        ->type_name("<id|name>");
+
+    app.add_option("-t,--threshold", threshold_, "Minimum similarity (0.0 - 1.0)")
+        ->check(CLI::Range(0.0f, 1.0f));
+}
+
+int DedupeCommand::execute(CommandContext& ctx) {
+    // Similar snippets for one snippet
+    if (!id_or_name_.empty()) {
+        auto snippet_result = resolve_snippet(ctx.store, id_or_name_);
+        if (!snippet_result.ok()) {
+            std::cerr << "Error: Snippet not found: " << id_or_name_ << "\n";
+            return DAM_EXIT_NOT_FOUND;
+        }
+
+        auto matches = ctx.store->find_similar(snippet_result.value().id, threshold_, 50);
+        if (!matches.ok()) {
+            std::cerr << "Error: " << matches.error().to_string() << "\n";
+            return DAM_EXIT_IO_ERROR;
+        }
+        if (matches.value().empty()) {
+            std::cout << "No similar snippets found.\n";
+            return DAM_EXIT_SUCCESS;
+        }
+
+        for (const auto& match : matches.value()) {
+            std::cout << std::fixed << std::setprecision(2) << match.similarity << "  "
+                      << match.id << "  " << snippet_name(ctx.store, match.id) << "\n";
+        }
+        return DAM_EXIT_SUCCESS;
+    }
+
+    // All near-duplicate pairs
+    auto pairs = ctx.store->find_near_duplicates(threshold_);
+    if (!pairs.ok()) {
+        std::cerr << "Error: " << pairs.error().to_string() << "\n";
+        return DAM_EXIT_IO_ERROR;
+    }
+    if (pairs.value().empty()) {
+        std::cout << "No near-duplicate snippets found.\n";
+        return DAM_EXIT_SUCCESS;
+    }
+
+    std::cout << std::left
+              << std::setw(8) << "SIM"
+              << std::setw(32) << "SNIPPET"
+              << "DUPLICATE\n";
+    std::cout << std::string(72, '-') << "\n";
+
+    for (const auto& pair : pairs.value()) {
+        std::cout << std::left << std::fixed << std::setprecision(2)
+                  << std::setw(8) << pair.similarity
+                  << std::setw(32) << truncate(snippet_name(ctx.store, pair.first), 31)
+                  << snippet_name(ctx.store, pair.second) << "\n";
+    }
+
+    std::cout << "\n" << pairs.value().size() << " pair(s)\n";
+    return DAM_EXIT_SUCCESS;
+}
+
+}  // namespace dam::cli
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "command.hpp"
+#include "exit_codes.hpp"
+
+namespace dam::cli {
+
+/**
+ * Find near-duplicate snippets, across the store or for one snippet.
+ */
+class DedupeCommand : public Command {
+public:
+    void setup(CLI::App& app) override;
+    int execute(CommandContext& ctx) override;
+
+    std::string name() const override { return "dedupe"; }
+    std::string description() const override {
+        return "Find near-duplicate snippets";
+    }
+
+private:
+    std::string id_or_name_;
+    float threshold_ = 0.9f;
+};
+
+}  // namespace dam::cli
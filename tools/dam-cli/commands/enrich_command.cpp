@@ -0,0 +1,93 @@
+#include "enrich_command.hpp"
+
+#ifdef DAM_ENABLE_LLM
+#include <dam/llm/enrichment.hpp>
+#include <dam/llm/error_messages.hpp>
+#endif
+
+#include <chrono>
+#include <thread>
+
+namespace dam::cli {
+
+void EnrichCommand::setup(CLI::App& app) {
+    app.add_flag("--no-descriptions", no_descriptions_, "Leave descriptions alone");
+    app.add_flag("--no-tags", no_tags_, "Leave tags alone");
+
+    app.add_option("--duty", duty_, "Fraction of the time spent generating (0-1]")
+        ->type_name("<fraction>")
+        ->check(CLI::Range(0.01, 1.0));
+}
+
+int EnrichCommand::execute(CommandContext& ctx) {
+#ifdef DAM_ENABLE_LLM
+    if (no_descriptions_ && no_tags_) {
+        std::cerr << "Error: Nothing to do with both --no-descriptions and --no-tags.\n";
+        return DAM_EXIT_USER_ERROR;
+    }
+
+    auto created = llm::LLMFactory::create_with_discovery();
+    if (!created.ok()) {
+        if (created.error_code() == ErrorCode::OLLAMA_NOT_RUNNING) {
+            std::cerr << llm::ErrorMessages::ollama_not_running() << "\n";
+        } else if (created.error_code() == ErrorCode::MODEL_NOT_FOUND) {
+            std::cerr << llm::ErrorMessages::no_models_installed() << "\n";
+        } else {
+            std::cerr << "Error: " << created.error().message() << "\n";
+        }
+        return DAM_EXIT_IO_ERROR;
+    }
+    auto router = std::move(created.value().router);
+    if (!router) {
+        std::cerr << "Error: Several models are installed; set DAM_OLLAMA_MODEL to choose one.\n";
+        return DAM_EXIT_USER_ERROR;
+    }
+
+    // Nothing interactive runs in this process, so only the duty cycle throttles
+    llm::EnrichmentOptions options;
+    options.describe = !no_descriptions_;
+    options.tag = !no_tags_;
+    options.max_duty_cycle = duty_;
+    options.idle_delay = std::chrono::milliseconds(0);
+
+    llm::EnrichmentWorker worker(*ctx.store, *router, options);
+    auto started = worker.start();
+    if (!started.ok()) {
+        std::cerr << "Error: " << started.error().to_string() << "\n";
+        return DAM_EXIT_IO_ERROR;
+    }
+
+    do {
+        auto polled = worker.poll();
+        if (!polled.ok()) {
+            std::cerr << "Error: " << polled.error().to_string() << "\n";
+            (void)worker.stop();
+            return DAM_EXIT_IO_ERROR;
+        }
+        if (ctx.verbose && *polled > 0) {
+            std::cerr << "Updated " << *polled << " snippet(s)\n";
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    } while (worker.busy());
+
+    auto stopped = worker.stop();
+    if (!stopped.ok()) {
+        std::cerr << "Error: " << stopped.error().to_string() << "\n";
+        return DAM_EXIT_IO_ERROR;
+    }
+
+    auto stats = worker.stats();
+    std::cout << "Enriched " << stats.updated << " snippet(s)";
+    if (stats.from_cache > 0) std::cout << ", " << stats.from_cache << " from cache";
+    if (stats.failed > 0) std::cout << ", " << stats.failed << " failed";
+    std::cout << ".\n";
+    return stats.failed == 0 ? DAM_EXIT_SUCCESS : DAM_EXIT_IO_ERROR;
+#else
+    (void)ctx;
+    std::cerr << "Error: Enrichment not available (compiled without LLM support).\n";
+    std::cerr << "Rebuild with -DDAM_ENABLE_LLM=ON to enable.\n";
+    return DAM_EXIT_USER_ERROR;
+#endif
+}
+
+}  // namespace dam::cli
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "command.hpp"
+#include "exit_codes.hpp"
+
+namespace dam::cli {
+
+/**
+ * Fill in missing snippet descriptions and tags with an LLM.
+ *
+ * Runs the store's enrichment worker until every snippet lacking a
+ * description or tags has been tried once. Fields the user filled in are
+ * never changed, and results are cached by content (enrichment.cache)
+ * so unchanged snippets are not sent to the model again.
+ */
+class EnrichCommand : public Command {
+public:
+    void setup(CLI::App& app) override;
+    int execute(CommandContext& ctx) override;
+
+    std::string name() const override { return "enrich"; }
+    std::string description() const override {
+        return "Generate missing descriptions and tags with an LLM";
+    }
+
+private:
+    bool no_descriptions_ = false;
+    bool no_tags_ = false;
+    double duty_ = 0.25;
+};
+
+}  // namespace dam::cli
@@ -0,0 +1,327 @@
+#include "generate_command.hpp"
+
+#ifdef DAM_ENABLE_LLM
+#include <dam/llm/batch_journal.hpp>
+#include <dam/llm/error_messages.hpp>
+#include <dam/llm/router.hpp>
+#include <nlohmann/json.hpp>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+namespace dam::cli {
+
+#ifdef DAM_ENABLE_LLM
+
+namespace {
+
+using json = nlohmann::json;
+
+enum class JobKind { CREATE, DESCRIBE, TAGS, DOCSTRING };
+
+struct Job {
+    std::string key;
+    JobKind kind = JobKind::CREATE;
+    SnippetId target = INVALID_SNIPPET_ID;
+    std::string name;
+    std::string language;
+    std::vector<std::string> tags;
+};
+
+std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+// Models sometimes wrap code in a markdown fence despite the prompt
+std::string strip_code_fence(const std::string& text) {
+    std::string body = trim(text);
+    if (body.rfind("```", 0) != 0) return body;
+
+    size_t first_newline = body.find('\n');
+    size_t closing = body.rfind("```");
+    if (first_newline == std::string::npos || closing <= first_newline) return body;
+    return trim(body.substr(first_newline + 1, closing - first_newline - 1));
+}
+
+std::vector<std::string> parse_tags(const std::string& text) {
+    std::vector<std::string> tags;
+    std::string tag;
+    auto flush = [&]() {
+        std::string t = trim(tag);
+        tag.clear();
+        if (!t.empty() && t[0] == '#') t.erase(0, 1);
+        if (!t.empty() && std::find(tags.begin(), tags.end(), t) == tags.end()) {
+            tags.push_back(t);
+        }
+    };
+    for (char c : text) {
+        if (c == ',' || c == '\n') {
+            flush();
+        } else {
+            tag += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    flush();
+    return tags;
+}
+
+std::string job_string(const json& j, const char* field) {
+    if (!j.contains(field)) return "";
+    const auto& value = j[field];
+    return value.is_string() ? value.get<std::string>() : value.dump();
+}
+
+// Build a job and its request from one JSONL line
+Result<std::pair<Job, llm::CompletionRequest>> parse_job(
+    SnippetStore* store, const std::string& line, size_t line_number) {
+
+    json j = json::parse(line, nullptr, false);
+    if (j.is_discarded() || !j.is_object()) {
+        return Error(ErrorCode::INVALID_ARGUMENT, "not a JSON object");
+    }
+
+    Job job;
+    job.key = j.contains("id") ? job_string(j, "id") : std::to_string(line_number);
+
+    llm::CompletionRequest request;
+    request.temperature = 0.3f;
+
+    if (j.contains("snippet")) {
+        std::string task = job_string(j, "task");
+        if (task == "describe") {
+            job.kind = JobKind::DESCRIBE;
+            request.system_prompt = llm::prompts::DESCRIBE_SNIPPET;
+            request.max_tokens = 96;
+        } else if (task == "tags") {
+            job.kind = JobKind::TAGS;
+            request.system_prompt = llm::prompts::SUGGEST_TAGS;
+            request.max_tokens = 48;
+        } else if (task == "docstring") {
+            job.kind = JobKind::DOCSTRING;
+            request.system_prompt = llm::prompts::ADD_DOCSTRING;
+            request.max_tokens = 2048;
+        } else {
+            return Error(ErrorCode::INVALID_ARGUMENT,
+                "unknown task '" + task + "' (describe, tags or docstring)");
+        }
+
+        auto snippet = resolve_snippet(store, job_string(j, "snippet"));
+        if (!snippet.ok()) {
+            return snippet.error();
+        }
+        job.target = snippet->id;
+
+        std::ostringstream msg;
+        if (!snippet->language.empty()) {
+            msg << "Language: " << snippet->language << "\n";
+        }
+        msg << "Name: " << snippet->name << "\n\n" << snippet->content;
+        request.messages = {llm::Message::user(msg.str())};
+    } else {
+        job.name = job_string(j, "name");
+        std::string prompt = job_string(j, "prompt");
+        if (job.name.empty() || prompt.empty()) {
+            return Error(ErrorCode::INVALID_ARGUMENT,
+                "expected \"name\" and \"prompt\", or \"snippet\" and \"task\"");
+        }
+        job.language = job_string(j, "language");
+        if (j.contains("tags") && j["tags"].is_array()) {
+            for (const auto& tag : j["tags"]) {
+                if (tag.is_string()) job.tags.push_back(tag.get<std::string>());
+            }
+        }
+
+        std::ostringstream msg;
+        if (!job.language.empty()) {
+            msg << "Write this in " << job.language << ":\n\n";
+        }
+        msg << prompt;
+        request.system_prompt = llm::prompts::NL_TO_CODE;
+        request.messages = {llm::Message::user(msg.str())};
+        request.max_tokens = 1024;
+    }
+
+    return std::make_pair(std::move(job), std::move(request));
+}
+
+// Apply a finished job to the store
+Result<void> write_back(SnippetStore* store, const Job& job, const std::string& output) {
+    if (job.kind == JobKind::CREATE) {
+        std::string content = strip_code_fence(output);
+        if (content.empty()) {
+            return Error(ErrorCode::INVALID_ARGUMENT, "empty response");
+        }
+        auto added = store->add(content, job.name, job.tags, job.language);
+        if (!added.ok()) {
+            return added.error();
+        }
+        return Ok();
+    }
+
+    if (job.kind == JobKind::TAGS) {
+        for (const auto& tag : parse_tags(output)) {
+            auto tagged = store->add_tag(job.target, tag);
+            if (!tagged.ok()) {
+                return tagged;
+            }
+        }
+        return Ok();
+    }
+
+    auto snippet = store->get(job.target);
+    if (!snippet.ok()) {
+        return snippet.error();
+    }
+    auto& s = snippet.value();
+    if (job.kind == JobKind::DESCRIBE) {
+        std::string text = trim(output);
+        text = trim(text.substr(0, text.find('\n')));
+        if (text.empty()) {
+            return Error(ErrorCode::INVALID_ARGUMENT, "empty response");
+        }
+        return store->update(s.id, s.content, s.name, s.tags, s.language, text);
+    }
+
+    std::string content = strip_code_fence(output);
+    if (content.empty()) {
+        return Error(ErrorCode::INVALID_ARGUMENT, "empty response");
+    }
+    return store->update(s.id, content, s.name, s.tags, s.language, s.description);
+}
+
+}  // namespace
+
+#endif  // DAM_ENABLE_LLM
+
+void GenerateCommand::setup(CLI::App& app) {
+    app.add_option("--batch", batch_file_, "JSONL file of generation jobs")
+        ->required()
+        ->type_name("<jsonl>");
+
+    app.add_option("--journal", journal_file_,
+                   "Progress journal (default: <jsonl>.progress)")
+        ->type_name("<path>");
+
+    app.add_option("-j,--jobs", jobs_,
+                   "Concurrent requests per provider that serves them (local models take one)")
+        ->type_name("<n>")
+        ->check(CLI::PositiveNumber);
+
+    app.add_option("--attempts", attempts_, "Tries per job on rate limits and network errors")
+        ->type_name("<n>")
+        ->check(CLI::PositiveNumber);
+}
+
+int GenerateCommand::execute(CommandContext& ctx) {
+#ifdef DAM_ENABLE_LLM
+    std::ifstream input(batch_file_);
+    if (!input) {
+        std::cerr << "Error: Cannot read " << batch_file_ << "\n";
+        return DAM_EXIT_USER_ERROR;
+    }
+
+    std::string journal_path = journal_file_.empty() ? batch_file_ + ".progress" : journal_file_;
+    auto journal = llm::BatchJournal::open(journal_path);
+    if (!journal.ok()) {
+        std::cerr << "Error: " << journal.error().message() << "\n";
+        return DAM_EXIT_IO_ERROR;
+    }
+
+    // Parse every job up front so bad lines are reported before any work
+    std::vector<Job> jobs;
+    std::vector<llm::CompletionRequest> requests;
+    size_t skipped = 0;
+    size_t failed = 0;
+    std::string line;
+    for (size_t line_number = 1; std::getline(input, line); ++line_number) {
+        if (trim(line).empty()) continue;
+
+        auto parsed = parse_job(ctx.store, line, line_number);
+        if (!parsed.ok()) {
+            std::cerr << batch_file_ << ":" << line_number << ": "
+                      << parsed.error().message() << "\n";
+            ++failed;
+            continue;
+        }
+        if (journal->done(parsed->first.key)) {
+            ++skipped;
+            continue;
+        }
+        jobs.push_back(std::move(parsed->first));
+        requests.push_back(std::move(parsed->second));
+    }
+
+    if (jobs.empty()) {
+        std::cout << "Nothing to do (" << skipped << " already done).\n";
+        return failed == 0 ? DAM_EXIT_SUCCESS : DAM_EXIT_USER_ERROR;
+    }
+
+    // Non-interactive: take the recommended model when several exist
+    auto created = llm::LLMFactory::create_with_discovery();
+    if (!created.ok()) {
+        if (created.error_code() == ErrorCode::OLLAMA_NOT_RUNNING) {
+            std::cerr << llm::ErrorMessages::ollama_not_running() << "\n";
+        } else if (created.error_code() == ErrorCode::MODEL_NOT_FOUND) {
+            std::cerr << llm::ErrorMessages::no_models_installed() << "\n";
+        } else {
+            std::cerr << "Error: " << created.error().message() << "\n";
+        }
+        return DAM_EXIT_IO_ERROR;
+    }
+    auto router = std::move(created.value().router);
+    if (!router) {
+        std::cerr << "Error: Several models are installed; set DAM_OLLAMA_MODEL to choose one.\n";
+        return DAM_EXIT_USER_ERROR;
+    }
+
+    size_t finished = 0;
+    size_t succeeded = 0;
+    llm::BatchOptions options;
+    options.max_concurrency_per_provider = jobs_;
+    options.max_attempts = attempts_;
+    options.on_result = [&](size_t index, const Result<llm::CompletionResult>& result) {
+        const Job& job = jobs[index];
+        ++finished;
+
+        Result<void> written = result.ok()
+            ? write_back(ctx.store, job, result->content)
+            : Result<void>(result.error());
+
+        std::cerr << "[" << finished << "/" << jobs.size() << "] " << job.key << ": ";
+        if (!written.ok()) {
+            std::cerr << written.error().to_string() << "\n";
+            ++failed;
+            return;
+        }
+        std::cerr << "ok\n";
+        ++succeeded;
+
+        // Journal only once the result is in the store
+        auto recorded = journal->record(job.key);
+        if (!recorded.ok()) {
+            std::cerr << "Warning: " << recorded.error().message() << "\n";
+        }
+    };
+
+    router->complete_batch(requests, options);
+
+    std::cout << "Completed " << succeeded << " job(s)";
+    if (skipped > 0) std::cout << ", skipped " << skipped << " already done";
+    if (failed > 0) std::cout << ", " << failed << " failed";
+    std::cout << ".\n";
+    return failed == 0 ? DAM_EXIT_SUCCESS : DAM_EXIT_IO_ERROR;
+#else
+    (void)ctx;
+    std::cerr << "Error: Batch generation not available (compiled without LLM support).\n";
+    std::cerr << "Rebuild with -DDAM_ENABLE_LLM=ON to enable.\n";
+    return DAM_EXIT_USER_ERROR;
+#endif
+}
+
+}  // namespace dam::cli
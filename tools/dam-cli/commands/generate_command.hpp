@@ -0,0 +1,41 @@
+#pragma once
+
+#include "command.hpp"
+#include "exit_codes.hpp"
+
+#include <string>
+
+namespace dam::cli {
+
+/**
+ * Generate or annotate snippets in bulk with an LLM.
+ *
+ * --batch reads a JSONL file with one job per line:
+ *   {"name": "...", "prompt": "...", "language": "...", "tags": [...]}
+ *       Generate a new snippet from a description
+ *   {"snippet": <id|name>, "task": "describe" | "tags" | "docstring"}
+ *       Annotate an existing snippet
+ * An optional "id" gives a job a stable key (the line number otherwise).
+ *
+ * Results are written to the store as they arrive, and each finished job
+ * is appended to a journal, so an interrupted batch resumes where it
+ * stopped when run again.
+ */
+class GenerateCommand : public Command {
+public:
+    void setup(CLI::App& app) override;
+    int execute(CommandContext& ctx) override;
+
+    std::string name() const override { return "generate"; }
+    std::string description() const override {
+        return "Generate or annotate snippets in bulk with an LLM";
+    }
+
+private:
+    std::string batch_file_;
+    std::string journal_file_;
+    int jobs_ = 1;
+    int attempts_ = 4;
+};
+
+}  // namespace dam::cli
@@ -1,16 +1,50 @@
 #include "get_command.hpp"
 
+#include <cerrno>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+#include <unistd.h>
+#endif
+
 namespace dam::cli {
 
+namespace {
+
+// Write a chunk to stdout with no stream buffering in between
+bool write_stdout(std::string_view chunk) {
+#if defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+    while (!chunk.empty()) {
+        ssize_t n = ::write(STDOUT_FILENO, chunk.data(), chunk.size());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        chunk.remove_prefix(static_cast<size_t>(n));
+    }
+    return true;
+#else
+    return std::fwrite(chunk.data(), 1, chunk.size(), stdout) == chunk.size();
+#endif
+}
+
+}  // namespace
+
 void GetCommand::setup(CLI::App& app) {
     app.add_option("id_or_name", id_or_name_, "Snippet ID or name")
         ->required()
         ->type_name("<id|name>");
 
     app.add_flag("--raw", raw_, "Output content only, no headers");
+    app.add_option("-r,--revision", revision_, "Show an earlier revision (see 'dam log')")
+        ->type_name("<rev>");
 }
 
 int GetCommand::execute(CommandContext& ctx) {
+    if (raw_ && revision_ == 0) {
+        return write_raw(ctx);
+    }
+
     auto snippet_result = resolve_snippet(ctx.store, id_or_name_);
 
     if (!snippet_result.ok()) {
@@ -18,6 +52,15 @@ int GetCommand::execute(CommandContext& ctx) {
         return DAM_EXIT_NOT_FOUND;
     }
 
+    if (revision_ > 0) {
+        auto revision_result = ctx.store->get_revision(snippet_result.value().id, revision_);
+        if (!revision_result.ok()) {
+            std::cerr << "Error: Revision " << revision_ << " not found: " << id_or_name_ << "\n";
+            return DAM_EXIT_NOT_FOUND;
+        }
+        snippet_result = std::move(revision_result);
+    }
+
     auto& snippet = snippet_result.value();
 
     if (raw_) {
@@ -49,4 +92,31 @@ int GetCommand::execute(CommandContext& ctx) {
     return DAM_EXIT_SUCCESS;
 }
 
+int GetCommand::write_raw(CommandContext& ctx) {
+    // Resolve without decoding the body; it is only read once, below
+    std::optional<SnippetId> id = parse_snippet_id(id_or_name_);
+    auto sink = [](std::string_view chunk) { return write_stdout(chunk); };
+
+    Result<uint64_t> written = Error(ErrorCode::NOT_FOUND, "Snippet not found");
+    if (id.has_value()) {
+        written = ctx.store->read_content(*id, sink);
+    }
+    if (!written.ok() && written.error().code() == ErrorCode::NOT_FOUND) {
+        auto found = ctx.store->find_by_name(id_or_name_);
+        if (found.ok()) {
+            written = ctx.store->read_content(found.value(), sink);
+        }
+    }
+
+    if (!written.ok()) {
+        if (written.error().code() == ErrorCode::NOT_FOUND) {
+            std::cerr << "Error: Snippet not found: " << id_or_name_ << "\n";
+            return DAM_EXIT_NOT_FOUND;
+        }
+        std::cerr << "Error: " << written.error().to_string() << "\n";
+        return DAM_EXIT_IO_ERROR;
+    }
+    return DAM_EXIT_SUCCESS;
+}
+
 }  // namespace dam::cli
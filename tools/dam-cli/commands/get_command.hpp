@@ -21,6 +21,10 @@ public:
 private:
     std::string id_or_name_;
     bool raw_ = false;
+    uint32_t revision_ = 0;
+
+    // Stream the content to stdout without copying it into a stream
+    int write_raw(CommandContext& ctx);
 };
 
 }  // namespace dam::cli
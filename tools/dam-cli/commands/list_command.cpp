@@ -1,52 +1,71 @@
 #include "list_command.hpp"
-#include <iomanip>
+#include "table_writer.hpp"
 
 namespace dam::cli {
 
-void ListCommand::setup(CLI::App& /* app */) {
-    // No options for list command
+void ListCommand::setup(CLI::App& app) {
+    app.add_option("-n,--limit", limit_, "Maximum snippets to list (default: all)")
+        ->type_name("<num>");
+
+    app.add_option("--offset", offset_, "Snippets to skip before listing")
+        ->type_name("<num>");
 }
 
 int ListCommand::execute(CommandContext& ctx) {
-    auto snippets_result = ctx.store->list_all();
-    if (!snippets_result.ok()) {
-        std::cerr << "Error: " << snippets_result.error().to_string() << "\n";
+    // Bodies are only measured, never decoded
+    ScanOptions options;
+    options.with_content = false;
+    options.offset = offset_;
+    options.limit = limit_;
+
+    auto cursor_result = ctx.store->scan(options);
+    if (!cursor_result.ok()) {
+        std::cerr << "Error: " << cursor_result.error().to_string() << "\n";
         return DAM_EXIT_IO_ERROR;
     }
+    auto& cursor = cursor_result.value();
 
-    auto& snippets = snippets_result.value();
-    if (snippets.empty()) {
-        std::cout << "No snippets found.\n";
-        std::cout << "Use 'dam add' to create your first snippet.\n";
+    if (!cursor.next()) {
+        if (offset_ > 0) {
+            std::cout << "No snippets after offset " << offset_ << ".\n";
+        } else {
+            std::cout << "No snippets found.\n";
+            std::cout << "Use 'dam add' to create your first snippet.\n";
+        }
         return DAM_EXIT_SUCCESS;
     }
 
+    TableWriter out;
+
     // Print header
-    std::cout << std::left
-              << std::setw(6) << "ID"
-              << std::setw(25) << "NAME"
-              << std::setw(12) << "LANG"
-              << std::setw(30) << "TAGS"
-              << "SIZE\n";
-    std::cout << std::string(80, '-') << "\n";
-
-    // Print snippets
-    for (const auto& s : snippets) {
+    out.column("ID", 6).column("NAME", 25).column("LANG", 12).column("TAGS", 30).text("SIZE");
+    out.end_row();
+    out.text(std::string(80, '-'));
+    out.end_row();
+
+    // Print snippets as they are read
+    size_t count = 0;
+    do {
+        const auto& s = cursor.snippet();
         std::string tags_str;
         for (size_t i = 0; i < s.tags.size(); ++i) {
             if (i > 0) tags_str += ", ";
             tags_str += s.tags[i];
         }
 
-        std::cout << std::left
-                  << std::setw(6) << s.id
-                  << std::setw(25) << truncate(s.name, 24)
-                  << std::setw(12) << truncate(s.language, 11)
-                  << std::setw(30) << truncate(tags_str, 29)
-                  << s.content.size() << " bytes\n";
-    }
+        out.column(std::to_string(s.id), 6)
+           .column(truncate(s.name, 24), 25)
+           .column(truncate(s.language, 11), 12)
+           .column(truncate(tags_str, 29), 30)
+           .text(std::to_string(cursor.content_size()))
+           .text(" bytes");
+        out.end_row();
+        ++count;
+    } while (out.ok() && cursor.next());
 
-    std::cout << "\n" << snippets.size() << " snippet(s)\n";
+    out.end_row();
+    out.text(std::to_string(count)).text(" snippet(s)");
+    out.end_row();
     return DAM_EXIT_SUCCESS;
 }
 
@@ -6,7 +6,7 @@
 namespace dam::cli {
 
 /**
- * List all snippets in the store.
+ * List snippets in the store, streamed page by page.
  */
 class ListCommand : public Command {
 public:
@@ -17,6 +17,10 @@ public:
     std::string description() const override {
         return "List all snippets";
     }
+
+private:
+    size_t limit_ = 0;   // 0 = no limit
+    size_t offset_ = 0;
 };
 
 }  // namespace dam::cli
@@ -0,0 +1,49 @@
+#include "log_command.hpp"
+#include <ctime>
+#include <iomanip>
+
+namespace dam::cli {
+
+void LogCommand::setup(CLI::App& app) {
+    app.add_option("id_or_name", id_or_name_, "Snippet ID or name")
+        ->required()
+        ->type_name("<id|name>");
+}
+
+int LogCommand::execute(CommandContext& ctx) {
+    auto snippet_result = resolve_snippet(ctx.store, id_or_name_);
+    if (!snippet_result.ok()) {
+        std::cerr << "Error: Snippet not found: " << id_or_name_ << "\n";
+        return DAM_EXIT_NOT_FOUND;
+    }
+
+    auto revisions_result = ctx.store->get_revisions(snippet_result.value().id);
+    if (!revisions_result.ok()) {
+        std::cerr << "Error: " << revisions_result.error().to_string() << "\n";
+        return DAM_EXIT_IO_ERROR;
+    }
+
+    // Newest first, like git log
+    auto& revisions = revisions_result.value();
+    std::cout << std::left
+              << std::setw(6) << "REV"
+              << std::setw(22) << "MODIFIED"
+              << "SIZE\n";
+    std::cout << std::string(40, '-') << "\n";
+
+    for (auto it = revisions.rbegin(); it != revisions.rend(); ++it) {
+        std::time_t t = std::chrono::system_clock::to_time_t(it->modified_at);
+        std::tm tm{};
+        localtime_r(&t, &tm);
+
+        std::cout << std::left
+                  << std::setw(6) << it->number
+                  << std::setw(22) << std::put_time(&tm, "%Y-%m-%d %H:%M:%S")
+                  << it->size << " bytes\n";
+    }
+
+    std::cout << "\nUse 'dam get " << id_or_name_ << " --revision <rev>' to view a revision.\n";
+    return DAM_EXIT_SUCCESS;
+}
+
+}  // namespace dam::cli
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "command.hpp"
+#include "exit_codes.hpp"
+
+namespace dam::cli {
+
+/**
+ * Show the revision history of a snippet.
+ */
+class LogCommand : public Command {
+public:
+    void setup(CLI::App& app) override;
+    int execute(CommandContext& ctx) override;
+
+    std::string name() const override { return "log"; }
+    std::string description() const override {
+        return "Show the revision history of a snippet";
+    }
+
+private:
+    std::string id_or_name_;
+};
+
+}  // namespace dam::cli
@@ -0,0 +1,65 @@
+#include "pack_command.hpp"
+
+namespace dam::cli {
+
+void PackCommand::setup(CLI::App& app) {
+    app.add_option("file", file_, "Pack file")
+        ->required()
+        ->type_name("<file>");
+
+    app.add_flag("--install", install_,
+                 "Copy <file> into the store's packs directory and mount it");
+    app.add_flag("--no-compress", no_compress_, "Store snippet bodies uncompressed");
+}
+
+int PackCommand::execute(CommandContext& ctx) {
+    if (install_) {
+        fs::path dest = ctx.store_path / "packs" / fs::path(file_).filename();
+        dest.replace_extension(".dampack");
+
+        // Copy beside the target and rename, so a mapped older copy stays intact
+        fs::path tmp = dest;
+        tmp += ".tmp";
+        std::error_code ec;
+        fs::create_directories(dest.parent_path(), ec);
+        fs::copy_file(file_, tmp, fs::copy_options::overwrite_existing, ec);
+        if (!ec) {
+            fs::rename(tmp, dest, ec);
+        }
+        if (ec) {
+            std::cerr << "Error: Failed to install pack: " << ec.message() << "\n";
+            return DAM_EXIT_IO_ERROR;
+        }
+
+        // Mount it once so a bad file is reported now rather than on every open
+        auto mounted = ctx.store->mount_pack(dest);
+        if (!mounted.ok()) {
+            fs::remove(dest, ec);
+            std::cerr << "Error: " << mounted.error().to_string() << "\n";
+            return DAM_EXIT_IO_ERROR;
+        }
+
+        std::cout << "Installed " << dest.filename().string() << " ("
+                  << mounted.value() << " snippets)\n";
+        return DAM_EXIT_SUCCESS;
+    }
+
+    PackOptions options;
+    options.compress = !no_compress_;
+
+    auto stats = ctx.store->export_pack(file_, options);
+    if (!stats.ok()) {
+        std::cerr << "Error: " << stats.error().to_string() << "\n";
+        return DAM_EXIT_IO_ERROR;
+    }
+
+    const auto& s = stats.value();
+    std::cout << "Packed " << s.snippets << " snippets into " << file_
+              << " (" << s.bytes << " bytes)\n";
+    if (ctx.verbose) {
+        std::cout << "Terms: " << s.terms << ", trigrams: " << s.trigrams << "\n";
+    }
+    return DAM_EXIT_SUCCESS;
+}
+
+}  // namespace dam::cli
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "command.hpp"
+#include "exit_codes.hpp"
+
+namespace dam::cli {
+
+/**
+ * Export the store as a read-only pack, or install a pack into the store.
+ */
+class PackCommand : public Command {
+public:
+    void setup(CLI::App& app) override;
+    int execute(CommandContext& ctx) override;
+
+    std::string name() const override { return "pack"; }
+    std::string description() const override {
+        return "Export or install a read-only snippet pack";
+    }
+
+private:
+    std::string file_;
+    bool install_ = false;
+    bool no_compress_ = false;
+};
+
+}  // namespace dam::cli
@@ -114,14 +114,18 @@ int SearchCommand::search_by_content(CommandContext& ctx) {
 }
 
 int SearchCommand::filter_by_metadata(CommandContext& ctx) {
-    std::vector<SnippetMetadata> snippets;
+    ScanOptions options;
+    options.tag = filter_tag_;
+    options.language = filter_lang_;
+    options.with_content = false;
+    options.limit = max_results_;
 
-    if (!filter_tag_.empty()) {
-        auto result = ctx.store->find_by_tag(filter_tag_);
-        if (result.ok()) snippets = result.value();
-    } else if (!filter_lang_.empty()) {
-        auto result = ctx.store->find_by_language(filter_lang_);
-        if (result.ok()) snippets = result.value();
+    std::vector<SnippetMetadata> snippets;
+    auto cursor = ctx.store->scan(options);
+    if (cursor.ok()) {
+        while (cursor.value().next()) {
+            snippets.push_back(cursor.value().snippet());
+        }
     }
 
     if (snippets.empty()) {
@@ -132,11 +136,6 @@ int SearchCommand::filter_by_metadata(CommandContext& ctx) {
         return DAM_EXIT_SUCCESS;
     }
 
-    // Limit results
-    if (snippets.size() > max_results_) {
-        snippets.resize(max_results_);
-    }
-
     print_results(snippets);
     return DAM_EXIT_SUCCESS;
 }
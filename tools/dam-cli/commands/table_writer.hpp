@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace dam::cli {
+
+/**
+ * Buffered writer for row-oriented command output.
+ *
+ * Rows are assembled in one buffer and written to stdout with fwrite
+ * whenever it fills, rather than formatting every field through
+ * std::cout. When a write fails (say, the reader of a pipe has exited),
+ * ok() turns false so the caller can stop producing rows.
+ */
+class TableWriter {
+public:
+    explicit TableWriter(size_t capacity = 64 * 1024)
+        : capacity_(capacity) {
+        std::cout.flush();  // Keep earlier std::cout output in order
+        buffer_.reserve(capacity_);
+    }
+
+    ~TableWriter() { flush(); }
+
+    TableWriter(const TableWriter&) = delete;
+    TableWriter& operator=(const TableWriter&) = delete;
+
+    /**
+     * Append text, padded with spaces to a column width.
+     */
+    TableWriter& column(std::string_view text, size_t width) {
+        buffer_ += text;
+        if (text.size() < width) {
+            buffer_.append(width - text.size(), ' ');
+        }
+        return *this;
+    }
+
+    /**
+     * Append text as-is.
+     */
+    TableWriter& text(std::string_view text) {
+        buffer_ += text;
+        return *this;
+    }
+
+    /**
+     * Finish a row, writing the buffer out if it is full.
+     */
+    void end_row() {
+        buffer_ += '\n';
+        if (buffer_.size() >= capacity_) {
+            flush();
+        }
+    }
+
+    /**
+     * Write out everything buffered so far.
+     */
+    bool flush() {
+        if (ok_ && !buffer_.empty()) {
+            ok_ = std::fwrite(buffer_.data(), 1, buffer_.size(), stdout) == buffer_.size() &&
+                  std::fflush(stdout) == 0;
+        }
+        buffer_.clear();
+        return ok_;
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    size_t capacity_;
+    std::string buffer_;
+    bool ok_ = true;
+};
+
+}  // namespace dam::cli
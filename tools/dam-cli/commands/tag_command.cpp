@@ -9,9 +9,18 @@ void TagCommand::setup(CLI::App& app) {
 
     app.add_option("operations", operations_, "Tag operations (+tag to add, -tag to remove)")
         ->type_name("<+tag|-tag>...");
+
+    app.add_option("--where", where_,
+                   "Apply the operations to every snippet matching a query "
+                   "(tag:<tag> lang:<language> id:<id> text)")
+        ->type_name("<query>");
 }
 
 int TagCommand::execute(CommandContext& ctx) {
+    if (!where_.empty()) {
+        return retag_matching(ctx);
+    }
+
     // No arguments: list all tags
     if (id_or_name_.empty()) {
         return list_all_tags(ctx);
@@ -21,6 +30,7 @@ int TagCommand::execute(CommandContext& ctx) {
     if (operations_.empty()) {
         std::cerr << "Usage: dam tag              # list all tags\n";
         std::cerr << "       dam tag <id> +tag... # add/remove tags\n";
+        std::cerr << "       dam tag --where <query> -- +tag... -tag...\n";
         std::cerr << "  +tag  Add tag\n";
         std::cerr << "  -tag  Remove tag\n";
         return DAM_EXIT_USER_ERROR;
@@ -94,4 +104,45 @@ int TagCommand::modify_tags(CommandContext& ctx) {
     return DAM_EXIT_SUCCESS;
 }
 
+int TagCommand::retag_matching(CommandContext& ctx) {
+    // Without a snippet, the first positional is already an operation
+    std::vector<std::string> operations = operations_;
+    if (!id_or_name_.empty()) {
+        operations.insert(operations.begin(), id_or_name_);
+    }
+
+    std::vector<std::string> add_tags;
+    std::vector<std::string> remove_tags;
+    for (const auto& op : operations) {
+        if (op.size() > 1 && op[0] == '+') {
+            add_tags.push_back(op.substr(1));
+        } else if (op.size() > 1 && op[0] == '-') {
+            remove_tags.push_back(op.substr(1));
+        } else {
+            std::cerr << "Error: Invalid tag operation '" << op << "' (use +tag or -tag)\n";
+            return DAM_EXIT_USER_ERROR;
+        }
+    }
+    if (add_tags.empty() && remove_tags.empty()) {
+        std::cerr << "Error: No tag operations given\n";
+        return DAM_EXIT_USER_ERROR;
+    }
+
+    auto selector = SnippetSelector::parse(where_);
+    if (!selector.ok()) {
+        std::cerr << "Error: " << selector.error().message() << "\n";
+        return DAM_EXIT_USER_ERROR;
+    }
+
+    auto changed = ctx.store->retag(selector.value(), add_tags, remove_tags);
+    if (!changed.ok()) {
+        std::cerr << "Error: " << changed.error().to_string() << "\n";
+        return changed.error().code() == ErrorCode::INVALID_ARGUMENT
+            ? DAM_EXIT_USER_ERROR : DAM_EXIT_IO_ERROR;
+    }
+
+    std::cout << "Retagged " << changed.value() << " snippet(s)\n";
+    return DAM_EXIT_SUCCESS;
+}
+
 }  // namespace dam::cli
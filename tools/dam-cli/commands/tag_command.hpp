@@ -10,6 +10,7 @@ namespace dam::cli {
  * Manage tags on snippets.
  * Without args: list all tags with counts.
  * With args: add/remove tags from a snippet.
+ * With --where: add/remove tags on every snippet matching a query.
  */
 class TagCommand : public Command {
 public:
@@ -24,9 +25,11 @@ public:
 private:
     std::string id_or_name_;
     std::vector<std::string> operations_;  // +tag or -tag
+    std::string where_;
 
     int list_all_tags(CommandContext& ctx);
     int modify_tags(CommandContext& ctx);
+    int retag_matching(CommandContext& ctx);
 };
 
 }  // namespace dam::cli
@@ -3,6 +3,7 @@
 #include <dam/language_detector.hpp>
 
 #include <algorithm>
+#include <limits>
 #include <sstream>
 
 namespace dam::cli {
@@ -12,7 +13,6 @@ InteractiveEditor::InteractiveEditor(std::unique_ptr<dam::llm::LLMRouter> router
     : router_(std::move(router))
     , config_(std::move(config))
     , debouncer_(config_.debounce_ms) {
-    lines_.push_back("");
 }
 
 bool InteractiveEditor::is_available() const {
@@ -39,9 +39,10 @@ EditorResult InteractiveEditor::run(const std::string& initial_content) {
     auto [cols, rows] = Terminal::get_size();
     editor_width_ = cols;
     editor_height_ = rows - 3;  // Reserve lines for header and status
+    screen_ = std::make_unique<Screen>(cols, rows);
 
     set_content(initial_content);
-    render();
+    draw_frame();
 
     EditorResult result;
     result.accepted = false;
@@ -53,10 +54,18 @@ EditorResult InteractiveEditor::run(const std::string& initial_content) {
         if (debouncer_.is_pending()) {
             timeout = std::min(timeout, debouncer_.remaining_ms() + 1);
         }
+        if (render_pending_) {
+            timeout = std::min(timeout, frame_wait_ms() + 1);
+        }
 
         auto key_event = terminal_->read_key(timeout);
 
         if (!key_event) {
+            // Timeout - draw a frame deferred by the rate limit
+            if (render_pending_) {
+                render();
+            }
+
             // Timeout - check if we should fetch suggestion
             if (debouncer_.ready() && !fetching_suggestion_ && !suggestion_visible_) {
                 request_suggestion();
@@ -84,7 +93,7 @@ EditorResult InteractiveEditor::run(const std::string& initial_content) {
                         result.accepted = false;
                     } else if (key_event->ch == 'd') {
                         // Ctrl+D - submit if content exists, else cancel
-                        if (!get_content().empty()) {
+                        if (!text_.empty()) {
                             running = false;
                             result.accepted = true;
                         } else {
@@ -179,7 +188,7 @@ EditorResult InteractiveEditor::run(const std::string& initial_content) {
                 break;
 
             case Key::CTRL_D:
-                if (!get_content().empty()) {
+                if (!text_.empty()) {
                     running = false;
                     result.accepted = true;
                 } else {
@@ -200,6 +209,7 @@ EditorResult InteractiveEditor::run(const std::string& initial_content) {
     terminal_->clear_screen();
     terminal_->flush();
     terminal_.reset();
+    screen_.reset();
 
     result.content = get_content();
     result.detected_language = detect_language();
@@ -212,18 +222,15 @@ EditorResult InteractiveEditor::run(const std::string& initial_content) {
 // ============================================================================
 
 void InteractiveEditor::insert_char(char c) {
-    lines_[cursor_row_].insert(cursor_col_, 1, c);
+    mark_edited(cursor_row_);
+    text_.insert(cursor_offset(), c);
     cursor_col_++;
 }
 
 void InteractiveEditor::insert_newline() {
     // Split current line at cursor
-    std::string current = lines_[cursor_row_];
-    std::string before = current.substr(0, cursor_col_);
-    std::string after = current.substr(cursor_col_);
-
-    lines_[cursor_row_] = before;
-    lines_.insert(lines_.begin() + cursor_row_ + 1, after);
+    mark_edited(cursor_row_);
+    text_.insert(cursor_offset(), '\n');
 
     cursor_row_++;
     cursor_col_ = 0;
@@ -233,40 +240,43 @@ void InteractiveEditor::insert_newline() {
 
 void InteractiveEditor::delete_char_backward() {
     if (cursor_col_ > 0) {
-        lines_[cursor_row_].erase(cursor_col_ - 1, 1);
+        mark_edited(cursor_row_);
+        text_.erase(cursor_offset() - 1, 1);
         cursor_col_--;
     } else if (cursor_row_ > 0) {
         // Merge with previous line
-        cursor_col_ = static_cast<int>(lines_[cursor_row_ - 1].length());
-        lines_[cursor_row_ - 1] += lines_[cursor_row_];
-        lines_.erase(lines_.begin() + cursor_row_);
+        cursor_col_ = line_length(cursor_row_ - 1);
         cursor_row_--;
+        mark_edited(cursor_row_);
+        text_.erase(cursor_offset(), 1);
     }
 }
 
 void InteractiveEditor::delete_char_forward() {
-    if (cursor_col_ < static_cast<int>(lines_[cursor_row_].length())) {
-        lines_[cursor_row_].erase(cursor_col_, 1);
-    } else if (cursor_row_ < static_cast<int>(lines_.size()) - 1) {
-        // Merge with next line
-        lines_[cursor_row_] += lines_[cursor_row_ + 1];
-        lines_.erase(lines_.begin() + cursor_row_ + 1);
+    // At the end of a line this removes the newline, merging the next line
+    if (cursor_col_ < line_length(cursor_row_) || cursor_row_ < line_count() - 1) {
+        mark_edited(cursor_row_);
+        text_.erase(cursor_offset(), 1);
     }
 }
 
+void InteractiveEditor::mark_edited(int row) {
+    classifier_dirty_row_ = std::min(classifier_dirty_row_, static_cast<size_t>(row));
+}
+
 void InteractiveEditor::move_cursor_left() {
     if (cursor_col_ > 0) {
         cursor_col_--;
     } else if (cursor_row_ > 0) {
         cursor_row_--;
-        cursor_col_ = static_cast<int>(lines_[cursor_row_].length());
+        cursor_col_ = line_length(cursor_row_);
     }
 }
 
 void InteractiveEditor::move_cursor_right() {
-    if (cursor_col_ < static_cast<int>(lines_[cursor_row_].length())) {
+    if (cursor_col_ < line_length(cursor_row_)) {
         cursor_col_++;
-    } else if (cursor_row_ < static_cast<int>(lines_.size()) - 1) {
+    } else if (cursor_row_ < line_count() - 1) {
         cursor_row_++;
         cursor_col_ = 0;
     }
@@ -275,15 +285,15 @@ void InteractiveEditor::move_cursor_right() {
 void InteractiveEditor::move_cursor_up() {
     if (cursor_row_ > 0) {
         cursor_row_--;
-        cursor_col_ = std::min(cursor_col_, static_cast<int>(lines_[cursor_row_].length()));
+        cursor_col_ = std::min(cursor_col_, line_length(cursor_row_));
         ensure_cursor_visible();
     }
 }
 
 void InteractiveEditor::move_cursor_down() {
-    if (cursor_row_ < static_cast<int>(lines_.size()) - 1) {
+    if (cursor_row_ < line_count() - 1) {
         cursor_row_++;
-        cursor_col_ = std::min(cursor_col_, static_cast<int>(lines_[cursor_row_].length()));
+        cursor_col_ = std::min(cursor_col_, line_length(cursor_row_));
         ensure_cursor_visible();
     }
 }
@@ -293,17 +303,17 @@ void InteractiveEditor::move_to_line_start() {
 }
 
 void InteractiveEditor::move_to_line_end() {
-    cursor_col_ = static_cast<int>(lines_[cursor_row_].length());
+    cursor_col_ = line_length(cursor_row_);
 }
 
 void InteractiveEditor::move_word_left() {
     if (cursor_col_ == 0 && cursor_row_ > 0) {
         cursor_row_--;
-        cursor_col_ = static_cast<int>(lines_[cursor_row_].length());
+        cursor_col_ = line_length(cursor_row_);
         return;
     }
 
-    const std::string& line = lines_[cursor_row_];
+    const std::string line = text_.line(cursor_row_);
 
     // Skip whitespace
     while (cursor_col_ > 0 && std::isspace(line[cursor_col_ - 1])) {
@@ -317,10 +327,10 @@ void InteractiveEditor::move_word_left() {
 }
 
 void InteractiveEditor::move_word_right() {
-    const std::string& line = lines_[cursor_row_];
+    const std::string line = text_.line(cursor_row_);
 
     if (cursor_col_ >= static_cast<int>(line.length())) {
-        if (cursor_row_ < static_cast<int>(lines_.size()) - 1) {
+        if (cursor_row_ < line_count() - 1) {
             cursor_row_++;
             cursor_col_ = 0;
         }
@@ -345,11 +355,19 @@ void InteractiveEditor::move_word_right() {
 void InteractiveEditor::request_suggestion() {
     if (fetching_suggestion_ || !router_) return;
 
-    std::string content = get_content_before_cursor();
+    std::string content(get_content_before_cursor());
     if (content.empty()) return;
 
-    // Classify input
-    last_classification_ = InputClassifier::classify(content, config_.language_hint);
+    // Classify input, rescanning only the lines edited since last time
+    size_t row = static_cast<size_t>(cursor_row_);
+    classifier_.truncate(std::min({classifier_.line_count(), classifier_dirty_row_, row}));
+    while (classifier_.line_count() < row) {
+        classifier_.append_line(text_.line(classifier_.line_count()));
+    }
+    classifier_dirty_row_ = std::numeric_limits<size_t>::max();
+    std::string line = text_.line(row);
+    last_classification_ = classifier_.classify(
+        std::string_view(line).substr(0, static_cast<size_t>(cursor_col_)));
 
     if (last_classification_ == InputType::EMPTY) {
         return;
@@ -359,15 +377,13 @@ void InteractiveEditor::request_suggestion() {
     current_suggestion_.clear();
 
     // Show "thinking" status
-    render_status_bar();
-    terminal_->flush();
+    draw_frame();
 
     // Streaming callback for real-time updates
     dam::llm::StreamCallback callback = [this](const std::string& chunk) -> bool {
         current_suggestion_ += chunk;
         suggestion_visible_ = true;
         render();
-        terminal_->flush();
         return true;  // Continue receiving chunks
     };
 
@@ -425,7 +441,17 @@ void InteractiveEditor::dismiss_suggestion() {
 // ============================================================================
 
 void InteractiveEditor::render() {
-    terminal_->hide_cursor();
+    // Coalesce bursts of input into frames at most max_fps apart
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_frame_) {
+        render_pending_ = true;
+        return;
+    }
+    draw_frame();
+}
+
+void InteractiveEditor::draw_frame() {
+    screen_->clear();
 
     render_header();
     render_content();
@@ -435,43 +461,46 @@ void InteractiveEditor::render() {
     render_status_bar();
     position_cursor();
 
-    terminal_->show_cursor();
-    terminal_->flush();
+    terminal_->write_frame(screen_->diff());
+
+    render_pending_ = false;
+    int fps = std::max(config_.max_fps, 1);
+    next_frame_ = std::chrono::steady_clock::now() +
+                  std::chrono::microseconds(1000000 / fps);
 }
 
-void InteractiveEditor::render_header() {
-    terminal_->move_cursor(0, 0);
-    terminal_->clear_line();
+int InteractiveEditor::frame_wait_ms() const {
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+        next_frame_ - std::chrono::steady_clock::now());
+    return std::max(0, static_cast<int>(wait.count()));
+}
 
+void InteractiveEditor::render_header() {
     std::string title = "Interactive Snippet Editor";
     if (!config_.language_hint.empty()) {
         title += " [" + config_.language_hint + "]";
     }
 
-    terminal_->write_colored(title, colors::BOLD);
-    terminal_->write("\n");
-
-    terminal_->clear_line();
-    terminal_->write_colored(std::string(editor_width_, '-'), colors::DIM);
+    screen_->put(0, 0, title, colors::BOLD);
+    screen_->fill(1, 0, editor_width_, '-', colors::DIM);
 }
 
 void InteractiveEditor::render_content() {
     // Render visible lines
     for (int i = 0; i < editor_height_; ++i) {
         int line_idx = scroll_offset_ + i;
-        terminal_->move_cursor(0, 2 + i);
-        terminal_->clear_line();
+        if (line_idx >= line_count()) {
+            break;
+        }
 
-        if (line_idx < static_cast<int>(lines_.size())) {
-            const std::string& line = lines_[line_idx];
+        const std::string line = text_.line(line_idx);
 
-            // Truncate long lines
-            if (static_cast<int>(line.length()) > editor_width_) {
-                terminal_->write(line.substr(0, editor_width_ - 1));
-                terminal_->write_colored(">", colors::DIM);
-            } else {
-                terminal_->write(line);
-            }
+        // Truncate long lines
+        if (static_cast<int>(line.length()) > editor_width_) {
+            int col = screen_->put(2 + i, 0, std::string_view(line).substr(0, editor_width_ - 1));
+            screen_->put(2 + i, col, ">", colors::DIM);
+        } else {
+            screen_->put(2 + i, 0, line);
         }
     }
 }
@@ -479,12 +508,10 @@ void InteractiveEditor::render_content() {
 void InteractiveEditor::render_suggestion_overlay() {
     if (current_suggestion_.empty()) return;
 
-    // Save position, render suggestion in gray after cursor
+    // Render suggestion in gray after cursor
     int display_row = cursor_row_ - scroll_offset_ + 2;
     int display_col = cursor_col_;
 
-    terminal_->move_cursor(display_col, display_row);
-
     // Get just the first line of suggestion for inline display
     std::string first_line;
     size_t newline_pos = current_suggestion_.find('\n');
@@ -498,17 +525,15 @@ void InteractiveEditor::render_suggestion_overlay() {
     // Truncate to fit screen
     int available = editor_width_ - display_col;
     if (static_cast<int>(first_line.length()) > available) {
-        first_line = first_line.substr(0, available - 3) + "...";
+        first_line = first_line.substr(0, std::max(available - 3, 0)) + "...";
     }
 
-    terminal_->write_colored(first_line, colors::GRAY);
+    screen_->put(display_row, display_col, first_line, colors::GRAY);
 }
 
 void InteractiveEditor::render_status_bar() {
-    terminal_->move_cursor(0, editor_height_ + 2);
-    terminal_->clear_line();
-
-    std::ostringstream status;
+    int row = editor_height_ + 2;
+    int left_end = 0;
 
     // Left side: mode/state info
     if (fetching_suggestion_) {
@@ -520,9 +545,9 @@ void InteractiveEditor::render_status_bar() {
             }
         }
         provider_info += "...]";
-        terminal_->write_colored(provider_info, colors::YELLOW);
+        left_end = screen_->put(row, 0, provider_info, colors::YELLOW);
     } else if (suggestion_visible_) {
-        terminal_->write_colored("[Tab: Accept | Esc: Dismiss]", colors::GREEN);
+        left_end = screen_->put(row, 0, "[Tab: Accept | Esc: Dismiss]", colors::GREEN);
     } else {
         std::string mode;
         switch (last_classification_) {
@@ -542,7 +567,7 @@ void InteractiveEditor::render_status_bar() {
                 mode += " Cloud";
             }
         }
-        terminal_->write_colored(mode, colors::DIM);
+        left_end = screen_->put(row, 0, mode, colors::DIM);
     }
 
     // Right side: position and help
@@ -551,11 +576,8 @@ void InteractiveEditor::render_status_bar() {
     right << " | Ctrl+S: Submit | Ctrl+C: Cancel";
 
     std::string right_str = right.str();
-    int padding = editor_width_ - 40 - static_cast<int>(right_str.length());
-    if (padding > 0) {
-        terminal_->write(std::string(padding, ' '));
-    }
-    terminal_->write_colored(right_str, colors::DIM);
+    int right_col = editor_width_ - static_cast<int>(right_str.length());
+    screen_->put(row, std::max(right_col, left_end), right_str, colors::DIM);
 }
 
 void InteractiveEditor::position_cursor() {
@@ -566,66 +588,34 @@ void InteractiveEditor::position_cursor() {
     display_row = std::max(2, std::min(display_row, editor_height_ + 1));
     display_col = std::max(0, std::min(display_col, editor_width_ - 1));
 
-    terminal_->move_cursor(display_col, display_row);
+    screen_->set_cursor(display_col, display_row);
 }
 
 // ============================================================================
 // Helpers
 // ============================================================================
 
-std::string InteractiveEditor::get_content() const {
-    std::ostringstream ss;
-    for (size_t i = 0; i < lines_.size(); ++i) {
-        ss << lines_[i];
-        if (i < lines_.size() - 1) {
-            ss << '\n';
-        }
-    }
-    return ss.str();
+std::string InteractiveEditor::get_content() {
+    return std::string(text_.view());
 }
 
-std::string InteractiveEditor::get_content_before_cursor() const {
-    std::ostringstream ss;
-    for (int i = 0; i < cursor_row_; ++i) {
-        ss << lines_[i] << '\n';
-    }
-    ss << lines_[cursor_row_].substr(0, cursor_col_);
-    return ss.str();
+std::string_view InteractiveEditor::get_content_before_cursor() {
+    // The gap sits at the cursor while typing, so this is usually free
+    return text_.prefix(cursor_offset());
 }
 
 void InteractiveEditor::set_content(const std::string& content) {
-    lines_.clear();
-
-    if (content.empty()) {
-        lines_.push_back("");
-        cursor_row_ = 0;
-        cursor_col_ = 0;
-        return;
-    }
-
-    std::istringstream ss(content);
-    std::string line;
-    while (std::getline(ss, line)) {
-        lines_.push_back(line);
-    }
-
-    // Handle trailing newline
-    if (!content.empty() && content.back() == '\n') {
-        lines_.push_back("");
-    }
-
-    if (lines_.empty()) {
-        lines_.push_back("");
-    }
+    mark_edited(0);
+    text_.set_text(content);
 
     // Move cursor to end
-    cursor_row_ = static_cast<int>(lines_.size()) - 1;
-    cursor_col_ = static_cast<int>(lines_[cursor_row_].length());
+    cursor_row_ = line_count() - 1;
+    cursor_col_ = line_length(cursor_row_);
 
     ensure_cursor_visible();
 }
 
-std::string InteractiveEditor::detect_language() const {
+std::string InteractiveEditor::detect_language() {
     if (!config_.language_hint.empty()) {
         return config_.language_hint;
     }
@@ -643,7 +633,7 @@ void InteractiveEditor::scroll_up() {
 }
 
 void InteractiveEditor::scroll_down() {
-    int max_scroll = std::max(0, static_cast<int>(lines_.size()) - editor_height_);
+    int max_scroll = std::max(0, line_count() - editor_height_);
     if (scroll_offset_ < max_scroll) {
         scroll_offset_++;
     }
@@ -2,12 +2,16 @@
 
 #include "terminal.hpp"
 #include "debouncer.hpp"
+#include "screen.hpp"
+#include "text_buffer.hpp"
 #include "../llm/input_classifier.hpp"
 
 #include <dam/llm/router.hpp>
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace dam::cli {
@@ -20,6 +24,7 @@ struct InteractiveEditorConfig {
     int suggestion_timeout_ms = 10000;  // Timeout for waiting on suggestions
     bool show_status_bar = true;        // Show status bar with hints
     bool show_line_numbers = false;     // Show line numbers
+    int max_fps = 60;                   // Frame rate limit for redraws
     std::string language_hint;          // Pre-set language for completions
 };
 
@@ -97,7 +102,7 @@ private:
     Debouncer debouncer_;
 
     // Editor state
-    std::vector<std::string> lines_;
+    TextBuffer text_;
     int cursor_row_ = 0;
     int cursor_col_ = 0;
     int scroll_offset_ = 0;       // Vertical scroll for long content
@@ -110,15 +115,21 @@ private:
     // Display state
     int editor_height_ = 0;       // Available lines for editor
     int editor_width_ = 0;        // Available columns
+    std::unique_ptr<Screen> screen_;
+    bool render_pending_ = false; // A frame was deferred by the rate limit
+    std::chrono::steady_clock::time_point next_frame_;
 
     // Input classification
     InputType last_classification_ = InputType::EMPTY;
+    IncrementalClassifier classifier_;
+    size_t classifier_dirty_row_ = 0;  // First row edited since the last sync
 
     // Core editing operations
     void insert_char(char c);
     void insert_newline();
     void delete_char_backward();      // Backspace
     void delete_char_forward();       // Delete key
+    void mark_edited(int row);
     void move_cursor_left();
     void move_cursor_right();
     void move_cursor_up();
@@ -133,8 +144,10 @@ private:
     void accept_suggestion();
     void dismiss_suggestion();
 
-    // Rendering
+    // Rendering (render() is rate-limited; draw_frame() draws now)
     void render();
+    void draw_frame();
+    int frame_wait_ms() const;
     void render_header();
     void render_content();
     void render_suggestion_overlay();
@@ -142,10 +155,13 @@ private:
     void position_cursor();
 
     // Helpers
-    std::string get_content() const;
-    std::string get_content_before_cursor() const;
+    int line_length(int row) const { return static_cast<int>(text_.line_length(row)); }
+    int line_count() const { return static_cast<int>(text_.line_count()); }
+    size_t cursor_offset() const { return text_.offset(cursor_row_, cursor_col_); }
+    std::string get_content();
+    std::string_view get_content_before_cursor();
     void set_content(const std::string& content);
-    std::string detect_language() const;
+    std::string detect_language();
     void ensure_cursor_visible();
 
     // Scroll management
@@ -0,0 +1,268 @@
+#include "screen.hpp"
+#include "terminal.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+namespace dam::cli {
+
+namespace {
+
+void append_move(std::string& out, int col, int row) {
+    out += "\033[";
+    out += std::to_string(row + 1);
+    out += ';';
+    out += std::to_string(col + 1);
+    out += 'H';
+}
+
+struct Range {
+    uint32_t first;
+    uint32_t last;
+};
+
+bool in_ranges(uint32_t cp, const Range* ranges, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (cp >= ranges[i].first && cp <= ranges[i].last) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Combining marks, zero-width spaces and joiners, variation selectors
+constexpr Range ZERO_WIDTH[] = {
+    {0x0300, 0x036F}, {0x1AB0, 0x1AFF}, {0x1DC0, 0x1DFF}, {0x200B, 0x200F},
+    {0x20D0, 0x20FF}, {0xFE00, 0xFE0F}, {0xFE20, 0xFE2F}, {0xE0100, 0xE01EF},
+};
+
+// East Asian wide and fullwidth characters, and the emoji blocks
+// terminals draw two columns wide
+constexpr Range WIDE[] = {
+    {0x1100, 0x115F},   {0x2329, 0x232A},   {0x2E80, 0x303E},   {0x3040, 0xA4CF},
+    {0xAC00, 0xD7A3},   {0xF900, 0xFAFF},   {0xFE10, 0xFE19},   {0xFE30, 0xFE6F},
+    {0xFF00, 0xFF60},   {0xFFE0, 0xFFE6},   {0x1F300, 0x1F64F}, {0x1F900, 0x1F9FF},
+    {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD},
+};
+
+int display_width(uint32_t cp) {
+    if (in_ranges(cp, ZERO_WIDTH, std::size(ZERO_WIDTH))) {
+        return 0;
+    }
+    return in_ranges(cp, WIDE, std::size(WIDE)) ? 2 : 1;
+}
+
+/**
+ * Decode the UTF-8 sequence at the start of text.
+ *
+ * @return Its length in bytes, or 0 if it is malformed or truncated
+ */
+size_t decode(std::string_view text, uint32_t& cp) {
+    auto lead = static_cast<unsigned char>(text[0]);
+    size_t size = lead < 0x80 ? 1 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+    if (size == 0 || size > text.size()) {
+        return 0;
+    }
+    static constexpr unsigned char LEAD_BITS[] = {0, 0x7F, 0x1F, 0x0F, 0x07};
+    static constexpr uint32_t SMALLEST[] = {0, 0, 0x80, 0x800, 0x10000};
+    cp = lead & LEAD_BITS[size];
+    for (size_t i = 1; i < size; ++i) {
+        auto byte = static_cast<unsigned char>(text[i]);
+        if ((byte & 0xC0) != 0x80) {
+            return 0;
+        }
+        cp = (cp << 6) | (byte & 0x3F);
+    }
+    // Overlong forms, surrogates and values past Unicode are malformed
+    if (cp < SMALLEST[size] || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+        return 0;
+    }
+    return size;
+}
+
+}  // namespace
+
+Screen::Screen(int cols, int rows)
+    : cols_(0)
+    , rows_(0) {
+    resize(cols, rows);
+}
+
+void Screen::resize(int cols, int rows) {
+    cols_ = std::max(cols, 1);
+    rows_ = std::max(rows, 1);
+    back_.assign(static_cast<size_t>(cols_) * rows_, Cell{});
+    front_.assign(back_.size(), Cell{});
+    invalidate();
+}
+
+void Screen::invalidate() {
+    // No real cell is empty yet one column wide, so every row is repainted
+    Cell stale;
+    stale.size = 0;
+    std::fill(front_.begin(), front_.end(), stale);
+    shown_cursor_col_ = -1;
+    shown_cursor_row_ = -1;
+}
+
+void Screen::clear() {
+    std::fill(back_.begin(), back_.end(), Cell{});
+}
+
+void Screen::set_cell(int row, int col, const Cell& cell) {
+    Cell& old = back(row, col);
+    Cell blank;
+    blank.style = old.style;
+    if (old.width == 2 && col + 1 < cols_) {
+        back(row, col + 1) = blank;
+    }
+    if (old.width == 0 && cell.width != 0 && col > 0) {
+        back(row, col - 1) = blank;
+    }
+    old = cell;
+}
+
+int Screen::put(int row, int col, std::string_view text, const char* style) {
+    if (row < 0 || row >= rows_) {
+        return col;
+    }
+    while (!text.empty() && col < cols_) {
+        Cell cell;
+        cell.style = style;
+        uint32_t cp = 0;
+        size_t size = decode(text, cp);
+        if (size == 0) {
+            cell.bytes[0] = '?';
+            size = 1;
+        } else {
+            text.copy(cell.bytes, size);
+            cell.size = static_cast<uint8_t>(size);
+            cell.width = static_cast<uint8_t>(display_width(cp));
+        }
+        text.remove_prefix(size);
+        if (cell.width == 0) {
+            continue;
+        }
+
+        // Half a wide character can't be drawn, so a clipped one shows as a space
+        if (cell.width == 2 && (col < 0 || col + 1 >= cols_)) {
+            Cell space;
+            space.style = style;
+            for (int half = col; half < std::min(col + 2, cols_); ++half) {
+                if (half >= 0) {
+                    set_cell(row, half, space);
+                }
+            }
+            col = std::min(col + 2, cols_);
+            continue;
+        }
+
+        if (col >= 0) {
+            set_cell(row, col, cell);
+            if (cell.width == 2) {
+                Cell rest;
+                rest.size = 0;
+                rest.width = 0;
+                rest.style = style;
+                set_cell(row, col + 1, rest);
+            }
+        }
+        col += cell.width;
+    }
+    return col;
+}
+
+int Screen::fill(int row, int col, int count, char ch, const char* style) {
+    return put(row, col, std::string(std::max(count, 0), ch), style);
+}
+
+void Screen::set_cursor(int col, int row, bool visible) {
+    cursor_col_ = std::clamp(col, 0, cols_ - 1);
+    cursor_row_ = std::clamp(row, 0, rows_ - 1);
+    cursor_visible_ = visible;
+}
+
+void Screen::diff_row(int row, std::string& out) {
+    const Cell* b = &back_[static_cast<size_t>(row) * cols_];
+    Cell* f = &front_[static_cast<size_t>(row) * cols_];
+
+    int first = 0;
+    while (first < cols_ && b[first] == f[first]) {
+        ++first;
+    }
+    if (first == cols_) {
+        return;
+    }
+    int last = cols_ - 1;
+    while (b[last] == f[last]) {
+        --last;
+    }
+
+    // Don't start or end in the middle of a wide character
+    while (first > 0 && b[first].width == 0) {
+        --first;
+    }
+    while (last + 1 < cols_ && b[last + 1].width == 0) {
+        ++last;
+    }
+
+    // A blank tail is cleared with one erase instead of spaces
+    int content_end = cols_;
+    while (content_end > first && b[content_end - 1] == Cell{}) {
+        --content_end;
+    }
+    bool erase_tail = last >= content_end;
+    int stop = erase_tail ? content_end : last + 1;
+
+    append_move(out, first, row);
+    const char* style = nullptr;
+    for (int col = first; col < stop; ++col) {
+        // The terminal moved past this column with the wide character before it
+        if (b[col].width == 0) {
+            continue;
+        }
+        if (b[col].style != style) {
+            out += colors::RESET;
+            if (b[col].style) {
+                out += b[col].style;
+            }
+            style = b[col].style;
+        }
+        out.append(b[col].bytes, b[col].size);
+    }
+    if (style) {
+        out += colors::RESET;
+    }
+    if (erase_tail) {
+        out += "\033[K";
+    }
+
+    std::copy(b + first, b + cols_, f + first);
+}
+
+std::string Screen::diff() {
+    std::string out;
+    for (int row = 0; row < rows_; ++row) {
+        diff_row(row, out);
+    }
+
+    bool moved = cursor_col_ != shown_cursor_col_ || cursor_row_ != shown_cursor_row_;
+    if (out.empty() && !moved && cursor_visible_ == shown_cursor_visible_) {
+        return out;
+    }
+
+    // Hide the cursor while drawing so it doesn't flicker across the screen
+    if (!out.empty() || moved) {
+        out = "\033[?25l" + out;
+        append_move(out, cursor_col_, cursor_row_);
+    }
+    out += cursor_visible_ ? "\033[?25h" : "\033[?25l";
+
+    shown_cursor_col_ = cursor_col_;
+    shown_cursor_row_ = cursor_row_;
+    shown_cursor_visible_ = cursor_visible_;
+    return out;
+}
+
+}  // namespace dam::cli
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dam::cli {
+
+/**
+ * Double-buffered screen model with per-cell damage tracking.
+ *
+ * Each frame is drawn into a back buffer of cells, one per terminal
+ * column. A cell holds one UTF-8 code point and its style; a wide
+ * character (CJK, most emoji) takes its column and a continuation cell
+ * after it, so cell indexes are screen columns. diff() compares the back
+ * buffer with the front buffer (what the terminal shows) and returns the
+ * escape sequences for just the changed span of each changed row, ready
+ * to be written in one write(2). Styles are pointers to the colors::
+ * constants and compare by identity.
+ *
+ * Usage:
+ *   screen.clear();
+ *   screen.put(0, 0, "title", colors::BOLD);
+ *   screen.set_cursor(col, row);
+ *   terminal.write_frame(screen.diff());
+ */
+class Screen {
+public:
+    Screen(int cols, int rows);
+
+    /**
+     * Resize both buffers; the next frame repaints everything.
+     */
+    void resize(int cols, int rows);
+
+    /**
+     * Forget what the terminal shows; the next frame repaints everything.
+     */
+    void invalidate();
+
+    /**
+     * Blank the back buffer before drawing a frame.
+     */
+    void clear();
+
+    /**
+     * Draw UTF-8 text into the back buffer, clipped to the row. Columns
+     * advance by display width. Zero-width code points (combining marks,
+     * joiners, variation selectors) are dropped, and malformed bytes are
+     * drawn as '?'.
+     *
+     * @param row Row (0-indexed)
+     * @param col Starting column (0-indexed)
+     * @param text Text without newlines
+     * @param style ANSI style (nullptr = default)
+     * @return The column after the text
+     */
+    int put(int row, int col, std::string_view text, const char* style = nullptr);
+
+    /**
+     * Fill a span of a row with one character.
+     */
+    int fill(int row, int col, int count, char ch, const char* style = nullptr);
+
+    /**
+     * Set where the cursor is left after the frame.
+     */
+    void set_cursor(int col, int row, bool visible = true);
+
+    /**
+     * Build the output for the back buffer's changes and make it the
+     * front buffer.
+     *
+     * @return Escape sequences and text (empty if nothing changed)
+     */
+    std::string diff();
+
+    int cols() const { return cols_; }
+    int rows() const { return rows_; }
+
+private:
+    struct Cell {
+        char bytes[4] = {' '};  // One code point; none for a continuation
+        uint8_t size = 1;
+        uint8_t width = 1;      // 2 for a wide character, 0 for the cell after it
+        const char* style = nullptr;
+
+        bool operator==(const Cell& other) const {
+            return size == other.size && width == other.width && style == other.style &&
+                   std::char_traits<char>::compare(bytes, other.bytes, size) == 0;
+        }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    Cell& back(int row, int col) { return back_[static_cast<size_t>(row) * cols_ + col]; }
+
+    // Store a cell, blanking any wide character it cuts in half
+    void set_cell(int row, int col, const Cell& cell);
+
+    // Append the changed span of one row to out
+    void diff_row(int row, std::string& out);
+
+    int cols_;
+    int rows_;
+    std::vector<Cell> back_;
+    std::vector<Cell> front_;
+
+    int cursor_col_ = 0;
+    int cursor_row_ = 0;
+    bool cursor_visible_ = true;
+    int shown_cursor_col_ = -1;
+    int shown_cursor_row_ = -1;
+    bool shown_cursor_visible_ = true;
+};
+
+}  // namespace dam::cli
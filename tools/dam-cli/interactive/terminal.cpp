@@ -1,5 +1,6 @@
 #include "terminal.hpp"
 
+#include <cerrno>
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
@@ -8,6 +9,7 @@
 #include <stdexcept>
 
 #if defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <sys/select.h>
 #include <termios.h>
@@ -415,6 +417,36 @@ void Terminal::flush() {
     std::cout.flush();
 }
 
+void Terminal::write_frame(const std::string& frame) {
+    if (frame.empty()) {
+        return;
+    }
+    std::cout.flush();
+
+#if defined(__unix__) || defined(__APPLE__) || defined(__MACH__)
+    const char* data = frame.data();
+    size_t remaining = frame.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(STDOUT_FILENO, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Non-blocking stdout is full; sleep until it drains
+                pollfd pfd{STDOUT_FILENO, POLLOUT, 0};
+                if (::poll(&pfd, 1, -1) < 0 && errno != EINTR) return;
+                continue;
+            }
+            return;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+#else
+    std::cout << frame;
+    std::cout.flush();
+#endif
+}
+
 void Terminal::bell() {
     std::cout << '\a';
     flush();
@@ -176,6 +176,12 @@ public:
      */
     void flush();
 
+    /**
+     * Write a complete frame (see Screen::diff) with a single write(2),
+     * after flushing anything buffered in std::cout.
+     */
+    void write_frame(const std::string& frame);
+
     /**
      * Ring the terminal bell.
      */
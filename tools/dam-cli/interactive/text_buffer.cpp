@@ -0,0 +1,142 @@
+#include "text_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dam::cli {
+
+namespace {
+
+constexpr size_t MIN_GAP = 64;
+
+}  // namespace
+
+TextBuffer::TextBuffer() {
+    starts_before_.push_back(0);
+}
+
+void TextBuffer::set_text(std::string_view text) {
+    buffer_.assign(text.data(), text.size());
+    buffer_.append(MIN_GAP, '\0');
+    gap_start_ = text.size();
+    gap_end_ = buffer_.size();
+    size_ = text.size();
+
+    starts_before_.assign(1, 0);
+    ends_after_.clear();
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\n') {
+            starts_before_.push_back(i + 1);
+        }
+    }
+}
+
+void TextBuffer::reserve_gap(size_t n) {
+    if (gap_size() >= n) {
+        return;
+    }
+
+    // Grow geometrically and shift the text after the gap to the new end
+    size_t after = buffer_.size() - gap_end_;
+    size_t new_size = std::max(buffer_.size() * 2, size_ + n + MIN_GAP);
+    buffer_.resize(new_size);
+    std::memmove(&buffer_[new_size - after], &buffer_[gap_end_], after);
+    gap_end_ = new_size - after;
+}
+
+void TextBuffer::move_gap(size_t pos) {
+    pos = std::min(pos, size_);
+
+    if (pos < gap_start_) {
+        // Text [pos, gap_start) moves to just before gap_end
+        size_t n = gap_start_ - pos;
+        std::memmove(&buffer_[gap_end_ - n], &buffer_[pos], n);
+        gap_start_ -= n;
+        gap_end_ -= n;
+
+        while (starts_before_.size() > 1 && starts_before_.back() > pos) {
+            ends_after_.push_back(size_ - starts_before_.back());
+            starts_before_.pop_back();
+        }
+    } else if (pos > gap_start_) {
+        // Text [gap_end, gap_end + n) moves to gap_start
+        size_t n = pos - gap_start_;
+        std::memmove(&buffer_[gap_start_], &buffer_[gap_end_], n);
+        gap_start_ += n;
+        gap_end_ += n;
+
+        while (!ends_after_.empty() && size_ - ends_after_.back() <= pos) {
+            starts_before_.push_back(size_ - ends_after_.back());
+            ends_after_.pop_back();
+        }
+    }
+}
+
+void TextBuffer::insert(size_t pos, std::string_view text) {
+    move_gap(pos);
+    reserve_gap(text.size());
+
+    std::memcpy(&buffer_[gap_start_], text.data(), text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\n') {
+            starts_before_.push_back(gap_start_ + i + 1);
+        }
+    }
+    gap_start_ += text.size();
+    size_ += text.size();
+}
+
+void TextBuffer::erase(size_t pos, size_t len) {
+    if (pos >= size_) {
+        return;
+    }
+    len = std::min(len, size_ - pos);
+
+    // Absorb [pos, pos + len) into the gap from its end
+    move_gap(pos);
+    while (!ends_after_.empty() && size_ - ends_after_.back() <= pos + len) {
+        ends_after_.pop_back();
+    }
+    gap_end_ += len;
+    size_ -= len;
+}
+
+std::string_view TextBuffer::prefix(size_t pos) {
+    move_gap(pos);
+    return std::string_view(buffer_.data(), gap_start_);
+}
+
+size_t TextBuffer::line_start(size_t row) const {
+    if (row < starts_before_.size()) {
+        return starts_before_[row];
+    }
+    size_t from_gap = row - starts_before_.size();
+    if (from_gap >= ends_after_.size()) {
+        return size_;
+    }
+    return size_ - ends_after_[ends_after_.size() - 1 - from_gap];
+}
+
+size_t TextBuffer::line_length(size_t row) const {
+    size_t start = line_start(row);
+    size_t end = (row + 1 < line_count()) ? line_start(row + 1) - 1 : size_;
+    return end - start;
+}
+
+std::string TextBuffer::line(size_t row) const {
+    size_t start = line_start(row);
+    size_t len = line_length(row);
+
+    std::string result;
+    result.reserve(len);
+    if (start < gap_start_) {
+        size_t before = std::min(len, gap_start_ - start);
+        result.append(buffer_, start, before);
+        start += before;
+        len -= before;
+    }
+    result.append(buffer_, start + gap_size(), len);
+    return result;
+}
+
+}  // namespace dam::cli
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dam::cli {
+
+/**
+ * Gap buffer text model with an incremental line index.
+ *
+ * Text is kept in one buffer with a movable gap at the last edit
+ * position, so typing at the cursor is amortized O(1) and the text
+ * before the cursor is a single contiguous view. Line starts are split
+ * the same way: starts before the gap are stored as offsets from the
+ * beginning, starts after it as distances from the end, so an edit only
+ * touches the line starts it creates or removes.
+ *
+ * Positions are byte offsets into the logical text (the gap excluded).
+ */
+class TextBuffer {
+public:
+    TextBuffer();
+
+    /**
+     * Replace the whole text.
+     */
+    void set_text(std::string_view text);
+
+    /**
+     * Insert text at a position.
+     */
+    void insert(size_t pos, std::string_view text);
+    void insert(size_t pos, char c) { insert(pos, std::string_view(&c, 1)); }
+
+    /**
+     * Erase len bytes starting at pos.
+     */
+    void erase(size_t pos, size_t len);
+
+    /**
+     * View of the text before pos. Moves the gap to pos; the view is
+     * valid until the next call that edits or moves the gap.
+     */
+    std::string_view prefix(size_t pos);
+
+    /**
+     * View of the whole text (moves the gap to the end).
+     */
+    std::string_view view() { return prefix(size_); }
+
+    /**
+     * Byte at a position.
+     */
+    char at(size_t pos) const {
+        return pos < gap_start_ ? buffer_[pos] : buffer_[pos + gap_size()];
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // ========================================================================
+    // Lines
+    // ========================================================================
+
+    /**
+     * Number of lines (a trailing newline starts an empty last line).
+     */
+    size_t line_count() const { return starts_before_.size() + ends_after_.size(); }
+
+    /**
+     * Offset of the first byte of a line.
+     */
+    size_t line_start(size_t row) const;
+
+    /**
+     * Length of a line, excluding its newline.
+     */
+    size_t line_length(size_t row) const;
+
+    /**
+     * Copy of a line, excluding its newline.
+     */
+    std::string line(size_t row) const;
+
+    /**
+     * Offset of a (row, col) position.
+     */
+    size_t offset(size_t row, size_t col) const { return line_start(row) + col; }
+
+private:
+    size_t gap_size() const { return gap_end_ - gap_start_; }
+
+    // Move the gap so that it starts at logical position pos
+    void move_gap(size_t pos);
+
+    // Make room for at least n more bytes in the gap
+    void reserve_gap(size_t n);
+
+    std::string buffer_;
+    size_t gap_start_ = 0;
+    size_t gap_end_ = 0;
+    size_t size_ = 0;
+
+    // Line starts at or before the gap, ascending
+    std::vector<size_t> starts_before_;
+    // Line starts after the gap as distances from the end of the text,
+    // ascending (the back is the line closest to the gap)
+    std::vector<size_t> ends_after_;
+};
+
+}  // namespace dam::cli
@@ -1,8 +1,11 @@
 #include "input_classifier.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <cmath>
+#include <cstring>
+#include <queue>
 
 namespace dam::cli {
 
@@ -49,156 +52,490 @@ const std::vector<std::string> CONVERSATIONAL_WORDS = {
     " me ", " my ", " your ", " our ", " their "
 };
 
+
+// Question phrases (lowercase)
+const std::vector<std::string> QUESTION_PHRASES = {
+    "how to", "what is", "how do", "can i"
+};
+
+// Indentation that suggests code structure
+const std::vector<std::string> INDENT_PATTERNS = {
+    "    ", "\t"
+};
+
+enum Family : uint8_t {
+    STRONG_CODE, CODE_KEYWORD, CONVERSATIONAL, QUESTION, INDENT, NUM_FAMILIES
+};
+
+// Bytes of a line kept for prefix checks (longest NL starter and more)
+constexpr size_t HEAD_SIZE = 16;
+
+/**
+ * Aho-Corasick automaton over all pattern tables. The automaton runs on
+ * case-folded input; a case-sensitive family (the strong code patterns,
+ * where "System.out" is code and "system.out" may be prose) is checked
+ * against the raw bytes when it matches. Bytes that appear in no pattern
+ * share one symbol, which keeps the transition table small. No pattern
+ * contains a newline, so matches never span lines.
+ */
+class PatternAutomaton {
+public:
+    PatternAutomaton() {
+        add_family(STRONG_CODE_PATTERNS, STRONG_CODE, /*case_sensitive=*/true);
+        add_family(CODE_KEYWORDS, CODE_KEYWORD);
+        add_family(CONVERSATIONAL_WORDS, CONVERSATIONAL);
+        add_family(QUESTION_PHRASES, QUESTION);
+        add_family(INDENT_PATTERNS, INDENT);
+        build();
+    }
+
+    uint16_t step(uint16_t state, unsigned char c) const {
+        return next_[state * num_symbols_ + symbols_[c]];
+    }
+
+    // Patterns ending at a state
+    const uint16_t* matches_begin(uint16_t state) const {
+        return output_ids_.data() + output_start_[state];
+    }
+    const uint16_t* matches_end(uint16_t state) const {
+        return output_ids_.data() + output_start_[state + 1];
+    }
+
+    // Whether a match of the pattern ending just before `end` counts
+    bool accepts(uint16_t id, const char* end) const {
+        const std::string& raw = case_sensitive_[id];
+        return raw.empty() || std::memcmp(end - raw.size(), raw.data(), raw.size()) == 0;
+    }
+
+    size_t pattern_count() const { return patterns_.size(); }
+    size_t pattern_length(uint16_t id) const { return patterns_[id].size(); }
+    Family family(uint16_t id) const { return families_[id]; }
+
+private:
+    static unsigned char fold(unsigned char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+    }
+
+    void add_family(const std::vector<std::string>& patterns, Family family,
+                    bool case_sensitive = false) {
+        for (const auto& pattern : patterns) {
+            std::string folded = pattern;
+            for (char& c : folded) {
+                c = static_cast<char>(fold(static_cast<unsigned char>(c)));
+            }
+            case_sensitive_.push_back(case_sensitive ? pattern : "");
+            patterns_.push_back(std::move(folded));
+            families_.push_back(family);
+        }
+    }
+
+    void build() {
+        // Symbol 0 stands for every byte that appears in no pattern
+        for (const auto& pattern : patterns_) {
+            for (unsigned char c : pattern) {
+                if (symbols_[c] == 0) {
+                    symbols_[c] = static_cast<uint8_t>(num_symbols_++);
+                }
+            }
+        }
+        for (int c = 'A'; c <= 'Z'; ++c) {
+            symbols_[c] = symbols_[fold(static_cast<unsigned char>(c))];
+        }
+
+        // Trie
+        std::vector<int32_t> trie(num_symbols_, -1);
+        std::vector<std::vector<uint16_t>> outputs(1);
+        for (size_t id = 0; id < patterns_.size(); ++id) {
+            size_t state = 0;
+            for (unsigned char c : patterns_[id]) {
+                int32_t& child = trie[state * num_symbols_ + symbols_[c]];
+                if (child < 0) {
+                    child = static_cast<int32_t>(outputs.size());
+                    outputs.emplace_back();
+                    trie.resize(trie.size() + num_symbols_, -1);
+                }
+                state = static_cast<size_t>(trie[state * num_symbols_ + symbols_[c]]);
+            }
+            outputs[state].push_back(static_cast<uint16_t>(id));
+        }
+
+        // Failure links in BFS order turn the trie into a full DFA
+        std::vector<int32_t> fail(outputs.size(), 0);
+        std::queue<size_t> queue;
+        for (size_t sym = 0; sym < num_symbols_; ++sym) {
+            int32_t& child = trie[sym];
+            if (child < 0) {
+                child = 0;
+            } else {
+                queue.push(static_cast<size_t>(child));
+            }
+        }
+        while (!queue.empty()) {
+            size_t state = queue.front();
+            queue.pop();
+            for (size_t sym = 0; sym < num_symbols_; ++sym) {
+                int32_t& child = trie[state * num_symbols_ + sym];
+                int32_t fallback = trie[static_cast<size_t>(fail[state]) * num_symbols_ + sym];
+                if (child < 0) {
+                    child = fallback;
+                } else {
+                    fail[child] = fallback;
+                    const auto& inherited = outputs[fallback];
+                    outputs[child].insert(outputs[child].end(), inherited.begin(), inherited.end());
+                    queue.push(static_cast<size_t>(child));
+                }
+            }
+        }
+
+        next_.assign(trie.begin(), trie.end());
+        output_start_.push_back(0);
+        for (const auto& ids : outputs) {
+            output_ids_.insert(output_ids_.end(), ids.begin(), ids.end());
+            output_start_.push_back(static_cast<uint32_t>(output_ids_.size()));
+        }
+    }
+
+    std::vector<std::string> patterns_;
+    std::vector<Family> families_;
+    std::vector<std::string> case_sensitive_;  // Raw pattern, if case matters
+    std::array<uint8_t, 256> symbols_{};
+    size_t num_symbols_ = 1;
+    std::vector<uint16_t> next_;
+    std::vector<uint32_t> output_start_;
+    std::vector<uint16_t> output_ids_;
+};
+
+const PatternAutomaton& automaton() {
+    static const PatternAutomaton instance;
+    return instance;
+}
+
+bool is_leading_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
 }  // namespace
 
+// ============================================================================
+// InputClassifier
+// ============================================================================
+
+struct IncrementalClassifier::Features {
+    Counts counts;
+    size_t length = 0;
+    size_t newlines = 0;
+    size_t family_hits[NUM_FAMILIES] = {};
+    std::string head;       // Start of the text
+    char last = '\0';       // Last byte of the text
+    bool empty = false;
+};
+
 InputType InputClassifier::classify(const std::string& input,
                                      const std::string& language_hint) {
-    // Trim leading whitespace
-    size_t start = input.find_first_not_of(" \t\n\r");
-    if (start == std::string::npos) {
-        return InputType::EMPTY;
+    IncrementalClassifier classifier;
+    std::string_view partial = classifier.load(input);
+    return classifier.classify(partial);
+}
+
+float InputClassifier::calculate_code_score(const std::string& input) {
+    IncrementalClassifier classifier;
+    std::string_view partial = classifier.load(input);
+    return IncrementalClassifier::code_score(classifier.features(partial, false));
+}
+
+float InputClassifier::calculate_nl_score(const std::string& input) {
+    IncrementalClassifier classifier;
+    std::string_view partial = classifier.load(input);
+    return IncrementalClassifier::nl_score(classifier.features(partial, false));
+}
+
+bool InputClassifier::starts_with_nl_phrase(const std::string& lower_input) {
+    for (const auto& starter : NL_STARTERS) {
+        if (lower_input.find(starter) == 0) {
+            return true;
+        }
     }
+    return false;
+}
+
+bool InputClassifier::has_code_syntax(const std::string& input) {
+    return calculate_code_score(input) > 0.3f;
+}
 
-    std::string trimmed = input.substr(start);
+bool InputClassifier::has_shebang(const std::string& input) {
+    return input.size() >= 2 && input[0] == '#' && input[1] == '!';
+}
 
-    // Very short inputs are ambiguous
-    if (trimmed.length() < 3) {
-        return InputType::AMBIGUOUS;
+float InputClassifier::confidence(const std::string& input) {
+    float code_score = calculate_code_score(input);
+    float nl_score = calculate_nl_score(input);
+    return std::abs(code_score - nl_score);
+}
+
+bool InputClassifier::is_natural_language(const std::string& input) {
+    InputType type = classify(input);
+    return type == InputType::NATURAL_LANG;
+}
+
+bool InputClassifier::is_code(const std::string& input) {
+    InputType type = classify(input);
+    return type == InputType::CODE || type == InputType::AMBIGUOUS;
+}
+
+const char* InputClassifier::type_name(InputType type) {
+    switch (type) {
+        case InputType::CODE: return "CODE";
+        case InputType::NATURAL_LANG: return "NATURAL_LANG";
+        case InputType::EMPTY: return "EMPTY";
+        case InputType::AMBIGUOUS: return "AMBIGUOUS";
+        default: return "UNKNOWN";
     }
+}
 
-    // Check for shebang (definitely code)
-    if (has_shebang(trimmed)) {
-        return InputType::CODE;
+// ============================================================================
+// IncrementalClassifier
+// ============================================================================
+
+IncrementalClassifier::IncrementalClassifier()
+    : pattern_hits_(automaton().pattern_count(), 0)
+    , family_hits_(NUM_FAMILIES, 0) {
+}
+
+void IncrementalClassifier::truncate(size_t count) {
+    while (lines_.size() > count) {
+        remove(lines_.back());
+        lines_.pop_back();
     }
+}
 
-    float code_score = calculate_code_score(trimmed);
-    float nl_score = calculate_nl_score(trimmed);
+void IncrementalClassifier::append_line(std::string_view line) {
+    lines_.push_back(scan_line(line));
+    add(lines_.back());
+}
 
-    // Clear code indicators
-    if (code_score > 0.6f) {
-        return InputType::CODE;
+std::string_view IncrementalClassifier::load(std::string_view text) {
+    size_t start = 0;
+    size_t newline;
+    while ((newline = text.find('\n', start)) != std::string_view::npos) {
+        append_line(text.substr(start, newline - start));
+        start = newline + 1;
     }
+    return text.substr(start);
+}
 
-    // Clear natural language (and low code score)
-    if (nl_score > 0.5f && code_score < 0.3f) {
-        return InputType::NATURAL_LANG;
+InputType IncrementalClassifier::classify(std::string_view partial_line) {
+    return decide(features(partial_line, true));
+}
+
+IncrementalClassifier::LineFeatures IncrementalClassifier::scan_line(std::string_view line) {
+    const PatternAutomaton& patterns = automaton();
+
+    LineFeatures features;
+    features.length = line.size();
+    while (features.leading < line.size() && is_leading_space(line[features.leading])) {
+        features.leading_spaces += (line[features.leading] == ' ');
+        features.leading++;
+    }
+    features.head = std::string(line.substr(features.leading, HEAD_SIZE));
+    if (!line.empty()) {
+        features.last = line.back();
     }
 
-    // High confidence NL
-    if (nl_score > 0.7f) {
-        return InputType::NATURAL_LANG;
+    Counts& counts = features.counts;
+    uint16_t state = 0;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (c == '(' || c == ')') counts.brackets++;
+        if (c == '{' || c == '}') counts.braces++;
+        if (c == ';') counts.semicolons++;
+        if (c == '=' || c == '+' || c == '-' || c == '*' || c == '/' || c == '%') counts.operators++;
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == ' ') {
+            counts.alphanumeric++;
+        } else if (c != '\r' && c != '\t') {
+            counts.special++;
+        }
+        counts.spaces += (c == ' ');
+
+        state = patterns.step(state, static_cast<unsigned char>(c));
+        for (const uint16_t* id = patterns.matches_begin(state);
+             id != patterns.matches_end(state); ++id) {
+            if (!patterns.accepts(*id, line.data() + i + 1)) {
+                continue;
+            }
+            size_t match_start = i + 1 - patterns.pattern_length(*id);
+            if (match_start < features.leading) {
+                features.leading_matches.push_back(*id);
+            } else {
+                features.matches.push_back(*id);
+            }
+        }
     }
+    return features;
+}
 
-    // Default to ambiguous (which the editor treats as code)
-    return InputType::AMBIGUOUS;
+void IncrementalClassifier::add(const LineFeatures& line) {
+    const PatternAutomaton& patterns = automaton();
+    auto count = [&](const std::vector<uint16_t>& ids) {
+        for (uint16_t id : ids) {
+            if (pattern_hits_[id]++ == 0) {
+                family_hits_[patterns.family(id)]++;
+            }
+        }
+    };
+    count(line.leading_matches);
+    count(line.matches);
+
+    totals_.brackets += line.counts.brackets;
+    totals_.braces += line.counts.braces;
+    totals_.semicolons += line.counts.semicolons;
+    totals_.operators += line.counts.operators;
+    totals_.alphanumeric += line.counts.alphanumeric;
+    totals_.special += line.counts.special;
+    totals_.spaces += line.counts.spaces;
+    length_ += line.length;
 }
 
-float InputClassifier::calculate_code_score(const std::string& input) {
-    float score = 0.0f;
+void IncrementalClassifier::remove(const LineFeatures& line) {
+    const PatternAutomaton& patterns = automaton();
+    auto uncount = [&](const std::vector<uint16_t>& ids) {
+        for (uint16_t id : ids) {
+            if (--pattern_hits_[id] == 0) {
+                family_hits_[patterns.family(id)]--;
+            }
+        }
+    };
+    uncount(line.leading_matches);
+    uncount(line.matches);
+
+    totals_.brackets -= line.counts.brackets;
+    totals_.braces -= line.counts.braces;
+    totals_.semicolons -= line.counts.semicolons;
+    totals_.operators -= line.counts.operators;
+    totals_.alphanumeric -= line.counts.alphanumeric;
+    totals_.special -= line.counts.special;
+    totals_.spaces -= line.counts.spaces;
+    length_ -= line.length;
+}
 
-    // Check for strong code patterns (highest weight)
-    for (const auto& pattern : STRONG_CODE_PATTERNS) {
-        if (input.find(pattern) != std::string::npos) {
-            score += 0.4f;
-            break;  // One strong pattern is enough
+IncrementalClassifier::Features IncrementalClassifier::features(std::string_view partial_line,
+                                                                bool trim) {
+    const PatternAutomaton& patterns = automaton();
+
+    // The partial line takes part like any other until we return
+    append_line(partial_line);
+    struct Restore {
+        IncrementalClassifier* self;
+        ~Restore() { self->truncate(self->lines_.size() - 1); }
+    } restore{this};
+
+    Features features;
+    features.counts = totals_;
+    features.length = length_ + lines_.size() - 1;
+    std::copy(family_hits_.begin(), family_hits_.end(), features.family_hits);
+
+    size_t first = 0;
+    std::vector<uint16_t> trimmed;  // Matches inside trimmed whitespace
+    if (trim) {
+        // Leading blank lines and the first line's indentation are dropped
+        while (first < lines_.size() && lines_[first].blank()) {
+            const LineFeatures& line = lines_[first];
+            features.counts.alphanumeric -= line.counts.alphanumeric;
+            features.counts.spaces -= line.counts.spaces;
+            features.length -= line.length + 1;
+            trimmed.insert(trimmed.end(), line.leading_matches.begin(), line.leading_matches.end());
+            first++;
+        }
+        if (first == lines_.size()) {
+            features.empty = true;
+            return features;
         }
-    }
 
-    // Check for code keywords
-    std::string lower = input;
-    std::transform(lower.begin(), lower.end(), lower.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
+        const LineFeatures& line = lines_[first];
+        features.counts.alphanumeric -= line.leading_spaces;
+        features.counts.spaces -= line.leading_spaces;
+        features.length -= line.leading;
+        trimmed.insert(trimmed.end(), line.leading_matches.begin(), line.leading_matches.end());
+    }
 
-    int keyword_count = 0;
-    for (const auto& keyword : CODE_KEYWORDS) {
-        if (lower.find(keyword) != std::string::npos) {
-            keyword_count++;
-            if (keyword_count >= 2) break;  // Cap the contribution
+    // Patterns seen only in the trimmed whitespace no longer count
+    std::sort(trimmed.begin(), trimmed.end());
+    for (size_t i = 0; i < trimmed.size();) {
+        size_t j = i;
+        while (j < trimmed.size() && trimmed[j] == trimmed[i]) {
+            ++j;
+        }
+        if (pattern_hits_[trimmed[i]] == j - i) {
+            features.family_hits[patterns.family(trimmed[i])]--;
         }
+        i = j;
+    }
+
+    features.newlines = lines_.size() - 1 - first;
+    const LineFeatures& first_line = lines_[first];
+    if (trim || first_line.leading == 0) {
+        features.head = first_line.head;
+    }
+    if (lines_.back().length > 0) {
+        features.last = lines_.back().last;
+    } else if (lines_.size() > 1) {
+        features.last = '\n';
     }
-    score += keyword_count * 0.2f;
 
-    // Check for programming punctuation patterns
-    int brackets = 0;
-    int braces = 0;
-    int semicolons = 0;
-    int operators = 0;
-    int colons = 0;
+    return features;
+}
+
+float IncrementalClassifier::code_score(const Features& f) {
+    float score = 0.0f;
 
-    for (size_t i = 0; i < input.size(); ++i) {
-        char c = input[i];
-        if (c == '(' || c == ')') brackets++;
-        if (c == '{' || c == '}') braces++;
-        if (c == ';') semicolons++;
-        if (c == ':' && (i + 1 >= input.size() || input[i + 1] != ':')) colons++;
-        if (c == '=' || c == '+' || c == '-' || c == '*' || c == '/' || c == '%') operators++;
+    // Strong code patterns (highest weight); one is enough
+    if (f.family_hits[STRONG_CODE] > 0) {
+        score += 0.4f;
     }
 
-    if (brackets >= 2) score += 0.15f;
-    if (braces >= 2) score += 0.2f;
-    if (semicolons >= 1) score += 0.15f;
-    if (operators >= 2) score += 0.1f;
+    // Code keywords, capping the contribution
+    score += std::min<size_t>(f.family_hits[CODE_KEYWORD], 2) * 0.2f;
+
+    // Programming punctuation patterns
+    if (f.counts.brackets >= 2) score += 0.15f;
+    if (f.counts.braces >= 2) score += 0.2f;
+    if (f.counts.semicolons >= 1) score += 0.15f;
+    if (f.counts.operators >= 2) score += 0.1f;
 
     // Indentation suggests code structure
-    if (input.find("    ") != std::string::npos ||
-        input.find("\t") != std::string::npos) {
+    if (f.family_hits[INDENT] > 0) {
         score += 0.1f;
     }
 
     // Multiple lines with consistent indentation
-    size_t newlines = std::count(input.begin(), input.end(), '\n');
-    if (newlines >= 2) {
+    if (f.newlines >= 2) {
         score += 0.1f;
     }
 
     return std::min(1.0f, score);
 }
 
-float InputClassifier::calculate_nl_score(const std::string& input) {
+float IncrementalClassifier::nl_score(const Features& f) {
     float score = 0.0f;
 
-    // Convert to lowercase for comparison
-    std::string lower = input;
+    // Natural language starters (highest weight)
+    std::string lower(f.head);
     std::transform(lower.begin(), lower.end(), lower.begin(),
                    [](unsigned char c) { return std::tolower(c); });
-
-    // Check for natural language starters (highest weight)
-    if (starts_with_nl_phrase(lower)) {
+    if (InputClassifier::starts_with_nl_phrase(lower)) {
         score += 0.5f;
     }
 
-    // Check for question patterns
-    if (lower.back() == '?' ||
-        lower.find("how to") != std::string::npos ||
-        lower.find("what is") != std::string::npos ||
-        lower.find("how do") != std::string::npos ||
-        lower.find("can i") != std::string::npos) {
+    // Question patterns
+    if (f.last == '?' || f.family_hits[QUESTION] > 0) {
         score += 0.25f;
     }
 
-    // Check for conversational words
-    int conversational_count = 0;
-    for (const auto& word : CONVERSATIONAL_WORDS) {
-        if (lower.find(word) != std::string::npos) {
-            conversational_count++;
-            if (conversational_count >= 3) break;
-        }
-    }
-    score += conversational_count * 0.1f;
+    // Conversational words
+    score += std::min<size_t>(f.family_hits[CONVERSATIONAL], 3) * 0.1f;
 
     // Low special character ratio suggests prose
-    int alphanumeric = 0;
-    int special = 0;
-    for (char c : input) {
-        if (std::isalnum(static_cast<unsigned char>(c)) || c == ' ') {
-            alphanumeric++;
-        } else if (c != '\n' && c != '\r' && c != '\t') {
-            special++;
-        }
-    }
-
-    if (alphanumeric > 0) {
-        float special_ratio = static_cast<float>(special) / alphanumeric;
+    if (f.counts.alphanumeric > 0) {
+        float special_ratio = static_cast<float>(f.counts.special) / f.counts.alphanumeric;
         if (special_ratio < 0.05f) {
             score += 0.2f;  // Very few special chars
         } else if (special_ratio < 0.1f) {
@@ -207,9 +544,8 @@ float InputClassifier::calculate_nl_score(const std::string& input) {
     }
 
     // Sentence-like structure (starts with capital, has spaces)
-    if (!input.empty() && std::isupper(static_cast<unsigned char>(input[0]))) {
-        int spaces = std::count(input.begin(), input.end(), ' ');
-        if (spaces >= 3) {
+    if (!f.head.empty() && std::isupper(static_cast<unsigned char>(f.head[0]))) {
+        if (f.counts.spaces >= 3) {
             score += 0.1f;
         }
     }
@@ -217,47 +553,41 @@ float InputClassifier::calculate_nl_score(const std::string& input) {
     return std::min(1.0f, score);
 }
 
-bool InputClassifier::starts_with_nl_phrase(const std::string& lower_input) {
-    for (const auto& starter : NL_STARTERS) {
-        if (lower_input.find(starter) == 0) {
-            return true;
-        }
+InputType IncrementalClassifier::decide(const Features& f) {
+    if (f.empty) {
+        return InputType::EMPTY;
     }
-    return false;
-}
 
-bool InputClassifier::has_code_syntax(const std::string& input) {
-    return calculate_code_score(input) > 0.3f;
-}
+    // Very short inputs are ambiguous
+    if (f.length < 3) {
+        return InputType::AMBIGUOUS;
+    }
 
-bool InputClassifier::has_shebang(const std::string& input) {
-    return input.size() >= 2 && input[0] == '#' && input[1] == '!';
-}
+    // Check for shebang (definitely code)
+    if (InputClassifier::has_shebang(f.head)) {
+        return InputType::CODE;
+    }
 
-float InputClassifier::confidence(const std::string& input) {
-    float code_score = calculate_code_score(input);
-    float nl_score = calculate_nl_score(input);
-    return std::abs(code_score - nl_score);
-}
+    float code_score_value = code_score(f);
+    float nl_score_value = nl_score(f);
 
-bool InputClassifier::is_natural_language(const std::string& input) {
-    InputType type = classify(input);
-    return type == InputType::NATURAL_LANG;
-}
+    // Clear code indicators
+    if (code_score_value > 0.6f) {
+        return InputType::CODE;
+    }
 
-bool InputClassifier::is_code(const std::string& input) {
-    InputType type = classify(input);
-    return type == InputType::CODE || type == InputType::AMBIGUOUS;
-}
+    // Clear natural language (and low code score)
+    if (nl_score_value > 0.5f && code_score_value < 0.3f) {
+        return InputType::NATURAL_LANG;
+    }
 
-const char* InputClassifier::type_name(InputType type) {
-    switch (type) {
-        case InputType::CODE: return "CODE";
-        case InputType::NATURAL_LANG: return "NATURAL_LANG";
-        case InputType::EMPTY: return "EMPTY";
-        case InputType::AMBIGUOUS: return "AMBIGUOUS";
-        default: return "UNKNOWN";
+    // High confidence NL
+    if (nl_score_value > 0.7f) {
+        return InputType::NATURAL_LANG;
     }
+
+    // Default to ambiguous (which the editor treats as code)
+    return InputType::AMBIGUOUS;
 }
 
 }  // namespace dam::cli
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace dam::cli {
@@ -22,7 +25,9 @@ enum class InputType {
  * - Code being typed (for syntax completion)
  * - Natural language requests (for code generation)
  *
- * The classifier is designed to be fast and run on every keystroke.
+ * The classifier is designed to be fast and run on every keystroke: all
+ * keyword tables are compiled into one Aho-Corasick automaton, so a
+ * single pass scores every family regardless of table size.
  *
  * Examples:
  *   "def binary_search("         -> CODE
@@ -73,6 +78,97 @@ private:
     static bool starts_with_nl_phrase(const std::string& lower_input);
     static bool has_code_syntax(const std::string& input);
     static bool has_shebang(const std::string& input);
+
+    friend class IncrementalClassifier;
+};
+
+/**
+ * InputClassifier over a growing buffer that only rescans edited lines.
+ *
+ * Holds the features of complete lines; classify() adds the line being
+ * typed. After an edit, truncate() to the first changed line and
+ * append_line() the lines from there, so typing at the end of a long
+ * buffer only rescans the current line.
+ *
+ * Usage:
+ *   classifier.truncate(std::min(classifier.line_count(), first_edited_row));
+ *   while (classifier.line_count() < cursor_row) {
+ *       classifier.append_line(line(classifier.line_count()));
+ *   }
+ *   InputType type = classifier.classify(line(cursor_row).substr(0, cursor_col));
+ */
+class IncrementalClassifier {
+public:
+    IncrementalClassifier();
+
+    /**
+     * Number of complete lines held.
+     */
+    size_t line_count() const { return lines_.size(); }
+
+    /**
+     * Drop lines from the end, keeping the first count.
+     */
+    void truncate(size_t count);
+
+    /**
+     * Append a complete line (without its newline).
+     */
+    void append_line(std::string_view line);
+
+    /**
+     * Classify the held lines followed by a partial last line, i.e. the
+     * text lines[0] + '\n' + ... + '\n' + partial_line.
+     */
+    InputType classify(std::string_view partial_line);
+
+private:
+    friend class InputClassifier;
+
+    struct Counts {
+        size_t brackets = 0;
+        size_t braces = 0;
+        size_t semicolons = 0;
+        size_t operators = 0;
+        size_t alphanumeric = 0;  // Includes spaces
+        size_t special = 0;
+        size_t spaces = 0;
+    };
+
+    struct LineFeatures {
+        Counts counts;
+        size_t length = 0;
+        size_t leading = 0;          // Length of the leading whitespace
+        size_t leading_spaces = 0;
+        std::vector<uint16_t> leading_matches;  // Patterns starting in it
+        std::vector<uint16_t> matches;          // Patterns starting after it
+        std::string head;            // First bytes after the leading whitespace
+        char last = '\0';
+
+        bool blank() const { return leading == length; }
+    };
+
+    struct Features;
+
+    static LineFeatures scan_line(std::string_view line);
+    static float code_score(const Features& features);
+    static float nl_score(const Features& features);
+    static InputType decide(const Features& features);
+    void add(const LineFeatures& line);
+    void remove(const LineFeatures& line);
+
+    // Load text, returning its last (partial) line
+    std::string_view load(std::string_view text);
+
+    // Features of the held lines plus a partial line, optionally with
+    // leading whitespace trimmed like InputClassifier::classify does
+    Features features(std::string_view partial_line, bool trim);
+
+    std::vector<LineFeatures> lines_;
+    Counts totals_;
+    size_t length_ = 0;                  // Sum of line lengths
+    std::vector<uint32_t> pattern_hits_; // Occurrences per pattern
+    std::vector<size_t> family_hits_;    // Distinct patterns per family
 };
 
 }  // namespace dam::cli
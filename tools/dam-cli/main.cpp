@@ -10,6 +10,13 @@
 #include "commands/rm_command.hpp"
 #include "commands/tag_command.hpp"
 #include "commands/search_command.hpp"
+#include "commands/log_command.hpp"
+#include "commands/dedupe_command.hpp"
+#include "commands/backup_command.hpp"
+#include "commands/pack_command.hpp"
+#include "commands/generate_command.hpp"
+#include "commands/enrich_command.hpp"
+#include "commands/complete_command.hpp"
 
 #include <iostream>
 #include <memory>
@@ -39,6 +46,13 @@ int main(int argc, char* argv[]) {
     commands.push_back(std::make_unique<RmCommand>());
     commands.push_back(std::make_unique<TagCommand>());
     commands.push_back(std::make_unique<SearchCommand>());
+    commands.push_back(std::make_unique<LogCommand>());
+    commands.push_back(std::make_unique<DedupeCommand>());
+    commands.push_back(std::make_unique<BackupCommand>());
+    commands.push_back(std::make_unique<PackCommand>());
+    commands.push_back(std::make_unique<GenerateCommand>());
+    commands.push_back(std::make_unique<EnrichCommand>());
+    commands.push_back(std::make_unique<CompleteCommand>());
 
     // Track which command was selected
     Command* selected_command = nullptr;
@@ -48,6 +62,11 @@ int main(int argc, char* argv[]) {
         auto* subapp = app.add_subcommand(cmd->name(), cmd->description());
         cmd->setup(*subapp);
 
+        // Commands for shell integration are left out of help
+        if (cmd->name().rfind("__", 0) == 0) {
+            subapp->group("");
+        }
+
         // Capture the command when its subcommand is parsed
         subapp->callback([&selected_command, &cmd]() {
             selected_command = cmd.get();
@@ -69,9 +88,12 @@ int main(int argc, char* argv[]) {
             : std::filesystem::path(store_path);
 
         // Open store
-        auto store = open_store(path, verbose);
-        if (!store) {
-            return DAM_EXIT_IO_ERROR;
+        std::unique_ptr<dam::SnippetStore> store;
+        if (selected_command->needs_store()) {
+            store = open_store(path, verbose);
+            if (!store) {
+                return DAM_EXIT_IO_ERROR;
+            }
         }
 
         // Create context